@@ -1,7 +1,9 @@
 #include "exceptions.hpp"
 
 #include <sstream>
+#ifdef _WIN32
 #include <comdef.h>
+#endif
 
 #include "utils.hpp"
 
@@ -53,6 +55,7 @@ int SomeException::GetLine() const noexcept
 }
 
 
+#ifdef _WIN32
 SomeWinException::SomeWinException(int line, const wchar_t* file, HRESULT hr) noexcept
 	: SomeException(line, file)
 	, m_hresult(hr)
@@ -120,5 +123,6 @@ std::wstring SomeD3DException::GetErrorInfo() const noexcept
 {
 	return m_errorInfo;
 }
+#endif
 
 }  // end namespace SD
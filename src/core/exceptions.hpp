@@ -3,7 +3,16 @@
 #include <exception>
 #include <string>
 #include <vector>
+#ifdef _WIN32
 #include <Windows.h>
+#endif
+
+// wide file name for the exception macros where the compiler has none
+#ifndef __FILEW__
+#define SD_WIDEN_IMPL(str) L ## str
+#define SD_WIDEN(str) SD_WIDEN_IMPL(str)
+#define __FILEW__ SD_WIDEN(__FILE__)
+#endif
 
 
 namespace SD {
@@ -30,6 +39,7 @@ private:
 };
 
 
+#ifdef _WIN32
 class SomeWinException : public SomeException
 {
 public:
@@ -59,10 +69,12 @@ public:
 private:
     std::wstring m_errorInfo;
 };
+#endif
 
 
 #define THROW_SOME_EXCEPTION(msg) {throw SomeException(__LINE__, __FILEW__, msg);}
 
+#ifdef _WIN32
     // Win Exceptions Macro
 #define WIN_THROW_IF_FAILED(hrcall) {HRESULT hr = (hrcall); if(FAILED(hr)) throw SomeWinException(__LINE__, __FILEW__ , hr);}
 #define WIN_THROW_LAST_EXCEPTION() {throw  SomeWinException(__LINE__, __FILEW__ , GetLastError());}
@@ -71,8 +83,9 @@ private:
 // D3D Exceptions Macro
 #define D3D_DEBUG_LAYER(renderer) auto debugLayer = renderer->GetDebugLayer()
 #define D3D_EXCEPTION(hr) SomeD3DException(__LINE__, __FILEW__ , hr, debugLayer->GetMessages())
-#define D3D_THROW_INFO_EXCEPTION(hrcall) {debugLayer->Set(); HRESULT hr = (hrcall); if(FAILED(hr)) throw D3D_EXCEPTION(hr);}
+#define D3D_THROW_INFO_EXCEPTION(hrcall) {auto debugLock = debugLayer->Lock(); debugLayer->Set(); HRESULT hr = (hrcall); if(FAILED(hr)) throw D3D_EXCEPTION(hr);}
 #define D3D_THROW_NOINFO_EXCEPTION(hrcall) {HRESULT hr = (hrcall); if(FAILED(hr)) throw SomeD3DException(__LINE__, __FILEW__ , hr);}
-#define D3D_THROW_IF_INFO(call) debugLayer->Set(); (call); {auto msgs = debugLayer->GetMessages(); if(!msgs.empty()) {throw SomeD3DException(__LINE__, __FILEW__ , S_OK, msgs);}}
+#define D3D_THROW_IF_INFO(call) {auto debugLock = debugLayer->Lock(); debugLayer->Set(); (call); auto msgs = debugLayer->GetMessages(); if(!msgs.empty()) {throw SomeD3DException(__LINE__, __FILEW__ , S_OK, msgs);}}
+#endif
 
 }  // end namespace SD
@@ -0,0 +1,115 @@
+#include "hash.hpp"
+
+#include <cstring>
+
+
+namespace
+{
+constexpr uint64_t PRIME1 = 11400714785074694791ull;
+constexpr uint64_t PRIME2 = 14029467366897019727ull;
+constexpr uint64_t PRIME3 = 1609587929392839161ull;
+constexpr uint64_t PRIME4 = 9650029242287828579ull;
+constexpr uint64_t PRIME5 = 2870177450012600261ull;
+
+uint64_t Rotl(uint64_t value, int bits)
+{
+	return (value << bits) | (value >> (64 - bits));
+}
+
+uint64_t Read64(const uint8_t* data)
+{
+	uint64_t value;
+	memcpy(&value, data, sizeof(value));
+	return value;
+}
+
+uint32_t Read32(const uint8_t* data)
+{
+	uint32_t value;
+	memcpy(&value, data, sizeof(value));
+	return value;
+}
+
+uint64_t Round(uint64_t accumulator, uint64_t input)
+{
+	accumulator += input * PRIME2;
+	accumulator = Rotl(accumulator, 31);
+	return accumulator * PRIME1;
+}
+
+uint64_t Merge(uint64_t hash, uint64_t accumulator)
+{
+	hash ^= Round(0, accumulator);
+	return hash * PRIME1 + PRIME4;
+}
+}  // end namespace
+
+namespace SD {
+
+uint64_t Hash64(const void* data, size_t size, uint64_t seed)
+{
+	const auto* bytes = static_cast<const uint8_t*>(data);
+	const uint8_t* const end = bytes + size;
+
+	uint64_t hash;
+	if (size >= 32)
+	{
+		// four independent lanes of 8 bytes
+		uint64_t v1 = seed + PRIME1 + PRIME2;
+		uint64_t v2 = seed + PRIME2;
+		uint64_t v3 = seed;
+		uint64_t v4 = seed - PRIME1;
+
+		const uint8_t* const limit = end - 32;
+		do
+		{
+			v1 = Round(v1, Read64(bytes));
+			v2 = Round(v2, Read64(bytes + 8));
+			v3 = Round(v3, Read64(bytes + 16));
+			v4 = Round(v4, Read64(bytes + 24));
+			bytes += 32;
+		} while (bytes <= limit);
+
+		hash = Rotl(v1, 1) + Rotl(v2, 7) + Rotl(v3, 12) + Rotl(v4, 18);
+		hash = Merge(hash, v1);
+		hash = Merge(hash, v2);
+		hash = Merge(hash, v3);
+		hash = Merge(hash, v4);
+	}
+	else
+	{
+		hash = seed + PRIME5;
+	}
+
+	hash += static_cast<uint64_t>(size);
+
+	for (; bytes + 8 <= end; bytes += 8)
+	{
+		hash ^= Round(0, Read64(bytes));
+		hash = Rotl(hash, 27) * PRIME1 + PRIME4;
+	}
+
+	if (bytes + 4 <= end)
+	{
+		hash ^= static_cast<uint64_t>(Read32(bytes)) * PRIME1;
+		hash = Rotl(hash, 23) * PRIME2 + PRIME3;
+		bytes += 4;
+	}
+
+	for (; bytes < end; ++bytes)
+	{
+		hash ^= static_cast<uint64_t>(*bytes) * PRIME5;
+		hash = Rotl(hash, 11) * PRIME1;
+	}
+
+	// avalanche
+	hash ^= hash >> 33;
+	hash *= PRIME2;
+	hash ^= hash >> 29;
+	hash *= PRIME3;
+	hash ^= hash >> 32;
+
+	return hash;
+}
+
+}  // end namespace SD
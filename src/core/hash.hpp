@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+
+namespace SD {
+
+// 64-bit non-cryptographic hash of a byte range (xxHash64), stable between runs and platforms.
+uint64_t Hash64(const void* data, size_t size, uint64_t seed = 0);
+
+// Mixes a value into an accumulated hash.
+inline uint64_t HashCombine(uint64_t hash, uint64_t value)
+{
+    return hash ^ (value + 0x9E3779B97F4A7C15ull + (hash << 6) + (hash >> 2));
+}
+
+}  // end namespace SD
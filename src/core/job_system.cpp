@@ -0,0 +1,154 @@
+#include "job_system.hpp"
+
+#include <algorithm>
+#include <exception>
+
+
+namespace SD {
+
+JobSystem::JobSystem(const size_t workersCount)
+{
+	m_workers.reserve(workersCount);
+	for (size_t i = 0; i < workersCount; ++i)
+	{
+		m_workers.emplace_back([this]() { workerLoop(); });
+	}
+}
+
+JobSystem::~JobSystem()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stopping = true;
+	}
+	m_condition.notify_all();
+
+	for (auto& worker : m_workers)
+	{
+		worker.join();
+	}
+}
+
+void JobSystem::ParallelFor(const size_t count, const std::function<void(size_t)>& job)
+{
+	ParallelFor(count, m_workers.size() + 1, job);
+}
+
+void JobSystem::ParallelFor(const size_t count, const size_t maxThreads, const std::function<void(size_t)>& job)
+{
+	if (count == 0)
+	{
+		return;
+	}
+
+	// shared with the helpers, those that start once every index is taken find nothing to do and never touch the job
+	struct Range
+	{
+		const std::function<void(size_t)>* job = nullptr;
+		size_t count = 0;
+		std::atomic<size_t> next{ 0 };
+
+		std::mutex mutex;
+		std::condition_variable condition;
+		size_t done = 0;
+		std::exception_ptr error = nullptr;
+
+		void Run()
+		{
+			for (size_t idx = next++; idx < count; idx = next++)
+			{
+				std::exception_ptr jobError = nullptr;
+				try
+				{
+					(*job)(idx);
+				}
+				catch (...)
+				{
+					jobError = std::current_exception();
+				}
+
+				std::lock_guard<std::mutex> lock(mutex);
+				if (jobError && !error)
+				{
+					error = jobError;
+				}
+
+				if (++done == count)
+				{
+					condition.notify_all();
+				}
+			}
+		}
+	};
+
+	const auto range = std::make_shared<Range>();
+	range->job = &job;
+	range->count = count;
+
+	// calling thread is one of the participants
+	const size_t helpers = std::min({ count, std::max<size_t>(maxThreads, 1), m_workers.size() + 1 }) - 1;
+
+	// ahead of queued jobs, so free workers join a running range before they start more work of their own
+	for (size_t i = 0; i < helpers; ++i)
+	{
+		push([range]() { range->Run(); }, true);
+	}
+
+	range->Run();
+
+	// the rest of the indices are being run by other threads, waiting on them cannot deadlock
+	std::unique_lock<std::mutex> lock(range->mutex);
+	range->condition.wait(lock, [&range]() { return range->done == range->count; });
+
+	if (range->error)
+	{
+		std::rethrow_exception(range->error);
+	}
+}
+
+size_t JobSystem::DefaultWorkersCount()
+{
+	const auto cores = static_cast<size_t>(std::thread::hardware_concurrency());
+
+	return cores > 1 ? cores - 1 : 1;
+}
+
+void JobSystem::push(std::function<void()> job, bool front)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (front)
+		{
+			m_jobs.emplace_front(std::move(job));
+		}
+		else
+		{
+			m_jobs.emplace_back(std::move(job));
+		}
+	}
+	m_condition.notify_one();
+}
+
+void JobSystem::workerLoop()
+{
+	while (true)
+	{
+		std::function<void()> job;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_condition.wait(lock, [this]() { return m_stopping || !m_jobs.empty(); });
+
+			if (m_stopping && m_jobs.empty())
+			{
+				return;
+			}
+
+			job = std::move(m_jobs.front());
+			m_jobs.pop_front();
+		}
+
+		job();
+	}
+}
+
+}  // end namespace SD
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+
+namespace SD {
+
+class JobSystem
+{
+public:
+    JobSystem(const size_t workersCount = DefaultWorkersCount());
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    // Queue a single job, the result (or exception) is delivered through the future.
+    template<class F>
+    auto Submit(F&& job) -> std::future<std::invoke_result_t<std::decay_t<F>>>
+    {
+        using R = std::invoke_result_t<std::decay_t<F>>;
+
+        auto task = std::make_shared<std::packaged_task<R()>>(std::forward<F>(job));
+        auto future = task->get_future();
+
+        push([task]() { (*task)(); });
+
+        return future;
+    }
+
+    // Run job(idx) for every idx in [0, count) and wait for all of them.
+    // The calling thread takes part in the work and then waits for the indices other threads took only, it never runs
+    // unrelated queued jobs, so nested calls from jobs are allowed. Helpers are queued ahead of other jobs.
+    // The first exception thrown by a job is rethrown on the calling thread.
+    void ParallelFor(const size_t count, const std::function<void(size_t)>& job);
+
+    // Same as ParallelFor, but limits the number of threads working on the range (calling thread included).
+    void ParallelFor(const size_t count, const size_t maxThreads, const std::function<void(size_t)>& job);
+
+    size_t GetWorkersCount() const { return m_workers.size(); }
+
+    static size_t DefaultWorkersCount();
+
+private:
+    void push(std::function<void()> job, bool front = false);
+    void workerLoop();
+
+private:
+    std::vector<std::thread> m_workers;
+
+    std::deque<std::function<void()>> m_jobs;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_stopping = false;
+};
+
+}  // end namespace SD
@@ -0,0 +1,129 @@
+#include "mapped_file.hpp"
+
+#ifndef _WIN32
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "exceptions.hpp"
+#include "utils.hpp"
+
+
+namespace SD {
+
+#ifdef _WIN32
+MappedFile::MappedFile(const std::filesystem::path& path)
+{
+	m_file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (m_file == INVALID_HANDLE_VALUE)
+	{
+		WIN_THROW_LAST_EXCEPTION();
+	}
+
+	LARGE_INTEGER size = {};
+	if (!GetFileSizeEx(m_file, &size))
+	{
+		const auto error = GetLastError();
+		CloseHandle(m_file);
+		throw SomeWinException(__LINE__, __FILEW__, static_cast<HRESULT>(error));
+	}
+	m_size = static_cast<size_t>(size.QuadPart);
+
+	// empty files can not be mapped
+	if (m_size == 0)
+	{
+		return;
+	}
+
+	m_mapping = CreateFileMappingW(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (m_mapping)
+	{
+		m_pData = static_cast<const uint8_t*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+	}
+
+	if (!m_pData)
+	{
+		const auto error = GetLastError();
+		if (m_mapping)
+		{
+			CloseHandle(m_mapping);
+		}
+		CloseHandle(m_file);
+		throw SomeWinException(__LINE__, __FILEW__, static_cast<HRESULT>(error));
+	}
+}
+
+MappedFile::~MappedFile()
+{
+	if (m_pData)
+	{
+		UnmapViewOfFile(m_pData);
+	}
+
+	if (m_mapping)
+	{
+		CloseHandle(m_mapping);
+	}
+
+	if (m_file != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(m_file);
+	}
+}
+
+#else
+MappedFile::MappedFile(const std::filesystem::path& path)
+{
+	m_file = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (m_file == -1)
+	{
+		THROW_SOME_EXCEPTION(L"Failed to open " + path.wstring() + L": " + AToWstring(std::strerror(errno)));
+	}
+
+	struct stat status = {};
+	if (fstat(m_file, &status) == -1)
+	{
+		const auto error = errno;
+		close(m_file);
+		THROW_SOME_EXCEPTION(L"Failed to stat " + path.wstring() + L": " + AToWstring(std::strerror(error)));
+	}
+	m_size = static_cast<size_t>(status.st_size);
+
+	// empty files can not be mapped
+	if (m_size == 0)
+	{
+		return;
+	}
+
+	void* data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, m_file, 0);
+	if (data == MAP_FAILED)
+	{
+		const auto error = errno;
+		close(m_file);
+		THROW_SOME_EXCEPTION(L"Failed to map " + path.wstring() + L": " + AToWstring(std::strerror(error)));
+	}
+	m_pData = static_cast<const uint8_t*>(data);
+
+	// same access pattern as FILE_FLAG_SEQUENTIAL_SCAN
+	madvise(data, m_size, MADV_SEQUENTIAL);
+}
+
+MappedFile::~MappedFile()
+{
+	if (m_pData)
+	{
+		munmap(const_cast<uint8_t*>(m_pData), m_size);
+	}
+
+	if (m_file != -1)
+	{
+		close(m_file);
+	}
+}
+#endif
+
+}  // end namespace SD
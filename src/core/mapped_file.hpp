@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#ifdef _WIN32
+#include <Windows.h>
+#endif
+
+
+namespace SD {
+
+// Read-only view of a whole file, pages are loaded by the OS on first access.
+class MappedFile
+{
+public:
+    MappedFile(const std::filesystem::path& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const uint8_t* GetData() const { return m_pData; }
+    size_t GetSize() const { return m_size; }
+
+private:
+#ifdef _WIN32
+    HANDLE m_file = INVALID_HANDLE_VALUE;
+    HANDLE m_mapping = nullptr;
+#else
+    int m_file = -1;
+#endif
+    const uint8_t* m_pData = nullptr;
+    size_t m_size = 0;
+};
+
+}  // end namespace SD
@@ -2,10 +2,14 @@
 
 #include <string>
 #include <stdlib.h>
+#ifdef _WIN32
+#include <Windows.h>
+#endif
 
 
 namespace SD {
 
+#ifdef _WIN32
 inline std::wstring AToWstring(const std::string& str)
 {
     WCHAR buffer[1024];
@@ -19,5 +23,22 @@ inline std::string WToAstring(const std::wstring& str)
     wcstombs_s(nullptr, buffer, str.c_str(), _TRUNCATE);
     return buffer;
 }
+#else
+inline std::wstring AToWstring(const std::string& str)
+{
+    std::wstring result(str.size(), L'\0');
+    const auto size = mbstowcs(result.data(), str.c_str(), result.size());
+    result.resize(size == static_cast<size_t>(-1) ? 0 : size);
+    return result;
+}
+
+inline std::string WToAstring(const std::wstring& str)
+{
+    std::string result(str.size() * MB_CUR_MAX, '\0');
+    const auto size = wcstombs(result.data(), str.c_str(), result.size());
+    result.resize(size == static_cast<size_t>(-1) ? 0 : size);
+    return result;
+}
+#endif
 
 }  // end namespace SD
@@ -1,11 +1,13 @@
 #include "application.hpp"
 
+#include <algorithm>
 #include <iostream>
 #include <stdint.h>
 
 #include <backends/imgui_impl_win32.h>
 
 #include "exceptions.hpp"
+#include "renderer.hpp"
 
 
 // Forward declare message handler from imgui_impl_win32.cpp
@@ -18,21 +20,31 @@ const std::wstring NAME = L"Some Demo";
 const uint16_t WIDTH = 1200;
 const uint16_t HEIGHT = 800;
 const float FRAME_STATS_UPDATE_PERIOD = 0.1f;
+const float HEADLESS_FRAME_DELTA = 1.0f / 60.0f;
 
 
-HWND Application::s_hWnd = nullptr;
+Application* Application::s_pApplication = nullptr;
 
 
-Application::Application()
+Application::Application(const ApplicationSettings& settings)
+	: m_settings(settings)
 {
 	std::clog << "Application initialization!" << std::endl;
 
+	s_pApplication = this;
+
 	WIN_THROW_IF_FAILED(CoInitializeEx(nullptr, COINIT_MULTITHREADED));
 
-	m_pWindow = std::make_unique<Window>(this, WIDTH, HEIGHT, NAME);
-	s_hWnd = m_pWindow->GetHandle();
+	m_pJobSystem = std::make_unique<JobSystem>();
+
+	if (!m_settings.headless)
+	{
+		m_pWindow = std::make_unique<Window>(this, WIDTH, HEIGHT, NAME);
+	}
 
 	m_pRenderSystem = std::make_unique<RenderSystem>();
+	m_pTextureStreamer = std::make_unique<TextureStreamer>(m_pRenderSystem->GetRenderer(), SD_RES_DIR + std::string("cache\\textures"));
+	m_pTextureCache = std::make_unique<TextureCache>(m_pRenderSystem->GetRenderer(), m_pTextureStreamer.get());
 	m_pCamera = std::make_unique<Camera>();
 	m_pSpace = std::make_unique<Space>();
 	m_pTimer = std::make_unique<Timer>();
@@ -43,10 +55,17 @@ Application::~Application()
 	std::clog << "Application destroying!" << std::endl;
 
 	CoUninitialize();
+
+	s_pApplication = nullptr;
 }
 
 int Application::Run()
 {
+	if (m_settings.headless)
+	{
+		return RunHeadless();
+	}
+
 	m_pSpace->Init();
 
 	while (true) {
@@ -60,37 +79,75 @@ int Application::Run()
 		const auto dt = m_pTimer->GetDelta();
 		UpdateFrameStats(dt);
 
-		// Simulate
-		{
-			m_pSpace->Simulate(dt);
-		}
+		Frame(dt);
+	}
+}
+
+int Application::RunHeadless()
+{
+	m_pSpace->Init();
+
+	std::clog << "Headless run: " << m_settings.frames << " frames." << std::endl;
+
+	// fixed simulation step, so runs are comparable
+	m_pTimer->GetDelta();
+	for (uint32_t frame = 0; frame < m_settings.frames; ++frame)
+	{
+		Frame(HEADLESS_FRAME_DELTA);
+	}
+	const auto elapsed = m_pTimer->GetDelta();
+
+	const auto stats = m_pRenderSystem->GetRenderer()->GetStats();
+	const auto frames = std::max(m_settings.frames, 1u);
+
+	std::clog << "CPU frame time: " << elapsed * 1000.0f / frames << " ms." << std::endl;
+	std::clog << "Calls per frame: " << stats.calls / frames << ", draws per frame: " << stats.draws / frames << "." << std::endl;
+	std::clog << "Buffers: " << stats.buffers << " (" << stats.bufferBytes << " bytes), textures: " << stats.textures << " (" << stats.textureBytes << " bytes)." << std::endl;
+	std::clog << "Uploaded: " << stats.uploadBytes << " bytes." << std::endl;
+
+	m_pSpace->Destroy();
+
+	return 0;
+}
+
+void Application::Frame(float dt)
+{
+	// Simulate
+	{
+		m_pSpace->Simulate(dt);
+	}
+
+	// Stream
+	{
+		m_pTextureStreamer->Update();
+	}
 
-		// Update
+	// Update
+	{
+		m_pSpace->Update(dt);
+		m_pCamera->Update(dt);
+	}
+
+	// Draw
+	{
+		m_pRenderSystem->Begin();
+
+		// Space
 		{
-			m_pSpace->Update(dt);
-			m_pCamera->Update(dt);
+			m_pRenderSystem->BeginFrame();
+			m_pSpace->DrawFrame();
+			m_pRenderSystem->EndFrame();
 		}
 
-		// Draw
+		// ImGui
+		if (!m_settings.headless)
 		{
-			m_pRenderSystem->Begin();
-
-			// Space
-			{
-				m_pRenderSystem->BeginFrame();
-				m_pSpace->DrawFrame();
-				m_pRenderSystem->EndFrame();
-			}
-			
-			// ImGui
-			{
-				m_pRenderSystem->BeginImGui();
-				m_pSpace->DrawImGui();
-				m_pRenderSystem->EndImGui();
-			}
-
-			m_pRenderSystem->End();
+			m_pRenderSystem->BeginImGui();
+			m_pSpace->DrawImGui();
+			m_pRenderSystem->EndImGui();
 		}
+
+		m_pRenderSystem->End();
 	}
 }
 
@@ -124,6 +181,36 @@ Camera* Application::GetCamera() const
 	return m_pCamera.get();
 }
 
+JobSystem* Application::GetJobSystem() const
+{
+	if (!m_pJobSystem)
+	{
+		THROW_SOME_EXCEPTION(L"MISSING JOB SYSTEM!");
+	}
+
+	return m_pJobSystem.get();
+}
+
+TextureCache* Application::GetTextureCache() const
+{
+	if (!m_pTextureCache)
+	{
+		THROW_SOME_EXCEPTION(L"MISSING TEXTURE CACHE!");
+	}
+
+	return m_pTextureCache.get();
+}
+
+TextureStreamer* Application::GetTextureStreamer() const
+{
+	if (!m_pTextureStreamer)
+	{
+		THROW_SOME_EXCEPTION(L"MISSING TEXTURE STREAMER!");
+	}
+
+	return m_pTextureStreamer.get();
+}
+
 LRESULT Application::WindowProc(HWND hWnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
 {
 	if (ImGui_ImplWin32_WndProcHandler(hWnd, uMsg, wParam, lParam))
@@ -200,7 +287,7 @@ LRESULT Application::WindowProc(HWND hWnd, UINT uMsg, WPARAM wParam, LPARAM lPar
 
 Application* const Application::GetApplication()
 {
-	return reinterpret_cast<Application*>(GetWindowLongPtr(s_hWnd, GWLP_USERDATA));
+	return s_pApplication;
 }
 
 void Application::Activate(bool active)
@@ -1,20 +1,40 @@
 #pragma once
 
+#include <cstdint>
 #include <memory>
+#include <string>
+
+#include "job_system.hpp"
 
 #include "camera.hpp"
 #include "render_system.hpp"
 #include "space.hpp"
+#include "texture_cache.hpp"
+#include "texture_streamer.hpp"
 #include "timer.hpp"
 #include "window.hpp"
 
 
 namespace SD::ENGINE {
 
+struct ApplicationSettings
+{
+	// no window, UI or GPU work, renders through the null backend
+	bool headless = false;
+	// frames to run in headless mode
+	uint32_t frames = 1000u;
+	// glTF file to benchmark the readers on instead of running, empty to run
+	std::string gltfBenchmark = {};
+	// benchmark block compression instead of running
+	bool compressionBenchmark = false;
+	// image to benchmark block compression on, empty for a synthetic one
+	std::string compressionBenchmarkImage = {};
+};
+
 class Application
 {
 public:
-	Application();
+	Application(const ApplicationSettings& settings = {});
 	~Application();
 
 	int Run();
@@ -22,7 +42,11 @@ public:
 	Window* GetWindow() const;
 	RenderSystem* GetRenderSystem() const;
 	Camera* GetCamera() const;
+	JobSystem* GetJobSystem() const;
+	TextureCache* GetTextureCache() const;
+	TextureStreamer* GetTextureStreamer() const;
 
+	bool IsHeadless() const { return m_settings.headless; };
 	bool IsActive() const { return m_isActive; };
 	bool IsCameraActive() const { return m_isCameraActive; };
 
@@ -31,16 +55,24 @@ public:
 	static Application* const GetApplication();
 
 private:
+	int RunHeadless();
+	void Frame(float dt);
+
 	void Activate(bool active);
 	void ActivateCamera(bool active);
 	void UpdateFrameStats(float dt);
 
 private:
+	ApplicationSettings m_settings;
+
 	bool m_isActive = false;
 	bool m_isCameraActive = false;
 
+	std::unique_ptr<JobSystem> m_pJobSystem;
 	std::unique_ptr<Window> m_pWindow;
 	std::unique_ptr<RenderSystem> m_pRenderSystem;
+	std::unique_ptr<TextureStreamer> m_pTextureStreamer;
+	std::unique_ptr<TextureCache> m_pTextureCache;
 	std::unique_ptr<Camera> m_pCamera;
 	std::unique_ptr<Space> m_pSpace;
 	std::unique_ptr<Timer> m_pTimer;
@@ -48,7 +80,7 @@ private:
 	using FrameStatsCollector = std::pair<float, int>;  // <time delta, frames count>
 	FrameStatsCollector m_frameStatsCollector;
 
-	static HWND s_hWnd;
+	static Application* s_pApplication;
 };
 
 }  // end namespace SD::ENGINE
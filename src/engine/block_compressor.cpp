@@ -0,0 +1,707 @@
+#include "block_compressor.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+#include <emmintrin.h>
+
+#include <DirectXTex.h>
+
+#include "exceptions.hpp"
+
+
+namespace
+{
+constexpr size_t BLOCK_SIZE = 4;
+constexpr size_t BLOCK_PIXELS = BLOCK_SIZE * BLOCK_SIZE;
+// blocks compressed by one job, a few hundred microseconds of BC1 work, BC7 rows take much longer
+constexpr size_t BLOCKS_PER_JOB = 1024;
+constexpr size_t BC7_BLOCKS_PER_JOB = 128;
+
+constexpr int BC1_POWER_ITERATIONS = 8;
+constexpr int BC4_INSET_STEPS = 4;
+
+// 4x4 RGBA8 pixels, row after row
+struct alignas(16) Block
+{
+	uint8_t rgba[BLOCK_PIXELS * 4];
+};
+
+// BC1 works on one channel per register, four pixels per register
+struct BlockChannels
+{
+	__m128 r[4];
+	__m128 g[4];
+	__m128 b[4];
+};
+
+struct Color
+{
+	float r;
+	float g;
+	float b;
+};
+
+using EncodeBlock = void (*)(const Block& block, SD::ENGINE::CompressionPreset preset, uint8_t* out);
+
+struct BlockEncoder
+{
+	size_t blockBytes;
+	EncodeBlock encode;  // nullptr for formats compressed by DirectXTex
+};
+
+// Edge blocks of sizes that are not a multiple of four repeat the last row and column.
+void LoadBlock(const DirectX::Image& image, size_t blockX, size_t blockY, Block& block)
+{
+	const size_t x = blockX * BLOCK_SIZE;
+	const bool fullRow = x + BLOCK_SIZE <= image.width;
+
+	for (size_t row = 0; row < BLOCK_SIZE; ++row)
+	{
+		const size_t y = std::min(blockY * BLOCK_SIZE + row, image.height - 1);
+		const uint8_t* src = image.pixels + y * image.rowPitch;
+		uint8_t* dst = block.rgba + row * BLOCK_SIZE * 4;
+
+		if (fullRow)
+		{
+			std::memcpy(dst, src + x * 4, BLOCK_SIZE * 4);
+			continue;
+		}
+
+		for (size_t column = 0; column < BLOCK_SIZE; ++column)
+		{
+			std::memcpy(dst + column * 4, src + std::min(x + column, image.width - 1) * 4, 4);
+		}
+	}
+}
+
+__m128i LoadPixels(const Block& block, size_t group)
+{
+	return _mm_load_si128(reinterpret_cast<const __m128i*>(block.rgba) + group);
+}
+
+// One channel of all sixteen pixels as bytes.
+__m128i ExtractChannel(const Block& block, int channel)
+{
+	const __m128i mask = _mm_set1_epi32(0xFF);
+	const __m128i shift = _mm_cvtsi32_si128(channel * 8);
+
+	__m128i words[4];
+	for (size_t group = 0; group < 4; ++group)
+	{
+		words[group] = _mm_and_si128(_mm_srl_epi32(LoadPixels(block, group), shift), mask);
+	}
+
+	return _mm_packus_epi16(_mm_packs_epi32(words[0], words[1]), _mm_packs_epi32(words[2], words[3]));
+}
+
+uint8_t ReduceMin(__m128i bytes)
+{
+	bytes = _mm_min_epu8(bytes, _mm_srli_si128(bytes, 8));
+	bytes = _mm_min_epu8(bytes, _mm_srli_si128(bytes, 4));
+	bytes = _mm_min_epu8(bytes, _mm_srli_si128(bytes, 2));
+	bytes = _mm_min_epu8(bytes, _mm_srli_si128(bytes, 1));
+	return static_cast<uint8_t>(_mm_cvtsi128_si32(bytes));
+}
+
+uint8_t ReduceMax(__m128i bytes)
+{
+	bytes = _mm_max_epu8(bytes, _mm_srli_si128(bytes, 8));
+	bytes = _mm_max_epu8(bytes, _mm_srli_si128(bytes, 4));
+	bytes = _mm_max_epu8(bytes, _mm_srli_si128(bytes, 2));
+	bytes = _mm_max_epu8(bytes, _mm_srli_si128(bytes, 1));
+	return static_cast<uint8_t>(_mm_cvtsi128_si32(bytes));
+}
+
+int ReduceAdd(__m128i ints)
+{
+	ints = _mm_add_epi32(ints, _mm_shuffle_epi32(ints, _MM_SHUFFLE(1, 0, 3, 2)));
+	ints = _mm_add_epi32(ints, _mm_shuffle_epi32(ints, _MM_SHUFFLE(2, 3, 0, 1)));
+	return _mm_cvtsi128_si32(ints);
+}
+
+float ReduceAdd(__m128 floats)
+{
+	floats = _mm_add_ps(floats, _mm_shuffle_ps(floats, floats, _MM_SHUFFLE(1, 0, 3, 2)));
+	floats = _mm_add_ps(floats, _mm_shuffle_ps(floats, floats, _MM_SHUFFLE(2, 3, 0, 1)));
+	return _mm_cvtss_f32(floats);
+}
+
+float ReduceMin(__m128 floats)
+{
+	floats = _mm_min_ps(floats, _mm_shuffle_ps(floats, floats, _MM_SHUFFLE(1, 0, 3, 2)));
+	floats = _mm_min_ps(floats, _mm_shuffle_ps(floats, floats, _MM_SHUFFLE(2, 3, 0, 1)));
+	return _mm_cvtss_f32(floats);
+}
+
+float ReduceMax(__m128 floats)
+{
+	floats = _mm_max_ps(floats, _mm_shuffle_ps(floats, floats, _MM_SHUFFLE(1, 0, 3, 2)));
+	floats = _mm_max_ps(floats, _mm_shuffle_ps(floats, floats, _MM_SHUFFLE(2, 3, 0, 1)));
+	return _mm_cvtss_f32(floats);
+}
+
+// BC4
+
+struct BC4Fit
+{
+	int error;
+	uint64_t indices;
+};
+
+// Nearest of the eight palette entries for every value, e0 > e1.
+BC4Fit FitBC4(__m128i values, int e0, int e1)
+{
+	int palette[8] = { e0, e1 };
+	for (int idx = 2; idx < 8; ++idx)
+	{
+		palette[idx] = ((8 - idx) * e0 + (idx - 1) * e1 + 3) / 7;
+	}
+
+	__m128i bestDistance = _mm_set1_epi8(-1);
+	__m128i bestIndex = _mm_setzero_si128();
+	for (int idx = 0; idx < 8; ++idx)
+	{
+		const __m128i entry = _mm_set1_epi8(static_cast<char>(palette[idx]));
+		const __m128i distance = _mm_or_si128(_mm_subs_epu8(values, entry), _mm_subs_epu8(entry, values));
+		// unsigned distance < bestDistance
+		const __m128i closer = _mm_andnot_si128(_mm_cmpeq_epi8(distance, bestDistance),
+			_mm_cmpeq_epi8(_mm_min_epu8(distance, bestDistance), distance));
+
+		bestDistance = _mm_min_epu8(distance, bestDistance);
+		bestIndex = _mm_or_si128(_mm_and_si128(closer, _mm_set1_epi8(static_cast<char>(idx))), _mm_andnot_si128(closer, bestIndex));
+	}
+
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i low = _mm_unpacklo_epi8(bestDistance, zero);
+	const __m128i high = _mm_unpackhi_epi8(bestDistance, zero);
+
+	alignas(16) uint8_t indices[BLOCK_PIXELS];
+	_mm_store_si128(reinterpret_cast<__m128i*>(indices), bestIndex);
+
+	BC4Fit fit = { ReduceAdd(_mm_add_epi32(_mm_madd_epi16(low, low), _mm_madd_epi16(high, high))), 0 };
+	for (size_t pixel = 0; pixel < BLOCK_PIXELS; ++pixel)
+	{
+		fit.indices |= static_cast<uint64_t>(indices[pixel]) << (3 * pixel);
+	}
+
+	return fit;
+}
+
+// Endpoints are the extremes of the block, the quality preset also tries them moved inwards, which trades the
+// outliers for a finer palette in between.
+void EncodeBC4Channel(__m128i values, SD::ENGINE::CompressionPreset preset, uint8_t* out)
+{
+	const int low = ReduceMin(values);
+	const int high = ReduceMax(values);
+
+	int e0 = high;
+	int e1 = low;
+	BC4Fit best = { 0, 0 };
+	if (high > low)
+	{
+		best = FitBC4(values, high, low);
+	}
+
+	if (preset == SD::ENGINE::CompressionPreset::QUALITY && high > low)
+	{
+		const int step = std::max((high - low) / 32, 1);
+		for (int inset0 = 0; inset0 < BC4_INSET_STEPS; ++inset0)
+		{
+			for (int inset1 = 0; inset1 < BC4_INSET_STEPS; ++inset1)
+			{
+				const int candidate0 = high - inset0 * step;
+				const int candidate1 = low + inset1 * step;
+				if ((inset0 == 0 && inset1 == 0) || candidate0 <= candidate1)
+				{
+					continue;
+				}
+
+				const auto fit = FitBC4(values, candidate0, candidate1);
+				if (fit.error < best.error)
+				{
+					best = fit;
+					e0 = candidate0;
+					e1 = candidate1;
+				}
+			}
+		}
+	}
+
+	// equal endpoints leave all indices at zero, the first endpoint
+	out[0] = static_cast<uint8_t>(e0);
+	out[1] = static_cast<uint8_t>(e1);
+	for (size_t byte = 0; byte < 6; ++byte)
+	{
+		out[2 + byte] = static_cast<uint8_t>(best.indices >> (8 * byte));
+	}
+}
+
+void EncodeBC4(const Block& block, SD::ENGINE::CompressionPreset preset, uint8_t* out)
+{
+	EncodeBC4Channel(ExtractChannel(block, 0), preset, out);
+}
+
+void EncodeBC5(const Block& block, SD::ENGINE::CompressionPreset preset, uint8_t* out)
+{
+	EncodeBC4Channel(ExtractChannel(block, 0), preset, out);
+	EncodeBC4Channel(ExtractChannel(block, 1), preset, out + 8);
+}
+
+// BC1
+
+struct BC1Fit
+{
+	float error;
+	uint16_t c0;
+	uint16_t c1;
+	uint32_t indices;
+};
+
+BlockChannels LoadChannels(const Block& block)
+{
+	const __m128i mask = _mm_set1_epi32(0xFF);
+
+	BlockChannels channels;
+	for (size_t group = 0; group < 4; ++group)
+	{
+		const __m128i pixels = LoadPixels(block, group);
+		channels.r[group] = _mm_cvtepi32_ps(_mm_and_si128(pixels, mask));
+		channels.g[group] = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(pixels, 8), mask));
+		channels.b[group] = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(pixels, 16), mask));
+	}
+
+	return channels;
+}
+
+uint16_t Quantize565(const Color& color)
+{
+	const auto quantize = [](float value, int maxValue)
+	{
+		return static_cast<uint16_t>(std::clamp(static_cast<int>(value * static_cast<float>(maxValue) / 255.0f + 0.5f), 0, maxValue));
+	};
+
+	return static_cast<uint16_t>(quantize(color.r, 31) << 11 | quantize(color.g, 63) << 5 | quantize(color.b, 31));
+}
+
+void Expand565(uint16_t color, int rgb[3])
+{
+	const int r = color >> 11 & 31;
+	const int g = color >> 5 & 63;
+	const int b = color & 31;
+
+	rgb[0] = r << 3 | r >> 2;
+	rgb[1] = g << 2 | g >> 4;
+	rgb[2] = b << 3 | b >> 2;
+}
+
+// Nearest of the four colors of the opaque palette for every pixel.
+BC1Fit FitBC1(const BlockChannels& channels, uint16_t c0, uint16_t c1)
+{
+	int endpoints[2][3];
+	Expand565(c0, endpoints[0]);
+	Expand565(c1, endpoints[1]);
+
+	__m128 palette[4][3];
+	for (int channel = 0; channel < 3; ++channel)
+	{
+		const int a = endpoints[0][channel];
+		const int b = endpoints[1][channel];
+		palette[0][channel] = _mm_set1_ps(static_cast<float>(a));
+		palette[1][channel] = _mm_set1_ps(static_cast<float>(b));
+		palette[2][channel] = _mm_set1_ps(static_cast<float>((2 * a + b + 1) / 3));
+		palette[3][channel] = _mm_set1_ps(static_cast<float>((a + 2 * b + 1) / 3));
+	}
+
+	BC1Fit fit = { 0.0f, c0, c1, 0 };
+	__m128 error = _mm_setzero_ps();
+	for (size_t group = 0; group < 4; ++group)
+	{
+		__m128 bestDistance = _mm_set1_ps(std::numeric_limits<float>::max());
+		__m128i bestIndex = _mm_setzero_si128();
+		for (int idx = 0; idx < 4; ++idx)
+		{
+			const __m128 dr = _mm_sub_ps(channels.r[group], palette[idx][0]);
+			const __m128 dg = _mm_sub_ps(channels.g[group], palette[idx][1]);
+			const __m128 db = _mm_sub_ps(channels.b[group], palette[idx][2]);
+			const __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dr, dr), _mm_mul_ps(dg, dg)), _mm_mul_ps(db, db));
+			const __m128i closer = _mm_castps_si128(_mm_cmplt_ps(distance, bestDistance));
+
+			bestDistance = _mm_min_ps(distance, bestDistance);
+			bestIndex = _mm_or_si128(_mm_and_si128(closer, _mm_set1_epi32(idx)), _mm_andnot_si128(closer, bestIndex));
+		}
+		error = _mm_add_ps(error, bestDistance);
+
+		alignas(16) uint32_t indices[4];
+		_mm_store_si128(reinterpret_cast<__m128i*>(indices), bestIndex);
+		for (size_t pixel = 0; pixel < 4; ++pixel)
+		{
+			fit.indices |= indices[pixel] << (2 * (group * 4 + pixel));
+		}
+	}
+	fit.error = ReduceAdd(error);
+
+	return fit;
+}
+
+// The opaque four color mode needs c0 > c1, equal endpoints are nudged apart by one step of blue.
+BC1Fit FitBC1(const BlockChannels& channels, const Color& a, const Color& b)
+{
+	uint16_t c0 = Quantize565(a);
+	uint16_t c1 = Quantize565(b);
+	if (c0 < c1)
+	{
+		std::swap(c0, c1);
+	}
+	if (c0 == c1 && c0 == 0)
+	{
+		++c0;
+	}
+	else if (c0 == c1)
+	{
+		--c1;
+	}
+
+	return FitBC1(channels, c0, c1);
+}
+
+// Corners of the bounding box along the diagonal the colors follow, moved inwards by a sixteenth of the box.
+BC1Fit FitBoundingBox(const Block& block, const BlockChannels& channels, Color& axis)
+{
+	__m128i low = LoadPixels(block, 0);
+	__m128i high = low;
+	for (size_t group = 1; group < 4; ++group)
+	{
+		low = _mm_min_epu8(low, LoadPixels(block, group));
+		high = _mm_max_epu8(high, LoadPixels(block, group));
+	}
+	low = _mm_min_epu8(low, _mm_srli_si128(low, 8));
+	low = _mm_min_epu8(low, _mm_srli_si128(low, 4));
+	high = _mm_max_epu8(high, _mm_srli_si128(high, 8));
+	high = _mm_max_epu8(high, _mm_srli_si128(high, 4));
+
+	const uint32_t lowColor = static_cast<uint32_t>(_mm_cvtsi128_si32(low));
+	const uint32_t highColor = static_cast<uint32_t>(_mm_cvtsi128_si32(high));
+
+	float minimum[3];
+	float maximum[3];
+	for (int channel = 0; channel < 3; ++channel)
+	{
+		minimum[channel] = static_cast<float>(lowColor >> (8 * channel) & 0xFF);
+		maximum[channel] = static_cast<float>(highColor >> (8 * channel) & 0xFF);
+		const float inset = (maximum[channel] - minimum[channel]) / 16.0f;
+		minimum[channel] += inset;
+		maximum[channel] -= inset;
+	}
+
+	// channels falling while the widest one rises swap their ends
+	const __m128* values[3] = { channels.r, channels.g, channels.b };
+	int widest = 0;
+	for (int channel = 1; channel < 3; ++channel)
+	{
+		widest = maximum[channel] - minimum[channel] > maximum[widest] - minimum[widest] ? channel : widest;
+	}
+
+	float direction[3] = {};
+	for (int channel = 0; channel < 3; ++channel)
+	{
+		const __m128 center = _mm_set1_ps((minimum[channel] + maximum[channel]) * 0.5f);
+		const __m128 widestCenter = _mm_set1_ps((minimum[widest] + maximum[widest]) * 0.5f);
+
+		__m128 covariance = _mm_setzero_ps();
+		for (size_t group = 0; group < 4; ++group)
+		{
+			covariance = _mm_add_ps(covariance, _mm_mul_ps(_mm_sub_ps(values[channel][group], center),
+				_mm_sub_ps(values[widest][group], widestCenter)));
+		}
+
+		if (ReduceAdd(covariance) < 0.0f)
+		{
+			std::swap(minimum[channel], maximum[channel]);
+		}
+		direction[channel] = maximum[channel] - minimum[channel];
+	}
+
+	axis = { direction[0], direction[1], direction[2] };
+	return FitBC1(channels, Color{ maximum[0], maximum[1], maximum[2] }, Color{ minimum[0], minimum[1], minimum[2] });
+}
+
+// Extremes of the block projected on its principal axis.
+BC1Fit FitPrincipalAxis(const BlockChannels& channels, Color axis)
+{
+	__m128 sum[3] = { _mm_setzero_ps(), _mm_setzero_ps(), _mm_setzero_ps() };
+	for (size_t group = 0; group < 4; ++group)
+	{
+		sum[0] = _mm_add_ps(sum[0], channels.r[group]);
+		sum[1] = _mm_add_ps(sum[1], channels.g[group]);
+		sum[2] = _mm_add_ps(sum[2], channels.b[group]);
+	}
+	const Color mean = { ReduceAdd(sum[0]) / BLOCK_PIXELS, ReduceAdd(sum[1]) / BLOCK_PIXELS, ReduceAdd(sum[2]) / BLOCK_PIXELS };
+
+	__m128 products[6] = {};
+	for (size_t group = 0; group < 4; ++group)
+	{
+		const __m128 r = _mm_sub_ps(channels.r[group], _mm_set1_ps(mean.r));
+		const __m128 g = _mm_sub_ps(channels.g[group], _mm_set1_ps(mean.g));
+		const __m128 b = _mm_sub_ps(channels.b[group], _mm_set1_ps(mean.b));
+		products[0] = _mm_add_ps(products[0], _mm_mul_ps(r, r));
+		products[1] = _mm_add_ps(products[1], _mm_mul_ps(r, g));
+		products[2] = _mm_add_ps(products[2], _mm_mul_ps(r, b));
+		products[3] = _mm_add_ps(products[3], _mm_mul_ps(g, g));
+		products[4] = _mm_add_ps(products[4], _mm_mul_ps(g, b));
+		products[5] = _mm_add_ps(products[5], _mm_mul_ps(b, b));
+	}
+
+	float covariance[6];
+	for (size_t idx = 0; idx < 6; ++idx)
+	{
+		covariance[idx] = ReduceAdd(products[idx]);
+	}
+
+	// power iteration from the bounding box diagonal
+	for (int iteration = 0; iteration < BC1_POWER_ITERATIONS; ++iteration)
+	{
+		const Color next = {
+			covariance[0] * axis.r + covariance[1] * axis.g + covariance[2] * axis.b,
+			covariance[1] * axis.r + covariance[3] * axis.g + covariance[4] * axis.b,
+			covariance[2] * axis.r + covariance[4] * axis.g + covariance[5] * axis.b,
+		};
+		const float length = std::max({ std::abs(next.r), std::abs(next.g), std::abs(next.b) });
+		if (length < 1e-6f)
+		{
+			break;
+		}
+		axis = { next.r / length, next.g / length, next.b / length };
+	}
+
+	const float lengthSquared = axis.r * axis.r + axis.g * axis.g + axis.b * axis.b;
+	if (lengthSquared < 1e-12f)
+	{
+		return FitBC1(channels, mean, mean);
+	}
+
+	__m128 lowest = _mm_set1_ps(std::numeric_limits<float>::max());
+	__m128 highest = _mm_set1_ps(std::numeric_limits<float>::lowest());
+	for (size_t group = 0; group < 4; ++group)
+	{
+		const __m128 projection = _mm_add_ps(_mm_add_ps(
+			_mm_mul_ps(_mm_sub_ps(channels.r[group], _mm_set1_ps(mean.r)), _mm_set1_ps(axis.r)),
+			_mm_mul_ps(_mm_sub_ps(channels.g[group], _mm_set1_ps(mean.g)), _mm_set1_ps(axis.g))),
+			_mm_mul_ps(_mm_sub_ps(channels.b[group], _mm_set1_ps(mean.b)), _mm_set1_ps(axis.b)));
+		lowest = _mm_min_ps(lowest, projection);
+		highest = _mm_max_ps(highest, projection);
+	}
+
+	const float low = ReduceMin(lowest) / lengthSquared;
+	const float high = ReduceMax(highest) / lengthSquared;
+
+	return FitBC1(channels,
+		Color{ mean.r + axis.r * high, mean.g + axis.g * high, mean.b + axis.b * high },
+		Color{ mean.r + axis.r * low, mean.g + axis.g * low, mean.b + axis.b * low });
+}
+
+// Least squares endpoints for the indices of a fit.
+BC1Fit RefineEndpoints(const Block& block, const BlockChannels& channels, const BC1Fit& fit)
+{
+	// weight of c0 for every index
+	constexpr float WEIGHTS[4] = { 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f };
+
+	float aa = 0.0f;
+	float ab = 0.0f;
+	float bb = 0.0f;
+	float ax[3] = {};
+	float bx[3] = {};
+	for (size_t pixel = 0; pixel < BLOCK_PIXELS; ++pixel)
+	{
+		const float alpha = WEIGHTS[fit.indices >> (2 * pixel) & 3];
+		const float beta = 1.0f - alpha;
+		aa += alpha * alpha;
+		ab += alpha * beta;
+		bb += beta * beta;
+		for (size_t channel = 0; channel < 3; ++channel)
+		{
+			const float value = static_cast<float>(block.rgba[pixel * 4 + channel]);
+			ax[channel] += alpha * value;
+			bx[channel] += beta * value;
+		}
+	}
+
+	const float determinant = aa * bb - ab * ab;
+	if (std::abs(determinant) < 1e-6f)
+	{
+		return fit;
+	}
+
+	float a[3];
+	float b[3];
+	for (size_t channel = 0; channel < 3; ++channel)
+	{
+		a[channel] = std::clamp((ax[channel] * bb - bx[channel] * ab) / determinant, 0.0f, 255.0f);
+		b[channel] = std::clamp((bx[channel] * aa - ax[channel] * ab) / determinant, 0.0f, 255.0f);
+	}
+
+	return FitBC1(channels, Color{ a[0], a[1], a[2] }, Color{ b[0], b[1], b[2] });
+}
+
+// Opaque four color mode only, alpha is dropped. The fast preset takes the bounding box, the quality preset the
+// best of the bounding box, the principal axis and least squares endpoints refined from it.
+void EncodeBC1(const Block& block, SD::ENGINE::CompressionPreset preset, uint8_t* out)
+{
+	const auto channels = LoadChannels(block);
+
+	Color axis = {};
+	auto best = FitBoundingBox(block, channels, axis);
+
+	if (preset == SD::ENGINE::CompressionPreset::QUALITY && best.error > 0.0f)
+	{
+		const auto principal = FitPrincipalAxis(channels, axis);
+		const auto refined = RefineEndpoints(block, channels, principal);
+		for (const auto& fit : { principal, refined })
+		{
+			best = fit.error < best.error ? fit : best;
+		}
+	}
+
+	std::memcpy(out, &best.c0, sizeof(uint16_t));
+	std::memcpy(out + 2, &best.c1, sizeof(uint16_t));
+	std::memcpy(out + 4, &best.indices, sizeof(uint32_t));
+}
+
+const std::unordered_map<DXGI_FORMAT, BlockEncoder> BLOCK_ENCODERS_MAP = {
+	{DXGI_FORMAT_BC1_UNORM, {8, EncodeBC1}},
+	{DXGI_FORMAT_BC1_UNORM_SRGB, {8, EncodeBC1}},
+	{DXGI_FORMAT_BC4_UNORM, {8, EncodeBC4}},
+	{DXGI_FORMAT_BC5_UNORM, {16, EncodeBC5}},
+	{DXGI_FORMAT_BC7_UNORM, {16, nullptr}},
+	{DXGI_FORMAT_BC7_UNORM_SRGB, {16, nullptr}},
+};
+
+// Rows of blocks of one image, the unit of work of a job.
+struct Strip
+{
+	size_t image;
+	size_t firstRow;
+	size_t rowCount;
+};
+
+void EncodeStrip(const DirectX::Image& src, const DirectX::Image& dst, const Strip& strip, const BlockEncoder& encoder,
+	SD::ENGINE::CompressionPreset preset)
+{
+	const size_t blocksWide = (src.width + BLOCK_SIZE - 1) / BLOCK_SIZE;
+
+	Block block;
+	for (size_t blockY = strip.firstRow; blockY < strip.firstRow + strip.rowCount; ++blockY)
+	{
+		uint8_t* out = dst.pixels + blockY * dst.rowPitch;
+		for (size_t blockX = 0; blockX < blocksWide; ++blockX)
+		{
+			LoadBlock(src, blockX, blockY, block);
+			encoder.encode(block, preset, out + blockX * encoder.blockBytes);
+		}
+	}
+}
+
+// BC7 mode search is left to DirectXTex, one strip at a time so it runs on the job system instead of OpenMP.
+void CompressStrip(const DirectX::Image& src, const DirectX::Image& dst, const Strip& strip, SD::ENGINE::CompressionPreset preset)
+{
+	const size_t firstY = strip.firstRow * BLOCK_SIZE;
+
+	DirectX::Image part = src;
+	part.height = std::min(strip.rowCount * BLOCK_SIZE, src.height - firstY);
+	part.slicePitch = part.rowPitch * part.height;
+	part.pixels = src.pixels + firstY * src.rowPitch;
+
+	const auto flags = preset == SD::ENGINE::CompressionPreset::FAST ? DirectX::TEX_COMPRESS_BC7_QUICK : DirectX::TEX_COMPRESS_DEFAULT;
+
+	DirectX::ScratchImage compressed;
+	const HRESULT hr = DirectX::Compress(part, dst.format, flags, DirectX::TEX_THRESHOLD_DEFAULT, compressed);
+	if (FAILED(hr))
+	{
+		throw SD::SomeWinException(__LINE__, __FILEW__, hr);
+	}
+
+	const auto* image = compressed.GetImage(0, 0, 0);
+	for (size_t row = 0; row < strip.rowCount; ++row)
+	{
+		std::memcpy(dst.pixels + (strip.firstRow + row) * dst.rowPitch, image->pixels + row * image->rowPitch, dst.rowPitch);
+	}
+}
+}  // end namespace
+
+namespace SD::ENGINE {
+
+bool IsBlockCompressionSupported(DXGI_FORMAT format)
+{
+	return BLOCK_ENCODERS_MAP.count(format) > 0;
+}
+
+DirectX::ScratchImage CompressImage(
+	const DirectX::ScratchImage& image,
+	DXGI_FORMAT format,
+	CompressionPreset preset,
+	JobSystem& jobSystem,
+	size_t maxThreads)
+{
+	const auto encoder = BLOCK_ENCODERS_MAP.find(format);
+	if (encoder == BLOCK_ENCODERS_MAP.end())
+	{
+		THROW_SOME_EXCEPTION(L"UNSUPPORTED BLOCK COMPRESSION FORMAT!");
+	}
+
+	// encoders read RGBA8, gamma encoded for sRGB targets
+	const DXGI_FORMAT pixelFormat = DirectX::IsSRGB(format) ? DXGI_FORMAT_R8G8B8A8_UNORM_SRGB : DXGI_FORMAT_R8G8B8A8_UNORM;
+
+	const DirectX::ScratchImage* source = &image;
+	DirectX::ScratchImage converted;
+	if (image.GetMetadata().format != pixelFormat)
+	{
+		WIN_THROW_IF_FAILED(DirectX::Convert(image.GetImages(), image.GetImageCount(), image.GetMetadata(), pixelFormat,
+			DirectX::TEX_FILTER_DEFAULT, DirectX::TEX_THRESHOLD_DEFAULT, converted));
+		source = &converted;
+	}
+
+	auto metadata = source->GetMetadata();
+	metadata.format = format;
+
+	DirectX::ScratchImage compressed;
+	WIN_THROW_IF_FAILED(compressed.Initialize(metadata));
+
+	const size_t blocksPerJob = encoder->second.encode ? BLOCKS_PER_JOB : BC7_BLOCKS_PER_JOB;
+
+	std::vector<Strip> strips;
+	for (size_t idx = 0; idx < source->GetImageCount(); ++idx)
+	{
+		const auto& src = source->GetImages()[idx];
+		const size_t blocksWide = (src.width + BLOCK_SIZE - 1) / BLOCK_SIZE;
+		const size_t blocksHigh = (src.height + BLOCK_SIZE - 1) / BLOCK_SIZE;
+		const size_t rowsPerJob = std::max<size_t>(blocksPerJob / blocksWide, 1);
+
+		for (size_t row = 0; row < blocksHigh; row += rowsPerJob)
+		{
+			strips.push_back({ idx, row, std::min(rowsPerJob, blocksHigh - row) });
+		}
+	}
+
+	jobSystem.ParallelFor(strips.size(), maxThreads, [&](size_t idx)
+	{
+		const auto& strip = strips[idx];
+		const auto& src = source->GetImages()[strip.image];
+		const auto& dst = compressed.GetImages()[strip.image];
+
+		if (encoder->second.encode)
+		{
+			EncodeStrip(src, dst, strip, encoder->second, preset);
+		}
+		else
+		{
+			CompressStrip(src, dst, strip, preset);
+		}
+	});
+
+	return compressed;
+}
+
+}  // end namespace SD::ENGINE
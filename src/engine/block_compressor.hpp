@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#include <dxgiformat.h>
+
+#include "job_system.hpp"
+
+
+namespace DirectX {
+	class ScratchImage;
+}
+
+namespace SD::ENGINE {
+
+enum class CompressionPreset : uint32_t
+{
+	FAST,  // bounding box endpoints, BC7 quick mode
+	QUALITY,  // principal axis and refined endpoints, every BC7 mode
+};
+
+bool IsBlockCompressionSupported(DXGI_FORMAT format);
+
+// Compresses every image (mips and slices) to BC1, BC4, BC5 or BC7, sRGB variants included. Images are split into
+// rows of blocks, which are compressed as jobs of the job system, by at most maxThreads threads (the calling one
+// included). BC1, BC4 and BC5 are encoded here with SSE2 endpoint and index search, BC7 rows are given to DirectXTex.
+DirectX::ScratchImage CompressImage(
+	const DirectX::ScratchImage& image,
+	DXGI_FORMAT format,
+	CompressionPreset preset,
+	JobSystem& jobSystem,
+	size_t maxThreads = std::numeric_limits<size_t>::max());
+
+}  // end namespace SD::ENGINE
@@ -0,0 +1,232 @@
+#include "compression_benchmark.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+#include <DirectXTex.h>
+
+#include "block_compressor.hpp"
+#include "exceptions.hpp"
+#include "job_system.hpp"
+#include "mip_generator.hpp"
+#include "texture.hpp"
+#include "timer.hpp"
+
+
+namespace
+{
+constexpr size_t ITERATIONS = 3;
+constexpr size_t SYNTHETIC_SIZE = 1024;
+
+struct BenchmarkFormat
+{
+	const char* name;
+	DXGI_FORMAT format;
+};
+
+const std::vector<BenchmarkFormat> BENCHMARK_FORMATS = {
+	{"BC1", DXGI_FORMAT_BC1_UNORM},
+	{"BC4", DXGI_FORMAT_BC4_UNORM},
+	{"BC5", DXGI_FORMAT_BC5_UNORM},
+	{"BC7", DXGI_FORMAT_BC7_UNORM},
+};
+
+// Best time of a few runs.
+template<typename F>
+float Measure(F&& run)
+{
+	float best = std::numeric_limits<float>::max();
+	for (size_t iteration = 0; iteration < ITERATIONS; ++iteration)
+	{
+		SD::ENGINE::Timer timer;
+		run();
+		best = std::min(best, timer.GetDelta());
+	}
+
+	return best;
+}
+
+// Smooth gradients with ripples and hard edges, something between a photo and a mask.
+DirectX::ScratchImage GenerateSyntheticImage(size_t size)
+{
+	DirectX::ScratchImage image;
+	const HRESULT hr = image.Initialize2D(DXGI_FORMAT_R8G8B8A8_UNORM, size, size, 1, 1);
+	if (FAILED(hr))
+	{
+		throw SD::SomeWinException(__LINE__, __FILEW__, hr);
+	}
+
+	const auto& pixels = *image.GetImage(0, 0, 0);
+	for (size_t y = 0; y < size; ++y)
+	{
+		uint8_t* row = pixels.pixels + y * pixels.rowPitch;
+		for (size_t x = 0; x < size; ++x)
+		{
+			const float u = static_cast<float>(x) / static_cast<float>(size);
+			const float v = static_cast<float>(y) / static_cast<float>(size);
+			const bool checker = (x / 64 + y / 64) % 2 == 0;
+
+			row[x * 4 + 0] = static_cast<uint8_t>(200.0f * u + 40.0f * std::sin(static_cast<float>(y) * 0.05f) + 15.0f);
+			row[x * 4 + 1] = static_cast<uint8_t>(128.0f + 100.0f * v * std::cos(static_cast<float>(x) * 0.02f));
+			row[x * 4 + 2] = static_cast<uint8_t>(checker ? 60.0f + 150.0f * u * v : 220.0f - 100.0f * v);
+			row[x * 4 + 3] = 255;
+		}
+	}
+
+	return image;
+}
+
+// Top level of the image as RGBA8, what the compressors read.
+DirectX::ScratchImage LoadSource(const std::string& path)
+{
+	if (path.empty())
+	{
+		return GenerateSyntheticImage(SYNTHETIC_SIZE);
+	}
+
+	const auto image = SD::RENDER::Texture::Load(std::filesystem::path(path).wstring());
+	const auto& top = *image.GetImage(0, 0, 0);
+
+	DirectX::ScratchImage source;
+	const HRESULT hr = top.format == DXGI_FORMAT_R8G8B8A8_UNORM
+		? source.InitializeFromImage(top)
+		: DirectX::Convert(top, DXGI_FORMAT_R8G8B8A8_UNORM, DirectX::TEX_FILTER_DEFAULT, DirectX::TEX_THRESHOLD_DEFAULT, source);
+	if (FAILED(hr))
+	{
+		throw SD::SomeWinException(__LINE__, __FILEW__, hr);
+	}
+
+	return source;
+}
+
+struct BenchmarkFilter
+{
+	const char* name;
+	SD::ENGINE::MipFilter filter;
+	DirectX::TEX_FILTER_FLAGS baselineFilter;  // closest DirectXTex filter
+};
+
+const std::vector<BenchmarkFilter> BENCHMARK_FILTERS = {
+	{"Box", SD::ENGINE::MipFilter::BOX, DirectX::TEX_FILTER_BOX},
+	{"Kaiser", SD::ENGINE::MipFilter::KAISER, DirectX::TEX_FILTER_CUBIC},
+};
+
+void Report(const std::string& name, float megapixels, float time, float baselineTime)
+{
+	std::clog << std::left << std::setw(28) << name << std::right << std::setw(10) << megapixels / time << " MPix/s (x"
+		<< baselineTime / time << ")." << std::endl;
+}
+
+void BenchmarkCompression(const DirectX::ScratchImage& image, SD::JobSystem& jobSystem, const std::vector<size_t>& threadCounts)
+{
+	const auto& source = *image.GetImage(0, 0, 0);
+	const float megapixels = static_cast<float>(source.width * source.height) / 1e6f;
+
+	for (const auto& format : BENCHMARK_FORMATS)
+	{
+		for (const auto preset : { SD::ENGINE::CompressionPreset::FAST, SD::ENGINE::CompressionPreset::QUALITY })
+		{
+			const std::string name = std::string(format.name) + (preset == SD::ENGINE::CompressionPreset::FAST ? " fast" : " quality");
+
+			// DirectXTex is built without OpenMP, compression runs on the calling thread
+			const auto flags = preset == SD::ENGINE::CompressionPreset::FAST ? DirectX::TEX_COMPRESS_BC7_QUICK : DirectX::TEX_COMPRESS_DEFAULT;
+			const float baselineTime = Measure([&]()
+			{
+				DirectX::ScratchImage compressed;
+				const HRESULT hr = DirectX::Compress(source, format.format, flags, DirectX::TEX_THRESHOLD_DEFAULT, compressed);
+				if (FAILED(hr))
+				{
+					throw SD::SomeWinException(__LINE__, __FILEW__, hr);
+				}
+			});
+			Report(name + ", DirectXTex", megapixels, baselineTime, baselineTime);
+
+			for (const size_t threads : threadCounts)
+			{
+				const float time = Measure([&]()
+				{
+					SD::ENGINE::CompressImage(image, format.format, preset, jobSystem, threads);
+				});
+				Report(name + ", " + std::to_string(threads) + " threads", megapixels, time, baselineTime);
+			}
+		}
+	}
+}
+
+// Full chains of the image taken as sRGB, throughput in top level pixels.
+void BenchmarkMips(const DirectX::ScratchImage& image, SD::JobSystem& jobSystem, const std::vector<size_t>& threadCounts)
+{
+	auto source = *image.GetImage(0, 0, 0);
+	source.format = DXGI_FORMAT_R8G8B8A8_UNORM_SRGB;
+	const float megapixels = static_cast<float>(source.width * source.height) / 1e6f;
+
+	for (const auto& filter : BENCHMARK_FILTERS)
+	{
+		const std::string name = std::string(filter.name) + " mips";
+
+		const float baselineTime = Measure([&]()
+		{
+			DirectX::ScratchImage mips;
+			const HRESULT hr = DirectX::GenerateMipMaps(source, filter.baselineFilter | DirectX::TEX_FILTER_FORCE_NON_WIC, 0, mips);
+			if (FAILED(hr))
+			{
+				throw SD::SomeWinException(__LINE__, __FILEW__, hr);
+			}
+		});
+		Report(name + ", DirectXTex", megapixels, baselineTime, baselineTime);
+
+		SD::ENGINE::MipSettings settings;
+		settings.filter = filter.filter;
+		for (const size_t threads : threadCounts)
+		{
+			const float time = Measure([&]()
+			{
+				SD::ENGINE::GenerateMips(source, 0, settings, jobSystem, threads);
+			});
+			Report(name + ", " + std::to_string(threads) + " threads", megapixels, time, baselineTime);
+		}
+	}
+}
+}  // end namespace
+
+namespace SD::ENGINE {
+
+int RunCompressionBenchmark(const std::string& path)
+{
+	std::clog << "Benchmark block compression!" << std::endl;
+
+	WIN_THROW_IF_FAILED(CoInitializeEx(nullptr, COINIT_MULTITHREADED));
+
+	{
+		const auto image = LoadSource(path);
+		const auto& source = *image.GetImage(0, 0, 0);
+
+		std::clog << (path.empty() ? std::string("Synthetic image") : path) << ": " << source.width << "x" << source.height
+			<< ", speedups against single threaded DirectXTex." << std::endl;
+
+		JobSystem jobSystem;
+		std::vector<size_t> threadCounts;
+		for (size_t threads = 1; threads <= jobSystem.GetWorkersCount() + 1; threads *= 2)
+		{
+			threadCounts.push_back(threads);
+		}
+		if (threadCounts.back() != jobSystem.GetWorkersCount() + 1)
+		{
+			threadCounts.push_back(jobSystem.GetWorkersCount() + 1);
+		}
+
+		BenchmarkCompression(image, jobSystem, threadCounts);
+		BenchmarkMips(image, jobSystem, threadCounts);
+	}
+
+	CoUninitialize();
+
+	return 0;
+}
+
+}  // end namespace SD::ENGINE
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <string>
+
+
+namespace SD::ENGINE {
+
+// Times block compression of an image (a synthetic 1024x1024 one for an empty path) for every format, preset and
+// thread count, and mip generation for every filter and thread count, against single threaded DirectXTex. Results go
+// to the log in MPix/s.
+int RunCompressionBenchmark(const std::string& path);
+
+}  // end namespace SD::ENGINE
@@ -0,0 +1,943 @@
+#include "cooked_scene.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <type_traits>
+
+#include "exceptions.hpp"
+
+#define TINYGLTF_NO_STB_IMAGE
+#define TINYGLTF_NO_STB_IMAGE_WRITE
+#define TINYGLTF_NO_EXTERNAL_IMAGE
+#define TINYGLTF_USE_CPP14
+#pragma warning( push, 0 )
+#include "tiny_gltf.h"
+#pragma warning( pop )
+
+
+namespace
+{
+constexpr char MAGIC[8] = "SDSCENE";
+
+// sections are arrays of records, blobs start on own pages
+constexpr size_t SECTION_ALIGNMENT = 16;
+constexpr size_t BLOB_ALIGNMENT = 4096;
+
+enum Section : uint32_t
+{
+	STRINGS,
+	BUFFER_FILES,
+	IMAGES,
+	TEXTURES,
+	SAMPLERS,
+	MATERIALS,
+	MESHES,
+	MESH_PRIMITIVES,
+	LIGHTS,
+	NODES,
+	NODE_INDICES,  // children of nodes and roots of scenes
+	SCENES,
+	VERTEX_ELEMENTS,
+	BATCHES,
+	GEOMETRY_PRIMITIVES,
+	MESH_GEOMETRY,  // geometry primitive list per mesh
+	STATIC_GEOMETRY,  // geometry primitive list per scene
+	STATIC_BOUNDS,  // quantization bounds of static geometry per scene
+	CHUNKS,
+	MESHLETS,
+	BLOBS,
+	SECTIONS_COUNT
+};
+
+struct SectionEntry
+{
+	uint64_t offset;
+	uint64_t count;
+};
+
+struct Header
+{
+	char magic[8];
+	uint32_t version;
+	uint32_t settings;
+	uint64_t sourceSize;
+	int64_t sourceWriteTime;
+	int32_t defaultScene;
+	uint32_t reserved;
+	SectionEntry sections[SECTIONS_COUNT];
+};
+
+struct StringRef
+{
+	uint32_t offset;
+	uint32_t length;
+};
+
+struct BufferFileRecord
+{
+	StringRef path;
+	uint64_t size;
+	int64_t writeTime;
+};
+
+struct ImageRecord
+{
+	StringRef uri;
+	uint64_t dataOffset;  // of embedded images, from the blobs section start
+	uint64_t dataSize;
+};
+
+struct TextureRecord
+{
+	int32_t source;
+	int32_t sampler;
+};
+
+struct SamplerRecord
+{
+	int32_t minFilter;
+	int32_t magFilter;
+	int32_t wrapS;
+	int32_t wrapT;
+};
+
+struct MaterialRecord
+{
+	StringRef name;
+	StringRef alphaMode;
+	double alphaCutoff;
+	double baseColorFactor[4];
+	double metallicFactor;
+	double roughnessFactor;
+	double normalScale;
+	int32_t baseColorTexture;
+	int32_t metallicRoughnessTexture;
+	int32_t normalTexture;
+	uint32_t doubleSided;
+};
+
+struct MeshRecord
+{
+	StringRef name;
+	uint32_t firstPrimitive;
+	uint32_t primitiveCount;
+};
+
+// primitive bounds are all the model keeps of accessors, in the accessor component type
+struct MeshPrimitiveRecord
+{
+	int32_t material;
+	uint32_t hasBounds;
+	int32_t componentType;
+	uint32_t normalized;
+	double min[3];
+	double max[3];
+};
+
+struct LightRecord
+{
+	StringRef name;
+	StringRef type;
+	double color[3];
+	double intensity;
+};
+
+// glTF transform properties as they are, an empty one has zero size
+struct NodeRecord
+{
+	StringRef name;
+	int32_t mesh;
+	int32_t light;
+	int32_t staticExtra;  // extras.static as it is, -1 if it is not a bool
+	uint32_t firstChild;
+	uint32_t childCount;
+	uint32_t matrixSize;
+	uint32_t scaleSize;
+	uint32_t rotationSize;
+	uint32_t translationSize;
+	double matrix[16];
+	double scale[3];
+	double rotation[4];
+	double translation[3];
+};
+
+struct SceneRecord
+{
+	StringRef name;
+	uint32_t firstNode;
+	uint32_t nodeCount;
+};
+
+struct VertexElementRecord
+{
+	StringRef semantic;
+	uint32_t semanticIdx;
+	uint32_t format;
+	uint32_t offset;
+};
+
+struct BatchRecord
+{
+	uint32_t firstElement;
+	uint32_t elementCount;
+	uint32_t stride;
+	uint32_t indexFormat;
+	uint64_t vertexCount;
+	uint64_t indexCount;
+	uint64_t vertexOffset;  // from the blobs section start
+	uint64_t indexOffset;
+};
+
+struct GeometryPrimitiveRecord
+{
+	uint32_t material;
+	uint32_t node;
+	uint32_t firstChunk;
+	uint32_t chunkCount;
+	uint32_t firstMeshlet;
+	uint32_t meshletCount;
+	SD::ENGINE::GeometryRange range;
+	DirectX::BoundingBox bounds;
+};
+
+struct ListRecord
+{
+	uint32_t first;
+	uint32_t count;
+};
+
+struct StaticBoundsRecord
+{
+	DirectX::BoundingBox bounds;
+	uint32_t hasBounds;
+};
+
+static_assert(std::is_trivially_copyable_v<SD::ENGINE::IndexRange>);
+static_assert(std::is_trivially_copyable_v<SD::ENGINE::Meshlet>);
+static_assert(std::is_trivially_copyable_v<GeometryPrimitiveRecord>);
+
+constexpr std::array<size_t, SECTIONS_COUNT> RECORD_SIZES = {
+	sizeof(char),
+	sizeof(BufferFileRecord),
+	sizeof(ImageRecord),
+	sizeof(TextureRecord),
+	sizeof(SamplerRecord),
+	sizeof(MaterialRecord),
+	sizeof(MeshRecord),
+	sizeof(MeshPrimitiveRecord),
+	sizeof(LightRecord),
+	sizeof(NodeRecord),
+	sizeof(uint32_t),
+	sizeof(SceneRecord),
+	sizeof(VertexElementRecord),
+	sizeof(BatchRecord),
+	sizeof(GeometryPrimitiveRecord),
+	sizeof(ListRecord),
+	sizeof(ListRecord),
+	sizeof(StaticBoundsRecord),
+	sizeof(SD::ENGINE::IndexRange),
+	sizeof(SD::ENGINE::Meshlet),
+	sizeof(uint8_t),
+};
+
+size_t Align(size_t value, size_t alignment)
+{
+	return (value + alignment - 1) / alignment * alignment;
+}
+
+size_t GetIndexSize(uint32_t format)
+{
+	return format == DXGI_FORMAT_R32_UINT ? sizeof(uint32_t) : sizeof(uint16_t);
+}
+
+template<size_t N>
+uint32_t CopyValues(const std::vector<double>& values, double (&target)[N])
+{
+	const size_t count = std::min(values.size(), N);
+	std::copy_n(values.begin(), count, target);
+	return static_cast<uint32_t>(count);
+}
+
+template<size_t N>
+std::vector<double> GetValues(const double (&source)[N], uint32_t size)
+{
+	return std::vector<double>(source, source + std::min<size_t>(size, N));
+}
+
+// Lays out sections one after another behind the header.
+class Writer
+{
+public:
+	Writer()
+		: m_data(sizeof(Header), 0u)
+	{
+	}
+
+	template<typename T>
+	void Add(Section section, const std::vector<T>& records, size_t alignment = SECTION_ALIGNMENT)
+	{
+		static_assert(std::is_trivially_copyable_v<T>);
+
+		m_data.resize(Align(m_data.size(), alignment), 0u);
+		m_sections[section] = { m_data.size(), records.size() };
+
+		const auto* data = reinterpret_cast<const uint8_t*>(records.data());
+		m_data.insert(m_data.end(), data, data + records.size() * sizeof(T));
+	}
+
+	void Write(const std::filesystem::path& path, Header& header)
+	{
+		std::copy(std::begin(m_sections), std::end(m_sections), std::begin(header.sections));
+		memcpy(m_data.data(), &header, sizeof(Header));
+
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		file.write(reinterpret_cast<const char*>(m_data.data()), static_cast<std::streamsize>(m_data.size()));
+		if (!file)
+		{
+			throw SD::SomeException(__LINE__, __FILEW__, L"FAILED TO WRITE COOKED SCENE!");
+		}
+	}
+
+private:
+	std::vector<uint8_t> m_data;
+	SectionEntry m_sections[SECTIONS_COUNT] = {};
+};
+
+// Flattens pool primitives into the primitive, chunk and meshlet tables and returns their list.
+ListRecord AddPrimitives(
+	const std::vector<SD::ENGINE::CookedPrimitive>& primitives,
+	std::vector<GeometryPrimitiveRecord>& records,
+	std::vector<SD::ENGINE::IndexRange>& chunks,
+	std::vector<SD::ENGINE::Meshlet>& meshlets)
+{
+	const ListRecord list = { static_cast<uint32_t>(records.size()), static_cast<uint32_t>(primitives.size()) };
+
+	for (const auto& primitive : primitives)
+	{
+		auto& record = records.emplace_back();
+		record.material = primitive.material;
+		record.node = primitive.node;
+		record.firstChunk = static_cast<uint32_t>(chunks.size());
+		record.chunkCount = static_cast<uint32_t>(primitive.chunks.size());
+		record.firstMeshlet = static_cast<uint32_t>(meshlets.size());
+		record.meshletCount = static_cast<uint32_t>(primitive.meshlets.size());
+		record.range = primitive.range;
+		record.bounds = primitive.bounds;
+
+		chunks.insert(chunks.end(), primitive.chunks.begin(), primitive.chunks.end());
+		meshlets.insert(meshlets.end(), primitive.meshlets.begin(), primitive.meshlets.end());
+	}
+
+	return list;
+}
+
+// Size and write time of a file, zeros for a missing one.
+void GetFileStamp(const std::filesystem::path& path, uint64_t& size, int64_t& writeTime)
+{
+	std::error_code error;
+	const auto fileSize = std::filesystem::file_size(path, error);
+	const auto fileWriteTime = std::filesystem::last_write_time(path, error);
+
+	size = error ? 0 : static_cast<uint64_t>(fileSize);
+	writeTime = error ? 0 : static_cast<int64_t>(fileWriteTime.time_since_epoch().count());
+}
+
+void CheckRange(size_t first, size_t count, size_t size)
+{
+	if (first > size || count > size - first)
+	{
+		throw SD::SomeException(__LINE__, __FILEW__, L"COOKED SCENE IS DAMAGED!");
+	}
+}
+}  // end namespace
+
+namespace SD::ENGINE {
+
+CookedSceneSource GetCookedSceneSource(const std::filesystem::path& path, uint32_t settings)
+{
+	// a missing source gives an empty one, loading it reports the error
+	CookedSceneSource source;
+	GetFileStamp(path, source.size, source.writeTime);
+	source.settings = settings;
+
+	return source;
+}
+
+void WriteCookedScene(
+	const std::filesystem::path& path,
+	const CookedSceneSource& source,
+	const tinygltf::Model& model,
+	const GltfFile& file,
+	const CookedGeometry& geometry)
+{
+	std::vector<char> strings;
+	const auto addString = [&strings](const std::string& string)
+	{
+		const StringRef ref = { static_cast<uint32_t>(strings.size()), static_cast<uint32_t>(string.size()) };
+		strings.insert(strings.end(), string.begin(), string.end());
+		return ref;
+	};
+
+	std::vector<BufferFileRecord> bufferFiles;
+	for (const auto& bufferFile : source.bufferFiles)
+	{
+		auto& record = bufferFiles.emplace_back();
+		record.path = addString(bufferFile);
+		GetFileStamp(path.parent_path() / std::filesystem::u8path(bufferFile), record.size, record.writeTime);
+	}
+
+	std::vector<ImageRecord> images;
+	for (const auto& image : model.images)
+	{
+		images.push_back({ addString(image.uri), 0u, 0u });
+	}
+
+	std::vector<TextureRecord> textures;
+	for (const auto& texture : model.textures)
+	{
+		textures.push_back({ texture.source, texture.sampler });
+	}
+
+	std::vector<SamplerRecord> samplers;
+	for (const auto& sampler : model.samplers)
+	{
+		samplers.push_back({ sampler.minFilter, sampler.magFilter, sampler.wrapS, sampler.wrapT });
+	}
+
+	std::vector<MaterialRecord> materials;
+	for (const auto& material : model.materials)
+	{
+		auto& record = materials.emplace_back();
+		record.name = addString(material.name);
+		record.alphaMode = addString(material.alphaMode);
+		record.alphaCutoff = material.alphaCutoff;
+		CopyValues(material.pbrMetallicRoughness.baseColorFactor, record.baseColorFactor);
+		record.metallicFactor = material.pbrMetallicRoughness.metallicFactor;
+		record.roughnessFactor = material.pbrMetallicRoughness.roughnessFactor;
+		record.normalScale = material.normalTexture.scale;
+		record.baseColorTexture = material.pbrMetallicRoughness.baseColorTexture.index;
+		record.metallicRoughnessTexture = material.pbrMetallicRoughness.metallicRoughnessTexture.index;
+		record.normalTexture = material.normalTexture.index;
+		record.doubleSided = material.doubleSided;
+	}
+
+	std::vector<MeshRecord> meshes;
+	std::vector<MeshPrimitiveRecord> meshPrimitives;
+	for (const auto& mesh : model.meshes)
+	{
+		meshes.push_back({ addString(mesh.name), static_cast<uint32_t>(meshPrimitives.size()), static_cast<uint32_t>(mesh.primitives.size()) });
+
+		for (const auto& primitive : mesh.primitives)
+		{
+			auto& record = meshPrimitives.emplace_back();
+			record.material = primitive.material;
+
+			const auto& accessor = model.accessors[primitive.attributes.at("POSITION")];
+			record.componentType = accessor.componentType;
+			record.normalized = accessor.normalized;
+			if (accessor.minValues.size() == 3 && accessor.maxValues.size() == 3)
+			{
+				record.hasBounds = true;
+				CopyValues(accessor.minValues, record.min);
+				CopyValues(accessor.maxValues, record.max);
+			}
+		}
+	}
+
+	std::vector<LightRecord> lights;
+	for (const auto& light : model.lights)
+	{
+		auto& record = lights.emplace_back();
+		record.name = addString(light.name);
+		record.type = addString(light.type);
+		CopyValues(light.color, record.color);
+		record.intensity = light.intensity;
+	}
+
+	std::vector<uint32_t> nodeIndices;
+	std::vector<NodeRecord> nodes;
+	for (const auto& node : model.nodes)
+	{
+		auto& record = nodes.emplace_back();
+		record.name = addString(node.name);
+		record.mesh = node.mesh;
+		record.light = node.light;
+		const bool hasStatic = node.extras.Has("static") && node.extras.Get("static").IsBool();
+		record.staticExtra = hasStatic ? node.extras.Get("static").Get<bool>() : -1;
+		record.firstChild = static_cast<uint32_t>(nodeIndices.size());
+		record.childCount = static_cast<uint32_t>(node.children.size());
+		record.matrixSize = CopyValues(node.matrix, record.matrix);
+		record.scaleSize = CopyValues(node.scale, record.scale);
+		record.rotationSize = CopyValues(node.rotation, record.rotation);
+		record.translationSize = CopyValues(node.translation, record.translation);
+
+		nodeIndices.insert(nodeIndices.end(), node.children.begin(), node.children.end());
+	}
+
+	std::vector<SceneRecord> scenes;
+	for (const auto& scene : model.scenes)
+	{
+		scenes.push_back({ addString(scene.name), static_cast<uint32_t>(nodeIndices.size()), static_cast<uint32_t>(scene.nodes.size()) });
+		nodeIndices.insert(nodeIndices.end(), scene.nodes.begin(), scene.nodes.end());
+	}
+
+	// batches point into the blobs, every vertex and index blob starts on an own page
+	std::vector<VertexElementRecord> vertexElements;
+	std::vector<BatchRecord> batches;
+	std::vector<uint8_t> blobs;
+	for (const auto& batch : geometry.batches)
+	{
+		auto& record = batches.emplace_back();
+		record.firstElement = static_cast<uint32_t>(vertexElements.size());
+		record.elementCount = static_cast<uint32_t>(batch.format->elements.size());
+		record.stride = batch.format->stride;
+		record.indexFormat = static_cast<uint32_t>(batch.format->indexFormat);
+		record.vertexCount = batch.vertexCount;
+		record.indexCount = batch.indexCount;
+
+		for (const auto& element : batch.format->elements)
+		{
+			vertexElements.push_back({ addString(element.semantic), element.semanticIdx, static_cast<uint32_t>(element.format), element.offset });
+		}
+
+		record.vertexOffset = blobs.size();
+		blobs.insert(blobs.end(), batch.vertices, batch.vertices + batch.vertexCount * batch.format->stride);
+		blobs.resize(Align(blobs.size(), BLOB_ALIGNMENT), 0u);
+
+		record.indexOffset = blobs.size();
+		blobs.insert(blobs.end(), batch.indices, batch.indices + batch.indexCount * GetIndexSize(record.indexFormat));
+		blobs.resize(Align(blobs.size(), BLOB_ALIGNMENT), 0u);
+	}
+
+	for (size_t idx = 0; idx < model.images.size(); ++idx)
+	{
+		const auto data = file.GetImage(model, static_cast<int>(idx));
+		if (data.data)
+		{
+			images[idx].dataOffset = blobs.size();
+			images[idx].dataSize = data.size;
+			blobs.insert(blobs.end(), data.data, data.data + data.size);
+			blobs.resize(Align(blobs.size(), BLOB_ALIGNMENT), 0u);
+		}
+	}
+
+	std::vector<GeometryPrimitiveRecord> geometryPrimitives;
+	std::vector<IndexRange> chunks;
+	std::vector<Meshlet> meshlets;
+
+	std::vector<ListRecord> meshGeometry;
+	for (const auto& primitives : geometry.meshPrimitives)
+	{
+		meshGeometry.push_back(AddPrimitives(primitives, geometryPrimitives, chunks, meshlets));
+	}
+
+	std::vector<ListRecord> staticGeometry;
+	for (const auto& primitives : geometry.staticPrimitives)
+	{
+		staticGeometry.push_back(AddPrimitives(primitives, geometryPrimitives, chunks, meshlets));
+	}
+
+	std::vector<StaticBoundsRecord> staticBounds;
+	for (const auto& bounds : geometry.staticBounds)
+	{
+		staticBounds.push_back({ bounds.value_or(DirectX::BoundingBox()), bounds.has_value() });
+	}
+
+	Writer writer;
+	writer.Add(STRINGS, strings);
+	writer.Add(BUFFER_FILES, bufferFiles);
+	writer.Add(IMAGES, images);
+	writer.Add(TEXTURES, textures);
+	writer.Add(SAMPLERS, samplers);
+	writer.Add(MATERIALS, materials);
+	writer.Add(MESHES, meshes);
+	writer.Add(MESH_PRIMITIVES, meshPrimitives);
+	writer.Add(LIGHTS, lights);
+	writer.Add(NODES, nodes);
+	writer.Add(NODE_INDICES, nodeIndices);
+	writer.Add(SCENES, scenes);
+	writer.Add(VERTEX_ELEMENTS, vertexElements);
+	writer.Add(BATCHES, batches);
+	writer.Add(GEOMETRY_PRIMITIVES, geometryPrimitives);
+	writer.Add(MESH_GEOMETRY, meshGeometry);
+	writer.Add(STATIC_GEOMETRY, staticGeometry);
+	writer.Add(STATIC_BOUNDS, staticBounds);
+	writer.Add(CHUNKS, chunks);
+	writer.Add(MESHLETS, meshlets);
+	writer.Add(BLOBS, blobs, BLOB_ALIGNMENT);
+
+	Header header = {};
+	std::copy(std::begin(MAGIC), std::end(MAGIC), std::begin(header.magic));
+	header.version = COOKED_SCENE_VERSION;
+	header.settings = source.settings;
+	header.sourceSize = source.size;
+	header.sourceWriteTime = source.writeTime;
+	header.defaultScene = model.defaultScene;
+
+	auto tmpPath = path;
+	tmpPath += ".tmp";
+	writer.Write(tmpPath, header);
+	std::filesystem::rename(tmpPath, path);
+}
+
+CookedScene::CookedScene(const std::filesystem::path& path)
+	: m_file(path)
+	, m_dir(path.parent_path())
+{
+	if (m_file.GetSize() < sizeof(Header))
+	{
+		return;
+	}
+
+	const auto* header = reinterpret_cast<const Header*>(m_file.GetData());
+	if (memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0 || header->version != COOKED_SCENE_VERSION)
+	{
+		return;
+	}
+
+	for (uint32_t section = 0; section < SECTIONS_COUNT; ++section)
+	{
+		const auto& entry = header->sections[section];
+		const size_t size = m_file.GetSize();
+		if (entry.offset % SECTION_ALIGNMENT != 0 || entry.offset > size || entry.count > (size - entry.offset) / RECORD_SIZES[section])
+		{
+			return;
+		}
+	}
+
+	m_valid = true;
+}
+
+bool CookedScene::IsValid(const CookedSceneSource& source) const
+{
+	if (!m_valid)
+	{
+		return false;
+	}
+
+	const auto* header = reinterpret_cast<const Header*>(m_file.GetData());
+	if (header->sourceSize != source.size || header->sourceWriteTime != source.writeTime || header->settings != source.settings)
+	{
+		return false;
+	}
+
+	// geometry comes from the buffers, a .bin file can change without the glTF
+	size_t stringsSize = 0;
+	const auto* strings = getSection<char>(STRINGS, stringsSize);
+	size_t count = 0;
+	const auto* bufferFiles = getSection<BufferFileRecord>(BUFFER_FILES, count);
+	for (size_t idx = 0; idx < count; ++idx)
+	{
+		const auto& record = bufferFiles[idx];
+		CheckRange(record.path.offset, record.path.length, stringsSize);
+
+		uint64_t size = 0;
+		int64_t writeTime = 0;
+		GetFileStamp(m_dir / std::filesystem::u8path(std::string(strings + record.path.offset, record.path.length)), size, writeTime);
+		if (size != record.size || writeTime != record.writeTime)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+tinygltf::Model CookedScene::GetModel() const
+{
+	if (!m_valid)
+	{
+		THROW_SOME_EXCEPTION(L"COOKED SCENE IS DAMAGED!");
+	}
+
+	size_t stringsSize = 0;
+	const auto* strings = getSection<char>(STRINGS, stringsSize);
+	const auto getString = [&](const StringRef& ref)
+	{
+		CheckRange(ref.offset, ref.length, stringsSize);
+		return std::string(strings + ref.offset, ref.length);
+	};
+
+	size_t nodeIndicesCount = 0;
+	const auto* nodeIndices = getSection<uint32_t>(NODE_INDICES, nodeIndicesCount);
+	const auto getNodeIndices = [&](uint32_t first, uint32_t count)
+	{
+		CheckRange(first, count, nodeIndicesCount);
+		return std::vector<int>(nodeIndices + first, nodeIndices + first + count);
+	};
+
+	tinygltf::Model model;
+	model.defaultScene = reinterpret_cast<const Header*>(m_file.GetData())->defaultScene;
+
+	size_t count = 0;
+	const auto* images = getSection<ImageRecord>(IMAGES, count);
+	model.images.resize(count);
+	for (size_t idx = 0; idx < count; ++idx)
+	{
+		model.images[idx].uri = getString(images[idx].uri);
+	}
+
+	const auto* textures = getSection<TextureRecord>(TEXTURES, count);
+	model.textures.resize(count);
+	for (size_t idx = 0; idx < count; ++idx)
+	{
+		model.textures[idx].source = textures[idx].source;
+		model.textures[idx].sampler = textures[idx].sampler;
+	}
+
+	const auto* samplers = getSection<SamplerRecord>(SAMPLERS, count);
+	model.samplers.resize(count);
+	for (size_t idx = 0; idx < count; ++idx)
+	{
+		model.samplers[idx].minFilter = samplers[idx].minFilter;
+		model.samplers[idx].magFilter = samplers[idx].magFilter;
+		model.samplers[idx].wrapS = samplers[idx].wrapS;
+		model.samplers[idx].wrapT = samplers[idx].wrapT;
+	}
+
+	const auto* materials = getSection<MaterialRecord>(MATERIALS, count);
+	model.materials.resize(count);
+	for (size_t idx = 0; idx < count; ++idx)
+	{
+		const auto& record = materials[idx];
+		auto& material = model.materials[idx];
+		material.name = getString(record.name);
+		material.alphaMode = getString(record.alphaMode);
+		material.alphaCutoff = record.alphaCutoff;
+		material.pbrMetallicRoughness.baseColorFactor = GetValues(record.baseColorFactor, 4);
+		material.pbrMetallicRoughness.metallicFactor = record.metallicFactor;
+		material.pbrMetallicRoughness.roughnessFactor = record.roughnessFactor;
+		material.normalTexture.scale = record.normalScale;
+		material.pbrMetallicRoughness.baseColorTexture.index = record.baseColorTexture;
+		material.pbrMetallicRoughness.metallicRoughnessTexture.index = record.metallicRoughnessTexture;
+		material.normalTexture.index = record.normalTexture;
+		material.doubleSided = record.doubleSided != 0;
+	}
+
+	// every primitive gets a POSITION accessor holding its bounds
+	size_t meshPrimitivesCount = 0;
+	const auto* meshPrimitives = getSection<MeshPrimitiveRecord>(MESH_PRIMITIVES, meshPrimitivesCount);
+	const auto* meshes = getSection<MeshRecord>(MESHES, count);
+	model.meshes.resize(count);
+	model.accessors.reserve(meshPrimitivesCount);
+	for (size_t idx = 0; idx < count; ++idx)
+	{
+		const auto& record = meshes[idx];
+		auto& mesh = model.meshes[idx];
+		mesh.name = getString(record.name);
+
+		CheckRange(record.firstPrimitive, record.primitiveCount, meshPrimitivesCount);
+		for (uint32_t primitiveIdx = 0; primitiveIdx < record.primitiveCount; ++primitiveIdx)
+		{
+			const auto& primitiveRecord = meshPrimitives[record.firstPrimitive + primitiveIdx];
+
+			auto& accessor = model.accessors.emplace_back();
+			accessor.componentType = primitiveRecord.componentType;
+			accessor.normalized = primitiveRecord.normalized != 0;
+			accessor.type = TINYGLTF_TYPE_VEC3;
+			if (primitiveRecord.hasBounds)
+			{
+				accessor.minValues = GetValues(primitiveRecord.min, 3);
+				accessor.maxValues = GetValues(primitiveRecord.max, 3);
+			}
+
+			auto& primitive = mesh.primitives.emplace_back();
+			primitive.material = primitiveRecord.material;
+			primitive.mode = TINYGLTF_MODE_TRIANGLES;
+			primitive.attributes["POSITION"] = static_cast<int>(model.accessors.size() - 1);
+		}
+	}
+
+	const auto* lights = getSection<LightRecord>(LIGHTS, count);
+	model.lights.resize(count);
+	for (size_t idx = 0; idx < count; ++idx)
+	{
+		model.lights[idx].name = getString(lights[idx].name);
+		model.lights[idx].type = getString(lights[idx].type);
+		model.lights[idx].color = GetValues(lights[idx].color, 3);
+		model.lights[idx].intensity = lights[idx].intensity;
+	}
+
+	const auto* nodes = getSection<NodeRecord>(NODES, count);
+	model.nodes.resize(count);
+	for (size_t idx = 0; idx < count; ++idx)
+	{
+		const auto& record = nodes[idx];
+		auto& node = model.nodes[idx];
+		node.name = getString(record.name);
+		node.mesh = record.mesh;
+		node.light = record.light;
+		node.children = getNodeIndices(record.firstChild, record.childCount);
+		node.matrix = GetValues(record.matrix, record.matrixSize);
+		node.scale = GetValues(record.scale, record.scaleSize);
+		node.rotation = GetValues(record.rotation, record.rotationSize);
+		node.translation = GetValues(record.translation, record.translationSize);
+
+		if (record.staticExtra >= 0)
+		{
+			tinygltf::Value::Object extras;
+			extras["static"] = tinygltf::Value(record.staticExtra != 0);
+			node.extras = tinygltf::Value(extras);
+		}
+	}
+
+	const auto* scenes = getSection<SceneRecord>(SCENES, count);
+	model.scenes.resize(count);
+	for (size_t idx = 0; idx < count; ++idx)
+	{
+		model.scenes[idx].name = getString(scenes[idx].name);
+		model.scenes[idx].nodes = getNodeIndices(scenes[idx].firstNode, scenes[idx].nodeCount);
+	}
+
+	return model;
+}
+
+void CookedScene::AddGeometry(GeometryPool& pool) const
+{
+	size_t elementsCount = 0;
+	const auto* elements = getSection<VertexElementRecord>(VERTEX_ELEMENTS, elementsCount);
+	size_t stringsSize = 0;
+	const auto* strings = getSection<char>(STRINGS, stringsSize);
+	size_t blobsSize = 0;
+	const auto* blobs = getSection<uint8_t>(BLOBS, blobsSize);
+
+	// primitives refer to batches by index, so they have to be the first ones of the pool
+	size_t count = 0;
+	const auto* batches = getSection<BatchRecord>(BATCHES, count);
+	for (size_t idx = 0; idx < count; ++idx)
+	{
+		const auto& record = batches[idx];
+
+		GeometryFormat format;
+		format.stride = record.stride;
+		format.indexFormat = static_cast<DXGI_FORMAT>(record.indexFormat);
+
+		CheckRange(record.firstElement, record.elementCount, elementsCount);
+		for (uint32_t elementIdx = 0; elementIdx < record.elementCount; ++elementIdx)
+		{
+			const auto& elementRecord = elements[record.firstElement + elementIdx];
+			CheckRange(elementRecord.semantic.offset, elementRecord.semantic.length, stringsSize);
+
+			auto& element = format.elements.emplace_back();
+			element.semantic = std::string(strings + elementRecord.semantic.offset, elementRecord.semantic.length);
+			element.semanticIdx = elementRecord.semanticIdx;
+			element.format = static_cast<DXGI_FORMAT>(elementRecord.format);
+			element.offset = elementRecord.offset;
+		}
+
+		CheckRange(record.vertexOffset, record.vertexCount * record.stride, blobsSize);
+		CheckRange(record.indexOffset, record.indexCount * GetIndexSize(record.indexFormat), blobsSize);
+
+		const uint32_t batch = pool.AddExternal(
+			format, blobs + record.vertexOffset, record.vertexCount, blobs + record.indexOffset, record.indexCount);
+		if (batch != idx)
+		{
+			THROW_SOME_EXCEPTION(L"COOKED GEOMETRY NEEDS AN EMPTY POOL!");
+		}
+	}
+}
+
+std::vector<CookedPrimitive> CookedScene::GetMeshPrimitives(uint32_t mesh) const
+{
+	return getPrimitives(MESH_GEOMETRY, mesh);
+}
+
+std::vector<CookedPrimitive> CookedScene::GetStaticPrimitives(uint32_t scene) const
+{
+	return getPrimitives(STATIC_GEOMETRY, scene);
+}
+
+bool CookedScene::GetStaticBounds(uint32_t scene, DirectX::BoundingBox& bounds) const
+{
+	size_t count = 0;
+	const auto* records = getSection<StaticBoundsRecord>(STATIC_BOUNDS, count);
+	if (scene >= count || !records[scene].hasBounds)
+	{
+		return false;
+	}
+
+	bounds = records[scene].bounds;
+	return true;
+}
+
+BufferSpan CookedScene::GetImage(uint32_t image) const
+{
+	size_t count = 0;
+	const auto* images = getSection<ImageRecord>(IMAGES, count);
+	CheckRange(image, 1, count);
+
+	const auto& record = images[image];
+	if (record.dataSize == 0)
+	{
+		return {};
+	}
+
+	size_t blobsSize = 0;
+	const auto* blobs = getSection<uint8_t>(BLOBS, blobsSize);
+	CheckRange(record.dataOffset, record.dataSize, blobsSize);
+
+	return { blobs + record.dataOffset, record.dataSize };
+}
+
+template<typename T>
+const T* CookedScene::getSection(uint32_t section, size_t& count) const
+{
+	if (!m_valid)
+	{
+		count = 0;
+		return nullptr;
+	}
+
+	const auto& entry = reinterpret_cast<const Header*>(m_file.GetData())->sections[section];
+	count = static_cast<size_t>(entry.count);
+
+	return reinterpret_cast<const T*>(m_file.GetData() + entry.offset);
+}
+
+std::vector<CookedPrimitive> CookedScene::getPrimitives(uint32_t listSection, uint32_t list) const
+{
+	size_t listsCount = 0;
+	const auto* lists = getSection<ListRecord>(listSection, listsCount);
+	if (list >= listsCount)
+	{
+		return {};
+	}
+
+	size_t recordsCount = 0;
+	const auto* records = getSection<GeometryPrimitiveRecord>(GEOMETRY_PRIMITIVES, recordsCount);
+	size_t chunksCount = 0;
+	const auto* chunks = getSection<IndexRange>(CHUNKS, chunksCount);
+	size_t meshletsCount = 0;
+	const auto* meshlets = getSection<Meshlet>(MESHLETS, meshletsCount);
+	size_t batchesCount = 0;
+	getSection<BatchRecord>(BATCHES, batchesCount);
+
+	CheckRange(lists[list].first, lists[list].count, recordsCount);
+
+	std::vector<CookedPrimitive> primitives(lists[list].count);
+	for (size_t idx = 0; idx < primitives.size(); ++idx)
+	{
+		const auto& record = records[lists[list].first + idx];
+		auto& primitive = primitives[idx];
+		primitive.material = record.material;
+		primitive.node = record.node;
+		primitive.bounds = record.bounds;
+		primitive.range = record.range;
+
+		// ranges are drawn from the pool batches added by AddGeometry
+		CheckRange(record.range.batch, 1, batchesCount);
+
+		CheckRange(record.firstChunk, record.chunkCount, chunksCount);
+		primitive.chunks.assign(chunks + record.firstChunk, chunks + record.firstChunk + record.chunkCount);
+
+		CheckRange(record.firstMeshlet, record.meshletCount, meshletsCount);
+		primitive.meshlets.assign(meshlets + record.firstMeshlet, meshlets + record.firstMeshlet + record.meshletCount);
+	}
+
+	return primitives;
+}
+
+}  // end namespace SD::ENGINE
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <DirectXCollision.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "geometry_pool.hpp"
+#include "gltf_file.hpp"
+#include "index_optimizer.hpp"
+#include "mapped_file.hpp"
+#include "meshlet.hpp"
+
+
+namespace tinygltf
+{
+class Model;
+}
+
+namespace SD::ENGINE {
+
+// bumped whenever the layout or the meaning of cooked data changes
+constexpr uint32_t COOKED_SCENE_VERSION = 5;
+constexpr const char* COOKED_SCENE_EXTENSION = ".sdscene";
+
+// Primitive geometry inside the pool.
+struct CookedPrimitive
+{
+	uint32_t material = 0;
+	uint32_t node = 0;  // of baked static primitives, the node they were baked from
+	DirectX::BoundingBox bounds = {};
+	GeometryRange range = {};
+	std::vector<IndexRange> chunks = {};
+	std::vector<Meshlet> meshlets = {};
+};
+
+struct CookedGeometry
+{
+	std::vector<GeometryBatchData> batches = {};
+	std::vector<std::vector<CookedPrimitive>> meshPrimitives = {};  // per mesh, empty for meshes drawn from baked copies only
+	std::vector<std::vector<CookedPrimitive>> staticPrimitives = {};  // baked static geometry per scene
+	// per scene, bounds its static positions are quantized to, none for scenes without static geometry
+	std::vector<std::optional<DirectX::BoundingBox>> staticBounds = {};
+};
+
+// What a scene was cooked from, it is cooked again once anything differs.
+struct CookedSceneSource
+{
+	uint64_t size = 0;
+	int64_t writeTime = 0;
+	uint32_t settings = 0;  // packing settings the geometry was cooked with
+
+	// External buffer files relative to the scene (UTF-8), known once the glTF is loaded. Their sizes and write times
+	// are stored with the cooked scene and checked against the files when it is mapped.
+	std::vector<std::string> bufferFiles = {};
+};
+
+CookedSceneSource GetCookedSceneSource(const std::filesystem::path& path, uint32_t settings);
+
+// Writes the model tables (nodes, transforms, meshes, materials, textures, lights and scenes, no buffers), the packed
+// pool batches, page aligned, and the bytes of images embedded in the file, as there are no buffers to read them from.
+// The file is written next to the target and renamed, so readers never see a part.
+void WriteCookedScene(
+	const std::filesystem::path& path,
+	const CookedSceneSource& source,
+	const tinygltf::Model& model,
+	const GltfFile& file,
+	const CookedGeometry& geometry);
+
+// Cooked scene mapped to memory, nothing is read before it is asked for.
+class CookedScene
+{
+public:
+	CookedScene(const std::filesystem::path& path);
+	~CookedScene() = default;
+
+	CookedScene(const CookedScene&) = delete;
+	CookedScene& operator=(const CookedScene&) = delete;
+
+	// False for damaged files, other versions or sources (buffer files included), the scene has to be cooked again then.
+	bool IsValid(const CookedSceneSource& source) const;
+
+	// Model without buffers, accessors only carry POSITION bounds of primitives (with their component type).
+	tinygltf::Model GetModel() const;
+
+	// Adds batches pointing into the mapping, so it has to live until GeometryPool::Create uploads them.
+	void AddGeometry(GeometryPool& pool) const;
+
+	std::vector<CookedPrimitive> GetMeshPrimitives(uint32_t mesh) const;
+	std::vector<CookedPrimitive> GetStaticPrimitives(uint32_t scene) const;
+	// False for scenes without static geometry.
+	bool GetStaticBounds(uint32_t scene, DirectX::BoundingBox& bounds) const;
+
+	// Encoded bytes of an embedded image in the mapping, empty for images in files of their own.
+	BufferSpan GetImage(uint32_t image) const;
+
+	size_t GetSize() const { return m_file.GetSize(); }
+
+private:
+	template<typename T>
+	const T* getSection(uint32_t section, size_t& count) const;
+
+	std::vector<CookedPrimitive> getPrimitives(uint32_t listSection, uint32_t list) const;
+
+private:
+	MappedFile m_file;
+	std::filesystem::path m_dir;  // of the source, buffer files are relative to it
+	bool m_valid = false;  // header and sections are in the file
+};
+
+}  // end namespace SD::ENGINE
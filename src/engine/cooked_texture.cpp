@@ -0,0 +1,195 @@
+#include "cooked_texture.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <system_error>
+#include <thread>
+#include <unordered_map>
+
+#include <DirectXTex.h>
+
+#include "exceptions.hpp"
+#include "hash.hpp"
+#include "mapped_file.hpp"
+#include "texture.hpp"
+#include "timer.hpp"
+
+
+namespace
+{
+struct CompressedFormats
+{
+	DXGI_FORMAT format;
+	DXGI_FORMAT singleChannelFormat;  // for sources with one channel
+};
+
+const std::unordered_map<SD::ENGINE::TextureUsage, CompressedFormats> COMPRESSED_FORMATS_MAP = {
+	{SD::ENGINE::TextureUsage::COLOR, {DXGI_FORMAT_BC7_UNORM, DXGI_FORMAT_BC7_UNORM}},
+	{SD::ENGINE::TextureUsage::CUTOUT, {DXGI_FORMAT_BC7_UNORM, DXGI_FORMAT_BC7_UNORM}},
+	{SD::ENGINE::TextureUsage::NORMAL, {DXGI_FORMAT_BC5_UNORM, DXGI_FORMAT_BC5_UNORM}},
+	{SD::ENGINE::TextureUsage::MASK, {DXGI_FORMAT_BC1_UNORM, DXGI_FORMAT_BC4_UNORM}},
+};
+
+// color is filtered sharper and in linear space, data keeps its plain average
+const std::unordered_map<SD::ENGINE::TextureUsage, SD::ENGINE::MipSettings> MIP_SETTINGS_MAP = {
+	{SD::ENGINE::TextureUsage::COLOR, {SD::ENGINE::MipFilter::KAISER, true, false}},
+	{SD::ENGINE::TextureUsage::CUTOUT, {SD::ENGINE::MipFilter::KAISER, true, true}},  // with the material cutoff
+	{SD::ENGINE::TextureUsage::NORMAL, {SD::ENGINE::MipFilter::BOX, false, false}},
+	{SD::ENGINE::TextureUsage::MASK, {SD::ENGINE::MipFilter::BOX, false, false}},
+};
+
+constexpr size_t BLOCK_SIZE = 4;
+
+size_t CountMips(size_t width, size_t height)
+{
+	size_t mipLevels = 1;
+	while (width > 1 || height > 1)
+	{
+		width = std::max<size_t>(width / 2, 1);
+		height = std::max<size_t>(height / 2, 1);
+		mipLevels++;
+	}
+
+	return mipLevels;
+}
+
+bool IsSingleChannel(DXGI_FORMAT format)
+{
+	switch (format)
+	{
+	case DXGI_FORMAT_R8_UNORM:
+	case DXGI_FORMAT_R16_UNORM:
+	case DXGI_FORMAT_R16_FLOAT:
+	case DXGI_FORMAT_R32_FLOAT:
+		return true;
+	default:
+		return false;
+	}
+}
+
+uint64_t GetCookedTextureKey(const std::filesystem::path& path, SD::ENGINE::TextureUsage usage, float alphaCutoff)
+{
+	const SD::MappedFile source(path);
+
+	uint64_t key = SD::Hash64(source.GetData(), source.GetSize());
+	key = SD::HashCombine(key, SD::ENGINE::COOKED_TEXTURE_VERSION);
+	key = SD::HashCombine(key, static_cast<uint64_t>(usage));
+	key = SD::HashCombine(key, static_cast<uint64_t>(SD::ENGINE::COOKED_TEXTURE_PRESET));
+
+	// other usages are cooked the same for any cutoff
+	if (usage == SD::ENGINE::TextureUsage::CUTOUT)
+	{
+		key = SD::HashCombine(key, SD::Hash64(&alphaCutoff, sizeof(alphaCutoff)));
+	}
+
+	return key;
+}
+
+DirectX::ScratchImage CookTexture(const std::filesystem::path& path, SD::ENGINE::TextureUsage usage, float alphaCutoff, SD::JobSystem& jobSystem)
+{
+	auto image = SD::RENDER::Texture::Load(path.wstring());
+	const auto cooked = SD::ENGINE::GetCookedTextureMetadata(image.GetMetadata(), usage);
+
+	if (image.GetMetadata().mipLevels < cooked.mipLevels)
+	{
+		auto settings = MIP_SETTINGS_MAP.at(usage);
+		settings.alphaCutoff = alphaCutoff;
+
+		image = SD::ENGINE::GenerateMips(*image.GetImage(0, 0, 0), cooked.mipLevels, settings, jobSystem);
+	}
+
+	if (image.GetMetadata().format != cooked.format)
+	{
+		image = SD::ENGINE::CompressImage(image, cooked.format, SD::ENGINE::COOKED_TEXTURE_PRESET, jobSystem);
+	}
+
+	return image;
+}
+
+// Written next to the target and renamed, so loads never see a part. Jobs cooking the same texture write files of
+// their own, the last rename wins.
+void WriteCookedTexture(const std::filesystem::path& path, const DirectX::ScratchImage& image)
+{
+	std::error_code error;
+	std::filesystem::create_directories(path.parent_path(), error);
+
+	auto tmpPath = path;
+	tmpPath += "." + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) + ".tmp";
+
+	const HRESULT hr = DirectX::SaveToDDSFile(image.GetImages(), image.GetImageCount(), image.GetMetadata(),
+		DirectX::DDS_FLAGS_NONE, tmpPath.wstring().c_str());
+	if (FAILED(hr))
+	{
+		std::clog << "Cooked texture not written: " << path.string() << std::endl;
+		std::filesystem::remove(tmpPath, error);
+		return;
+	}
+
+	std::filesystem::rename(tmpPath, path, error);
+	if (error)
+	{
+		std::filesystem::remove(tmpPath, error);
+	}
+}
+}  // end namespace
+
+namespace SD::ENGINE {
+
+DirectX::TexMetadata GetCookedTextureMetadata(const DirectX::TexMetadata& source, TextureUsage usage)
+{
+	DirectX::TexMetadata cooked = source;
+	if (DirectX::IsCompressed(source.format))
+	{
+		return cooked;
+	}
+
+	if (cooked.mipLevels == 1)
+	{
+		cooked.mipLevels = CountMips(cooked.width, cooked.height);
+	}
+
+	if (cooked.width % BLOCK_SIZE == 0 && cooked.height % BLOCK_SIZE == 0)
+	{
+		const auto& formats = COMPRESSED_FORMATS_MAP.at(usage);
+		cooked.format = IsSingleChannel(source.format) ? formats.singleChannelFormat : formats.format;
+		cooked.format = DirectX::IsSRGB(source.format) ? DirectX::MakeSRGB(cooked.format) : cooked.format;
+	}
+
+	return cooked;
+}
+
+DirectX::ScratchImage LoadCookedTexture(
+	const std::filesystem::path& path,
+	TextureUsage usage,
+	float alphaCutoff,
+	const std::filesystem::path& cacheDir,
+	JobSystem& jobSystem)
+{
+	std::ostringstream name;
+	name << std::hex << std::setw(16) << std::setfill('0') << GetCookedTextureKey(path, usage, alphaCutoff) << ".dds";
+	const auto cookedPath = cacheDir / name.str();
+
+	if (std::filesystem::exists(cookedPath))
+	{
+		try
+		{
+			return RENDER::Texture::Load(cookedPath.wstring());
+		}
+		catch (const SomeException& e)
+		{
+			std::wclog << L"Cooked texture is damaged, cook again: " << e.w_what() << std::endl;
+		}
+	}
+
+	Timer timer;
+	auto image = CookTexture(path, usage, alphaCutoff, jobSystem);
+	WriteCookedTexture(cookedPath, image);
+
+	std::clog << "Texture " << path.filename().string() << " cooked: " << timer.GetDelta() << " s." << std::endl;
+
+	return image;
+}
+
+}  // end namespace SD::ENGINE
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+
+#include "block_compressor.hpp"
+#include "mip_generator.hpp"
+
+
+namespace DirectX {
+	class ScratchImage;
+	struct TexMetadata;
+}
+
+namespace SD::ENGINE {
+
+// bumped whenever cooking gives different results for the same source
+constexpr uint32_t COOKED_TEXTURE_VERSION = 3;
+
+// What a texture is sampled as, decides the block compression it is cooked to.
+enum class TextureUsage : uint32_t
+{
+	COLOR,  // BC7, mips filtered as sRGB
+	CUTOUT,  // BC7 of alpha tested materials, mips keep the coverage of the material cutoff
+	NORMAL,  // BC5, two channels, shaders rebuild z
+	MASK,  // BC4 for single channel sources, BC1 otherwise
+};
+
+// Layout a texture is cooked to: a full mip chain, block compressed for the usage if the size is a multiple of the
+// block size. Block compressed sources are kept as they are.
+DirectX::TexMetadata GetCookedTextureMetadata(const DirectX::TexMetadata& source, TextureUsage usage);
+
+// preset textures are block compressed with when cooked
+constexpr CompressionPreset COOKED_TEXTURE_PRESET = CompressionPreset::QUALITY;
+
+// Loads the texture cooked for the usage from the cache directory. On a miss the source is decoded, mipmapped and block
+// compressed on the job system, and the result is written to the cache under a key of the source content hash and the
+// cook settings. Cutout mips keep the alpha coverage of the cutoff, which other usages ignore.
+DirectX::ScratchImage LoadCookedTexture(
+	const std::filesystem::path& path,
+	TextureUsage usage,
+	float alphaCutoff,
+	const std::filesystem::path& cacheDir,
+	JobSystem& jobSystem);
+
+}  // end namespace SD::ENGINE
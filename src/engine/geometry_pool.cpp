@@ -0,0 +1,270 @@
+#include "geometry_pool.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include "exceptions.hpp"
+#include "hash.hpp"
+
+
+namespace
+{
+size_t GetIndexSize(DXGI_FORMAT format)
+{
+	return format == DXGI_FORMAT_R32_UINT ? sizeof(uint32_t) : sizeof(uint16_t);
+}
+
+uint32_t GetPositionSize(DXGI_FORMAT format)
+{
+	switch (format)
+	{
+	case DXGI_FORMAT_R32G32B32A32_FLOAT:
+		return 16;
+	case DXGI_FORMAT_R32G32B32_FLOAT:
+		return 12;
+	case DXGI_FORMAT_R16G16B16A16_UNORM:
+		return 8;
+	default:
+		return 0;
+	}
+}
+}  // end namespace
+
+namespace SD::ENGINE {
+
+bool VertexElement::operator==(const VertexElement& other) const
+{
+	return semantic == other.semantic && semanticIdx == other.semanticIdx && format == other.format && offset == other.offset;
+}
+
+bool GeometryFormat::operator==(const GeometryFormat& other) const
+{
+	return elements == other.elements && stride == other.stride && indexFormat == other.indexFormat;
+}
+
+GeometryRange GeometryPool::Add(const GeometryFormat& format, const void* vertices, size_t vertexCount, const void* indices, size_t indexCount)
+{
+	if (m_created)
+	{
+		THROW_SOME_EXCEPTION(L"GEOMETRY POOL IS ALREADY CREATED!");
+	}
+
+	const uint32_t batchIdx = findBatch(format);
+	auto& batch = m_batches[batchIdx];
+
+	const size_t indexSize = GetIndexSize(format.indexFormat);
+	const size_t vertexBytes = vertexCount * format.stride;
+	const size_t indexBytes = indexCount * indexSize;
+
+	m_stats.primitives++;
+
+	// exporters often write the same geometry under several meshes and buffer views
+	const uint64_t hash = HashCombine(Hash64(vertices, vertexBytes, batchIdx), Hash64(indices, indexBytes));
+	const auto [first, last] = m_storedRanges.equal_range(hash);
+	for (auto it = first; it != last; ++it)
+	{
+		if (it->second.range.batch == batchIdx && isStored(it->second, vertices, vertexCount, indices, indexCount))
+		{
+			m_stats.duplicates++;
+			m_stats.savedBytes += vertexBytes + indexBytes;
+
+			return it->second.range;
+		}
+	}
+
+	GeometryRange range;
+	range.batch = batchIdx;
+	range.indexCount = static_cast<uint32_t>(indexCount);
+	range.startIndex = static_cast<uint32_t>(batch.indexCount);
+	range.baseVertex = static_cast<int32_t>(batch.vertexCount);
+
+	const auto* vertexData = static_cast<const uint8_t*>(vertices);
+	batch.vertices.insert(batch.vertices.end(), vertexData, vertexData + vertexCount * format.stride);
+
+	const auto* indexData = static_cast<const uint8_t*>(indices);
+	batch.indices.insert(batch.indices.end(), indexData, indexData + indexBytes);
+
+	batch.vertexCount += vertexCount;
+	batch.indexCount += indexCount;
+
+	m_storedRanges.emplace(hash, StoredRange{ range, vertexCount });
+
+	m_stats.vertices += vertexCount;
+	m_stats.indices += indexCount;
+
+	return range;
+}
+
+uint32_t GeometryPool::AddExternal(const GeometryFormat& format, const void* vertices, size_t vertexCount, const void* indices, size_t indexCount)
+{
+	if (m_created)
+	{
+		THROW_SOME_EXCEPTION(L"GEOMETRY POOL IS ALREADY CREATED!");
+	}
+
+	auto& batch = m_batches.emplace_back();
+	batch.format = format;
+	batch.vertexCount = vertexCount;
+	batch.indexCount = indexCount;
+	batch.pExternalVertices = static_cast<const uint8_t*>(vertices);
+	batch.pExternalIndices = static_cast<const uint8_t*>(indices);
+
+	m_stats.vertices += vertexCount;
+	m_stats.indices += indexCount;
+
+	return static_cast<uint32_t>(m_batches.size() - 1);
+}
+
+std::vector<GeometryBatchData> GeometryPool::GetBatches() const
+{
+	std::vector<GeometryBatchData> batches;
+	batches.reserve(m_batches.size());
+
+	for (const auto& batch : m_batches)
+	{
+		auto& data = batches.emplace_back();
+		data.format = &batch.format;
+		data.vertices = batch.pExternalVertices ? batch.pExternalVertices : batch.vertices.data();
+		data.vertexCount = batch.vertexCount;
+		data.indices = batch.pExternalIndices ? batch.pExternalIndices : batch.indices.data();
+		data.indexCount = batch.indexCount;
+	}
+
+	return batches;
+}
+
+void GeometryPool::Create(
+	RENDER::Renderer* renderer,
+	RENDER::StateLibrary* stateLibrary,
+	const std::vector<uint8_t>& vsBytecode,
+	const std::vector<uint8_t>& depthVSBytecode,
+	const std::vector<RENDER::InputElement>& instanceElements)
+{
+	for (auto& batch : m_batches)
+	{
+		std::vector<RENDER::InputElement> inputLayoutDesc;
+		inputLayoutDesc.reserve(batch.format.elements.size() + instanceElements.size());
+
+		for (const auto& element : batch.format.elements)
+		{
+			inputLayoutDesc.push_back(
+				{ element.semantic, element.semanticIdx, element.format, 0u, element.offset }
+			);
+		}
+		inputLayoutDesc.insert(inputLayoutDesc.end(), instanceElements.begin(), instanceElements.end());
+
+		batch.pInputLayout = stateLibrary->GetInputLayout(inputLayoutDesc, vsBytecode);
+
+		// external data goes to the buffers as it is, mapped pages included
+		const uint8_t* vertices = batch.pExternalVertices ? batch.pExternalVertices : batch.vertices.data();
+		const uint8_t* indices = batch.pExternalIndices ? batch.pExternalIndices : batch.indices.data();
+		const size_t vertexBytes = batch.vertexCount * batch.format.stride;
+		const size_t indexBytes = batch.indexCount * GetIndexSize(batch.format.indexFormat);
+
+		batch.pVertexBuffer = std::make_unique<RENDER::VertexBuffer>();
+		batch.pVertexBuffer->create(renderer, vertices, vertexBytes);
+		m_stats.vertexBytes += vertexBytes;
+
+		createPositions(renderer, stateLibrary, batch, vertices, depthVSBytecode);
+
+		batch.pIndexBuffer = std::make_unique<RENDER::IndexBuffer>(batch.format.indexFormat);
+		batch.pIndexBuffer->create(renderer, indices, indexBytes);
+		m_stats.indexBytes += indexBytes;
+
+		batch.vertices = {};
+		batch.indices = {};
+		batch.pExternalVertices = nullptr;
+		batch.pExternalIndices = nullptr;
+	}
+
+	m_stats.batches = m_batches.size();
+	m_storedRanges = {};
+	m_created = true;
+}
+
+void GeometryPool::Bind(RENDER::CommandList& commandList, uint32_t batchIdx) const
+{
+	const auto& batch = m_batches[batchIdx];
+
+	batch.pVertexBuffer->Bind(commandList, 0u, batch.format.stride, 0u);
+	batch.pIndexBuffer->Bind(commandList, 0u, 0u, 0u);
+	batch.pInputLayout->Bind(commandList);
+}
+
+void GeometryPool::BindPositions(RENDER::CommandList& commandList, uint32_t batchIdx) const
+{
+	const auto& batch = m_batches[batchIdx];
+
+	batch.pPositionBuffer->Bind(commandList, 0u, batch.positionStride, 0u);
+	batch.pIndexBuffer->Bind(commandList, 0u, 0u, 0u);
+	batch.pPositionInputLayout->Bind(commandList);
+}
+
+uint32_t GeometryPool::findBatch(const GeometryFormat& format)
+{
+	for (size_t idx = 0; idx < m_batches.size(); ++idx)
+	{
+		// external batches are complete
+		if (m_batches[idx].format == format && !m_batches[idx].pExternalVertices)
+		{
+			return static_cast<uint32_t>(idx);
+		}
+	}
+
+	auto& batch = m_batches.emplace_back();
+	batch.format = format;
+
+	return static_cast<uint32_t>(m_batches.size() - 1);
+}
+
+bool GeometryPool::isStored(const StoredRange& stored, const void* vertices, size_t vertexCount, const void* indices, size_t indexCount) const
+{
+	if (stored.vertexCount != vertexCount || stored.range.indexCount != indexCount)
+	{
+		return false;
+	}
+
+	const auto& batch = m_batches[stored.range.batch];
+	const size_t indexSize = GetIndexSize(batch.format.indexFormat);
+
+	const auto* storedVertices = batch.vertices.data() + static_cast<size_t>(stored.range.baseVertex) * batch.format.stride;
+	const auto* storedIndices = batch.indices.data() + static_cast<size_t>(stored.range.startIndex) * indexSize;
+
+	return memcmp(storedVertices, vertices, vertexCount * batch.format.stride) == 0
+		&& memcmp(storedIndices, indices, indexCount * indexSize) == 0;
+}
+
+void GeometryPool::createPositions(RENDER::Renderer* renderer, RENDER::StateLibrary* stateLibrary, Batch& batch, const uint8_t* vertices, const std::vector<uint8_t>& depthVSBytecode)
+{
+	const auto position = std::find_if(batch.format.elements.begin(), batch.format.elements.end(), [](const VertexElement& element)
+	{
+		return element.semantic == "POSITION" && element.semanticIdx == 0;
+	});
+	if (position == batch.format.elements.end() || GetPositionSize(position->format) == 0)
+	{
+		THROW_SOME_EXCEPTION(L"UNSUPPORTED POSITION FORMAT!");
+	}
+
+	batch.positionStride = GetPositionSize(position->format);
+
+	std::vector<uint8_t> positions(batch.vertexCount * batch.positionStride);
+	for (size_t vertex = 0; vertex < batch.vertexCount; ++vertex)
+	{
+		memcpy(
+			positions.data() + vertex * batch.positionStride,
+			vertices + vertex * batch.format.stride + position->offset,
+			batch.positionStride);
+	}
+
+	const std::vector<RENDER::InputElement> inputLayoutDesc =
+	{
+		{ "POSITION", 0u, position->format, 0u, 0u }
+	};
+	batch.pPositionInputLayout = stateLibrary->GetInputLayout(inputLayoutDesc, depthVSBytecode);
+
+	batch.pPositionBuffer = std::make_unique<RENDER::VertexBuffer>();
+	batch.pPositionBuffer->create(renderer, positions.data(), positions.size());
+	m_stats.positionBytes += positions.size();
+}
+
+}  // end namespace SD::ENGINE
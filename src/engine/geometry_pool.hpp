@@ -0,0 +1,147 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "command_list.hpp"
+#include "index_buffer.hpp"
+#include "input_layout.hpp"
+#include "state_library.hpp"
+#include "vertex_buffer.hpp"
+
+
+namespace SD::ENGINE {
+
+struct VertexElement
+{
+	std::string semantic;
+	uint32_t semanticIdx = 0;
+	DXGI_FORMAT format = DXGI_FORMAT_UNKNOWN;
+	uint32_t offset = 0;  // in the interleaved vertex
+
+	bool operator==(const VertexElement& other) const;
+};
+
+struct GeometryFormat
+{
+	std::vector<VertexElement> elements = {};
+	uint32_t stride = 0;
+	DXGI_FORMAT indexFormat = DXGI_FORMAT_R16_UINT;
+
+	bool operator==(const GeometryFormat& other) const;
+};
+
+// Location of a primitive inside the pool, ready for DrawIndexed.
+struct GeometryRange
+{
+	uint32_t batch = 0;
+	uint32_t indexCount = 0;
+	uint32_t startIndex = 0;
+	int32_t baseVertex = 0;
+};
+
+// CPU data of a batch, valid until the pool is created.
+struct GeometryBatchData
+{
+	const GeometryFormat* format = nullptr;
+	const uint8_t* vertices = nullptr;
+	size_t vertexCount = 0;
+	const uint8_t* indices = nullptr;
+	size_t indexCount = 0;
+};
+
+struct GeometryPoolStats
+{
+	size_t batches = 0;
+	size_t primitives = 0;
+	size_t vertices = 0;
+	size_t indices = 0;
+	size_t vertexBytes = 0;
+	size_t positionBytes = 0;
+	size_t indexBytes = 0;
+	size_t duplicates = 0;  // primitives sharing the geometry of an earlier identical one
+	size_t savedBytes = 0;  // vertex and index bytes not stored for duplicates
+};
+
+// Packs geometry of the same vertex format into shared vertex and index buffers,
+// so draws of different primitives only differ by base vertex and start index.
+// Positions are extracted into a separate stream for depth only passes.
+// Identical geometry is stored once, duplicates get the range of the first copy.
+class GeometryPool
+{
+	struct Batch
+	{
+		GeometryFormat format;
+
+		std::vector<uint8_t> vertices = {};
+		std::vector<uint8_t> indices = {};
+		size_t vertexCount = 0;
+		size_t indexCount = 0;
+
+		// data owned by someone else, used instead of the vectors
+		const uint8_t* pExternalVertices = nullptr;
+		const uint8_t* pExternalIndices = nullptr;
+
+		std::unique_ptr<RENDER::VertexBuffer> pVertexBuffer = nullptr;
+		std::unique_ptr<RENDER::IndexBuffer> pIndexBuffer = nullptr;
+		std::shared_ptr<RENDER::InputLayout> pInputLayout = nullptr;
+
+		uint32_t positionStride = 0;
+		std::unique_ptr<RENDER::VertexBuffer> pPositionBuffer = nullptr;
+		std::shared_ptr<RENDER::InputLayout> pPositionInputLayout = nullptr;
+	};
+
+	struct StoredRange
+	{
+		GeometryRange range;
+		size_t vertexCount;
+	};
+
+public:
+	GeometryPool() = default;
+	~GeometryPool() = default;
+
+	// Appends interleaved vertices and indices relative to the first of them.
+	GeometryRange Add(const GeometryFormat& format, const void* vertices, size_t vertexCount, const void* indices, size_t indexCount);
+
+	// Adds a whole batch without copying it, the data has to stay valid until Create (e.g. a mapped cooked scene).
+	// Returns the batch index, ranges in the batch are relative to its start.
+	uint32_t AddExternal(const GeometryFormat& format, const void* vertices, size_t vertexCount, const void* indices, size_t indexCount);
+
+	// Batches in index order, for cooking before Create.
+	std::vector<GeometryBatchData> GetBatches() const;
+
+	// Creates GPU buffers of all batches and drops the CPU copies, nothing can be added afterwards.
+	// Input layouts of the position streams are validated against the depth vertex shader.
+	// Instance elements (other slots) are appended to every main input layout, batches of the same format share one.
+	void Create(
+		RENDER::Renderer* renderer,
+		RENDER::StateLibrary* stateLibrary,
+		const std::vector<uint8_t>& vsBytecode,
+		const std::vector<uint8_t>& depthVSBytecode,
+		const std::vector<RENDER::InputElement>& instanceElements = {});
+
+	void Bind(RENDER::CommandList& commandList, uint32_t batch) const;
+	void BindPositions(RENDER::CommandList& commandList, uint32_t batch) const;
+
+	bool IsEmpty() const { return m_batches.empty(); }
+	const GeometryPoolStats& GetStats() const { return m_stats; }
+
+private:
+	uint32_t findBatch(const GeometryFormat& format);
+	bool isStored(const StoredRange& stored, const void* vertices, size_t vertexCount, const void* indices, size_t indexCount) const;
+	void createPositions(RENDER::Renderer* renderer, RENDER::StateLibrary* stateLibrary, Batch& batch, const uint8_t* vertices, const std::vector<uint8_t>& depthVSBytecode);
+
+private:
+	std::vector<Batch> m_batches = {};
+	bool m_created = false;
+
+	// content hash of vertices and indices, collisions are resolved by comparing the bytes
+	std::unordered_multimap<uint64_t, StoredRange> m_storedRanges = {};
+
+	GeometryPoolStats m_stats = {};
+};
+
+}  // end namespace SD::ENGINE
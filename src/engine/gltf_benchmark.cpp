@@ -0,0 +1,161 @@
+#include "gltf_benchmark.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+#include "gltf_file.hpp"
+#include "gltf_reader.hpp"
+#include "timer.hpp"
+
+#define TINYGLTF_NO_STB_IMAGE
+#define TINYGLTF_NO_STB_IMAGE_WRITE
+#define TINYGLTF_NO_EXTERNAL_IMAGE
+#define TINYGLTF_USE_CPP14
+#pragma warning( push, 0 )
+#include "tiny_gltf.h"
+#pragma warning( pop )
+
+
+namespace
+{
+constexpr size_t ITERATIONS = 5;
+constexpr size_t SYNTHETIC_NODES = 100000;
+constexpr size_t SYNTHETIC_CHILDREN = 8;
+
+// Best time of a few runs, the first one warms the file cache.
+template<typename F>
+float Measure(F&& run)
+{
+	float best = std::numeric_limits<float>::max();
+	for (size_t iteration = 0; iteration < ITERATIONS; ++iteration)
+	{
+		SD::ENGINE::Timer timer;
+		run();
+		best = std::min(best, timer.GetDelta());
+	}
+
+	return best;
+}
+
+// Node tree with transforms, every node instancing the same mesh.
+std::string GenerateSyntheticGltf(size_t nodeCount)
+{
+	std::string json;
+	json.reserve(nodeCount * 192);
+
+	json += R"({"asset":{"version":"2.0"},"scene":0,"scenes":[{"name":"Synthetic","nodes":[0]}],"nodes":[)";
+	for (size_t idx = 0; idx < nodeCount; ++idx)
+	{
+		json += idx > 0 ? "," : "";
+		json += R"({"name":"Node )" + std::to_string(idx) + R"(","mesh":0,"translation":[)";
+		json += std::to_string(idx % 100) + ".5," + std::to_string(idx / 100 % 100) + ".25," + std::to_string(idx / 10000) + ".125]";
+		json += R"(,"rotation":[0.0,0.7071068,0.0,0.7071068],"scale":[1.0,1.0,1.0])";
+
+		const size_t firstChild = idx * SYNTHETIC_CHILDREN + 1;
+		if (firstChild < nodeCount)
+		{
+			json += R"(,"children":[)";
+			for (size_t child = firstChild; child < std::min(firstChild + SYNTHETIC_CHILDREN, nodeCount); ++child)
+			{
+				json += (child > firstChild ? "," : "") + std::to_string(child);
+			}
+			json += "]";
+		}
+		json += "}";
+	}
+	json += R"(],"meshes":[{"name":"Triangle","primitives":[{"attributes":{"POSITION":0},"material":0}]}])";
+	json += R"(,"accessors":[{"componentType":5126,"count":3,"type":"VEC3","min":[0.0,0.0,0.0],"max":[1.0,1.0,0.0]}])";
+	json += R"(,"materials":[{"name":"Material","pbrMetallicRoughness":{"metallicFactor":0.0}}]})";
+
+	return json;
+}
+
+void ReportScan(const std::string& json)
+{
+	std::vector<uint32_t> indices;
+	const float scanTime = Measure([&]() { SD::ENGINE::ScanJsonStructure(json.data(), json.size(), indices); });
+
+	std::clog << "Structural scan: " << json.size() / 1024 << " KB, " << indices.size() << " positions in " << scanTime << " s ("
+		<< static_cast<float>(json.size()) / scanTime / 1e9f << " GB/s)." << std::endl;
+}
+
+void Report(const std::string& name, float nativeTime, float tinygltfTime)
+{
+	std::clog << name << ": native " << nativeTime << " s, tinygltf " << tinygltfTime << " s (x" << tinygltfTime / nativeTime << ")." << std::endl;
+}
+}  // end namespace
+
+namespace SD::ENGINE {
+
+int RunGltfBenchmark(const std::string& path)
+{
+	std::clog << "Benchmark glTF readers!" << std::endl;
+
+	// file with its buffers, as the world loads it
+	{
+		const float nativeTime = Measure([&]()
+		{
+			tinygltf::Model model;
+			std::string error;
+			std::string warning;
+			GltfFile file;
+			if (!file.Load(std::filesystem::path(path), model, error, warning) || !file.GetFallbackReason().empty())
+			{
+				std::clog << "Native reader: " << error << file.GetFallbackReason() << std::endl;
+			}
+		});
+
+		const float tinygltfTime = Measure([&]()
+		{
+			tinygltf::Model model;
+			tinygltf::TinyGLTF loader;
+			std::string error;
+			std::string warning;
+			const bool binary = std::filesystem::path(path).extension() == ".glb";
+			if (binary ? !loader.LoadBinaryFromFile(&model, &error, &warning, path) : !loader.LoadASCIIFromFile(&model, &error, &warning, path))
+			{
+				std::clog << "TinyGLTF Error: " << error << std::endl;
+			}
+		});
+
+		Report(std::filesystem::path(path).filename().string(), nativeTime, tinygltfTime);
+	}
+
+	// JSON only, tens of thousands of nodes
+	{
+		const auto json = GenerateSyntheticGltf(SYNTHETIC_NODES);
+
+		const float nativeTime = Measure([&]()
+		{
+			tinygltf::Model model;
+			std::vector<size_t> byteLengths;
+			std::string error;
+			if (!ReadGltf(json.data(), json.size(), model, byteLengths, error))
+			{
+				std::clog << "Native reader: " << error << std::endl;
+			}
+		});
+
+		const float tinygltfTime = Measure([&]()
+		{
+			tinygltf::Model model;
+			tinygltf::TinyGLTF loader;
+			std::string error;
+			std::string warning;
+			if (!loader.LoadASCIIFromString(&model, &error, &warning, json.data(), static_cast<unsigned int>(json.size()), ""))
+			{
+				std::clog << "TinyGLTF Error: " << error << std::endl;
+			}
+		});
+
+		Report("Synthetic " + std::to_string(SYNTHETIC_NODES) + " nodes", nativeTime, tinygltfTime);
+		ReportScan(json);
+	}
+
+	return 0;
+}
+
+}  // end namespace SD::ENGINE
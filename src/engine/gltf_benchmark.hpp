@@ -0,0 +1,12 @@
+#pragma once
+
+#include <string>
+
+
+namespace SD::ENGINE {
+
+// Times the native glTF reader against tinygltf on a file and on a synthetic 100k node scene, results go to the log.
+// The file is loaded with its buffers (mapped against read), the synthetic scene is parsed only.
+int RunGltfBenchmark(const std::string& path);
+
+}  // end namespace SD::ENGINE
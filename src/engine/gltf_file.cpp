@@ -0,0 +1,332 @@
+#include "gltf_file.hpp"
+
+#include <cctype>
+#include <cstring>
+
+#include "gltf_reader.hpp"
+
+#define TINYGLTF_NO_STB_IMAGE
+#define TINYGLTF_NO_STB_IMAGE_WRITE
+#define TINYGLTF_NO_EXTERNAL_IMAGE
+#define TINYGLTF_USE_CPP14
+#pragma warning( push, 0 )
+#include "json.hpp"
+#include "tiny_gltf.h"
+#pragma warning( pop )
+
+
+namespace
+{
+constexpr uint32_t GLB_MAGIC = 0x46546C67;  // glTF
+constexpr uint32_t GLB_VERSION = 2;
+constexpr uint32_t GLB_CHUNK_JSON = 0x4E4F534A;
+constexpr uint32_t GLB_CHUNK_BIN = 0x004E4942;
+
+// tinygltf requires buffer data, a mapped buffer keeps one byte of it in the model
+const std::string PLACEHOLDER_URI = "data:application/octet-stream;base64,AA==";
+
+// Images are decoded by the texture cache, tinygltf only hands over the encoded bytes of data URI images. Images in
+// buffer views are read from the mapping, the placeholder view they are given has nothing to keep.
+bool KeepImageData(
+	tinygltf::Image* image,
+	const int,
+	std::string*,
+	std::string*,
+	int,
+	int,
+	const unsigned char* bytes,
+	int size,
+	void*)
+{
+	if (image->bufferView < 0)
+	{
+		image->image.assign(bytes, bytes + size);
+		image->as_is = true;
+	}
+
+	return true;
+}
+
+uint32_t ReadUint32(const uint8_t* data)
+{
+	uint32_t value;
+	memcpy(&value, data, sizeof(value));
+	return value;
+}
+
+std::string DecodeUri(const std::string& uri)
+{
+	std::string result;
+	result.reserve(uri.size());
+
+	for (size_t idx = 0; idx < uri.size(); ++idx)
+	{
+		if (uri[idx] == '%' && idx + 2 < uri.size() && isxdigit(static_cast<unsigned char>(uri[idx + 1])) && isxdigit(static_cast<unsigned char>(uri[idx + 2])))
+		{
+			result += static_cast<char>(std::stoi(uri.substr(idx + 1, 2), nullptr, 16));
+			idx += 2;
+		}
+		else
+		{
+			result += uri[idx];
+		}
+	}
+
+	return result;
+}
+
+// Splits a GLB container into its JSON chunk and optional binary chunk.
+bool ParseGlb(const uint8_t* data, size_t size, std::string_view& json, SD::ENGINE::BufferSpan& bin, std::string& error)
+{
+	if (size < 20 || ReadUint32(data) != GLB_MAGIC || ReadUint32(data + 4) != GLB_VERSION || ReadUint32(data + 8) > size)
+	{
+		error = "Invalid GLB header";
+		return false;
+	}
+
+	size = ReadUint32(data + 8);
+
+	size_t offset = 12;
+	while (offset + 8 <= size)
+	{
+		const size_t chunkSize = ReadUint32(data + offset);
+		const uint32_t chunkType = ReadUint32(data + offset + 4);
+		offset += 8;
+
+		if (chunkSize > size - offset)
+		{
+			error = "GLB chunk is out of bounds";
+			return false;
+		}
+
+		if (chunkType == GLB_CHUNK_JSON && json.empty())
+		{
+			json = std::string_view(reinterpret_cast<const char*>(data + offset), chunkSize);
+		}
+		else if (chunkType == GLB_CHUNK_BIN && !bin.data)
+		{
+			bin = { data + offset, chunkSize };
+		}
+
+		// chunks are 4 byte aligned
+		offset += (chunkSize + 3) & ~size_t(3);
+	}
+
+	if (json.empty())
+	{
+		error = "GLB has no JSON chunk";
+		return false;
+	}
+
+	return true;
+}
+}  // end namespace
+
+namespace SD::ENGINE {
+
+bool GltfFile::Load(const std::filesystem::path& path, tinygltf::Model& model, std::string& error, std::string& warning)
+{
+	if (!std::filesystem::exists(path))
+	{
+		error = "File not found: " + path.string();
+		return false;
+	}
+
+	const auto& file = m_files.emplace_back(std::make_unique<MappedFile>(path));
+	const auto dir = std::filesystem::path(path).remove_filename();
+
+	std::string_view json;
+	BufferSpan bin;
+	if (path.extension() == ".glb")
+	{
+		if (!ParseGlb(file->GetData(), file->GetSize(), json, bin, error))
+		{
+			return false;
+		}
+	}
+	else
+	{
+		json = std::string_view(reinterpret_cast<const char*>(file->GetData()), file->GetSize());
+	}
+
+	// the native reader goes first, tinygltf reads what it leaves out
+	std::vector<size_t> byteLengths;
+	if (ReadGltf(json.data(), json.size(), model, byteLengths, m_fallbackReason))
+	{
+		m_fallbackReason.clear();
+		m_buffers.resize(model.buffers.size());
+
+		for (size_t idx = 0; idx < model.buffers.size(); ++idx)
+		{
+			if (!mapBuffer(idx, model.buffers[idx].uri, byteLengths[idx], dir, bin, error))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	model = tinygltf::Model();
+	return loadFallback(json, dir, bin, model, error, warning);
+}
+
+BufferSpan GltfFile::GetBuffer(const tinygltf::Model& model, int buffer) const
+{
+	const auto idx = static_cast<size_t>(buffer);
+	if (idx < m_buffers.size() && m_buffers[idx].data)
+	{
+		return m_buffers[idx];
+	}
+
+	const auto& data = model.buffers[idx].data;
+	return { data.data(), data.size() };
+}
+
+bool GltfFile::loadFallback(
+	std::string_view json,
+	const std::filesystem::path& dir,
+	const BufferSpan& bin,
+	tinygltf::Model& model,
+	std::string& error,
+	std::string& warning)
+{
+	auto document = nlohmann::json::parse(json.begin(), json.end(), nullptr, false);
+	if (document.is_discarded() || !document.is_object())
+	{
+		error = "Failed to parse glTF JSON";
+		return false;
+	}
+
+	// mapped buffers are replaced by placeholders, the JSON is small next to them so rewriting it is cheap
+	if (auto buffers = document.find("buffers"); buffers != document.end() && buffers->is_array())
+	{
+		m_buffers.resize(buffers->size());
+
+		for (size_t idx = 0; idx < buffers->size(); ++idx)
+		{
+			auto& buffer = (*buffers)[idx];
+			const auto uri = buffer.value("uri", std::string());
+			if (uri.rfind("data:", 0) == 0)
+			{
+				continue;
+			}
+
+			if (!mapBuffer(idx, uri, buffer.value("byteLength", size_t(0)), dir, bin, error))
+			{
+				return false;
+			}
+
+			buffer["uri"] = PLACEHOLDER_URI;
+			buffer["byteLength"] = 1;
+		}
+	}
+
+	// tinygltf hands images the bytes at their view offset, which is past the end of a placeholder, so they are given
+	// a view of a placeholder buffer of their own and get their views back once the model is loaded
+	std::vector<int> imageBufferViews;
+	int placeholderView = -1;
+	if (auto images = document.find("images"); images != document.end() && images->is_array())
+	{
+		imageBufferViews.resize(images->size(), -1);
+
+		for (size_t idx = 0; idx < images->size(); ++idx)
+		{
+			auto& image = (*images)[idx];
+			if (!image.is_object() || !image.contains("bufferView") || !image["bufferView"].is_number_integer())
+			{
+				continue;
+			}
+
+			auto& buffers = document["buffers"];
+			auto& bufferViews = document["bufferViews"];
+			if (!buffers.is_array() || !bufferViews.is_array())
+			{
+				error = "Image " + std::to_string(idx) + " has a bufferView but the file has no buffers";
+				return false;
+			}
+
+			if (placeholderView < 0)
+			{
+				placeholderView = static_cast<int>(bufferViews.size());
+				bufferViews.push_back({ { "buffer", buffers.size() }, { "byteLength", 1 } });
+				buffers.push_back({ { "uri", PLACEHOLDER_URI }, { "byteLength", 1 } });
+			}
+
+			imageBufferViews[idx] = image["bufferView"].get<int>();
+			image["bufferView"] = placeholderView;
+		}
+	}
+
+	const auto text = document.dump();
+
+	tinygltf::TinyGLTF loader;
+	loader.SetImageLoader(KeepImageData, nullptr);
+	if (!loader.LoadASCIIFromString(&model, &error, &warning, text.c_str(), static_cast<unsigned int>(text.size()), dir.string()))
+	{
+		return false;
+	}
+
+	for (size_t idx = 0; idx < imageBufferViews.size() && idx < model.images.size(); ++idx)
+	{
+		if (imageBufferViews[idx] >= 0)
+		{
+			model.images[idx].bufferView = imageBufferViews[idx];
+		}
+	}
+
+	return true;
+}
+
+bool GltfFile::mapBuffer(
+	size_t idx,
+	const std::string& uri,
+	size_t byteLength,
+	const std::filesystem::path& dir,
+	const BufferSpan& bin,
+	std::string& error)
+{
+	BufferSpan span;
+	if (uri.empty())
+	{
+		// GLB binary chunk, padded to 4 bytes
+		span = idx == 0 ? bin : BufferSpan();
+	}
+	else
+	{
+		const auto bufferName = DecodeUri(uri);
+		const auto bufferPath = dir / std::filesystem::u8path(bufferName);
+		if (!std::filesystem::exists(bufferPath))
+		{
+			error = "Buffer file not found: " + uri;
+			return false;
+		}
+
+		m_bufferFiles.push_back(bufferName);
+
+		const auto& bufferFile = m_files.emplace_back(std::make_unique<MappedFile>(bufferPath));
+		span = { bufferFile->GetData(), bufferFile->GetSize() };
+	}
+
+	if (!span.data || span.size < byteLength)
+	{
+		error = "Buffer " + std::to_string(idx) + " is smaller than its byteLength";
+		return false;
+	}
+
+	m_buffers[idx] = { span.data, byteLength };
+	return true;
+}
+
+size_t GltfFile::GetMappedSize() const
+{
+	size_t size = 0;
+	for (const auto& buffer : m_buffers)
+	{
+		size += buffer.size;
+	}
+
+	return size;
+}
+
+}  // end namespace SD::ENGINE
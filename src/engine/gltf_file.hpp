@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "mapped_file.hpp"
+
+
+namespace tinygltf
+{
+class Model;
+}
+
+namespace SD::ENGINE {
+
+struct BufferSpan
+{
+	const uint8_t* data = nullptr;
+	size_t size = 0;
+};
+
+// glTF or GLB file whose external .bin buffers and GLB binary chunk are mapped to memory instead of being read into
+// tinygltf::Buffer::data, so load keeps a single (file backed) copy of them. The JSON is read by the native reader,
+// files it does not read go to tinygltf with mapped buffers replaced by a placeholder byte.
+class GltfFile
+{
+public:
+	GltfFile() = default;
+	~GltfFile() = default;
+
+	GltfFile(const GltfFile&) = delete;
+	GltfFile& operator=(const GltfFile&) = delete;
+
+	// Returns false and fills the error if the file could not be parsed.
+	bool Load(const std::filesystem::path& path, tinygltf::Model& model, std::string& error, std::string& warning);
+
+	// Bytes of a model buffer, mapped or held by the model (data URIs, decoded and generated buffers).
+	BufferSpan GetBuffer(const tinygltf::Model& model, int buffer) const;
+	// Encoded bytes of an image in a buffer view or a data URI, empty for images in files of their own.
+	BufferSpan GetImage(const tinygltf::Model& model, int image) const;
+
+	size_t GetMappedSize() const;
+
+	// External buffer files relative to the glTF (UTF-8), in buffer order.
+	const std::vector<std::string>& GetBufferFiles() const { return m_bufferFiles; }
+
+	// Why the native reader gave the file to tinygltf, empty if it did not.
+	const std::string& GetFallbackReason() const { return m_fallbackReason; }
+
+private:
+	bool loadFallback(
+		std::string_view json,
+		const std::filesystem::path& dir,
+		const BufferSpan& bin,
+		tinygltf::Model& model,
+		std::string& error,
+		std::string& warning);
+
+	bool mapBuffer(
+		size_t idx,
+		const std::string& uri,
+		size_t byteLength,
+		const std::filesystem::path& dir,
+		const BufferSpan& bin,
+		std::string& error);
+
+private:
+	std::vector<std::unique_ptr<MappedFile>> m_files = {};
+	std::vector<BufferSpan> m_buffers = {};  // per buffer of the file, empty ones are held by the model
+	std::vector<std::string> m_bufferFiles = {};
+	std::string m_fallbackReason = {};
+};
+
+}  // end namespace SD::ENGINE
@@ -0,0 +1,850 @@
+#include "gltf_reader.hpp"
+
+#include <emmintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#include <charconv>
+#include <cstring>
+#include <limits>
+#include <string_view>
+#include <unordered_map>
+
+#define TINYGLTF_NO_STB_IMAGE
+#define TINYGLTF_NO_STB_IMAGE_WRITE
+#define TINYGLTF_NO_EXTERNAL_IMAGE
+#define TINYGLTF_USE_CPP14
+#pragma warning( push, 0 )
+#include "tiny_gltf.h"
+#pragma warning( pop )
+
+
+namespace
+{
+constexpr size_t BLOCK_SIZE = 64;
+
+uint32_t TrailingZeros(uint64_t mask)
+{
+#if defined(_MSC_VER)
+	unsigned long idx;
+	_BitScanForward64(&idx, mask);
+	return static_cast<uint32_t>(idx);
+#else
+	return static_cast<uint32_t>(__builtin_ctzll(mask));
+#endif
+}
+
+// Bits from every quote up to the next one, the opening quote included.
+uint64_t PrefixXor(uint64_t mask)
+{
+	mask ^= mask << 1;
+	mask ^= mask << 2;
+	mask ^= mask << 4;
+	mask ^= mask << 8;
+	mask ^= mask << 16;
+	mask ^= mask << 32;
+	return mask;
+}
+
+// A backslash escapes the next character unless it is escaped itself, the carry crosses blocks.
+uint64_t FindEscaped(uint64_t backslash, bool& carry)
+{
+	uint64_t escaped = 0;
+	if (carry)
+	{
+		escaped |= 1;
+		backslash &= ~uint64_t(1);
+	}
+
+	carry = false;
+	while (backslash)
+	{
+		const uint32_t bit = TrailingZeros(backslash);
+		if (bit == BLOCK_SIZE - 1)
+		{
+			carry = true;
+			backslash &= ~(uint64_t(1) << bit);
+		}
+		else
+		{
+			escaped |= uint64_t(2) << bit;
+			backslash &= ~(uint64_t(3) << bit);
+		}
+	}
+
+	return escaped;
+}
+
+uint64_t Match(const __m128i (&chunks)[4], char c)
+{
+	const __m128i value = _mm_set1_epi8(c);
+
+	uint64_t mask = 0;
+	for (uint32_t idx = 0; idx < 4; ++idx)
+	{
+		const auto bits = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunks[idx], value)));
+		mask |= static_cast<uint64_t>(bits) << (idx * 16);
+	}
+
+	return mask;
+}
+
+struct ReadError
+{
+	std::string reason;
+};
+
+// Pull parser over the structural positions, every Read consumes one value.
+class JsonCursor
+{
+public:
+	JsonCursor(const char* json, size_t size, const std::vector<uint32_t>& indices)
+		: m_json(json)
+		, m_size(size)
+		, m_indices(indices)
+	{
+	}
+
+	// Character of the current position, zero at the end.
+	char Peek() const
+	{
+		return IsEnd() ? '\0' : m_json[m_indices[m_pos]];
+	}
+
+	bool IsEnd() const
+	{
+		return m_pos + 1 >= m_indices.size();
+	}
+
+	template<typename F>
+	void ReadObject(F&& member)
+	{
+		expect('{');
+		if (Peek() == '}')
+		{
+			m_pos++;
+			return;
+		}
+
+		while (true)
+		{
+			if (Peek() != '"')
+			{
+				Fail("object key expected");
+			}
+			const auto key = readStringView();
+			expect(':');
+
+			member(key);
+
+			if (Peek() == ',')
+			{
+				m_pos++;
+				continue;
+			}
+			expect('}');
+			return;
+		}
+	}
+
+	template<typename F>
+	void ReadArray(F&& element)
+	{
+		expect('[');
+		if (Peek() == ']')
+		{
+			m_pos++;
+			return;
+		}
+
+		while (true)
+		{
+			element();
+
+			if (Peek() == ',')
+			{
+				m_pos++;
+				continue;
+			}
+			expect(']');
+			return;
+		}
+	}
+
+	std::string ReadString()
+	{
+		if (Peek() != '"')
+		{
+			Fail("string expected");
+		}
+
+		const auto raw = readStringView();
+		if (raw.find('\\') == std::string_view::npos)
+		{
+			return std::string(raw);
+		}
+
+		return unescape(raw);
+	}
+
+	double ReadNumber()
+	{
+		if (IsEnd())
+		{
+			Fail("number expected");
+		}
+
+		const char* first = m_json + m_indices[m_pos];
+		const char* last = m_json + m_indices[m_pos + 1];
+
+		double value = 0.0;
+		const auto result = std::from_chars(first, last, value);
+		if (result.ec != std::errc())
+		{
+			Fail("number expected");
+		}
+
+		m_pos++;
+		return value;
+	}
+
+	int ReadInt()
+	{
+		const double value = ReadNumber();
+		if (value != static_cast<double>(static_cast<int>(value)))
+		{
+			Fail("integer expected");
+		}
+
+		return static_cast<int>(value);
+	}
+
+	size_t ReadSize()
+	{
+		const double value = ReadNumber();
+		if (value < 0.0 || value != static_cast<double>(static_cast<size_t>(value)))
+		{
+			Fail("non-negative integer expected");
+		}
+
+		return static_cast<size_t>(value);
+	}
+
+	bool ReadBool()
+	{
+		if (matchLiteral("true"))
+		{
+			return true;
+		}
+		if (matchLiteral("false"))
+		{
+			return false;
+		}
+
+		Fail("boolean expected");
+		return false;
+	}
+
+	std::vector<double> ReadNumbers()
+	{
+		std::vector<double> values;
+		ReadArray([&]() { values.push_back(ReadNumber()); });
+		return values;
+	}
+
+	std::vector<int> ReadInts()
+	{
+		std::vector<int> values;
+		ReadArray([&]() { values.push_back(ReadInt()); });
+		return values;
+	}
+
+	std::vector<std::string> ReadStrings()
+	{
+		std::vector<std::string> values;
+		ReadArray([&]() { values.push_back(ReadString()); });
+		return values;
+	}
+
+	// Any value as a tinygltf one, for extras and extensions.
+	tinygltf::Value ReadValue()
+	{
+		if (IsEnd())
+		{
+			Fail("value expected");
+		}
+
+		switch (Peek())
+		{
+		case '{':
+		{
+			tinygltf::Value::Object object;
+			ReadObject([&](std::string_view key) { object[std::string(key)] = ReadValue(); });
+			return tinygltf::Value(std::move(object));
+		}
+		case '[':
+		{
+			tinygltf::Value::Array array;
+			ReadArray([&]() { array.push_back(ReadValue()); });
+			return tinygltf::Value(std::move(array));
+		}
+		case '"':
+			return tinygltf::Value(ReadString());
+		case 't':
+		case 'f':
+			return tinygltf::Value(ReadBool());
+		case 'n':
+			if (!matchLiteral("null"))
+			{
+				Fail("null expected");
+			}
+			return tinygltf::Value();
+		default:
+		{
+			// integers stay integers, as tinygltf keeps them
+			const std::string_view token(m_json + m_indices[m_pos], m_indices[m_pos + 1] - m_indices[m_pos]);
+			const bool real = token.find_first_of(".eE") != std::string_view::npos;
+			const double value = ReadNumber();
+			if (real || value < std::numeric_limits<int>::min() || value > std::numeric_limits<int>::max())
+			{
+				return tinygltf::Value(value);
+			}
+			return tinygltf::Value(static_cast<int>(value));
+		}
+		}
+	}
+
+	// Skips a value, containers are skipped by their brackets only.
+	void Skip()
+	{
+		if (IsEnd())
+		{
+			Fail("value expected");
+		}
+
+		const char c = Peek();
+		if (c != '{' && c != '[')
+		{
+			m_pos++;
+			return;
+		}
+
+		size_t depth = 0;
+		do
+		{
+			if (IsEnd())
+			{
+				Fail("unterminated container");
+			}
+
+			switch (Peek())
+			{
+			case '{':
+			case '[':
+				depth++;
+				break;
+			case '}':
+			case ']':
+				depth--;
+				break;
+			default:
+				break;
+			}
+			m_pos++;
+		} while (depth > 0);
+	}
+
+	[[noreturn]] void Fail(const std::string& reason) const
+	{
+		throw ReadError{ reason + " at " + std::to_string(IsEnd() ? m_size : m_indices[m_pos]) };
+	}
+
+private:
+	void expect(char c)
+	{
+		if (IsEnd() || Peek() != c)
+		{
+			Fail(std::string("'") + c + "' expected");
+		}
+		m_pos++;
+	}
+
+	bool matchLiteral(std::string_view literal)
+	{
+		const size_t start = m_indices[m_pos];
+		if (m_size - start < literal.size() || memcmp(m_json + start, literal.data(), literal.size()) != 0)
+		{
+			return false;
+		}
+
+		m_pos++;
+		return true;
+	}
+
+	// String contents between the quotes, escapes are left as they are.
+	std::string_view readStringView()
+	{
+		const size_t start = m_indices[m_pos] + 1;
+
+		size_t end = start;
+		while (end < m_size && m_json[end] != '"')
+		{
+			end += m_json[end] == '\\' ? 2 : 1;
+		}
+		if (end >= m_size)
+		{
+			Fail("unterminated string");
+		}
+
+		m_pos++;
+		return std::string_view(m_json + start, end - start);
+	}
+
+	std::string unescape(std::string_view raw) const
+	{
+		std::string result;
+		result.reserve(raw.size());
+
+		for (size_t idx = 0; idx < raw.size(); ++idx)
+		{
+			if (raw[idx] != '\\')
+			{
+				result += raw[idx];
+				continue;
+			}
+
+			if (++idx >= raw.size())
+			{
+				Fail("invalid escape");
+			}
+
+			switch (raw[idx])
+			{
+			case 'b':
+				result += '\b';
+				break;
+			case 'f':
+				result += '\f';
+				break;
+			case 'n':
+				result += '\n';
+				break;
+			case 'r':
+				result += '\r';
+				break;
+			case 't':
+				result += '\t';
+				break;
+			case 'u':
+			{
+				uint32_t code = 0;
+				if (idx + 4 >= raw.size() || std::from_chars(raw.data() + idx + 1, raw.data() + idx + 5, code, 16).ptr != raw.data() + idx + 5)
+				{
+					Fail("invalid unicode escape");
+				}
+				idx += 4;
+
+				// surrogate pairs are not combined, glTF names and URIs hardly need them
+				if (code < 0x80)
+				{
+					result += static_cast<char>(code);
+				}
+				else if (code < 0x800)
+				{
+					result += static_cast<char>(0xC0 | (code >> 6));
+					result += static_cast<char>(0x80 | (code & 0x3F));
+				}
+				else
+				{
+					result += static_cast<char>(0xE0 | (code >> 12));
+					result += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+					result += static_cast<char>(0x80 | (code & 0x3F));
+				}
+				break;
+			}
+			default:
+				result += raw[idx];
+				break;
+			}
+		}
+
+		return result;
+	}
+
+private:
+	const char* m_json;
+	size_t m_size;
+	const std::vector<uint32_t>& m_indices;
+	size_t m_pos = 0;
+};
+
+// Property readers of a glTF object type, unknown properties are skipped.
+template<typename T>
+using Properties = std::unordered_map<std::string_view, void(*)(JsonCursor&, T&)>;
+
+template<typename T>
+void ReadProperties(JsonCursor& cursor, T& object, const Properties<T>& properties)
+{
+	cursor.ReadObject([&](std::string_view key)
+	{
+		if (const auto it = properties.find(key); it != properties.end())
+		{
+			it->second(cursor, object);
+		}
+		else
+		{
+			cursor.Skip();
+		}
+	});
+}
+
+template<typename T>
+void ReadObjects(JsonCursor& cursor, std::vector<T>& objects, const Properties<T>& properties)
+{
+	cursor.ReadArray([&]() { ReadProperties(cursor, objects.emplace_back(), properties); });
+}
+
+// Properties of an extension only, other extensions are skipped.
+template<typename T>
+void ReadExtension(JsonCursor& cursor, T& object, std::string_view name, const Properties<T>& properties)
+{
+	cursor.ReadObject([&](std::string_view extension)
+	{
+		if (extension == name)
+		{
+			ReadProperties(cursor, object, properties);
+		}
+		else
+		{
+			cursor.Skip();
+		}
+	});
+}
+
+const std::unordered_map<std::string_view, int> ACCESSOR_TYPES_MAP = {
+	{"SCALAR", TINYGLTF_TYPE_SCALAR},
+	{"VEC2", TINYGLTF_TYPE_VEC2},
+	{"VEC3", TINYGLTF_TYPE_VEC3},
+	{"VEC4", TINYGLTF_TYPE_VEC4},
+	{"MAT2", TINYGLTF_TYPE_MAT2},
+	{"MAT3", TINYGLTF_TYPE_MAT3},
+	{"MAT4", TINYGLTF_TYPE_MAT4},
+};
+
+const Properties<tinygltf::TextureInfo> TEXTURE_INFO_PROPERTIES = {
+	{"index", [](JsonCursor& cursor, tinygltf::TextureInfo& info) { info.index = cursor.ReadInt(); }},
+	{"texCoord", [](JsonCursor& cursor, tinygltf::TextureInfo& info) { info.texCoord = cursor.ReadInt(); }},
+};
+
+const Properties<tinygltf::NormalTextureInfo> NORMAL_TEXTURE_INFO_PROPERTIES = {
+	{"index", [](JsonCursor& cursor, tinygltf::NormalTextureInfo& info) { info.index = cursor.ReadInt(); }},
+	{"texCoord", [](JsonCursor& cursor, tinygltf::NormalTextureInfo& info) { info.texCoord = cursor.ReadInt(); }},
+	{"scale", [](JsonCursor& cursor, tinygltf::NormalTextureInfo& info) { info.scale = cursor.ReadNumber(); }},
+};
+
+const Properties<tinygltf::OcclusionTextureInfo> OCCLUSION_TEXTURE_INFO_PROPERTIES = {
+	{"index", [](JsonCursor& cursor, tinygltf::OcclusionTextureInfo& info) { info.index = cursor.ReadInt(); }},
+	{"texCoord", [](JsonCursor& cursor, tinygltf::OcclusionTextureInfo& info) { info.texCoord = cursor.ReadInt(); }},
+	{"strength", [](JsonCursor& cursor, tinygltf::OcclusionTextureInfo& info) { info.strength = cursor.ReadNumber(); }},
+};
+
+const Properties<tinygltf::PbrMetallicRoughness> PBR_PROPERTIES = {
+	{"baseColorFactor", [](JsonCursor& cursor, tinygltf::PbrMetallicRoughness& pbr) { pbr.baseColorFactor = cursor.ReadNumbers(); }},
+	{"metallicFactor", [](JsonCursor& cursor, tinygltf::PbrMetallicRoughness& pbr) { pbr.metallicFactor = cursor.ReadNumber(); }},
+	{"roughnessFactor", [](JsonCursor& cursor, tinygltf::PbrMetallicRoughness& pbr) { pbr.roughnessFactor = cursor.ReadNumber(); }},
+	{"baseColorTexture", [](JsonCursor& cursor, tinygltf::PbrMetallicRoughness& pbr)
+	{
+		ReadProperties(cursor, pbr.baseColorTexture, TEXTURE_INFO_PROPERTIES);
+	}},
+	{"metallicRoughnessTexture", [](JsonCursor& cursor, tinygltf::PbrMetallicRoughness& pbr)
+	{
+		ReadProperties(cursor, pbr.metallicRoughnessTexture, TEXTURE_INFO_PROPERTIES);
+	}},
+};
+
+const Properties<tinygltf::Material> MATERIAL_PROPERTIES = {
+	{"name", [](JsonCursor& cursor, tinygltf::Material& material) { material.name = cursor.ReadString(); }},
+	{"alphaMode", [](JsonCursor& cursor, tinygltf::Material& material) { material.alphaMode = cursor.ReadString(); }},
+	{"alphaCutoff", [](JsonCursor& cursor, tinygltf::Material& material) { material.alphaCutoff = cursor.ReadNumber(); }},
+	{"doubleSided", [](JsonCursor& cursor, tinygltf::Material& material) { material.doubleSided = cursor.ReadBool(); }},
+	{"emissiveFactor", [](JsonCursor& cursor, tinygltf::Material& material) { material.emissiveFactor = cursor.ReadNumbers(); }},
+	{"extras", [](JsonCursor& cursor, tinygltf::Material& material) { material.extras = cursor.ReadValue(); }},
+	{"pbrMetallicRoughness", [](JsonCursor& cursor, tinygltf::Material& material)
+	{
+		ReadProperties(cursor, material.pbrMetallicRoughness, PBR_PROPERTIES);
+	}},
+	{"normalTexture", [](JsonCursor& cursor, tinygltf::Material& material)
+	{
+		ReadProperties(cursor, material.normalTexture, NORMAL_TEXTURE_INFO_PROPERTIES);
+	}},
+	{"occlusionTexture", [](JsonCursor& cursor, tinygltf::Material& material)
+	{
+		ReadProperties(cursor, material.occlusionTexture, OCCLUSION_TEXTURE_INFO_PROPERTIES);
+	}},
+	{"emissiveTexture", [](JsonCursor& cursor, tinygltf::Material& material)
+	{
+		ReadProperties(cursor, material.emissiveTexture, TEXTURE_INFO_PROPERTIES);
+	}},
+};
+
+const Properties<tinygltf::Accessor> ACCESSOR_PROPERTIES = {
+	{"name", [](JsonCursor& cursor, tinygltf::Accessor& accessor) { accessor.name = cursor.ReadString(); }},
+	{"bufferView", [](JsonCursor& cursor, tinygltf::Accessor& accessor) { accessor.bufferView = cursor.ReadInt(); }},
+	{"byteOffset", [](JsonCursor& cursor, tinygltf::Accessor& accessor) { accessor.byteOffset = cursor.ReadSize(); }},
+	{"componentType", [](JsonCursor& cursor, tinygltf::Accessor& accessor) { accessor.componentType = cursor.ReadInt(); }},
+	{"normalized", [](JsonCursor& cursor, tinygltf::Accessor& accessor) { accessor.normalized = cursor.ReadBool(); }},
+	{"count", [](JsonCursor& cursor, tinygltf::Accessor& accessor) { accessor.count = cursor.ReadSize(); }},
+	{"min", [](JsonCursor& cursor, tinygltf::Accessor& accessor) { accessor.minValues = cursor.ReadNumbers(); }},
+	{"max", [](JsonCursor& cursor, tinygltf::Accessor& accessor) { accessor.maxValues = cursor.ReadNumbers(); }},
+	{"sparse", [](JsonCursor& cursor, tinygltf::Accessor&) { cursor.Fail("sparse accessors are read by tinygltf"); }},
+	{"type", [](JsonCursor& cursor, tinygltf::Accessor& accessor)
+	{
+		const auto type = ACCESSOR_TYPES_MAP.find(cursor.ReadString());
+		accessor.type = type != ACCESSOR_TYPES_MAP.end() ? type->second : -1;
+	}},
+};
+
+const Properties<tinygltf::BufferView> BUFFER_VIEW_PROPERTIES = {
+	{"name", [](JsonCursor& cursor, tinygltf::BufferView& bufferView) { bufferView.name = cursor.ReadString(); }},
+	{"buffer", [](JsonCursor& cursor, tinygltf::BufferView& bufferView) { bufferView.buffer = cursor.ReadInt(); }},
+	{"byteOffset", [](JsonCursor& cursor, tinygltf::BufferView& bufferView) { bufferView.byteOffset = cursor.ReadSize(); }},
+	{"byteLength", [](JsonCursor& cursor, tinygltf::BufferView& bufferView) { bufferView.byteLength = cursor.ReadSize(); }},
+	{"byteStride", [](JsonCursor& cursor, tinygltf::BufferView& bufferView) { bufferView.byteStride = cursor.ReadSize(); }},
+	{"target", [](JsonCursor& cursor, tinygltf::BufferView& bufferView) { bufferView.target = cursor.ReadInt(); }},
+	{"extensions", [](JsonCursor& cursor, tinygltf::BufferView& bufferView)
+	{
+		cursor.ReadObject([&](std::string_view name) { bufferView.extensions[std::string(name)] = cursor.ReadValue(); });
+	}},
+};
+
+// buffers are not loaded, the byte length is kept to check the mapped data against
+struct BufferRecord
+{
+	tinygltf::Buffer buffer;
+	size_t byteLength = 0;
+};
+
+const Properties<BufferRecord> BUFFER_PROPERTIES = {
+	{"name", [](JsonCursor& cursor, BufferRecord& record) { record.buffer.name = cursor.ReadString(); }},
+	{"byteLength", [](JsonCursor& cursor, BufferRecord& record) { record.byteLength = cursor.ReadSize(); }},
+	{"uri", [](JsonCursor& cursor, BufferRecord& record)
+	{
+		record.buffer.uri = cursor.ReadString();
+		if (record.buffer.uri.rfind("data:", 0) == 0)
+		{
+			cursor.Fail("data URI buffers are read by tinygltf");
+		}
+	}},
+};
+
+const Properties<tinygltf::Primitive> PRIMITIVE_PROPERTIES = {
+	{"indices", [](JsonCursor& cursor, tinygltf::Primitive& primitive) { primitive.indices = cursor.ReadInt(); }},
+	{"material", [](JsonCursor& cursor, tinygltf::Primitive& primitive) { primitive.material = cursor.ReadInt(); }},
+	{"mode", [](JsonCursor& cursor, tinygltf::Primitive& primitive) { primitive.mode = cursor.ReadInt(); }},
+	{"extras", [](JsonCursor& cursor, tinygltf::Primitive& primitive) { primitive.extras = cursor.ReadValue(); }},
+	{"attributes", [](JsonCursor& cursor, tinygltf::Primitive& primitive)
+	{
+		cursor.ReadObject([&](std::string_view name) { primitive.attributes[std::string(name)] = cursor.ReadInt(); });
+	}},
+};
+
+const Properties<tinygltf::Mesh> MESH_PROPERTIES = {
+	{"name", [](JsonCursor& cursor, tinygltf::Mesh& mesh) { mesh.name = cursor.ReadString(); }},
+	{"primitives", [](JsonCursor& cursor, tinygltf::Mesh& mesh) { ReadObjects(cursor, mesh.primitives, PRIMITIVE_PROPERTIES); }},
+	{"extras", [](JsonCursor& cursor, tinygltf::Mesh& mesh) { mesh.extras = cursor.ReadValue(); }},
+};
+
+const Properties<tinygltf::Node> NODE_LIGHT_PROPERTIES = {
+	{"light", [](JsonCursor& cursor, tinygltf::Node& node) { node.light = cursor.ReadInt(); }},
+};
+
+const Properties<tinygltf::Node> NODE_PROPERTIES = {
+	{"name", [](JsonCursor& cursor, tinygltf::Node& node) { node.name = cursor.ReadString(); }},
+	{"mesh", [](JsonCursor& cursor, tinygltf::Node& node) { node.mesh = cursor.ReadInt(); }},
+	{"children", [](JsonCursor& cursor, tinygltf::Node& node) { node.children = cursor.ReadInts(); }},
+	{"matrix", [](JsonCursor& cursor, tinygltf::Node& node) { node.matrix = cursor.ReadNumbers(); }},
+	{"rotation", [](JsonCursor& cursor, tinygltf::Node& node) { node.rotation = cursor.ReadNumbers(); }},
+	{"scale", [](JsonCursor& cursor, tinygltf::Node& node) { node.scale = cursor.ReadNumbers(); }},
+	{"translation", [](JsonCursor& cursor, tinygltf::Node& node) { node.translation = cursor.ReadNumbers(); }},
+	{"extras", [](JsonCursor& cursor, tinygltf::Node& node) { node.extras = cursor.ReadValue(); }},
+	{"extensions", [](JsonCursor& cursor, tinygltf::Node& node)
+	{
+		ReadExtension(cursor, node, "KHR_lights_punctual", NODE_LIGHT_PROPERTIES);
+	}},
+};
+
+const Properties<tinygltf::Scene> SCENE_PROPERTIES = {
+	{"name", [](JsonCursor& cursor, tinygltf::Scene& scene) { scene.name = cursor.ReadString(); }},
+	{"nodes", [](JsonCursor& cursor, tinygltf::Scene& scene) { scene.nodes = cursor.ReadInts(); }},
+};
+
+const Properties<tinygltf::Image> IMAGE_PROPERTIES = {
+	{"name", [](JsonCursor& cursor, tinygltf::Image& image) { image.name = cursor.ReadString(); }},
+	{"uri", [](JsonCursor& cursor, tinygltf::Image& image) { image.uri = cursor.ReadString(); }},
+	{"mimeType", [](JsonCursor& cursor, tinygltf::Image& image) { image.mimeType = cursor.ReadString(); }},
+	{"bufferView", [](JsonCursor& cursor, tinygltf::Image& image) { image.bufferView = cursor.ReadInt(); }},
+};
+
+const Properties<tinygltf::Texture> TEXTURE_PROPERTIES = {
+	{"name", [](JsonCursor& cursor, tinygltf::Texture& texture) { texture.name = cursor.ReadString(); }},
+	{"source", [](JsonCursor& cursor, tinygltf::Texture& texture) { texture.source = cursor.ReadInt(); }},
+	{"sampler", [](JsonCursor& cursor, tinygltf::Texture& texture) { texture.sampler = cursor.ReadInt(); }},
+};
+
+const Properties<tinygltf::Sampler> SAMPLER_PROPERTIES = {
+	{"name", [](JsonCursor& cursor, tinygltf::Sampler& sampler) { sampler.name = cursor.ReadString(); }},
+	{"minFilter", [](JsonCursor& cursor, tinygltf::Sampler& sampler) { sampler.minFilter = cursor.ReadInt(); }},
+	{"magFilter", [](JsonCursor& cursor, tinygltf::Sampler& sampler) { sampler.magFilter = cursor.ReadInt(); }},
+	{"wrapS", [](JsonCursor& cursor, tinygltf::Sampler& sampler) { sampler.wrapS = cursor.ReadInt(); }},
+	{"wrapT", [](JsonCursor& cursor, tinygltf::Sampler& sampler) { sampler.wrapT = cursor.ReadInt(); }},
+};
+
+// color defaults to white, the reader starts every light with it
+const Properties<tinygltf::Light> LIGHT_PROPERTIES = {
+	{"name", [](JsonCursor& cursor, tinygltf::Light& light) { light.name = cursor.ReadString(); }},
+	{"type", [](JsonCursor& cursor, tinygltf::Light& light) { light.type = cursor.ReadString(); }},
+	{"color", [](JsonCursor& cursor, tinygltf::Light& light) { light.color = cursor.ReadNumbers(); }},
+	{"intensity", [](JsonCursor& cursor, tinygltf::Light& light) { light.intensity = cursor.ReadNumber(); }},
+	{"range", [](JsonCursor& cursor, tinygltf::Light& light) { light.range = cursor.ReadNumber(); }},
+};
+
+struct ModelRecord
+{
+	tinygltf::Model& model;
+	std::vector<BufferRecord> buffers;
+};
+
+const Properties<ModelRecord> MODEL_LIGHTS_PROPERTIES = {
+	{"lights", [](JsonCursor& cursor, ModelRecord& record)
+	{
+		cursor.ReadArray([&]()
+		{
+			auto& light = record.model.lights.emplace_back();
+			light.color = { 1.0, 1.0, 1.0 };
+			ReadProperties(cursor, light, LIGHT_PROPERTIES);
+		});
+	}},
+};
+
+const Properties<ModelRecord> MODEL_PROPERTIES = {
+	{"scene", [](JsonCursor& cursor, ModelRecord& record) { record.model.defaultScene = cursor.ReadInt(); }},
+	{"extensionsUsed", [](JsonCursor& cursor, ModelRecord& record) { record.model.extensionsUsed = cursor.ReadStrings(); }},
+	{"extensionsRequired", [](JsonCursor& cursor, ModelRecord& record) { record.model.extensionsRequired = cursor.ReadStrings(); }},
+	{"extras", [](JsonCursor& cursor, ModelRecord& record) { record.model.extras = cursor.ReadValue(); }},
+	{"accessors", [](JsonCursor& cursor, ModelRecord& record) { ReadObjects(cursor, record.model.accessors, ACCESSOR_PROPERTIES); }},
+	{"bufferViews", [](JsonCursor& cursor, ModelRecord& record) { ReadObjects(cursor, record.model.bufferViews, BUFFER_VIEW_PROPERTIES); }},
+	{"buffers", [](JsonCursor& cursor, ModelRecord& record) { ReadObjects(cursor, record.buffers, BUFFER_PROPERTIES); }},
+	{"meshes", [](JsonCursor& cursor, ModelRecord& record) { ReadObjects(cursor, record.model.meshes, MESH_PROPERTIES); }},
+	{"nodes", [](JsonCursor& cursor, ModelRecord& record) { ReadObjects(cursor, record.model.nodes, NODE_PROPERTIES); }},
+	{"scenes", [](JsonCursor& cursor, ModelRecord& record) { ReadObjects(cursor, record.model.scenes, SCENE_PROPERTIES); }},
+	{"materials", [](JsonCursor& cursor, ModelRecord& record) { ReadObjects(cursor, record.model.materials, MATERIAL_PROPERTIES); }},
+	{"images", [](JsonCursor& cursor, ModelRecord& record) { ReadObjects(cursor, record.model.images, IMAGE_PROPERTIES); }},
+	{"textures", [](JsonCursor& cursor, ModelRecord& record) { ReadObjects(cursor, record.model.textures, TEXTURE_PROPERTIES); }},
+	{"samplers", [](JsonCursor& cursor, ModelRecord& record) { ReadObjects(cursor, record.model.samplers, SAMPLER_PROPERTIES); }},
+	{"extensions", [](JsonCursor& cursor, ModelRecord& record)
+	{
+		ReadExtension(cursor, record, "KHR_lights_punctual", MODEL_LIGHTS_PROPERTIES);
+	}},
+};
+}  // end namespace
+
+namespace SD::ENGINE {
+
+bool ScanJsonStructure(const char* json, size_t size, std::vector<uint32_t>& indices)
+{
+	indices.clear();
+	indices.reserve(size / 8);
+
+	bool escapeCarry = false;
+	uint64_t stringCarry = 0;  // all ones inside a string
+	uint64_t scalarCarry = 0;
+
+	for (size_t offset = 0; offset < size; offset += BLOCK_SIZE)
+	{
+		// the tail is padded with whitespace
+		alignas(16) char tail[BLOCK_SIZE];
+		const char* block = json + offset;
+		if (size - offset < BLOCK_SIZE)
+		{
+			memset(tail, ' ', BLOCK_SIZE);
+			memcpy(tail, block, size - offset);
+			block = tail;
+		}
+
+		__m128i chunks[4];
+		for (uint32_t idx = 0; idx < 4; ++idx)
+		{
+			chunks[idx] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + idx * 16));
+		}
+
+		const uint64_t escaped = FindEscaped(Match(chunks, '\\'), escapeCarry);
+		const uint64_t quotes = Match(chunks, '"') & ~escaped;
+		const uint64_t inside = PrefixXor(quotes) ^ stringCarry;
+		stringCarry = 0 - (inside >> 63);
+
+		const uint64_t operators = (Match(chunks, '{') | Match(chunks, '}') | Match(chunks, '[') | Match(chunks, ']')
+			| Match(chunks, ':') | Match(chunks, ',')) & ~inside;
+		const uint64_t whitespace = Match(chunks, ' ') | Match(chunks, '\n') | Match(chunks, '\r') | Match(chunks, '\t');
+
+		// first characters of numbers and literals
+		const uint64_t scalars = ~(operators | whitespace | quotes | inside);
+		const uint64_t scalarStarts = scalars & ~((scalars << 1) | scalarCarry);
+		scalarCarry = scalars >> 63;
+
+		uint64_t structurals = operators | (quotes & inside) | scalarStarts;
+		while (structurals)
+		{
+			indices.push_back(static_cast<uint32_t>(offset + TrailingZeros(structurals)));
+			structurals &= structurals - 1;
+		}
+	}
+
+	indices.push_back(static_cast<uint32_t>(size));
+
+	return stringCarry == 0;
+}
+
+bool ReadGltf(const char* json, size_t size, tinygltf::Model& model, std::vector<size_t>& byteLengths, std::string& error)
+{
+	if (size >= std::numeric_limits<uint32_t>::max())
+	{
+		error = "JSON is too large";
+		return false;
+	}
+
+	std::vector<uint32_t> indices;
+	if (!ScanJsonStructure(json, size, indices) || indices.size() < 2)
+	{
+		error = "Malformed JSON";
+		return false;
+	}
+
+	try
+	{
+		JsonCursor cursor(json, size, indices);
+		ModelRecord record = { model, {} };
+		ReadProperties(cursor, record, MODEL_PROPERTIES);
+
+		if (!cursor.IsEnd())
+		{
+			cursor.Fail("end of JSON expected");
+		}
+
+		byteLengths.clear();
+		for (auto& buffer : record.buffers)
+		{
+			model.buffers.push_back(std::move(buffer.buffer));
+			byteLengths.push_back(buffer.byteLength);
+		}
+	}
+	catch (const ReadError& e)
+	{
+		error = e.reason;
+		return false;
+	}
+
+	return true;
+}
+
+}  // end namespace SD::ENGINE
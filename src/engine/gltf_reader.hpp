@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+namespace tinygltf
+{
+class Model;
+}
+
+namespace SD::ENGINE {
+
+// Positions of JSON structural characters ({}[]:,), opening quotes and first characters of other scalars, found 64
+// bytes at a time with SSE2. The size of the JSON is appended as a sentinel. Returns false for unterminated strings.
+bool ScanJsonStructure(const char* json, size_t size, std::vector<uint32_t>& indices);
+
+// Reads glTF JSON straight into the model, walking the structural positions without building a DOM.
+// Reads what the engine uses: scenes, nodes, meshes, accessors, buffer views, buffers, images, textures, samplers,
+// materials and KHR_lights_punctual lights, extras and buffer view extensions are kept as values. Anything else is
+// skipped. Buffers are not loaded, their byte lengths are returned instead.
+// Returns false with a reason for malformed JSON and for features it leaves to tinygltf (sparse accessors, data URI
+// buffers).
+bool ReadGltf(const char* json, size_t size, tinygltf::Model& model, std::vector<size_t>& byteLengths, std::string& error);
+
+}  // end namespace SD::ENGINE
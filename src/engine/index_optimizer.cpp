@@ -0,0 +1,478 @@
+#include "index_optimizer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+
+
+namespace
+{
+// FIFO post-transform cache, a vertex is cached while less than cacheSize misses happened after its own.
+class FifoCache
+{
+public:
+	FifoCache(size_t vertexCount, size_t cacheSize)
+		: m_timestamps(vertexCount, 0)
+		, m_cacheSize(cacheSize)
+		, m_time(cacheSize + 1)
+	{
+	}
+
+	// returns 1 on miss
+	size_t Access(uint32_t vertex)
+	{
+		if (m_time - m_timestamps[vertex] > m_cacheSize)
+		{
+			m_timestamps[vertex] = m_time++;
+			return 1;
+		}
+
+		return 0;
+	}
+
+	size_t AccessTriangle(const uint32_t* triangle)
+	{
+		return Access(triangle[0]) + Access(triangle[1]) + Access(triangle[2]);
+	}
+
+	void Flush()
+	{
+		m_time += m_cacheSize + 1;
+	}
+
+private:
+	std::vector<size_t> m_timestamps;
+	size_t m_cacheSize;
+	size_t m_time;
+};
+
+// Triangles around every vertex.
+struct Adjacency
+{
+	Adjacency(const std::vector<uint32_t>& indices, size_t vertexCount)
+		: offsets(vertexCount + 1, 0)
+		, triangles(indices.size())
+	{
+		for (const auto index : indices)
+		{
+			offsets[index + 1]++;
+		}
+		std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+		std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+		for (size_t idx = 0; idx < indices.size(); ++idx)
+		{
+			triangles[fill[indices[idx]]++] = static_cast<uint32_t>(idx / 3);
+		}
+	}
+
+	std::vector<uint32_t> offsets;
+	std::vector<uint32_t> triangles;
+};
+
+struct Float3
+{
+	float x, y, z;
+};
+
+Float3 Sub(const Float3& a, const Float3& b)
+{
+	return { a.x - b.x, a.y - b.y, a.z - b.z };
+}
+
+Float3 Cross(const Float3& a, const Float3& b)
+{
+	return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+}
+
+float Dot(const Float3& a, const Float3& b)
+{
+	return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+Float3 LoadPosition(const float* positions, size_t stride, uint32_t vertex)
+{
+	const float* position = positions + vertex * stride;
+	return { position[0], position[1], position[2] };
+}
+}  // end namespace
+
+namespace SD::ENGINE {
+
+VertexCacheStats AnalyzeVertexCache(const std::vector<uint32_t>& indices, size_t vertexCount, size_t cacheSize)
+{
+	VertexCacheStats stats;
+
+	// zero stats for anything that is not a list of whole triangles over the vertices
+	if (indices.empty() || indices.size() % 3 != 0)
+	{
+		return stats;
+	}
+	const bool inRange = std::all_of(indices.begin(), indices.end(), [vertexCount](uint32_t index)
+	{
+		return index < vertexCount;
+	});
+	if (!inRange)
+	{
+		return stats;
+	}
+
+	FifoCache cache(vertexCount, cacheSize);
+	std::vector<bool> referenced(vertexCount, false);
+
+	size_t transformed = 0;
+	size_t unique = 0;
+	for (const auto index : indices)
+	{
+		transformed += cache.Access(index);
+
+		if (!referenced[index])
+		{
+			referenced[index] = true;
+			unique++;
+		}
+	}
+
+	stats.acmr = static_cast<float>(transformed) / static_cast<float>(indices.size() / 3);
+	stats.atvr = static_cast<float>(transformed) / static_cast<float>(unique);
+
+	return stats;
+}
+
+std::vector<uint32_t> OptimizeVertexCache(const std::vector<uint32_t>& indices, size_t vertexCount, size_t cacheSize)
+{
+	const size_t triangleCount = indices.size() / 3;
+	const Adjacency adjacency(indices, vertexCount);
+
+	std::vector<uint32_t> live(vertexCount);
+	for (size_t vertex = 0; vertex < vertexCount; ++vertex)
+	{
+		live[vertex] = adjacency.offsets[vertex + 1] - adjacency.offsets[vertex];
+	}
+
+	std::vector<size_t> cacheTime(vertexCount, 0);
+	size_t timestamp = cacheSize + 1;
+
+	std::vector<bool> emitted(triangleCount, false);
+	std::vector<uint32_t> deadEnd;
+	std::vector<uint32_t> candidates;
+	size_t cursor = 0;
+
+	// most recently referenced vertex with triangles left, then the next one in input order
+	const auto skipDeadEnd = [&]()
+	{
+		while (!deadEnd.empty())
+		{
+			const uint32_t vertex = deadEnd.back();
+			deadEnd.pop_back();
+
+			if (live[vertex] > 0)
+			{
+				return vertex;
+			}
+		}
+
+		for (; cursor < vertexCount; ++cursor)
+		{
+			if (live[cursor] > 0)
+			{
+				return static_cast<uint32_t>(cursor);
+			}
+		}
+
+		return INVALID_VERTEX;
+	};
+
+	std::vector<uint32_t> result;
+	result.reserve(triangleCount * 3);
+
+	uint32_t fan = skipDeadEnd();
+	while (fan != INVALID_VERTEX)
+	{
+		candidates.clear();
+
+		// emit all triangles around the fan vertex
+		for (uint32_t idx = adjacency.offsets[fan]; idx < adjacency.offsets[fan + 1]; ++idx)
+		{
+			const uint32_t triangle = adjacency.triangles[idx];
+			if (emitted[triangle])
+			{
+				continue;
+			}
+			emitted[triangle] = true;
+
+			for (size_t corner = 0; corner < 3; ++corner)
+			{
+				const uint32_t vertex = indices[triangle * 3 + corner];
+
+				result.push_back(vertex);
+				deadEnd.push_back(vertex);
+				candidates.push_back(vertex);
+				live[vertex]--;
+
+				if (timestamp - cacheTime[vertex] > cacheSize)
+				{
+					cacheTime[vertex] = timestamp++;
+				}
+			}
+		}
+
+		// the oldest candidate that stays in the cache while its remaining triangles are emitted
+		uint32_t next = INVALID_VERTEX;
+		size_t bestPriority = 0;
+		for (const auto vertex : candidates)
+		{
+			if (live[vertex] == 0)
+			{
+				continue;
+			}
+
+			size_t priority = 0;
+			if (timestamp - cacheTime[vertex] + 2 * live[vertex] <= cacheSize)
+			{
+				priority = timestamp - cacheTime[vertex];
+			}
+
+			if (next == INVALID_VERTEX || priority > bestPriority)
+			{
+				next = vertex;
+				bestPriority = priority;
+			}
+		}
+
+		fan = next != INVALID_VERTEX ? next : skipDeadEnd();
+	}
+
+	return result;
+}
+
+std::vector<uint32_t> OptimizeOverdraw(
+	const std::vector<uint32_t>& indices,
+	const float* positions,
+	size_t positionStride,
+	size_t vertexCount,
+	float threshold,
+	size_t cacheSize)
+{
+	const size_t triangleCount = indices.size() / 3;
+	if (triangleCount == 0)
+	{
+		return indices;
+	}
+
+	FifoCache cache(vertexCount, cacheSize);
+
+	// hard boundaries, triangles missing all vertices start over
+	std::vector<size_t> hardBoundaries;
+	for (size_t triangle = 0; triangle < triangleCount; ++triangle)
+	{
+		if (cache.AccessTriangle(&indices[triangle * 3]) == 3)
+		{
+			hardBoundaries.push_back(triangle);
+		}
+	}
+	hardBoundaries.push_back(triangleCount);
+
+	// soft boundaries, split while the cluster ACMR stays close to the one of the whole hard cluster
+	std::vector<size_t> clusters;
+	for (size_t idx = 0; idx + 1 < hardBoundaries.size(); ++idx)
+	{
+		const size_t begin = hardBoundaries[idx];
+		const size_t end = hardBoundaries[idx + 1];
+
+		cache.Flush();
+		size_t misses = 0;
+		for (size_t triangle = begin; triangle < end; ++triangle)
+		{
+			misses += cache.AccessTriangle(&indices[triangle * 3]);
+		}
+		const float clusterThreshold = threshold * static_cast<float>(misses) / static_cast<float>(end - begin);
+
+		clusters.push_back(begin);
+
+		cache.Flush();
+		size_t start = begin;
+		misses = 0;
+		for (size_t triangle = begin; triangle + 1 < end; ++triangle)
+		{
+			misses += cache.AccessTriangle(&indices[triangle * 3]);
+
+			if (static_cast<float>(misses) <= clusterThreshold * static_cast<float>(triangle + 1 - start))
+			{
+				clusters.push_back(triangle + 1);
+
+				cache.Flush();
+				start = triangle + 1;
+				misses = 0;
+			}
+		}
+	}
+	clusters.push_back(triangleCount);
+
+	const size_t clusterCount = clusters.size() - 1;
+
+	// area weighted centroids and normals
+	std::vector<Float3> centroids(clusterCount, { 0.0f, 0.0f, 0.0f });
+	std::vector<Float3> normals(clusterCount, { 0.0f, 0.0f, 0.0f });
+	Float3 meshCentroid = { 0.0f, 0.0f, 0.0f };
+	float meshArea = 0.0f;
+
+	for (size_t cluster = 0; cluster < clusterCount; ++cluster)
+	{
+		float clusterArea = 0.0f;
+
+		for (size_t triangle = clusters[cluster]; triangle < clusters[cluster + 1]; ++triangle)
+		{
+			const auto p0 = LoadPosition(positions, positionStride, indices[triangle * 3 + 0]);
+			const auto p1 = LoadPosition(positions, positionStride, indices[triangle * 3 + 1]);
+			const auto p2 = LoadPosition(positions, positionStride, indices[triangle * 3 + 2]);
+
+			const auto normal = Cross(Sub(p1, p0), Sub(p2, p0));
+			const float area = std::sqrt(Dot(normal, normal));
+
+			auto& centroid = centroids[cluster];
+			centroid.x += (p0.x + p1.x + p2.x) / 3.0f * area;
+			centroid.y += (p0.y + p1.y + p2.y) / 3.0f * area;
+			centroid.z += (p0.z + p1.z + p2.z) / 3.0f * area;
+
+			normals[cluster].x += normal.x;
+			normals[cluster].y += normal.y;
+			normals[cluster].z += normal.z;
+
+			clusterArea += area;
+		}
+
+		meshCentroid.x += centroids[cluster].x;
+		meshCentroid.y += centroids[cluster].y;
+		meshCentroid.z += centroids[cluster].z;
+		meshArea += clusterArea;
+
+		if (clusterArea > 0.0f)
+		{
+			centroids[cluster] = { centroids[cluster].x / clusterArea, centroids[cluster].y / clusterArea, centroids[cluster].z / clusterArea };
+		}
+	}
+
+	if (meshArea > 0.0f)
+	{
+		meshCentroid = { meshCentroid.x / meshArea, meshCentroid.y / meshArea, meshCentroid.z / meshArea };
+	}
+
+	// clusters facing away from the center occlude the rest, draw them first
+	std::vector<float> sortKeys(clusterCount);
+	for (size_t cluster = 0; cluster < clusterCount; ++cluster)
+	{
+		const auto& normal = normals[cluster];
+		const float length = std::sqrt(Dot(normal, normal));
+
+		sortKeys[cluster] = length > 0.0f ? Dot(Sub(centroids[cluster], meshCentroid), normal) / length : 0.0f;
+	}
+
+	std::vector<size_t> order(clusterCount);
+	std::iota(order.begin(), order.end(), 0);
+	std::stable_sort(order.begin(), order.end(), [&sortKeys](size_t a, size_t b)
+	{
+		return sortKeys[a] > sortKeys[b];
+	});
+
+	std::vector<uint32_t> result;
+	result.reserve(indices.size());
+	for (const auto cluster : order)
+	{
+		result.insert(result.end(), indices.begin() + clusters[cluster] * 3, indices.begin() + clusters[cluster + 1] * 3);
+	}
+
+	return result;
+}
+
+std::vector<uint32_t> OptimizeVertexFetch(std::vector<uint32_t>& indices, size_t vertexCount, size_t& remappedCount)
+{
+	std::vector<uint32_t> remap(vertexCount, INVALID_VERTEX);
+
+	uint32_t next = 0;
+	for (auto& index : indices)
+	{
+		if (remap[index] == INVALID_VERTEX)
+		{
+			remap[index] = next++;
+		}
+
+		index = remap[index];
+	}
+
+	remappedCount = next;
+
+	return remap;
+}
+
+void RemapVertices(std::vector<uint8_t>& vertices, size_t stride, const std::vector<uint32_t>& remap, size_t remappedCount)
+{
+	std::vector<uint8_t> result(remappedCount * stride);
+
+	for (size_t vertex = 0; vertex < remap.size(); ++vertex)
+	{
+		if (remap[vertex] != INVALID_VERTEX)
+		{
+			memcpy(result.data() + remap[vertex] * stride, vertices.data() + vertex * stride, stride);
+		}
+	}
+
+	vertices = std::move(result);
+}
+
+std::vector<IndexRange> SplitIndices(const std::vector<uint32_t>& indices, size_t maxVertices)
+{
+	std::vector<IndexRange> chunks;
+
+	IndexRange chunk;
+	uint32_t min = INVALID_VERTEX;
+	uint32_t max = 0;
+
+	for (size_t idx = 0; idx + 2 < indices.size(); idx += 3)
+	{
+		const uint32_t triangleMin = std::min({ indices[idx], indices[idx + 1], indices[idx + 2] });
+		const uint32_t triangleMax = std::max({ indices[idx], indices[idx + 1], indices[idx + 2] });
+		if (triangleMax - triangleMin >= maxVertices)
+		{
+			return {};
+		}
+
+		if (chunk.indexCount > 0 && std::max(max, triangleMax) - std::min(min, triangleMin) >= maxVertices)
+		{
+			chunk.baseVertex = static_cast<int32_t>(min);
+			chunks.push_back(chunk);
+
+			chunk = {};
+			chunk.startIndex = static_cast<uint32_t>(idx);
+			min = INVALID_VERTEX;
+			max = 0;
+		}
+
+		min = std::min(min, triangleMin);
+		max = std::max(max, triangleMax);
+		chunk.indexCount += 3;
+	}
+
+	if (chunk.indexCount > 0)
+	{
+		chunk.baseVertex = static_cast<int32_t>(min);
+		chunks.push_back(chunk);
+	}
+
+	return chunks;
+}
+
+void RebaseIndices(std::vector<uint32_t>& indices, const std::vector<IndexRange>& chunks)
+{
+	for (const auto& chunk : chunks)
+	{
+		const auto base = static_cast<uint32_t>(chunk.baseVertex);
+		for (size_t idx = chunk.startIndex; idx < chunk.startIndex + chunk.indexCount; ++idx)
+		{
+			indices[idx] -= base;
+		}
+	}
+}
+
+}  // end namespace SD::ENGINE
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+namespace SD::ENGINE {
+
+// post-transform cache size the optimizer targets and the analysis simulates
+constexpr size_t VERTEX_CACHE_SIZE = 16;
+
+struct VertexCacheStats
+{
+	float acmr = 0.0f;  // transformed vertices per triangle, 0.5 at best
+	float atvr = 0.0f;  // transformed vertices per referenced vertex, 1.0 at best
+};
+
+// Simulates a FIFO post-transform cache. Zero stats when the index count is not a multiple of 3 or an index is out of range.
+VertexCacheStats AnalyzeVertexCache(const std::vector<uint32_t>& indices, size_t vertexCount, size_t cacheSize = VERTEX_CACHE_SIZE);
+
+// Tipsify (Sander et al. 2007) triangle order, fans around vertices that stay in the cache.
+std::vector<uint32_t> OptimizeVertexCache(const std::vector<uint32_t>& indices, size_t vertexCount, size_t cacheSize = VERTEX_CACHE_SIZE);
+
+// Splits cache optimized triangles into clusters (hard boundaries at cache restarts, soft ones while ACMR stays under
+// threshold times the cluster ACMR) and sorts clusters to draw outward facing ones first.
+// Positions are float3 at a stride in floats.
+std::vector<uint32_t> OptimizeOverdraw(
+	const std::vector<uint32_t>& indices,
+	const float* positions,
+	size_t positionStride,
+	size_t vertexCount,
+	float threshold = 1.05f,
+	size_t cacheSize = VERTEX_CACHE_SIZE);
+
+constexpr uint32_t INVALID_VERTEX = ~0u;
+constexpr size_t MAX_INDEX16_VERTICES = 65536;
+
+// Indices of a primitive to draw.
+struct IndexRange
+{
+	uint32_t startIndex = 0;  // relative to the primitive
+	uint32_t indexCount = 0;
+	int32_t baseVertex = 0;  // relative to the primitive
+};
+
+// Renumbers vertices in the order of first use and rewrites indices, unused vertices are dropped.
+// Returns old to new vertex remap, unused vertices map to INVALID_VERTEX.
+std::vector<uint32_t> OptimizeVertexFetch(std::vector<uint32_t>& indices, size_t vertexCount, size_t& remappedCount);
+
+// Moves vertices of the given stride to their remapped places.
+void RemapVertices(std::vector<uint8_t>& vertices, size_t stride, const std::vector<uint32_t>& remap, size_t remappedCount);
+
+// Splits triangles in their order into chunks referencing less than maxVertices vertices from the chunk base vertex on.
+// Works best on indices optimized for vertex fetch. Returns no chunks when a single triangle spans more vertices.
+std::vector<IndexRange> SplitIndices(const std::vector<uint32_t>& indices, size_t maxVertices = MAX_INDEX16_VERTICES);
+
+// Makes indices of every chunk relative to its base vertex.
+void RebaseIndices(std::vector<uint32_t>& indices, const std::vector<IndexRange>& chunks);
+
+}  // end namespace SD::ENGINE
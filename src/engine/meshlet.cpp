@@ -0,0 +1,220 @@
+#include "meshlet.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+
+namespace
+{
+// wider cones cull too rarely to be worth the test
+constexpr float MIN_CONE_DOT = 0.1f;
+
+// relative difference of axis scales still treated as uniform
+constexpr float UNIFORM_SCALE_TOLERANCE = 0.01f;
+
+DirectX::XMVECTOR LoadPosition(const float* positions, size_t stride, uint32_t vertex)
+{
+	return DirectX::XMLoadFloat3(reinterpret_cast<const DirectX::XMFLOAT3*>(positions + vertex * stride));
+}
+
+void ComputeBounds(
+	SD::ENGINE::Meshlet& meshlet,
+	const std::vector<uint32_t>& indices,
+	const float* positions,
+	size_t positionStride)
+{
+	const size_t begin = meshlet.startIndex;
+	const size_t end = begin + meshlet.indexCount;
+
+	// sphere around the box center
+	auto min = LoadPosition(positions, positionStride, indices[begin]);
+	auto max = min;
+	for (size_t idx = begin + 1; idx < end; ++idx)
+	{
+		const auto position = LoadPosition(positions, positionStride, indices[idx]);
+		min = DirectX::XMVectorMin(min, position);
+		max = DirectX::XMVectorMax(max, position);
+	}
+
+	const auto center = DirectX::XMVectorScale(DirectX::XMVectorAdd(min, max), 0.5f);
+	auto radius = DirectX::XMVectorZero();
+	for (size_t idx = begin; idx < end; ++idx)
+	{
+		const auto position = LoadPosition(positions, positionStride, indices[idx]);
+		radius = DirectX::XMVectorMax(radius, DirectX::XMVector3Length(DirectX::XMVectorSubtract(position, center)));
+	}
+
+	DirectX::XMStoreFloat3(&meshlet.center, center);
+	meshlet.radius = DirectX::XMVectorGetX(radius);
+
+	// normal cone, axis is the average of unit triangle normals
+	std::vector<DirectX::XMVECTOR> normals;
+	normals.reserve(meshlet.indexCount / 3);
+
+	auto axis = DirectX::XMVectorZero();
+	for (size_t idx = begin; idx < end; idx += 3)
+	{
+		const auto p0 = LoadPosition(positions, positionStride, indices[idx + 0]);
+		const auto p1 = LoadPosition(positions, positionStride, indices[idx + 1]);
+		const auto p2 = LoadPosition(positions, positionStride, indices[idx + 2]);
+
+		const auto normal = DirectX::XMVector3Cross(DirectX::XMVectorSubtract(p1, p0), DirectX::XMVectorSubtract(p2, p0));
+		if (DirectX::XMVectorGetX(DirectX::XMVector3LengthSq(normal)) > 0.0f)
+		{
+			normals.push_back(DirectX::XMVector3Normalize(normal));
+			axis = DirectX::XMVectorAdd(axis, normals.back());
+		}
+	}
+
+	meshlet.coneCutoff = 1.0f;
+	if (normals.empty() || DirectX::XMVectorGetX(DirectX::XMVector3LengthSq(axis)) == 0.0f)
+	{
+		return;
+	}
+	axis = DirectX::XMVector3Normalize(axis);
+	DirectX::XMStoreFloat3(&meshlet.coneAxis, axis);
+
+	float minDot = 1.0f;
+	for (const auto& normal : normals)
+	{
+		minDot = std::min(minDot, DirectX::XMVectorGetX(DirectX::XMVector3Dot(normal, axis)));
+	}
+
+	// backfacing when the view direction is within the cone widened by 90 degrees: sin instead of cos of the angle
+	if (minDot > MIN_CONE_DOT)
+	{
+		meshlet.coneCutoff = std::sqrt(1.0f - minDot * minDot);
+	}
+}
+
+bool IsUniformScale(const DirectX::XMMATRIX& transform)
+{
+	const float x = DirectX::XMVectorGetX(DirectX::XMVector3Length(transform.r[0]));
+	const float y = DirectX::XMVectorGetX(DirectX::XMVector3Length(transform.r[1]));
+	const float z = DirectX::XMVectorGetX(DirectX::XMVector3Length(transform.r[2]));
+
+	const float min = std::min({ x, y, z });
+	const float max = std::max({ x, y, z });
+
+	return min > 0.0f && max - min <= UNIFORM_SCALE_TOLERANCE * max;
+}
+}  // end namespace
+
+namespace SD::ENGINE {
+
+std::vector<Meshlet> BuildMeshlets(
+	const std::vector<uint32_t>& indices,
+	const IndexRange& chunk,
+	const float* positions,
+	size_t positionStride,
+	size_t vertexCount,
+	size_t maxVertices,
+	size_t maxTriangles)
+{
+	std::vector<Meshlet> meshlets;
+
+	// meshlet number + 1 that last referenced the vertex
+	std::vector<uint32_t> marks(vertexCount, 0);
+	uint32_t mark = 1;
+
+	Meshlet meshlet;
+	meshlet.startIndex = chunk.startIndex;
+	meshlet.baseVertex = chunk.baseVertex;
+	size_t vertices = 0;
+
+	const size_t end = static_cast<size_t>(chunk.startIndex) + chunk.indexCount;
+	for (size_t idx = chunk.startIndex; idx + 2 < end; idx += 3)
+	{
+		size_t added = 0;
+		for (size_t corner = 0; corner < 3; ++corner)
+		{
+			added += marks[indices[idx + corner]] != mark ? 1 : 0;
+		}
+
+		if (vertices + added > maxVertices || meshlet.indexCount / 3 + 1 > maxTriangles)
+		{
+			ComputeBounds(meshlets.emplace_back(meshlet), indices, positions, positionStride);
+
+			meshlet = {};
+			meshlet.startIndex = static_cast<uint32_t>(idx);
+			meshlet.baseVertex = chunk.baseVertex;
+			vertices = 0;
+			mark++;
+
+			added = 0;
+			for (size_t corner = 0; corner < 3; ++corner)
+			{
+				added += marks[indices[idx + corner]] != mark ? 1 : 0;
+			}
+		}
+
+		for (size_t corner = 0; corner < 3; ++corner)
+		{
+			marks[indices[idx + corner]] = mark;
+		}
+		vertices += added;
+		meshlet.indexCount += 3;
+	}
+
+	if (meshlet.indexCount > 0)
+	{
+		ComputeBounds(meshlets.emplace_back(meshlet), indices, positions, positionStride);
+	}
+
+	return meshlets;
+}
+
+size_t CullMeshlets(
+	const std::vector<Meshlet>& meshlets,
+	const DirectX::XMMATRIX& worldView,
+	const DirectX::BoundingFrustum& frustum,
+	bool insideFrustum,
+	bool cullBackfaces,
+	std::vector<IndexRange>& ranges)
+{
+	// cone angles survive rotation and uniform scale only, mirroring flips the facing
+	const bool testCones = cullBackfaces && IsUniformScale(worldView);
+	const float facing = DirectX::XMVectorGetX(DirectX::XMMatrixDeterminant(worldView)) < 0.0f ? -1.0f : 1.0f;
+
+	size_t visible = 0;
+	for (const auto& meshlet : meshlets)
+	{
+		DirectX::BoundingSphere sphere;
+		DirectX::BoundingSphere(meshlet.center, meshlet.radius).Transform(sphere, worldView);
+
+		if (!insideFrustum && !frustum.Intersects(sphere))
+		{
+			continue;
+		}
+
+		if (testCones && meshlet.coneCutoff < 1.0f)
+		{
+			// camera is at the view space origin
+			const auto center = DirectX::XMLoadFloat3(&sphere.Center);
+			const auto axis = DirectX::XMVectorScale(
+				DirectX::XMVector3Normalize(DirectX::XMVector3TransformNormal(DirectX::XMLoadFloat3(&meshlet.coneAxis), worldView)), facing);
+
+			const float distance = DirectX::XMVectorGetX(DirectX::XMVector3Length(center));
+			if (DirectX::XMVectorGetX(DirectX::XMVector3Dot(center, axis)) >= meshlet.coneCutoff * distance + sphere.Radius)
+			{
+				continue;
+			}
+		}
+
+		visible++;
+
+		auto* last = ranges.empty() ? nullptr : &ranges.back();
+		if (last && last->startIndex + last->indexCount == meshlet.startIndex && last->baseVertex == meshlet.baseVertex)
+		{
+			last->indexCount += meshlet.indexCount;
+		}
+		else
+		{
+			ranges.push_back({ meshlet.startIndex, meshlet.indexCount, meshlet.baseVertex });
+		}
+	}
+
+	return visible;
+}
+
+}  // end namespace SD::ENGINE
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <DirectXCollision.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "index_optimizer.hpp"
+
+
+namespace SD::ENGINE {
+
+constexpr size_t MESHLET_MAX_VERTICES = 64;
+constexpr size_t MESHLET_MAX_TRIANGLES = 124;
+
+// Cluster of consecutive triangles of a primitive.
+struct Meshlet
+{
+	uint32_t startIndex = 0;  // relative to the primitive
+	uint32_t indexCount = 0;
+	int32_t baseVertex = 0;  // of the index chunk
+
+	DirectX::XMFLOAT3 center = {};  // bounding sphere
+	float radius = 0.0f;
+
+	DirectX::XMFLOAT3 coneAxis = {};  // average triangle normal
+	float coneCutoff = 1.0f;  // sine of the normal cone angle, 1 - never backfacing as a whole
+};
+
+// Splits triangles of the chunk in their order into meshlets, so every meshlet is a continuous index range.
+// Indices are not rebased to the chunk yet, positions are float3 at a stride in floats.
+std::vector<Meshlet> BuildMeshlets(
+	const std::vector<uint32_t>& indices,
+	const IndexRange& chunk,
+	const float* positions,
+	size_t positionStride,
+	size_t vertexCount,
+	size_t maxVertices = MESHLET_MAX_VERTICES,
+	size_t maxTriangles = MESHLET_MAX_TRIANGLES);
+
+// Appends ranges of meshlets intersecting the view space frustum, backfacing meshlets are rejected as well when
+// cullBackfaces is set (ignored for non uniform scale). Visible neighbours of a chunk are merged into a single range.
+// Returns the number of visible meshlets.
+size_t CullMeshlets(
+	const std::vector<Meshlet>& meshlets,
+	const DirectX::XMMATRIX& worldView,
+	const DirectX::BoundingFrustum& frustum,
+	bool insideFrustum,
+	bool cullBackfaces,
+	std::vector<IndexRange>& ranges);
+
+}  // end namespace SD::ENGINE
@@ -0,0 +1,919 @@
+#include "meshopt_decoder.hpp"
+
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+
+#if defined(_MSC_VER)
+#define SD_TARGET_SSE41
+#define SD_TARGET_AVX2
+#else
+#define SD_TARGET_SSE41 __attribute__((target("sse4.1")))
+#define SD_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+namespace
+{
+constexpr uint8_t VERTEX_HEADER = 0xa0;
+constexpr uint8_t TRIANGLE_HEADER = 0xe0;
+constexpr uint8_t SEQUENCE_HEADER = 0xd0;
+
+constexpr size_t BYTE_GROUP_SIZE = 16;
+constexpr size_t BYTE_GROUP_DECODE_LIMIT = 24;  // group data and the overread of a wide load
+constexpr size_t VERTEX_BLOCK_BYTES = 8192;
+constexpr size_t VERTEX_BLOCK_MAX_SIZE = 256;
+constexpr size_t VERTEX_MAX_SIZE = 256;
+constexpr size_t TAIL_MAX_SIZE = 32;
+
+// exception byte positions of 8 packed values, indexed by the mask of escaped values
+struct ByteGroupTables
+{
+	uint8_t shuffle[256][8];
+	uint8_t count[256];
+
+	ByteGroupTables()
+	{
+		for (int mask = 0; mask < 256; ++mask)
+		{
+			uint8_t used = 0;
+			for (int idx = 0; idx < 8; ++idx)
+			{
+				const bool escaped = ((mask >> idx) & 1) != 0;
+				shuffle[mask][idx] = escaped ? used : static_cast<uint8_t>(0x80);
+				used = static_cast<uint8_t>(used + (escaped ? 1 : 0));
+			}
+			count[mask] = used;
+		}
+	}
+};
+
+const ByteGroupTables BYTE_GROUP_TABLES;
+
+uint8_t Unzigzag8(uint8_t value)
+{
+	return static_cast<uint8_t>(-(value & 1) ^ (value >> 1));
+}
+
+size_t GetVertexBlockSize(size_t vertexSize)
+{
+	return std::min((VERTEX_BLOCK_BYTES / vertexSize) & ~(BYTE_GROUP_SIZE - 1), VERTEX_BLOCK_MAX_SIZE);
+}
+
+// Unpacks 16 values of 0, 2, 4 or 8 bits, all ones in 2 and 4 bit values escape to a following byte.
+const uint8_t* DecodeBytesGroup(const uint8_t* data, uint8_t* destination, int bitsLog2)
+{
+	switch (bitsLog2)
+	{
+	case 0:
+		memset(destination, 0, BYTE_GROUP_SIZE);
+		return data;
+	case 3:
+		memcpy(destination, data, BYTE_GROUP_SIZE);
+		return data + BYTE_GROUP_SIZE;
+	default:
+	{
+		const int bits = 1 << bitsLog2;
+		const uint8_t escape = static_cast<uint8_t>((1 << bits) - 1);
+
+		const uint8_t* packed = data;
+		const uint8_t* exceptions = data + bits * 2;
+		for (size_t idx = 0; idx < BYTE_GROUP_SIZE; ++idx)
+		{
+			// first value in the highest bits
+			const size_t bit = idx * bits;
+			const uint8_t value = static_cast<uint8_t>((packed[bit / 8] >> (8 - bits - bit % 8)) & escape);
+			destination[idx] = value == escape ? *exceptions++ : value;
+		}
+		return exceptions;
+	}
+	}
+}
+
+SD_TARGET_SSE41 const uint8_t* DecodeBytesGroupSSE41(const uint8_t* data, uint8_t* destination, int bitsLog2)
+{
+	switch (bitsLog2)
+	{
+	case 1:
+	case 2:
+	{
+		__m128i values;
+		__m128i rest;
+		__m128i escape;
+		if (bitsLog2 == 1)
+		{
+			int32_t packed;
+			memcpy(&packed, data, sizeof(packed));
+
+			// spread every 2 bits into a byte, highest bits first
+			const __m128i sel2 = _mm_cvtsi32_si128(packed);
+			const __m128i sel22 = _mm_unpacklo_epi8(_mm_srli_epi16(sel2, 4), sel2);
+			const __m128i sel2222 = _mm_unpacklo_epi8(_mm_srli_epi16(sel22, 2), sel22);
+
+			escape = _mm_set1_epi8(3);
+			values = _mm_and_si128(sel2222, escape);
+			rest = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 4));
+			data += 4;
+		}
+		else
+		{
+			const __m128i sel4 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(data));
+			const __m128i sel44 = _mm_unpacklo_epi8(_mm_srli_epi16(sel4, 4), sel4);
+
+			escape = _mm_set1_epi8(15);
+			values = _mm_and_si128(sel44, escape);
+			rest = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 8));
+			data += 8;
+		}
+
+		const __m128i mask = _mm_cmpeq_epi8(values, escape);
+		const int mask16 = _mm_movemask_epi8(mask);
+		const uint8_t mask0 = static_cast<uint8_t>(mask16 & 255);
+		const uint8_t mask1 = static_cast<uint8_t>(mask16 >> 8);
+
+		// escaped values are gathered from the bytes that follow in order
+		const __m128i shuffle0 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(BYTE_GROUP_TABLES.shuffle[mask0]));
+		const __m128i shuffle1 = _mm_add_epi8(
+			_mm_loadl_epi64(reinterpret_cast<const __m128i*>(BYTE_GROUP_TABLES.shuffle[mask1])),
+			_mm_set1_epi8(static_cast<char>(BYTE_GROUP_TABLES.count[mask0])));
+		const __m128i shuffle = _mm_unpacklo_epi64(shuffle0, shuffle1);
+
+		const __m128i result = _mm_blendv_epi8(values, _mm_shuffle_epi8(rest, shuffle), mask);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(destination), result);
+
+		return data + BYTE_GROUP_TABLES.count[mask0] + BYTE_GROUP_TABLES.count[mask1];
+	}
+	default:
+		return DecodeBytesGroup(data, destination, bitsLog2);
+	}
+}
+
+template<bool SSE41>
+const uint8_t* DecodeBytes(const uint8_t* data, const uint8_t* dataEnd, uint8_t* destination, size_t count)
+{
+	// 2 bit modes of 4 groups per header byte
+	const size_t headerSize = (count / BYTE_GROUP_SIZE + 3) / 4;
+	if (static_cast<size_t>(dataEnd - data) < headerSize)
+	{
+		return nullptr;
+	}
+
+	const uint8_t* header = data;
+	data += headerSize;
+
+	for (size_t idx = 0; idx < count; idx += BYTE_GROUP_SIZE)
+	{
+		if (static_cast<size_t>(dataEnd - data) < BYTE_GROUP_DECODE_LIMIT)
+		{
+			return nullptr;
+		}
+
+		const size_t group = idx / BYTE_GROUP_SIZE;
+		const int bitsLog2 = (header[group / 4] >> ((group % 4) * 2)) & 3;
+
+		data = SSE41 ? DecodeBytesGroupSSE41(data, destination + idx, bitsLog2) : DecodeBytesGroup(data, destination + idx, bitsLog2);
+	}
+
+	return data;
+}
+
+// Zigzag deltas to values of a single byte of the vertex, continuing from the previous vertex.
+void DecodeDeltas(const uint8_t* deltas, size_t count, uint8_t* destination, size_t vertexSize, uint8_t& last)
+{
+	uint8_t previous = last;
+	for (size_t idx = 0; idx < count; ++idx)
+	{
+		previous = static_cast<uint8_t>(previous + Unzigzag8(deltas[idx]));
+		destination[idx * vertexSize] = previous;
+	}
+	last = previous;
+}
+
+SD_TARGET_SSE41 __m128i DecodeDeltaGroupSSE41(const uint8_t* deltas, __m128i& previous)
+{
+	const __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(deltas));
+	const __m128i delta = _mm_xor_si128(
+		_mm_and_si128(_mm_srli_epi16(value, 1), _mm_set1_epi8(0x7f)), _mm_sub_epi8(_mm_setzero_si128(), _mm_and_si128(value, _mm_set1_epi8(1))));
+
+	// inclusive prefix sum of 16 bytes
+	__m128i sum = _mm_add_epi8(delta, _mm_slli_si128(delta, 1));
+	sum = _mm_add_epi8(sum, _mm_slli_si128(sum, 2));
+	sum = _mm_add_epi8(sum, _mm_slli_si128(sum, 4));
+	sum = _mm_add_epi8(sum, _mm_slli_si128(sum, 8));
+	sum = _mm_add_epi8(sum, previous);
+
+	previous = _mm_shuffle_epi8(sum, _mm_set1_epi8(15));
+	return sum;
+}
+
+// Four byte streams at once, transposed back into 32 bit words of 16 vertices.
+SD_TARGET_SSE41 void DecodeDeltas4SSE41(
+	const uint8_t (*deltas)[VERTEX_BLOCK_MAX_SIZE], size_t count, uint8_t* destination, size_t vertexSize, uint8_t* last)
+{
+	__m128i previous[4];
+	for (size_t stream = 0; stream < 4; ++stream)
+	{
+		previous[stream] = _mm_set1_epi8(static_cast<char>(last[stream]));
+	}
+
+	for (size_t idx = 0; idx < count; idx += BYTE_GROUP_SIZE)
+	{
+		const __m128i v0 = DecodeDeltaGroupSSE41(deltas[0] + idx, previous[0]);
+		const __m128i v1 = DecodeDeltaGroupSSE41(deltas[1] + idx, previous[1]);
+		const __m128i v2 = DecodeDeltaGroupSSE41(deltas[2] + idx, previous[2]);
+		const __m128i v3 = DecodeDeltaGroupSSE41(deltas[3] + idx, previous[3]);
+
+		const __m128i r0 = _mm_unpacklo_epi8(v0, v1);
+		const __m128i r1 = _mm_unpackhi_epi8(v0, v1);
+		const __m128i r2 = _mm_unpacklo_epi8(v2, v3);
+		const __m128i r3 = _mm_unpackhi_epi8(v2, v3);
+
+		alignas(16) uint32_t words[BYTE_GROUP_SIZE];
+		_mm_store_si128(reinterpret_cast<__m128i*>(words + 0), _mm_unpacklo_epi16(r0, r2));
+		_mm_store_si128(reinterpret_cast<__m128i*>(words + 4), _mm_unpackhi_epi16(r0, r2));
+		_mm_store_si128(reinterpret_cast<__m128i*>(words + 8), _mm_unpacklo_epi16(r1, r3));
+		_mm_store_si128(reinterpret_cast<__m128i*>(words + 12), _mm_unpackhi_epi16(r1, r3));
+
+		const size_t groupCount = std::min(BYTE_GROUP_SIZE, count - idx);
+		for (size_t element = 0; element < groupCount; ++element)
+		{
+			memcpy(destination + (idx + element) * vertexSize, &words[element], sizeof(uint32_t));
+		}
+
+		memcpy(last, &words[groupCount - 1], sizeof(uint32_t));
+	}
+}
+
+template<bool SSE41>
+const uint8_t* DecodeVertexBlock(
+	const uint8_t* data, const uint8_t* dataEnd, uint8_t* vertices, size_t vertexCount, size_t vertexSize, uint8_t* lastVertex)
+{
+	uint8_t deltas[4][VERTEX_BLOCK_MAX_SIZE];
+	const size_t alignedCount = (vertexCount + BYTE_GROUP_SIZE - 1) & ~(BYTE_GROUP_SIZE - 1);
+
+	// every byte of the vertex is a separate stream of deltas, the vertex size is a multiple of 4
+	for (size_t byte = 0; byte < vertexSize; byte += 4)
+	{
+		for (size_t stream = 0; stream < 4; ++stream)
+		{
+			data = DecodeBytes<SSE41>(data, dataEnd, deltas[stream], alignedCount);
+			if (!data)
+			{
+				return nullptr;
+			}
+		}
+
+		if (SSE41)
+		{
+			DecodeDeltas4SSE41(deltas, vertexCount, vertices + byte, vertexSize, lastVertex + byte);
+			continue;
+		}
+
+		for (size_t stream = 0; stream < 4; ++stream)
+		{
+			DecodeDeltas(deltas[stream], vertexCount, vertices + byte + stream, vertexSize, lastVertex[byte + stream]);
+		}
+	}
+
+	return data;
+}
+
+template<bool SSE41>
+bool DecodeVertexBuffer(uint8_t* destination, size_t count, size_t vertexSize, const uint8_t* data, size_t size)
+{
+	if (vertexSize == 0 || vertexSize > VERTEX_MAX_SIZE || vertexSize % 4 != 0 || size < 1 + vertexSize)
+	{
+		return false;
+	}
+
+	const uint8_t* dataEnd = data + size;
+	if (*data++ != VERTEX_HEADER)
+	{
+		return false;
+	}
+
+	// the first vertex deltas start from is stored at the very end
+	uint8_t lastVertex[VERTEX_MAX_SIZE];
+	memcpy(lastVertex, dataEnd - vertexSize, vertexSize);
+
+	const size_t blockSize = GetVertexBlockSize(vertexSize);
+	for (size_t offset = 0; offset < count; offset += blockSize)
+	{
+		const size_t blockCount = std::min(blockSize, count - offset);
+		data = DecodeVertexBlock<SSE41>(data, dataEnd, destination + offset * vertexSize, blockCount, vertexSize, lastVertex);
+		if (!data)
+		{
+			return false;
+		}
+	}
+
+	const size_t tailSize = std::max(vertexSize, TAIL_MAX_SIZE);
+	return static_cast<size_t>(dataEnd - data) == tailSize;
+}
+
+uint32_t DecodeVByte(const uint8_t*& data)
+{
+	const uint8_t lead = *data++;
+	if (lead < 128)
+	{
+		return lead;
+	}
+
+	// 7 bits per byte, lowest first, up to 5 bytes
+	uint32_t result = lead & 127;
+	uint32_t shift = 7;
+	for (int idx = 0; idx < 4; ++idx)
+	{
+		const uint8_t group = *data++;
+		result |= static_cast<uint32_t>(group & 127) << shift;
+		shift += 7;
+
+		if (group < 128)
+		{
+			break;
+		}
+	}
+
+	return result;
+}
+
+uint32_t DecodeIndex(const uint8_t*& data, uint32_t last)
+{
+	const uint32_t value = DecodeVByte(data);
+	const uint32_t delta = (value >> 1) ^ (0u - (value & 1));
+
+	return last + delta;
+}
+
+void WriteIndex(void* destination, size_t idx, size_t indexSize, uint32_t index)
+{
+	if (indexSize == 2)
+	{
+		static_cast<uint16_t*>(destination)[idx] = static_cast<uint16_t>(index);
+	}
+	else
+	{
+		static_cast<uint32_t*>(destination)[idx] = index;
+	}
+}
+
+struct TriangleFifos
+{
+	uint32_t edges[16][2];
+	uint32_t vertices[16];
+	size_t edgeOffset = 0;
+	size_t vertexOffset = 0;
+
+	TriangleFifos()
+	{
+		memset(edges, -1, sizeof(edges));
+		memset(vertices, -1, sizeof(vertices));
+	}
+
+	void PushEdge(uint32_t a, uint32_t b)
+	{
+		edges[edgeOffset][0] = a;
+		edges[edgeOffset][1] = b;
+		edgeOffset = (edgeOffset + 1) & 15;
+	}
+
+	void PushVertex(uint32_t vertex, bool advance = true)
+	{
+		vertices[vertexOffset] = vertex;
+		vertexOffset = (vertexOffset + (advance ? 1 : 0)) & 15;
+	}
+};
+
+// Triangles are coded against recently seen edges and vertices, new vertices are mostly the next ones in order.
+bool DecodeTriangles(void* destination, size_t count, size_t indexSize, const uint8_t* buffer, size_t size)
+{
+	// header, a code per triangle and the 16 byte table of frequent codes
+	if (count % 3 != 0 || size < 1 + count / 3 + 16 || (buffer[0] & 0xf0) != TRIANGLE_HEADER)
+	{
+		return false;
+	}
+
+	const int version = buffer[0] & 0x0f;
+	if (version > 1)
+	{
+		return false;
+	}
+
+	TriangleFifos fifos;
+	uint32_t next = 0;
+	uint32_t last = 0;
+
+	// version 1 codes strips through the two highest vertex fifo codes
+	const int fecMax = version >= 1 ? 13 : 15;
+
+	const uint8_t* code = buffer + 1;
+	const uint8_t* data = code + count / 3;
+	const uint8_t* dataSafeEnd = buffer + size - 16;
+	const uint8_t* codeAuxTable = dataSafeEnd;
+
+	for (size_t idx = 0; idx < count; idx += 3)
+	{
+		// a triangle reads 16 bytes at most, the table makes the tail safe
+		if (data > dataSafeEnd)
+		{
+			return false;
+		}
+
+		const uint8_t codeTri = *code++;
+		if (codeTri < 0xf0)
+		{
+			// an edge from the fifo and a vertex from the fifo, next or free
+			const int fe = codeTri >> 4;
+			const uint32_t a = fifos.edges[(fifos.edgeOffset - 1 - fe) & 15][0];
+			const uint32_t b = fifos.edges[(fifos.edgeOffset - 1 - fe) & 15][1];
+
+			const int fec = codeTri & 15;
+			if (fec < fecMax)
+			{
+				const uint32_t c = fec == 0 ? next : fifos.vertices[(fifos.vertexOffset - 1 - fec) & 15];
+				next += fec == 0 ? 1 : 0;
+
+				WriteIndex(destination, idx + 0, indexSize, a);
+				WriteIndex(destination, idx + 1, indexSize, b);
+				WriteIndex(destination, idx + 2, indexSize, c);
+
+				fifos.PushVertex(c, fec == 0);
+				fifos.PushEdge(c, b);
+				fifos.PushEdge(a, c);
+			}
+			else
+			{
+				// 13 and 14 are last - 1 and last + 1, 15 a free index delta
+				const uint32_t c = fec != 15 ? last + static_cast<uint32_t>(fec - (fec ^ 3)) : DecodeIndex(data, last);
+				last = c;
+
+				WriteIndex(destination, idx + 0, indexSize, a);
+				WriteIndex(destination, idx + 1, indexSize, b);
+				WriteIndex(destination, idx + 2, indexSize, c);
+
+				fifos.PushVertex(c);
+				fifos.PushEdge(c, b);
+				fifos.PushEdge(a, c);
+			}
+		}
+		else if (codeTri < 0xfe)
+		{
+			// all three vertices are new or in the vertex fifo, modes come from the table
+			const uint8_t codeAux = codeAuxTable[codeTri & 15];
+			const int feb = codeAux >> 4;
+			const int fec = codeAux & 15;
+
+			const uint32_t a = next++;
+			const uint32_t b = feb == 0 ? next : fifos.vertices[(fifos.vertexOffset - feb) & 15];
+			next += feb == 0 ? 1 : 0;
+			const uint32_t c = fec == 0 ? next : fifos.vertices[(fifos.vertexOffset - fec) & 15];
+			next += fec == 0 ? 1 : 0;
+
+			WriteIndex(destination, idx + 0, indexSize, a);
+			WriteIndex(destination, idx + 1, indexSize, b);
+			WriteIndex(destination, idx + 2, indexSize, c);
+
+			fifos.PushVertex(a);
+			fifos.PushVertex(b, feb == 0);
+			fifos.PushVertex(c, fec == 0);
+			fifos.PushEdge(b, a);
+			fifos.PushEdge(c, b);
+			fifos.PushEdge(a, c);
+		}
+		else
+		{
+			// same with explicit modes, free indices allowed and a zero byte restarts next
+			const uint8_t codeAux = *data++;
+			const int fea = codeTri == 0xfe ? 0 : 15;
+			const int feb = codeAux >> 4;
+			const int fec = codeAux & 15;
+
+			if (codeAux == 0)
+			{
+				next = 0;
+			}
+
+			uint32_t a = fea == 0 ? next++ : 0;
+			uint32_t b = feb == 0 ? next++ : fifos.vertices[(fifos.vertexOffset - feb) & 15];
+			uint32_t c = fec == 0 ? next++ : fifos.vertices[(fifos.vertexOffset - fec) & 15];
+
+			if (fea == 15)
+			{
+				last = a = DecodeIndex(data, last);
+			}
+			if (feb == 15)
+			{
+				last = b = DecodeIndex(data, last);
+			}
+			if (fec == 15)
+			{
+				last = c = DecodeIndex(data, last);
+			}
+
+			WriteIndex(destination, idx + 0, indexSize, a);
+			WriteIndex(destination, idx + 1, indexSize, b);
+			WriteIndex(destination, idx + 2, indexSize, c);
+
+			fifos.PushVertex(a);
+			fifos.PushVertex(b, feb == 0 || feb == 15);
+			fifos.PushVertex(c, fec == 0 || fec == 15);
+			fifos.PushEdge(b, a);
+			fifos.PushEdge(c, b);
+			fifos.PushEdge(a, c);
+		}
+	}
+
+	// all data is read up to the table
+	return data == dataSafeEnd;
+}
+
+// Indices are deltas against one of two baselines, the lowest bit picks the baseline.
+bool DecodeIndexSequence(void* destination, size_t count, size_t indexSize, const uint8_t* buffer, size_t size)
+{
+	// header, a byte per index at least and a 4 byte tail
+	if (size < 1 + count + 4 || (buffer[0] & 0xf0) != SEQUENCE_HEADER || (buffer[0] & 0x0f) > 1)
+	{
+		return false;
+	}
+
+	const uint8_t* data = buffer + 1;
+	const uint8_t* dataSafeEnd = buffer + size - 4;
+
+	uint32_t last[2] = {};
+	for (size_t idx = 0; idx < count; ++idx)
+	{
+		// an index reads 5 bytes at most, the tail makes it safe
+		if (data >= dataSafeEnd)
+		{
+			return false;
+		}
+
+		uint32_t value = DecodeVByte(data);
+		const uint32_t baseline = value & 1;
+		value >>= 1;
+
+		const uint32_t index = last[baseline] + ((value >> 1) ^ (0u - (value & 1)));
+		last[baseline] = index;
+
+		WriteIndex(destination, idx, indexSize, index);
+	}
+
+	return data == dataSafeEnd;
+}
+
+template<typename T>
+void DecodeOctahedral(T* data, size_t count, size_t begin = 0)
+{
+	const float max = static_cast<float>((1 << (sizeof(T) * 8 - 1)) - 1);
+
+	for (size_t idx = begin; idx < count; ++idx)
+	{
+		// z stores the encoding of 1 at the same precision
+		float x = static_cast<float>(data[idx * 4 + 0]);
+		float y = static_cast<float>(data[idx * 4 + 1]);
+		const float z = static_cast<float>(data[idx * 4 + 2]) - std::fabs(x) - std::fabs(y);
+
+		// fold back the lower hemisphere
+		const float t = z >= 0.0f ? 0.0f : z;
+		x += x >= 0.0f ? t : -t;
+		y += y >= 0.0f ? t : -t;
+
+		const float length = std::sqrt(x * x + y * y + z * z);
+		const float scale = max / length;
+
+		data[idx * 4 + 0] = static_cast<T>(static_cast<int>(x * scale + (x >= 0.0f ? 0.5f : -0.5f)));
+		data[idx * 4 + 1] = static_cast<T>(static_cast<int>(y * scale + (y >= 0.0f ? 0.5f : -0.5f)));
+		data[idx * 4 + 2] = static_cast<T>(static_cast<int>(z * scale + (z >= 0.0f ? 0.5f : -0.5f)));
+	}
+}
+
+void DecodeQuaternion(int16_t* data, size_t count, size_t begin = 0)
+{
+	const float scale = 1.0f / std::sqrt(2.0f);
+
+	for (size_t idx = begin; idx < count; ++idx)
+	{
+		// the last component holds the scale and the index of the dropped largest component
+		const int scaleBits = data[idx * 4 + 3] | 3;
+		const float componentScale = scale / static_cast<float>(scaleBits);
+
+		const float x = static_cast<float>(data[idx * 4 + 0]) * componentScale;
+		const float y = static_cast<float>(data[idx * 4 + 1]) * componentScale;
+		const float z = static_cast<float>(data[idx * 4 + 2]) * componentScale;
+
+		const float ww = 1.0f - x * x - y * y - z * z;
+		const float w = std::sqrt(ww >= 0.0f ? ww : 0.0f);
+
+		const int xi = static_cast<int>(x * 32767.0f + (x >= 0.0f ? 0.5f : -0.5f));
+		const int yi = static_cast<int>(y * 32767.0f + (y >= 0.0f ? 0.5f : -0.5f));
+		const int zi = static_cast<int>(z * 32767.0f + (z >= 0.0f ? 0.5f : -0.5f));
+		const int wi = static_cast<int>(w * 32767.0f + 0.5f);
+
+		const int dropped = data[idx * 4 + 3] & 3;
+		data[idx * 4 + ((dropped + 1) & 3)] = static_cast<int16_t>(xi);
+		data[idx * 4 + ((dropped + 2) & 3)] = static_cast<int16_t>(yi);
+		data[idx * 4 + ((dropped + 3) & 3)] = static_cast<int16_t>(zi);
+		data[idx * 4 + ((dropped + 0) & 3)] = static_cast<int16_t>(wi);
+	}
+}
+
+void DecodeExponential(uint32_t* data, size_t count, size_t begin = 0)
+{
+	for (size_t idx = begin; idx < count; ++idx)
+	{
+		// 24 bit signed mantissa, 8 bit signed exponent
+		const int32_t mantissa = static_cast<int32_t>(data[idx] << 8) >> 8;
+		const int32_t exponent = static_cast<int32_t>(data[idx]) >> 24;
+
+		// ldexp of the mantissa without the library call
+		const uint32_t powerBits = static_cast<uint32_t>(exponent + 127) << 23;
+		float power;
+		memcpy(&power, &powerBits, sizeof(power));
+
+		const float value = power * static_cast<float>(mantissa);
+		memcpy(&data[idx], &value, sizeof(value));
+	}
+}
+
+// Rounds to the nearest integer away from zero, the same as the scalar filters.
+SD_TARGET_AVX2 __m256i RoundToInt(__m256 value)
+{
+	const __m256 sign = _mm256_and_ps(value, _mm256_set1_ps(-0.0f));
+	return _mm256_cvttps_epi32(_mm256_add_ps(value, _mm256_or_ps(sign, _mm256_set1_ps(0.5f))));
+}
+
+// Octahedral x, y, z in lanes of 8 elements, results are scaled back to the component range.
+SD_TARGET_AVX2 void DecodeOctahedralLanes(__m256& x, __m256& y, __m256& z, float max)
+{
+	const __m256 signMask = _mm256_set1_ps(-0.0f);
+
+	z = _mm256_sub_ps(_mm256_sub_ps(z, _mm256_andnot_ps(signMask, x)), _mm256_andnot_ps(signMask, y));
+
+	const __m256 t = _mm256_min_ps(z, _mm256_setzero_ps());
+	x = _mm256_add_ps(x, _mm256_xor_ps(t, _mm256_and_ps(x, signMask)));
+	y = _mm256_add_ps(y, _mm256_xor_ps(t, _mm256_and_ps(y, signMask)));
+
+	const __m256 length = _mm256_sqrt_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y)), _mm256_mul_ps(z, z)));
+	const __m256 scale = _mm256_div_ps(_mm256_set1_ps(max), length);
+
+	x = _mm256_mul_ps(x, scale);
+	y = _mm256_mul_ps(y, scale);
+	z = _mm256_mul_ps(z, scale);
+}
+
+SD_TARGET_AVX2 void DecodeOctahedral8AVX2(int8_t* data, size_t count)
+{
+	const size_t simdCount = count & ~size_t(7);
+	for (size_t idx = 0; idx < simdCount; idx += 8)
+	{
+		// an element per 32 bit lane
+		const __m256i packed = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + idx * 4));
+
+		__m256 x = _mm256_cvtepi32_ps(_mm256_srai_epi32(_mm256_slli_epi32(packed, 24), 24));
+		__m256 y = _mm256_cvtepi32_ps(_mm256_srai_epi32(_mm256_slli_epi32(packed, 16), 24));
+		__m256 z = _mm256_cvtepi32_ps(_mm256_srai_epi32(_mm256_slli_epi32(packed, 8), 24));
+
+		DecodeOctahedralLanes(x, y, z, 127.0f);
+
+		const __m256i byteMask = _mm256_set1_epi32(0xff);
+		__m256i result = _mm256_and_si256(packed, _mm256_set1_epi32(static_cast<int>(0xff000000)));
+		result = _mm256_or_si256(result, _mm256_and_si256(RoundToInt(x), byteMask));
+		result = _mm256_or_si256(result, _mm256_slli_epi32(_mm256_and_si256(RoundToInt(y), byteMask), 8));
+		result = _mm256_or_si256(result, _mm256_slli_epi32(_mm256_and_si256(RoundToInt(z), byteMask), 16));
+
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(data + idx * 4), result);
+	}
+
+	DecodeOctahedral(data, count, simdCount);
+}
+
+SD_TARGET_AVX2 void DecodeOctahedral16AVX2(int16_t* data, size_t count)
+{
+	const size_t simdCount = count & ~size_t(7);
+	for (size_t idx = 0; idx < simdCount; idx += 8)
+	{
+		// x|y and z|w pairs of 4 elements per register
+		const __m256i packed0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + idx * 4));
+		const __m256i packed1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + idx * 4 + 16));
+
+		// even lanes x|y, odd lanes z|w -> all x|y lanes first, then all z|w lanes
+		const __m256i order = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+		const __m256i sorted0 = _mm256_permutevar8x32_epi32(packed0, order);
+		const __m256i sorted1 = _mm256_permutevar8x32_epi32(packed1, order);
+		const __m256i xy = _mm256_permute2x128_si256(sorted0, sorted1, 0x20);
+		const __m256i zw = _mm256_permute2x128_si256(sorted0, sorted1, 0x31);
+
+		__m256 x = _mm256_cvtepi32_ps(_mm256_srai_epi32(_mm256_slli_epi32(xy, 16), 16));
+		__m256 y = _mm256_cvtepi32_ps(_mm256_srai_epi32(xy, 16));
+		__m256 z = _mm256_cvtepi32_ps(_mm256_srai_epi32(_mm256_slli_epi32(zw, 16), 16));
+
+		DecodeOctahedralLanes(x, y, z, 32767.0f);
+
+		const __m256i shortMask = _mm256_set1_epi32(0xffff);
+		const __m256i resultXY = _mm256_or_si256(_mm256_and_si256(RoundToInt(x), shortMask), _mm256_slli_epi32(RoundToInt(y), 16));
+		const __m256i resultZW = _mm256_or_si256(_mm256_and_si256(RoundToInt(z), shortMask), _mm256_andnot_si256(shortMask, zw));
+
+		// back to x|y, z|w pairs per element
+		const __m256i restore = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+		const __m256i result0 = _mm256_permutevar8x32_epi32(_mm256_permute2x128_si256(resultXY, resultZW, 0x20), restore);
+		const __m256i result1 = _mm256_permutevar8x32_epi32(_mm256_permute2x128_si256(resultXY, resultZW, 0x31), restore);
+
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(data + idx * 4), result0);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(data + idx * 4 + 16), result1);
+	}
+
+	DecodeOctahedral(data, count, simdCount);
+}
+
+SD_TARGET_AVX2 void DecodeQuaternionAVX2(int16_t* data, size_t count)
+{
+	const float scale = 1.0f / std::sqrt(2.0f);
+
+	const size_t simdCount = count & ~size_t(7);
+	for (size_t idx = 0; idx < simdCount; idx += 8)
+	{
+		const __m256i packed0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + idx * 4));
+		const __m256i packed1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + idx * 4 + 16));
+
+		const __m256i order = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+		const __m256i sorted0 = _mm256_permutevar8x32_epi32(packed0, order);
+		const __m256i sorted1 = _mm256_permutevar8x32_epi32(packed1, order);
+		const __m256i xy = _mm256_permute2x128_si256(sorted0, sorted1, 0x20);
+		const __m256i zs = _mm256_permute2x128_si256(sorted0, sorted1, 0x31);
+
+		const __m256i scaleBits = _mm256_or_si256(_mm256_srai_epi32(zs, 16), _mm256_set1_epi32(3));
+		const __m256 componentScale = _mm256_div_ps(_mm256_set1_ps(scale), _mm256_cvtepi32_ps(scaleBits));
+
+		const __m256 x = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srai_epi32(_mm256_slli_epi32(xy, 16), 16)), componentScale);
+		const __m256 y = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srai_epi32(xy, 16)), componentScale);
+		const __m256 z = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srai_epi32(_mm256_slli_epi32(zs, 16), 16)), componentScale);
+
+		const __m256 ww = _mm256_sub_ps(
+			_mm256_sub_ps(_mm256_sub_ps(_mm256_set1_ps(1.0f), _mm256_mul_ps(x, x)), _mm256_mul_ps(y, y)), _mm256_mul_ps(z, z));
+		const __m256 w = _mm256_sqrt_ps(_mm256_max_ps(ww, _mm256_setzero_ps()));
+
+		const __m256 maxValue = _mm256_set1_ps(32767.0f);
+		const __m256i shortMask = _mm256_set1_epi32(0xffff);
+
+		// w|x and y|z pairs, rotated by the dropped component index below
+		const __m256i wx = _mm256_or_si256(
+			_mm256_and_si256(RoundToInt(_mm256_mul_ps(w, maxValue)), shortMask), _mm256_slli_epi32(RoundToInt(_mm256_mul_ps(x, maxValue)), 16));
+		const __m256i yz = _mm256_or_si256(
+			_mm256_and_si256(RoundToInt(_mm256_mul_ps(y, maxValue)), shortMask), _mm256_slli_epi32(RoundToInt(_mm256_mul_ps(z, maxValue)), 16));
+
+		const __m256i restore = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+		const __m256i wxyz0 = _mm256_permutevar8x32_epi32(_mm256_permute2x128_si256(wx, yz, 0x20), restore);
+		const __m256i wxyz1 = _mm256_permutevar8x32_epi32(_mm256_permute2x128_si256(wx, yz, 0x31), restore);
+
+		// w goes to the dropped index: rotate every 64 bit element left by 16 bits per index
+		const __m256i dropped0 = _mm256_and_si256(_mm256_srli_epi64(packed0, 48), _mm256_set1_epi64x(3));
+		const __m256i dropped1 = _mm256_and_si256(_mm256_srli_epi64(packed1, 48), _mm256_set1_epi64x(3));
+		const __m256i shift0 = _mm256_slli_epi64(dropped0, 4);
+		const __m256i shift1 = _mm256_slli_epi64(dropped1, 4);
+		const __m256i bits = _mm256_set1_epi64x(64);
+
+		const __m256i result0 = _mm256_or_si256(_mm256_sllv_epi64(wxyz0, shift0), _mm256_srlv_epi64(wxyz0, _mm256_sub_epi64(bits, shift0)));
+		const __m256i result1 = _mm256_or_si256(_mm256_sllv_epi64(wxyz1, shift1), _mm256_srlv_epi64(wxyz1, _mm256_sub_epi64(bits, shift1)));
+
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(data + idx * 4), result0);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(data + idx * 4 + 16), result1);
+	}
+
+	DecodeQuaternion(data, count, simdCount);
+}
+
+SD_TARGET_AVX2 void DecodeExponentialAVX2(uint32_t* data, size_t count)
+{
+	const size_t simdCount = count & ~size_t(7);
+	for (size_t idx = 0; idx < simdCount; idx += 8)
+	{
+		const __m256i packed = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + idx));
+
+		const __m256i mantissa = _mm256_srai_epi32(_mm256_slli_epi32(packed, 8), 8);
+		const __m256i exponent = _mm256_srai_epi32(packed, 24);
+		const __m256 power = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_add_epi32(exponent, _mm256_set1_epi32(127)), 23));
+
+		const __m256 value = _mm256_mul_ps(power, _mm256_cvtepi32_ps(mantissa));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(data + idx), _mm256_castps_si256(value));
+	}
+
+	DecodeExponential(data, count, simdCount);
+}
+
+bool ApplyFilter(uint8_t* data, size_t count, size_t byteStride, SD::ENGINE::MeshoptFilter filter, bool avx2)
+{
+	switch (filter)
+	{
+	case SD::ENGINE::MeshoptFilter::NONE:
+		return true;
+	case SD::ENGINE::MeshoptFilter::OCTAHEDRAL:
+		if (byteStride == 4)
+		{
+			auto* values = reinterpret_cast<int8_t*>(data);
+			avx2 ? DecodeOctahedral8AVX2(values, count) : DecodeOctahedral(values, count);
+			return true;
+		}
+		if (byteStride == 8)
+		{
+			auto* values = reinterpret_cast<int16_t*>(data);
+			avx2 ? DecodeOctahedral16AVX2(values, count) : DecodeOctahedral(values, count);
+			return true;
+		}
+		return false;
+	case SD::ENGINE::MeshoptFilter::QUATERNION:
+		if (byteStride == 8)
+		{
+			auto* values = reinterpret_cast<int16_t*>(data);
+			avx2 ? DecodeQuaternionAVX2(values, count) : DecodeQuaternion(values, count);
+			return true;
+		}
+		return false;
+	case SD::ENGINE::MeshoptFilter::EXPONENTIAL:
+		if (byteStride % 4 == 0)
+		{
+			auto* values = reinterpret_cast<uint32_t*>(data);
+			avx2 ? DecodeExponentialAVX2(values, count * byteStride / 4) : DecodeExponential(values, count * byteStride / 4);
+			return true;
+		}
+		return false;
+	default:
+		return false;
+	}
+}
+
+SD::ENGINE::MeshoptDecoderFeatures DetectFeatures()
+{
+	SD::ENGINE::MeshoptDecoderFeatures features;
+
+#if defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 0);
+	const int maxLeaf = info[0];
+
+	__cpuid(info, 1);
+	features.sse41 = (info[2] & (1 << 19)) != 0;
+
+	// AVX state has to be enabled by the OS as well
+	const bool osxsave = (info[2] & (1 << 27)) != 0;
+	const bool avx = (info[2] & (1 << 28)) != 0;
+	if (maxLeaf >= 7 && osxsave && avx && (_xgetbv(0) & 6) == 6)
+	{
+		__cpuidex(info, 7, 0);
+		features.avx2 = (info[1] & (1 << 5)) != 0;
+	}
+#else
+	features.sse41 = __builtin_cpu_supports("sse4.1");
+	features.avx2 = __builtin_cpu_supports("avx2");
+#endif
+
+	return features;
+}
+}  // end namespace
+
+namespace SD::ENGINE {
+
+const MeshoptDecoderFeatures& GetMeshoptDecoderFeatures()
+{
+	static const MeshoptDecoderFeatures features = DetectFeatures();
+	return features;
+}
+
+bool DecodeMeshoptBuffer(
+	void* destination,
+	size_t count,
+	size_t byteStride,
+	const uint8_t* source,
+	size_t sourceSize,
+	MeshoptMode mode,
+	MeshoptFilter filter)
+{
+	const auto& features = GetMeshoptDecoderFeatures();
+
+	switch (mode)
+	{
+	case MeshoptMode::ATTRIBUTES:
+	{
+		auto* vertices = static_cast<uint8_t*>(destination);
+		const bool decoded = features.sse41
+			? DecodeVertexBuffer<true>(vertices, count, byteStride, source, sourceSize)
+			: DecodeVertexBuffer<false>(vertices, count, byteStride, source, sourceSize);
+
+		return decoded && ApplyFilter(vertices, count, byteStride, filter, features.avx2);
+	}
+	case MeshoptMode::TRIANGLES:
+		return (byteStride == 2 || byteStride == 4) && filter == MeshoptFilter::NONE
+			&& DecodeTriangles(destination, count, byteStride, source, sourceSize);
+	case MeshoptMode::INDICES:
+		return (byteStride == 2 || byteStride == 4) && filter == MeshoptFilter::NONE
+			&& DecodeIndexSequence(destination, count, byteStride, source, sourceSize);
+	default:
+		return false;
+	}
+}
+
+}  // end namespace SD::ENGINE
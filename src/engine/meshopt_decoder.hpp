@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+
+namespace SD::ENGINE {
+
+// EXT_meshopt_compression buffer view modes.
+enum class MeshoptMode : uint8_t
+{
+	ATTRIBUTES,
+	TRIANGLES,
+	INDICES
+};
+
+// EXT_meshopt_compression filters, applied to decoded attributes.
+enum class MeshoptFilter : uint8_t
+{
+	NONE,
+	OCTAHEDRAL,
+	QUATERNION,
+	EXPONENTIAL
+};
+
+// Instruction sets used by the decoder, detected once.
+struct MeshoptDecoderFeatures
+{
+	bool sse41 = false;  // byte groups and deltas of attributes
+	bool avx2 = false;  // filters
+};
+
+const MeshoptDecoderFeatures& GetMeshoptDecoderFeatures();
+
+// Decodes count elements of byteStride bytes (indices of 2 or 4 bytes for TRIANGLES and INDICES) into destination.
+// Returns false for malformed data, destination content is undefined then.
+bool DecodeMeshoptBuffer(
+	void* destination,
+	size_t count,
+	size_t byteStride,
+	const uint8_t* source,
+	size_t sourceSize,
+	MeshoptMode mode,
+	MeshoptFilter filter);
+
+}  // end namespace SD::ENGINE
@@ -0,0 +1,459 @@
+#include "mip_generator.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+#include <emmintrin.h>
+
+#include <DirectXTex.h>
+
+#include "exceptions.hpp"
+
+
+namespace
+{
+constexpr size_t CHANNELS = 4;
+constexpr size_t ROWS_PER_JOB = 16;
+
+// Kaiser window of the sinc, as wide as three destination texels
+constexpr float KAISER_ALPHA = 4.0f;
+constexpr float KAISER_RADIUS = 1.5f;
+
+constexpr float PI = 3.14159265f;
+
+// Four floats per texel, rows without padding.
+struct LinearImage
+{
+	size_t width = 0;
+	size_t height = 0;
+	std::vector<float> pixels = {};
+
+	float* Row(size_t y) { return pixels.data() + y * width * CHANNELS; }
+	const float* Row(size_t y) const { return pixels.data() + y * width * CHANNELS; }
+};
+
+struct Tap
+{
+	uint32_t index;
+	float weight;
+};
+
+// Source texels and weights of every destination texel along one axis.
+struct Kernel
+{
+	std::vector<size_t> offsets;  // destination count + 1
+	std::vector<Tap> taps;
+};
+
+constexpr size_t SRGB_BUCKETS = 4096;
+
+// The 8 bit transfer function both ways: a table of the 256 codes, and the linear values halfway between neighbouring
+// codes, which encode exactly as rounding the curve would. Encoding starts from the code of the value's bucket and
+// steps over the thresholds below the value, one at most but in the darkest buckets.
+struct SrgbTables
+{
+	float toLinear[256];
+	float thresholds[255];
+	uint8_t buckets[SRGB_BUCKETS + 1];
+};
+
+float SrgbToLinear(float value)
+{
+	return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+}
+
+const SrgbTables& GetSrgbTables()
+{
+	static const SrgbTables tables = []()
+	{
+		SrgbTables result = {};
+		for (size_t code = 0; code < 256; ++code)
+		{
+			result.toLinear[code] = SrgbToLinear(static_cast<float>(code) / 255.0f);
+		}
+		for (size_t code = 0; code < 255; ++code)
+		{
+			result.thresholds[code] = SrgbToLinear((static_cast<float>(code) + 0.5f) / 255.0f);
+		}
+		for (size_t bucket = 0; bucket <= SRGB_BUCKETS; ++bucket)
+		{
+			const float value = static_cast<float>(bucket) / static_cast<float>(SRGB_BUCKETS);
+			result.buckets[bucket] = static_cast<uint8_t>(
+				std::upper_bound(result.thresholds, result.thresholds + 255, value) - result.thresholds);
+		}
+		return result;
+	}();
+
+	return tables;
+}
+
+uint8_t LinearToSrgb(float value, const SrgbTables& tables)
+{
+	value = std::clamp(value, 0.0f, 1.0f);
+
+	size_t code = tables.buckets[static_cast<size_t>(value * static_cast<float>(SRGB_BUCKETS))];
+	while (code < 255 && value >= tables.thresholds[code])
+	{
+		++code;
+	}
+
+	return static_cast<uint8_t>(code);
+}
+
+// Zeroth order modified Bessel function of the first kind, by its series.
+float BesselI0(float x)
+{
+	float sum = 1.0f;
+	float term = 1.0f;
+	for (int k = 1; k < 32 && term > sum * 1e-8f; ++k)
+	{
+		term *= (x * x) / (4.0f * static_cast<float>(k * k));
+		sum += term;
+	}
+
+	return sum;
+}
+
+float KaiserSinc(float x)
+{
+	if (std::abs(x) >= KAISER_RADIUS)
+	{
+		return 0.0f;
+	}
+
+	const float ratio = x / KAISER_RADIUS;
+	const float window = BesselI0(KAISER_ALPHA * std::sqrt(1.0f - ratio * ratio)) / BesselI0(KAISER_ALPHA);
+	const float sinc = std::abs(x) < 1e-6f ? 1.0f : std::sin(PI * x) / (PI * x);
+
+	return window * sinc;
+}
+
+// Destination texels cover srcSize / dstSize source texels each, any size works, so do odd and 1 texel wide levels.
+Kernel CreateKernel(size_t srcSize, size_t dstSize, SD::ENGINE::MipFilter filter)
+{
+	const float scale = static_cast<float>(srcSize) / static_cast<float>(dstSize);
+
+	Kernel kernel;
+	kernel.offsets.reserve(dstSize + 1);
+	for (size_t dst = 0; dst < dstSize; ++dst)
+	{
+		kernel.offsets.push_back(kernel.taps.size());
+
+		const float begin = static_cast<float>(dst) * scale;
+		const float end = begin + scale;
+		const float center = (begin + end) * 0.5f;
+		const float radius = filter == SD::ENGINE::MipFilter::BOX ? scale * 0.5f : KAISER_RADIUS * scale;
+
+		const auto first = static_cast<ptrdiff_t>(std::floor(center - radius));
+		const auto last = static_cast<ptrdiff_t>(std::ceil(center + radius));
+
+		float sum = 0.0f;
+		const size_t firstTap = kernel.taps.size();
+		for (ptrdiff_t src = first; src < last; ++src)
+		{
+			const float texelBegin = static_cast<float>(src);
+			const float weight = filter == SD::ENGINE::MipFilter::BOX
+				? std::max(std::min(texelBegin + 1.0f, end) - std::max(texelBegin, begin), 0.0f)
+				: KaiserSinc((texelBegin + 0.5f - center) / scale);
+			if (weight == 0.0f)
+			{
+				continue;
+			}
+
+			// edges repeat the border texel
+			const auto index = static_cast<uint32_t>(std::clamp<ptrdiff_t>(src, 0, static_cast<ptrdiff_t>(srcSize) - 1));
+			kernel.taps.push_back({ index, weight });
+			sum += weight;
+		}
+
+		for (size_t tap = firstTap; tap < kernel.taps.size(); ++tap)
+		{
+			kernel.taps[tap].weight /= sum;
+		}
+	}
+	kernel.offsets.push_back(kernel.taps.size());
+
+	return kernel;
+}
+
+void ForRowBands(SD::JobSystem& jobSystem, size_t maxThreads, size_t height, const std::function<void(size_t, size_t)>& band)
+{
+	jobSystem.ParallelFor((height + ROWS_PER_JOB - 1) / ROWS_PER_JOB, maxThreads, [&](size_t idx)
+	{
+		band(idx * ROWS_PER_JOB, std::min((idx + 1) * ROWS_PER_JOB, height));
+	});
+}
+
+// Rows are filtered vertically into a row of the source width first, then that row horizontally.
+void Downsample(const LinearImage& src, LinearImage& dst, const Kernel& horizontal, const Kernel& vertical,
+	SD::JobSystem& jobSystem, size_t maxThreads)
+{
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 maximum = _mm_set_ps(1.0f, std::numeric_limits<float>::max(), std::numeric_limits<float>::max(),
+		std::numeric_limits<float>::max());
+
+	ForRowBands(jobSystem, maxThreads, dst.height, [&](size_t firstRow, size_t lastRow)
+	{
+		std::vector<float> row(src.width * CHANNELS);
+		for (size_t y = firstRow; y < lastRow; ++y)
+		{
+			std::fill(row.begin(), row.end(), 0.0f);
+			for (size_t tap = vertical.offsets[y]; tap < vertical.offsets[y + 1]; ++tap)
+			{
+				const float* srcRow = src.Row(vertical.taps[tap].index);
+				const __m128 weight = _mm_set1_ps(vertical.taps[tap].weight);
+				for (size_t x = 0; x < src.width * CHANNELS; x += CHANNELS)
+				{
+					_mm_storeu_ps(&row[x], _mm_add_ps(_mm_loadu_ps(&row[x]), _mm_mul_ps(_mm_loadu_ps(srcRow + x), weight)));
+				}
+			}
+
+			float* dstRow = dst.Row(y);
+			for (size_t x = 0; x < dst.width; ++x)
+			{
+				__m128 texel = _mm_setzero_ps();
+				for (size_t tap = horizontal.offsets[x]; tap < horizontal.offsets[x + 1]; ++tap)
+				{
+					const __m128 weight = _mm_set1_ps(horizontal.taps[tap].weight);
+					texel = _mm_add_ps(texel, _mm_mul_ps(_mm_loadu_ps(&row[horizontal.taps[tap].index * CHANNELS]), weight));
+				}
+
+				// negative lobes ring below black and above opaque
+				_mm_storeu_ps(dstRow + x * CHANNELS, _mm_min_ps(_mm_max_ps(texel, zero), maximum));
+			}
+		}
+	});
+}
+
+// Fraction of texels whose alpha passes the cutoff.
+float GetAlphaCoverage(const LinearImage& image, float cutoff)
+{
+	size_t passing = 0;
+	for (size_t idx = 3; idx < image.pixels.size(); idx += CHANNELS)
+	{
+		if (image.pixels[idx] > cutoff)
+		{
+			++passing;
+		}
+	}
+
+	return static_cast<float>(passing) / static_cast<float>(image.width * image.height);
+}
+
+// Alpha scale under which as many texels pass the cutoff as the coverage asks for: the cutoff over the alpha of the
+// most opaque texel that should not pass.
+float GetAlphaScale(const LinearImage& image, float cutoff, float coverage)
+{
+	std::vector<float> alphas;
+	alphas.reserve(image.width * image.height);
+	for (size_t idx = 3; idx < image.pixels.size(); idx += CHANNELS)
+	{
+		alphas.push_back(image.pixels[idx]);
+	}
+
+	const auto passing = static_cast<size_t>(std::lround(coverage * static_cast<float>(alphas.size())));
+	if (passing >= alphas.size())
+	{
+		return 1.0f;
+	}
+
+	const auto failing = alphas.begin() + static_cast<ptrdiff_t>(alphas.size() - passing - 1);
+	std::nth_element(alphas.begin(), failing, alphas.end());
+
+	return *failing > 0.0f ? cutoff / *failing : 1.0f;
+}
+
+bool IsRgba8(DXGI_FORMAT format)
+{
+	return format == DXGI_FORMAT_R8G8B8A8_UNORM || format == DXGI_FORMAT_R8G8B8A8_UNORM_SRGB;
+}
+
+DirectX::TEX_FILTER_FLAGS GetConvertFlags(bool srgb, DirectX::TEX_FILTER_FLAGS direction)
+{
+	return srgb ? direction : DirectX::TEX_FILTER_DEFAULT;
+}
+
+LinearImage Decode(const DirectX::Image& image, bool srgb, SD::JobSystem& jobSystem, size_t maxThreads)
+{
+	LinearImage linear;
+	linear.width = image.width;
+	linear.height = image.height;
+	linear.pixels.resize(image.width * image.height * CHANNELS);
+
+	if (image.format == DXGI_FORMAT_R32G32B32A32_FLOAT)
+	{
+		for (size_t y = 0; y < image.height; ++y)
+		{
+			std::memcpy(linear.Row(y), image.pixels + y * image.rowPitch, image.width * CHANNELS * sizeof(float));
+		}
+		return linear;
+	}
+
+	if (IsRgba8(image.format))
+	{
+		const auto& tables = GetSrgbTables();
+		const __m128i zero = _mm_setzero_si128();
+		const __m128 normalize = _mm_set1_ps(1.0f / 255.0f);
+
+		ForRowBands(jobSystem, maxThreads, image.height, [&](size_t firstRow, size_t lastRow)
+		{
+			for (size_t y = firstRow; y < lastRow; ++y)
+			{
+				const uint8_t* src = image.pixels + y * image.rowPitch;
+				float* dst = linear.Row(y);
+				for (size_t x = 0; x < image.width; ++x)
+				{
+					const __m128i texel = _mm_cvtsi32_si128(*reinterpret_cast<const int*>(src + x * CHANNELS));
+					const __m128i channels = _mm_unpacklo_epi16(_mm_unpacklo_epi8(texel, zero), zero);
+					_mm_storeu_ps(dst + x * CHANNELS, _mm_mul_ps(_mm_cvtepi32_ps(channels), normalize));
+
+					if (srgb)
+					{
+						for (size_t channel = 0; channel < 3; ++channel)
+						{
+							dst[x * CHANNELS + channel] = tables.toLinear[src[x * CHANNELS + channel]];
+						}
+					}
+				}
+			}
+		});
+		return linear;
+	}
+
+	DirectX::ScratchImage converted;
+	const HRESULT hr = DirectX::Convert(image, DXGI_FORMAT_R32G32B32A32_FLOAT, GetConvertFlags(srgb, DirectX::TEX_FILTER_SRGB_IN),
+		DirectX::TEX_THRESHOLD_DEFAULT, converted);
+	if (FAILED(hr))
+	{
+		throw SD::SomeWinException(__LINE__, __FILEW__, hr);
+	}
+
+	return Decode(*converted.GetImage(0, 0, 0), false, jobSystem, maxThreads);
+}
+
+void Encode(const LinearImage& linear, const DirectX::Image& image, bool srgb, float alphaScale, SD::JobSystem& jobSystem, size_t maxThreads)
+{
+	const __m128 scale = _mm_set_ps(alphaScale, 1.0f, 1.0f, 1.0f);
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.0f);
+
+	if (IsRgba8(image.format))
+	{
+		const auto& tables = GetSrgbTables();
+		const __m128 denormalize = _mm_set1_ps(255.0f);
+
+		ForRowBands(jobSystem, maxThreads, image.height, [&](size_t firstRow, size_t lastRow)
+		{
+			for (size_t y = firstRow; y < lastRow; ++y)
+			{
+				const float* src = linear.Row(y);
+				uint8_t* dst = image.pixels + y * image.rowPitch;
+				for (size_t x = 0; x < image.width; ++x)
+				{
+					const __m128 texel = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(src + x * CHANNELS), scale), zero), one);
+					const __m128i words = _mm_cvtps_epi32(_mm_mul_ps(texel, denormalize));
+					const __m128i shorts = _mm_packs_epi32(words, words);
+					*reinterpret_cast<int*>(dst + x * CHANNELS) = _mm_cvtsi128_si32(_mm_packus_epi16(shorts, shorts));
+
+					if (srgb)
+					{
+						for (size_t channel = 0; channel < 3; ++channel)
+						{
+							dst[x * CHANNELS + channel] = LinearToSrgb(src[x * CHANNELS + channel], tables);
+						}
+					}
+				}
+			}
+		});
+		return;
+	}
+
+	// float texels with the alpha scaled and clamped, written as they are or through DirectXTex
+	LinearImage scaled;
+	const LinearImage* source = &linear;
+	if (alphaScale != 1.0f)
+	{
+		scaled = linear;
+		for (size_t idx = 3; idx < scaled.pixels.size(); idx += CHANNELS)
+		{
+			scaled.pixels[idx] = std::min(scaled.pixels[idx] * alphaScale, 1.0f);
+		}
+		source = &scaled;
+	}
+
+	const DirectX::Image floats = {
+		linear.width, linear.height, DXGI_FORMAT_R32G32B32A32_FLOAT,
+		linear.width * CHANNELS * sizeof(float), linear.width * linear.height * CHANNELS * sizeof(float),
+		reinterpret_cast<uint8_t*>(const_cast<float*>(source->pixels.data())),
+	};
+
+	const DirectX::Image* result = &floats;
+	DirectX::ScratchImage converted;
+	if (image.format != DXGI_FORMAT_R32G32B32A32_FLOAT)
+	{
+		const HRESULT hr = DirectX::Convert(floats, image.format, GetConvertFlags(srgb, DirectX::TEX_FILTER_SRGB_OUT),
+			DirectX::TEX_THRESHOLD_DEFAULT, converted);
+		if (FAILED(hr))
+		{
+			throw SD::SomeWinException(__LINE__, __FILEW__, hr);
+		}
+		result = converted.GetImage(0, 0, 0);
+	}
+
+	for (size_t y = 0; y < image.height; ++y)
+	{
+		std::memcpy(image.pixels + y * image.rowPitch, result->pixels + y * result->rowPitch, std::min(image.rowPitch, result->rowPitch));
+	}
+}
+}  // end namespace
+
+namespace SD::ENGINE {
+
+DirectX::ScratchImage GenerateMips(
+	const DirectX::Image& image,
+	size_t levels,
+	const MipSettings& settings,
+	JobSystem& jobSystem,
+	size_t maxThreads)
+{
+	// filtered on linear values, the transfer function is taken off 8 bit color and put back on
+	const bool srgb = DirectX::IsSRGB(image.format) || (settings.srgb && DirectX::BitsPerColor(image.format) == 8);
+
+	DirectX::ScratchImage mips;
+	WIN_THROW_IF_FAILED(mips.Initialize2D(image.format, image.width, image.height, 1, levels));
+
+	const auto& top = *mips.GetImage(0, 0, 0);
+	for (size_t y = 0; y < image.height; ++y)
+	{
+		std::memcpy(top.pixels + y * top.rowPitch, image.pixels + y * image.rowPitch, std::min(top.rowPitch, image.rowPitch));
+	}
+
+	auto previous = Decode(image, srgb, jobSystem, maxThreads);
+	const float coverage = settings.preserveAlphaCoverage ? GetAlphaCoverage(previous, settings.alphaCutoff) : 0.0f;
+
+	LinearImage current;
+	for (size_t level = 1; level < mips.GetMetadata().mipLevels; ++level)
+	{
+		current.width = std::max<size_t>(previous.width / 2, 1);
+		current.height = std::max<size_t>(previous.height / 2, 1);
+		current.pixels.resize(current.width * current.height * CHANNELS);
+
+		const auto horizontal = CreateKernel(previous.width, current.width, settings.filter);
+		const auto vertical = CreateKernel(previous.height, current.height, settings.filter);
+		Downsample(previous, current, horizontal, vertical, jobSystem, maxThreads);
+
+		// scaled on the way out only, the next level filters the unscaled one
+		const float alphaScale = settings.preserveAlphaCoverage ? GetAlphaScale(current, settings.alphaCutoff, coverage) : 1.0f;
+
+		Encode(current, *mips.GetImage(level, 0, 0), srgb, alphaScale, jobSystem, maxThreads);
+
+		std::swap(previous, current);
+	}
+
+	return mips;
+}
+
+}  // end namespace SD::ENGINE
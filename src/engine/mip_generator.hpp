@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#include "job_system.hpp"
+
+
+namespace DirectX {
+	class ScratchImage;
+	struct Image;
+}
+
+namespace SD::ENGINE {
+
+enum class MipFilter : uint32_t
+{
+	BOX,  // area average
+	KAISER,  // Kaiser windowed sinc, sharper, clamped where it rings below zero
+};
+
+struct MipSettings
+{
+	MipFilter filter = MipFilter::BOX;
+	// 8 bit color channels are gamma encoded even if the format is not sRGB, sRGB formats always are
+	bool srgb = false;
+	// alpha tested textures keep the fraction of texels passing the cutoff in every mip
+	bool preserveAlphaCoverage = false;
+	float alphaCutoff = 0.5f;
+};
+
+// Mip chain of a 2D image, levels counts the top one, 0 for the full chain. Each level is filtered from the one above
+// it in linear space, four channels per SSE register, in bands of rows run on the job system by at most maxThreads
+// threads (the calling one included). RGBA8 and RGBA32F are converted here, other formats through DirectXTex.
+DirectX::ScratchImage GenerateMips(
+	const DirectX::Image& image,
+	size_t levels,
+	const MipSettings& settings,
+	JobSystem& jobSystem,
+	size_t maxThreads = std::numeric_limits<size_t>::max());
+
+}  // end namespace SD::ENGINE
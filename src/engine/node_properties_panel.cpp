@@ -12,6 +12,11 @@ enum NodeID : uint64_t
 	Mesh,
 	Material
 };
+
+bool Differs(const DirectX::XMFLOAT3& value, const DirectX::XMFLOAT3& other)
+{
+	return value.x != other.x || value.y != other.y || value.z != other.z;
+}
 } // end namespace
 
 namespace SD::ENGINE {
@@ -160,6 +165,14 @@ void NodePropertiesPanel::DrawTransform(World::Node* node)
 
 	if (ImGui::TreeNodeEx((void*)NodeID::Transform, flags, "Transform"))
 	{
+		if (node->m_static)
+		{
+			// transform is baked into the static geometry until it is edited
+			ImGui::Text("Static, editing unbakes it");
+		}
+
+		bool edited = false;
+
 		DirectX::XMVECTOR scale;
 		DirectX::XMVECTOR rotation;
 		DirectX::XMVECTOR translation;
@@ -170,7 +183,9 @@ void NodePropertiesPanel::DrawTransform(World::Node* node)
 			DirectX::XMFLOAT3 s, os;
 			DirectX::XMStoreFloat3(&s, scale);
 			DirectX::XMStoreFloat3(&os, node->m_originalScale);
+			const auto before = s;
 			DrawVector3Control("Scale", s, os);
+			edited |= Differs(s, before);
 			scale = DirectX::XMLoadFloat3(&s);
 		}
 
@@ -181,7 +196,9 @@ void NodePropertiesPanel::DrawTransform(World::Node* node)
 			DirectX::XMStoreFloat4(&oq, node->m_originalRotation);
 			DirectX::XMFLOAT3 r = ToDegrees(ToEulerAngles(q));
 			DirectX::XMFLOAT3 or = ToDegrees(ToEulerAngles(oq));
+			const auto before = r;
 			DrawVector3Control("Rotation", r, or);
+			edited |= Differs(r, before);
 			q = ToQuaternion(ToRadians(r));
 			rotation = DirectX::XMLoadFloat4(&q);
 		}
@@ -191,15 +208,26 @@ void NodePropertiesPanel::DrawTransform(World::Node* node)
 			DirectX::XMFLOAT3 t, ot;
 			DirectX::XMStoreFloat3(&t, translation);
 			DirectX::XMStoreFloat3(&ot, node->m_originalTranslation);
+			const auto before = t;
 			DrawVector3Control("Translation", t, ot);
+			edited |= Differs(t, before);
 			translation = DirectX::XMLoadFloat3(&t);
 		}
 
-		node->m_localTransform = DirectX::XMMatrixAffineTransformation(
-			scale,
-			{ 0.f, 0.f, 0.f, 0.f },
-			rotation,
-			translation);
+		// baked descendants follow the edit too
+		if (edited)
+		{
+			node->Unbake();
+		}
+
+		if (!node->m_static)
+		{
+			node->m_localTransform = DirectX::XMMatrixAffineTransformation(
+				scale,
+				{ 0.f, 0.f, 0.f, 0.f },
+				rotation,
+				translation);
+		}
 
 		ImGui::TreePop();
 	}
@@ -255,15 +283,13 @@ void NodePropertiesPanel::DrawPrimitive(const uint64_t id, const World::Primitiv
 	}
 }
 
-void NodePropertiesPanel::DrawMaterial(const World::Material* material)
+void NodePropertiesPanel::DrawMaterial(World::Material* material)
 {
 	if (!material)
 	{
 		return;
 	}
 
-	// TODO
-
 	ImGuiTreeNodeFlags flags = ImGuiTreeNodeFlags_None;
 	flags |= ImGuiTreeNodeFlags_Framed | ImGuiTreeNodeFlags_FramePadding;
 	flags |= ImGuiTreeNodeFlags_DefaultOpen;
@@ -271,8 +297,19 @@ void NodePropertiesPanel::DrawMaterial(const World::Material* material)
 
 	if (ImGui::TreeNodeEx((void*)NodeID::Material, flags, "Material"))
 	{
-		// TODO
-		ImGui::Text("Material properties");
+		ImGui::Text(material->m_name.c_str());
+
+		auto& parameters = material->m_parameters;
+
+		bool changed = false;
+		changed |= ImGui::ColorEdit4("Base Color", &parameters.baseColorFactor.x);
+		changed |= ImGui::SliderFloat("Metallic", &parameters.metallicFactor, 0.0f, 1.0f);
+		changed |= ImGui::SliderFloat("Roughness", &parameters.roughnessFactor, 0.0f, 1.0f);
+		changed |= ImGui::DragFloat("Normal Scale", &parameters.normalMapScale, 0.01f);
+		changed |= ImGui::SliderFloat("Alpha Cutoff", &parameters.alphaCutoff, 0.0f, 1.0f);
+
+		// only this element of the material table is uploaded on the next update
+		material->m_dirty |= changed;
 
 		ImGui::TreePop();
 	}
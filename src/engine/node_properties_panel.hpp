@@ -19,7 +19,7 @@ private:
 	void DrawTransform(World::Node* node);
 	void DrawMesh(const World::Mesh* mesh);
 	void DrawPrimitive(const uint64_t id, const World::Primitive* primitive);
-	void DrawMaterial(const World::Material* material);
+	void DrawMaterial(World::Material* material);
 };
 
 } // end namespace SD::ENGINE
@@ -0,0 +1,110 @@
+#include "render_settings_panel.hpp"
+
+#include <string>
+
+#include <imgui.h>
+
+#include "application.hpp"
+
+
+namespace
+{
+enum NodeID : uint64_t
+{
+	Submission = 0
+};
+} // end namespace
+
+namespace SD::ENGINE {
+
+void RenderSettingsPanel::Draw(World* world)
+{
+	ImGui::Begin("Render Settings");
+
+	DrawSubmission(world);
+
+	ImGui::End();
+}
+
+void RenderSettingsPanel::DrawSubmission(World* world)
+{
+	ImGuiTreeNodeFlags flags = ImGuiTreeNodeFlags_None;
+	flags |= ImGuiTreeNodeFlags_Framed | ImGuiTreeNodeFlags_FramePadding;
+	flags |= ImGuiTreeNodeFlags_DefaultOpen;
+	flags |= ImGuiTreeNodeFlags_SpanAvailWidth;
+
+	if (ImGui::TreeNodeEx((void*)NodeID::Submission, flags, "Submission"))
+	{
+		auto& settings = world->m_submissionSettings;
+		const auto& stats = world->m_submissionStats;
+
+		const auto& jobSystem = Application::GetApplication()->GetJobSystem();
+		const int maxThreads = static_cast<int>(jobSystem->GetWorkersCount()) + 1;
+
+		ImGui::SliderInt("Recording Threads", &settings.recordingThreads, 0, maxThreads, settings.recordingThreads == 0 ? "All" : "%d");
+		ImGui::Checkbox("GPU Playback", &settings.gpuPlayback);
+		ImGui::Checkbox("Cluster Culling", &settings.clusterCulling);
+		ImGui::Checkbox("Depth Prepass", &settings.depthPrepass);
+
+		ImGui::Separator();
+
+		const std::string drawItems = "Draw Items: " + std::to_string(stats.drawItems);
+		ImGui::Text(drawItems.c_str());
+		const std::string buckets = "Opaque / Alpha Test / Blend: "
+			+ std::to_string(stats.bucketItems[static_cast<size_t>(DrawBucket::OPAQUE_GEOMETRY)]) + " / "
+			+ std::to_string(stats.bucketItems[static_cast<size_t>(DrawBucket::ALPHA_TEST)]) + " / "
+			+ std::to_string(stats.bucketItems[static_cast<size_t>(DrawBucket::BLEND)]);
+		ImGui::Text(buckets.c_str());
+		const std::string blendSortShifts = "Blend Sort Shifts: " + std::to_string(stats.blendSortShifts);
+		ImGui::Text(blendSortShifts.c_str());
+		const std::string clusters = "Visible Clusters: " + std::to_string(stats.visibleClusters)
+			+ " / " + std::to_string(stats.clusters) + " (" + std::to_string(stats.drawRanges) + " ranges)";
+		ImGui::Text(clusters.c_str());
+		const std::string commandLists = "Command Lists: " + std::to_string(stats.commandLists);
+		ImGui::Text(commandLists.c_str());
+		const std::string commands = "Commands: " + std::to_string(stats.commands.commands)
+			+ " (state " + std::to_string(stats.commands.stateChanges)
+			+ ", skipped " + std::to_string(stats.commands.skippedChanges) + ")";
+		ImGui::Text(commands.c_str());
+		const std::string draws = "Draws: " + std::to_string(stats.commands.draws)
+			+ " (" + std::to_string(stats.commands.primitives) + " triangles)";
+		ImGui::Text(draws.c_str());
+		const std::string prepass = "Prepass Draws: " + std::to_string(stats.prepassCommands.draws)
+			+ " (" + std::to_string(stats.prepassCommands.primitives) + " triangles, "
+			+ std::to_string(stats.prepassItems) + " items)";
+		ImGui::Text(prepass.c_str());
+
+		ImGui::Separator();
+
+		const auto& geometry = world->m_geometryPool->GetStats();
+		const std::string geometryBatches = "Geometry Batches: " + std::to_string(geometry.batches)
+			+ " (" + std::to_string(geometry.primitives) + " primitives)";
+		ImGui::Text(geometryBatches.c_str());
+		const std::string vertices = "Vertices: " + std::to_string(geometry.vertices)
+			+ " (" + std::to_string(geometry.vertexBytes / 1024) + " KB)";
+		ImGui::Text(vertices.c_str());
+		const std::string positions = "Position Stream: " + std::to_string(geometry.positionBytes / 1024) + " KB";
+		ImGui::Text(positions.c_str());
+		const std::string indices = "Indices: " + std::to_string(geometry.indices)
+			+ " (" + std::to_string(geometry.indexBytes / 1024) + " KB)";
+		ImGui::Text(indices.c_str());
+		const std::string duplicates = "Duplicates: " + std::to_string(geometry.duplicates)
+			+ " (" + std::to_string(geometry.savedBytes / 1024) + " KB saved)";
+		ImGui::Text(duplicates.c_str());
+
+		ImGui::Separator();
+
+		const std::string collectTime = "Collect: " + std::to_string(stats.collectTime * 1000.0f) + " ms";
+		ImGui::Text(collectTime.c_str());
+		const std::string cullTime = "Cull: " + std::to_string(stats.cullTime * 1000.0f) + " ms";
+		ImGui::Text(cullTime.c_str());
+		const std::string recordTime = "Record: " + std::to_string(stats.recordTime * 1000.0f) + " ms";
+		ImGui::Text(recordTime.c_str());
+		const std::string playbackTime = "Playback: " + std::to_string(stats.playbackTime * 1000.0f) + " ms";
+		ImGui::Text(playbackTime.c_str());
+
+		ImGui::TreePop();
+	}
+}
+
+} // end namespace SD::ENGINE
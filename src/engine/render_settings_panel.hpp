@@ -0,0 +1,22 @@
+#pragma once
+
+#include "world.hpp"
+
+#include <memory>
+
+
+namespace SD::ENGINE {
+
+class RenderSettingsPanel
+{
+public:
+	RenderSettingsPanel() = default;
+	~RenderSettingsPanel() = default;
+
+	void Draw(World* world);
+
+private:
+	void DrawSubmission(World* world);
+};
+
+} // end namespace SD::ENGINE
@@ -4,8 +4,10 @@
 
 #include <exceptions.hpp> 
 #include <renderer.hpp>
+#include <d3d11_renderer.hpp>
+#include <null_renderer.hpp>
 #include <frame_buffer.hpp>
-#include <debug_layer.hpp>
+#include <state_library.hpp>
 
 #include <imgui.h>
 #include <backends/imgui_impl_dx11.h>
@@ -14,29 +16,40 @@
 
 namespace SD::ENGINE {
 
+const float HEADLESS_WIDTH = 1200.0f;
+const float HEADLESS_HEIGHT = 800.0f;
+
+
 RenderSystem::RenderSystem()
 {
-    const auto& window = ENGINE::Application::GetApplication()->GetWindow();
+    const auto& app = ENGINE::Application::GetApplication();
+    if (app->IsHeadless())
+    {
+        m_renderer = std::make_unique<RENDER::NullRenderer>();
+        m_stateLibrary = std::make_unique<RENDER::StateLibrary>(m_renderer.get());
+        m_frameBuffer = std::make_unique<RENDER::FrameBuffer>(m_renderer.get(), m_stateLibrary.get(), HEADLESS_WIDTH, HEADLESS_HEIGHT);
+
+        return;
+    }
+
+    const auto& window = app->GetWindow();
     const auto width = window->GetWidth();
     const auto height = window->GetHeight();
     const auto handel = window->GetHandle();
 
-    m_renderer = std::make_unique<RENDER::Renderer>(width, height, handel);
-    m_frameBuffer = std::make_unique<RENDER::FrameBuffer>(m_renderer.get(), width, height);
-
-    D3D_DEBUG_LAYER(m_renderer.get());
-
-    // gain access to texture subresource in swap chain (back buffer)
-    Microsoft::WRL::ComPtr<ID3D11Resource> pBackBuffer;
-    D3D_THROW_INFO_EXCEPTION(m_renderer->GetSwapChain()->GetBuffer(0, __uuidof(ID3D11Resource), &pBackBuffer));
-    m_renderer->GetDevice()->CreateRenderTargetView(pBackBuffer.Get(), nullptr, m_renderer->GetRenderTargetView().GetAddressOf());
+    m_renderer = std::make_unique<RENDER::D3D11Renderer>(width, height, handel);
+    m_stateLibrary = std::make_unique<RENDER::StateLibrary>(m_renderer.get());
+    m_frameBuffer = std::make_unique<RENDER::FrameBuffer>(m_renderer.get(), m_stateLibrary.get(), width, height);
 
     InitImGui();
 }
 
 RenderSystem::~RenderSystem()
 {
-    FiniImGui();
+    if (!m_renderer->IsHeadless())
+    {
+        FiniImGui();
+    }
 }
 
 void RenderSystem::InitImGui() const
@@ -116,7 +129,9 @@ void RenderSystem::InitImGui() const
 
     // Setup Platform/Renderer backends
     ImGui_ImplWin32_Init(window->GetHandle());
-    ImGui_ImplDX11_Init(m_renderer->GetDevice(), m_renderer->GetContext());
+    // ImGui is only drawn with a window, which always has the D3D11 backend
+    const auto* renderer = static_cast<RENDER::D3D11Renderer*>(m_renderer.get());
+    ImGui_ImplDX11_Init(renderer->GetDevice(), renderer->GetContext());
 }
 
 void RenderSystem::FiniImGui() const
@@ -130,9 +145,7 @@ void RenderSystem::FiniImGui() const
 
 void RenderSystem::BeginImGui() const
 {
-    D3D_DEBUG_LAYER(m_renderer.get());
-
-    D3D_THROW_IF_INFO(m_renderer->GetContext()->OMSetRenderTargets(1u, m_renderer->GetRenderTargetView().GetAddressOf(), nullptr));
+    m_renderer->SetRenderTarget(m_renderer->GetRenderTargetView(), nullptr);
 
 
     // Start the Dear ImGui frame
@@ -170,14 +183,10 @@ void RenderSystem::BeginImGui() const
 
     const auto& window = ENGINE::Application::GetApplication()->GetWindow();
     // configure viewport
-    D3D11_VIEWPORT vp;
-    vp.Width = window->GetWidth();
-    vp.Height = window->GetHeight();
-    vp.MinDepth = 0;
-    vp.MaxDepth = 1;
-    vp.TopLeftX = 0;
-    vp.TopLeftY = 0;
-    D3D_THROW_IF_INFO(m_renderer->GetContext()->RSSetViewports(1u, &vp));
+    RENDER::Viewport vp;
+    vp.width = window->GetWidth();
+    vp.height = window->GetHeight();
+    m_renderer->SetViewport(vp);
 }
 
 void RenderSystem::EndImGui() const
@@ -202,80 +211,43 @@ void RenderSystem::EndImGui() const
 
 void RenderSystem::OnWindowResize()
 {
-    D3D_DEBUG_LAYER(m_renderer.get());
-
-    D3D_THROW_IF_INFO(m_renderer->GetContext()->OMSetRenderTargets(0, nullptr, nullptr));
-
-    m_renderer->GetRenderTargetView()->Release();
-
-    // Preserve the existing buffer count and format.
-    // Automatically choose the width and height to match the client rect for HWNDs.
-    D3D_THROW_IF_INFO(m_renderer->GetSwapChain()->ResizeBuffers(0, 0, 0, DXGI_FORMAT_UNKNOWN, 0));
-
-    // Get buffer and create a render-target-view.
-    Microsoft::WRL::ComPtr<ID3D11Resource> pBackBuffer;
-    D3D_THROW_INFO_EXCEPTION(m_renderer->GetSwapChain()->GetBuffer(0, __uuidof(ID3D11Resource), &pBackBuffer));
-    D3D_THROW_INFO_EXCEPTION(m_renderer->GetDevice()->CreateRenderTargetView(pBackBuffer.Get(), nullptr, m_renderer->GetRenderTargetView().GetAddressOf()));
+    m_renderer->Resize();
 }
 
 void RenderSystem::OnSpaceViewportResize(const float width, const float height)
 {
     const auto& camera = ENGINE::Application::GetApplication()->GetCamera();
 
-    m_frameBuffer->resize(m_renderer.get(), static_cast<UINT>(width), static_cast<UINT>(height));
+    m_frameBuffer->resize(m_renderer.get(), static_cast<uint32_t>(width), static_cast<uint32_t>(height));
     camera->onSpaceViewportResize();
 }
 
 void RenderSystem::Begin()
 {
-    D3D_DEBUG_LAYER(m_renderer.get());
-
     m_frameBuffer->bind(m_renderer.get());
 
     const float color1[] = { EMPTY_COLOR.x, EMPTY_COLOR.y, EMPTY_COLOR.z, 1.0f };
-    D3D_THROW_IF_INFO(m_renderer->GetContext()->ClearRenderTargetView(m_frameBuffer->getRTV().Get(), color1));
-    D3D_THROW_IF_INFO(m_renderer->GetContext()->ClearDepthStencilView(m_frameBuffer->getDSV().Get(), D3D11_CLEAR_DEPTH, 1.0f, 0u));
+    m_renderer->ClearRenderTarget(m_frameBuffer->getRTV(), color1);
+    m_renderer->ClearDepth(m_frameBuffer->getDSV(), 1.0f);
 
     const float color2[] = { 0.0f, 0.0f, 0.0f, 1.0f };
-    D3D_THROW_IF_INFO(m_renderer->GetContext()->ClearRenderTargetView(m_renderer->GetRenderTargetView().Get(), color2));
+    m_renderer->ClearRenderTarget(m_renderer->GetRenderTargetView(), color2);
 }
 
 void RenderSystem::End()
 {
-    D3D_DEBUG_LAYER(m_renderer.get());
-
-    debugLayer->Set();
-
-    HRESULT hr;
-    // First argument for VSync
-    if (FAILED(hr = m_renderer->GetSwapChain()->Present(0u, 0u)))
-    {
-        if (hr == DXGI_ERROR_DEVICE_REMOVED)
-        {
-            throw D3D_EXCEPTION(m_renderer->GetDevice()->GetDeviceRemovedReason());
-        }
-        else
-        {
-            throw D3D_EXCEPTION(hr);
-        }
-    }
+    m_renderer->Present();
 }
 
 void RenderSystem::BeginFrame()
 {
-    D3D_DEBUG_LAYER(m_renderer.get());
-
-    D3D_THROW_IF_INFO(m_renderer->GetContext()->OMSetRenderTargets(1u, m_frameBuffer->getRTV().GetAddressOf(), m_frameBuffer->getDSV().Get()));
+    m_renderer->SetRenderTarget(m_frameBuffer->getRTV(), m_frameBuffer->getDSV());
 
     // configure viewport
-    D3D11_VIEWPORT vp;
-    vp.Width = static_cast<float>(m_frameBuffer->width());
-    vp.Height = static_cast<float>(m_frameBuffer->height());
-    vp.MinDepth = 0;
-    vp.MaxDepth = 1;
-    vp.TopLeftX = 0;
-    vp.TopLeftY = 0;
-    D3D_THROW_IF_INFO(m_renderer->GetContext()->RSSetViewports(1u, &vp));
+    RENDER::Viewport vp;
+    vp.width = static_cast<float>(m_frameBuffer->width());
+    vp.height = static_cast<float>(m_frameBuffer->height());
+    m_renderer->SetViewport(vp);
 }
 
 void RenderSystem::EndFrame()
@@ -1,9 +1,5 @@
 #pragma once
 
-#include <windows.h>
-
-#include <wrl.h>
-#include <d3d11.h>
 #include <DirectXMath.h>
 
 #include <memory>
@@ -12,6 +8,7 @@
 namespace SD::RENDER {
     class Renderer;
     class FrameBuffer;
+    class StateLibrary;
 }
 
 namespace SD::ENGINE {
@@ -44,6 +41,7 @@ public:
 
     RENDER::Renderer* GetRenderer() const { return m_renderer.get(); }
     RENDER::FrameBuffer* GetFrameBuffer() const { return m_frameBuffer.get(); }
+    RENDER::StateLibrary* GetStateLibrary() const { return m_stateLibrary.get(); }
 
 private:
     void InitImGui() const;
@@ -51,6 +49,7 @@ private:
 
 private:
     std::unique_ptr<RENDER::Renderer> m_renderer = nullptr;
+    std::unique_ptr<RENDER::StateLibrary> m_stateLibrary = nullptr;  // released before the renderer
     std::unique_ptr<RENDER::FrameBuffer> m_frameBuffer = nullptr;
 };
 
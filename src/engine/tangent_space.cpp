@@ -0,0 +1,346 @@
+#include "tangent_space.hpp"
+
+#include <DirectXMath.h>
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <unordered_map>
+
+#include "hash.hpp"
+
+
+namespace
+{
+constexpr uint32_t NO_GROUP = ~0u;
+
+// UV windings, corners of degenerate UV triangles join any group of their vertex
+constexpr uint32_t NEGATIVE_WINDING = 0;
+constexpr uint32_t POSITIVE_WINDING = 1;
+constexpr uint32_t ANY_WINDING = 2;
+
+const SD::ENGINE::VertexAttribute* FindAttribute(
+	const std::vector<SD::ENGINE::VertexAttribute>& attributes, const std::string& semantic, uint32_t semanticIdx = 0)
+{
+	const auto attribute = std::find_if(attributes.begin(), attributes.end(), [&](const SD::ENGINE::VertexAttribute& candidate)
+	{
+		return candidate.semantic == semantic && candidate.semanticIdx == semanticIdx;
+	});
+
+	return attribute != attributes.end() ? &*attribute : nullptr;
+}
+
+// Replaces an attribute of the same semantic, if any, with a zeroed one.
+SD::ENGINE::VertexAttribute& AddAttribute(
+	std::vector<SD::ENGINE::VertexAttribute>& attributes, const std::string& semantic, uint32_t components, size_t vertexCount)
+{
+	attributes.erase(std::remove_if(attributes.begin(), attributes.end(), [&](const SD::ENGINE::VertexAttribute& attribute)
+	{
+		return attribute.semantic == semantic && attribute.semanticIdx == 0;
+	}), attributes.end());
+
+	auto& attribute = attributes.emplace_back();
+	attribute.semantic = semantic;
+	attribute.components = components;
+	attribute.values.resize(vertexCount * components, 0.0f);
+
+	return attribute;
+}
+
+DirectX::XMVECTOR LoadVector(const SD::ENGINE::VertexAttribute* attribute, uint32_t vertex)
+{
+	DirectX::XMFLOAT3 value(0.0f, 0.0f, 0.0f);
+	if (attribute)
+	{
+		memcpy(&value, attribute->values.data() + static_cast<size_t>(vertex) * attribute->components, std::min(attribute->components, 3u) * sizeof(float));
+	}
+
+	return DirectX::XMLoadFloat3(&value);
+}
+
+// Removes the part of a vector along a unit normal.
+DirectX::XMVECTOR Project(DirectX::FXMVECTOR normal, DirectX::FXMVECTOR vector)
+{
+	return DirectX::XMVectorSubtract(vector, DirectX::XMVectorMultiply(normal, DirectX::XMVector3Dot(normal, vector)));
+}
+
+bool IsZero(DirectX::FXMVECTOR vector)
+{
+	return DirectX::XMVectorGetX(DirectX::XMVector3LengthSq(vector)) <= FLT_MIN;
+}
+
+// Any unit vector orthogonal to a unit normal.
+DirectX::XMVECTOR GetOrthogonal(DirectX::FXMVECTOR normal)
+{
+	const auto axis = std::abs(DirectX::XMVectorGetX(normal)) < 0.9f ? DirectX::g_XMIdentityR0 : DirectX::g_XMIdentityR1;
+
+	return DirectX::XMVector3Normalize(Project(normal, axis));
+}
+
+// Maps every vertex to the first one with bit exact equal values of the attributes.
+std::vector<uint32_t> WeldVertices(const std::vector<const SD::ENGINE::VertexAttribute*>& attributes, size_t vertexCount)
+{
+	size_t width = 0;
+	for (const auto* attribute : attributes)
+	{
+		width += attribute ? attribute->components : 0;
+	}
+
+	std::vector<float> keys(vertexCount * width);
+	for (size_t vertex = 0, offset = 0; vertex < vertexCount; ++vertex)
+	{
+		for (const auto* attribute : attributes)
+		{
+			if (attribute)
+			{
+				memcpy(keys.data() + offset, attribute->values.data() + vertex * attribute->components, attribute->components * sizeof(float));
+				offset += attribute->components;
+			}
+		}
+	}
+
+	std::vector<uint32_t> welded(vertexCount);
+	std::unordered_multimap<uint64_t, uint32_t> firstVertices;
+	firstVertices.reserve(vertexCount);
+
+	for (uint32_t vertex = 0; vertex < vertexCount; ++vertex)
+	{
+		const float* key = keys.data() + vertex * width;
+		const uint64_t hash = SD::Hash64(key, width * sizeof(float));
+
+		welded[vertex] = vertex;
+
+		const auto [begin, end] = firstVertices.equal_range(hash);
+		for (auto it = begin; it != end; ++it)
+		{
+			if (memcmp(keys.data() + it->second * width, key, width * sizeof(float)) == 0)
+			{
+				welded[vertex] = it->second;
+				break;
+			}
+		}
+
+		if (welded[vertex] == vertex)
+		{
+			firstVertices.emplace(hash, vertex);
+		}
+	}
+
+	return welded;
+}
+}  // end namespace
+
+namespace SD::ENGINE {
+
+void GenerateFlatNormals(std::vector<VertexAttribute>& attributes, std::vector<uint32_t>& indices, size_t& vertexCount)
+{
+	for (auto& attribute : attributes)
+	{
+		std::vector<float> values(indices.size() * attribute.components);
+		for (size_t corner = 0; corner < indices.size(); ++corner)
+		{
+			memcpy(
+				values.data() + corner * attribute.components,
+				attribute.values.data() + static_cast<size_t>(indices[corner]) * attribute.components,
+				attribute.components * sizeof(float));
+		}
+		attribute.values = std::move(values);
+	}
+
+	vertexCount = indices.size();
+	std::iota(indices.begin(), indices.end(), 0u);
+
+	auto& normals = AddAttribute(attributes, "NORMAL", 3, vertexCount).values;
+	const auto* position = FindAttribute(attributes, "POSITION");
+
+	for (uint32_t corner = 0; corner + 2 < vertexCount; corner += 3)
+	{
+		const auto p0 = LoadVector(position, corner + 0);
+		const auto p1 = LoadVector(position, corner + 1);
+		const auto p2 = LoadVector(position, corner + 2);
+
+		const auto normal = DirectX::XMVector3Normalize(
+			DirectX::XMVector3Cross(DirectX::XMVectorSubtract(p1, p0), DirectX::XMVectorSubtract(p2, p0)));
+
+		for (uint32_t k = 0; k < 3; ++k)
+		{
+			DirectX::XMStoreFloat3(reinterpret_cast<DirectX::XMFLOAT3*>(normals.data() + (corner + k) * 3), normal);
+		}
+	}
+}
+
+void GenerateSmoothNormals(std::vector<VertexAttribute>& attributes, const std::vector<uint32_t>& indices, size_t vertexCount)
+{
+	auto& normals = AddAttribute(attributes, "NORMAL", 3, vertexCount).values;
+	const auto* position = FindAttribute(attributes, "POSITION");
+
+	const auto welded = WeldVertices({ position }, vertexCount);
+
+	// cross product length is twice the triangle area
+	std::vector<DirectX::XMFLOAT3> sums(vertexCount, DirectX::XMFLOAT3(0.0f, 0.0f, 0.0f));
+	for (size_t idx = 0; idx + 2 < indices.size(); idx += 3)
+	{
+		const auto p0 = LoadVector(position, indices[idx + 0]);
+		const auto p1 = LoadVector(position, indices[idx + 1]);
+		const auto p2 = LoadVector(position, indices[idx + 2]);
+
+		const auto face = DirectX::XMVector3Cross(DirectX::XMVectorSubtract(p1, p0), DirectX::XMVectorSubtract(p2, p0));
+
+		for (size_t k = 0; k < 3; ++k)
+		{
+			auto& sum = sums[welded[indices[idx + k]]];
+			DirectX::XMStoreFloat3(&sum, DirectX::XMVectorAdd(DirectX::XMLoadFloat3(&sum), face));
+		}
+	}
+
+	for (size_t vertex = 0; vertex < vertexCount; ++vertex)
+	{
+		const auto normal = DirectX::XMVector3Normalize(DirectX::XMLoadFloat3(&sums[welded[vertex]]));
+		DirectX::XMStoreFloat3(reinterpret_cast<DirectX::XMFLOAT3*>(normals.data() + vertex * 3), normal);
+	}
+}
+
+void GenerateTangents(std::vector<VertexAttribute>& attributes, std::vector<uint32_t>& indices, size_t& vertexCount)
+{
+	const auto* position = FindAttribute(attributes, "POSITION");
+	const auto* normal = FindAttribute(attributes, "NORMAL");
+	const auto* texcoord = FindAttribute(attributes, "TEXCOORD");
+
+	const auto welded = WeldVertices({ position, normal, texcoord }, vertexCount);
+
+	// angle weighted corner tangents summed per welded vertex and winding
+	std::vector<DirectX::XMFLOAT3> groupSums(vertexCount * 2, DirectX::XMFLOAT3(0.0f, 0.0f, 0.0f));
+	std::vector<bool> groupUsed(vertexCount * 2, false);
+	std::vector<uint32_t> windings(indices.size() / 3, ANY_WINDING);
+
+	for (size_t triangle = 0; triangle < windings.size(); ++triangle)
+	{
+		const uint32_t* corners = indices.data() + triangle * 3;
+
+		const auto p0 = LoadVector(position, corners[0]);
+		const auto d1 = DirectX::XMVectorSubtract(LoadVector(position, corners[1]), p0);
+		const auto d2 = DirectX::XMVectorSubtract(LoadVector(position, corners[2]), p0);
+
+		const auto uv0 = LoadVector(texcoord, corners[0]);
+		const auto uv1 = DirectX::XMVectorSubtract(LoadVector(texcoord, corners[1]), uv0);
+		const auto uv2 = DirectX::XMVectorSubtract(LoadVector(texcoord, corners[2]), uv0);
+
+		const float s1 = DirectX::XMVectorGetX(uv1);
+		const float t1 = DirectX::XMVectorGetY(uv1);
+		const float s2 = DirectX::XMVectorGetX(uv2);
+		const float t2 = DirectX::XMVectorGetY(uv2);
+
+		const float signedArea = s1 * t2 - t1 * s2;
+		auto tangent = DirectX::XMVectorSubtract(DirectX::XMVectorScale(d1, t2), DirectX::XMVectorScale(d2, t1));
+		if (std::abs(signedArea) <= FLT_MIN || IsZero(tangent))
+		{
+			continue;
+		}
+
+		const uint32_t winding = signedArea > 0.0f ? POSITIVE_WINDING : NEGATIVE_WINDING;
+		tangent = DirectX::XMVector3Normalize(winding == POSITIVE_WINDING ? tangent : DirectX::XMVectorNegate(tangent));
+		windings[triangle] = winding;
+
+		for (size_t k = 0; k < 3; ++k)
+		{
+			const uint32_t vertex = corners[k];
+			const auto n = DirectX::XMVector3Normalize(LoadVector(normal, vertex));
+
+			const auto projected = Project(n, tangent);
+			if (IsZero(projected))
+			{
+				continue;
+			}
+
+			// angle between the corner edges in the normal plane
+			const auto p = LoadVector(position, vertex);
+			const auto e1 = DirectX::XMVector3Normalize(Project(n, DirectX::XMVectorSubtract(LoadVector(position, corners[(k + 1) % 3]), p)));
+			const auto e2 = DirectX::XMVector3Normalize(Project(n, DirectX::XMVectorSubtract(LoadVector(position, corners[(k + 2) % 3]), p)));
+			const float angle = std::acos(std::clamp(DirectX::XMVectorGetX(DirectX::XMVector3Dot(e1, e2)), -1.0f, 1.0f));
+
+			const size_t group = static_cast<size_t>(welded[vertex]) * 2 + winding;
+			auto& sum = groupSums[group];
+			DirectX::XMStoreFloat3(&sum, DirectX::XMVectorAdd(
+				DirectX::XMLoadFloat3(&sum), DirectX::XMVectorScale(DirectX::XMVector3Normalize(projected), angle)));
+			groupUsed[group] = true;
+		}
+	}
+
+	// a vertex keeps its index for the first winding it is used with, the other one gets a copy
+	std::vector<uint32_t> vertexWindings(vertexCount, NO_GROUP);
+	std::vector<uint32_t> copies(vertexCount, NO_GROUP);
+	std::vector<uint32_t> sources;
+
+	for (size_t corner = 0; corner < windings.size() * 3; ++corner)
+	{
+		const uint32_t vertex = indices[corner];
+		uint32_t winding = windings[corner / 3];
+		if (winding == ANY_WINDING)
+		{
+			const size_t groups = static_cast<size_t>(welded[vertex]) * 2;
+			if (vertexWindings[vertex] != NO_GROUP)
+			{
+				winding = vertexWindings[vertex];
+			}
+			else
+			{
+				winding = groupUsed[groups + NEGATIVE_WINDING] && !groupUsed[groups + POSITIVE_WINDING] ? NEGATIVE_WINDING : POSITIVE_WINDING;
+			}
+		}
+
+		if (vertexWindings[vertex] == NO_GROUP)
+		{
+			vertexWindings[vertex] = winding;
+		}
+		else if (vertexWindings[vertex] != winding)
+		{
+			if (copies[vertex] == NO_GROUP)
+			{
+				copies[vertex] = static_cast<uint32_t>(vertexCount + sources.size());
+				sources.push_back(vertex);
+			}
+			indices[corner] = copies[vertex];
+		}
+	}
+
+	const size_t splitCount = vertexCount + sources.size();
+
+	std::vector<float> tangents(splitCount * 4);
+	for (size_t vertex = 0; vertex < splitCount; ++vertex)
+	{
+		const uint32_t source = vertex < vertexCount ? static_cast<uint32_t>(vertex) : sources[vertex - vertexCount];
+		uint32_t winding = vertexWindings[source] != NO_GROUP ? vertexWindings[source] : POSITIVE_WINDING;
+		if (vertex >= vertexCount)
+		{
+			winding = POSITIVE_WINDING - winding;
+		}
+
+		auto tangent = DirectX::XMVector3Normalize(DirectX::XMLoadFloat3(&groupSums[static_cast<size_t>(welded[source]) * 2 + winding]));
+		if (IsZero(tangent))
+		{
+			tangent = GetOrthogonal(DirectX::XMVector3Normalize(LoadVector(normal, source)));
+		}
+
+		DirectX::XMStoreFloat3(reinterpret_cast<DirectX::XMFLOAT3*>(tangents.data() + vertex * 4), tangent);
+		tangents[vertex * 4 + 3] = winding == POSITIVE_WINDING ? 1.0f : -1.0f;
+	}
+
+	for (auto& attribute : attributes)
+	{
+		attribute.values.resize(splitCount * attribute.components);
+		for (size_t copy = 0; copy < sources.size(); ++copy)
+		{
+			memcpy(
+				attribute.values.data() + (vertexCount + copy) * attribute.components,
+				attribute.values.data() + static_cast<size_t>(sources[copy]) * attribute.components,
+				attribute.components * sizeof(float));
+		}
+	}
+
+	vertexCount = splitCount;
+	AddAttribute(attributes, "TANGENT", 4, vertexCount).values = std::move(tangents);
+}
+
+}  // end namespace SD::ENGINE
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "vertex_packer.hpp"
+
+
+namespace SD::ENGINE {
+
+// Gives every triangle corner an own vertex with the face normal, glTF requires flat normals when none are given.
+void GenerateFlatNormals(std::vector<VertexAttribute>& attributes, std::vector<uint32_t>& indices, size_t& vertexCount);
+
+// Area weighted normals of the triangles around a position, so UV seams stay smooth.
+void GenerateSmoothNormals(std::vector<VertexAttribute>& attributes, const std::vector<uint32_t>& indices, size_t vertexCount);
+
+// MikkTSpace tangents, handedness in w. Triangle tangents projected to the normal plane and weighted by the corner
+// angle are summed over corners of equal vertices (position, normal and TEXCOORD_0) with the same UV winding.
+// Vertices used with both windings are split. Tangents are arbitrary but orthogonal without texture coordinates.
+void GenerateTangents(std::vector<VertexAttribute>& attributes, std::vector<uint32_t>& indices, size_t& vertexCount);
+
+}  // end namespace SD::ENGINE
@@ -0,0 +1,219 @@
+#include "texture_cache.hpp"
+
+#include <cstring>
+#include <iterator>
+#include <system_error>
+#include <utility>
+
+#include <DirectXTex.h>
+
+#include "hash.hpp"
+
+
+namespace
+{
+// Pixels of all mips and slices together with the layout they are read with.
+uint64_t HashImage(const DirectX::ScratchImage& image)
+{
+	const auto& metadata = image.GetMetadata();
+
+	uint64_t hash = SD::Hash64(image.GetPixels(), image.GetPixelsSize());
+	hash = SD::HashCombine(hash, metadata.width);
+	hash = SD::HashCombine(hash, metadata.height);
+	hash = SD::HashCombine(hash, metadata.depth);
+	hash = SD::HashCombine(hash, metadata.arraySize);
+	hash = SD::HashCombine(hash, metadata.mipLevels);
+	hash = SD::HashCombine(hash, static_cast<uint64_t>(metadata.format));
+	hash = SD::HashCombine(hash, static_cast<uint64_t>(metadata.dimension));
+
+	return hash;
+}
+
+bool IsSameImage(const DirectX::ScratchImage& image, const DirectX::ScratchImage& other)
+{
+	const auto& metadata = image.GetMetadata();
+	const auto& otherMetadata = other.GetMetadata();
+
+	return metadata.width == otherMetadata.width
+		&& metadata.height == otherMetadata.height
+		&& metadata.depth == otherMetadata.depth
+		&& metadata.arraySize == otherMetadata.arraySize
+		&& metadata.mipLevels == otherMetadata.mipLevels
+		&& metadata.format == otherMetadata.format
+		&& metadata.dimension == otherMetadata.dimension
+		&& image.GetPixelsSize() == other.GetPixelsSize()
+		&& memcmp(image.GetPixels(), other.GetPixels(), image.GetPixelsSize()) == 0;
+}
+
+// Texture and the pixels it was created from in one allocation, the pixels go away with the last handle.
+struct DecodedTexture
+{
+	DecodedTexture(SD::RENDER::Renderer* renderer, DirectX::ScratchImage&& decoded)
+		: image(std::move(decoded))
+		, texture(renderer, image)
+	{
+	}
+
+	DirectX::ScratchImage image;
+	SD::RENDER::Texture texture;
+};
+
+// Same file for different spellings of its path.
+std::string GetKey(const std::filesystem::path& path)
+{
+	std::error_code ec;
+	const auto canonical = std::filesystem::weakly_canonical(path, ec);
+
+	return (ec ? path.lexically_normal() : canonical).string();
+}
+}  // end namespace
+
+namespace SD::ENGINE {
+
+TextureCache::TextureCache(RENDER::Renderer* renderer, TextureStreamer* streamer)
+	: m_renderer(renderer)
+	, m_streamer(streamer)
+{
+}
+
+std::shared_ptr<RENDER::Texture> TextureCache::Get(const std::filesystem::path& path)
+{
+	const auto key = GetKey(path);
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (auto texture = m_paths[key].lock())
+		{
+			m_stats.pathHits++;
+			return texture;
+		}
+	}
+
+	return create(key, RENDER::Texture::Load(path.wstring()));
+}
+
+std::shared_ptr<RENDER::Texture> TextureCache::Get(const std::string& name, const uint8_t* data, size_t size)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (auto texture = m_paths[name].lock())
+		{
+			m_stats.pathHits++;
+			return texture;
+		}
+	}
+
+	return create(name, RENDER::Texture::Load(data, size));
+}
+
+std::shared_ptr<RENDER::Texture> TextureCache::Stream(const std::filesystem::path& path, TextureUsage usage, float alphaCutoff)
+{
+	// cooked differently for other usages and cutouts for other cutoffs
+	auto key = GetKey(path) + "|" + std::to_string(static_cast<uint32_t>(usage));
+	if (usage == TextureUsage::CUTOUT)
+	{
+		key += "|" + std::to_string(alphaCutoff);
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (auto texture = m_paths[key].lock())
+		{
+			m_stats.pathHits++;
+			return texture;
+		}
+	}
+
+	auto texture = m_streamer->Stream(path, usage, alphaCutoff);
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	// another job may have streamed the same file meanwhile, the other texture is dropped along with its decode
+	if (auto streamed = m_paths[key].lock())
+	{
+		m_stats.pathHits++;
+		return streamed;
+	}
+
+	prune();
+
+	m_paths[key] = texture;
+	m_stats.misses++;
+
+	return texture;
+}
+
+TextureCacheStats TextureCache::GetStats() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	return m_stats;
+}
+
+std::shared_ptr<RENDER::Texture> TextureCache::create(const std::string& key, DirectX::ScratchImage image)
+{
+	const uint64_t hash = HashImage(image);
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (auto texture = find(hash, image))
+		{
+			m_paths[key] = texture;
+			m_stats.contentHits++;
+			return texture;
+		}
+	}
+
+	auto decoded = std::make_shared<DecodedTexture>(m_renderer, std::move(image));
+	std::shared_ptr<RENDER::Texture> texture(decoded, &decoded->texture);
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	// another job may have created the same texture meanwhile, the first one is kept
+	if (auto created = find(hash, decoded->image))
+	{
+		m_paths[key] = created;
+		m_stats.contentHits++;
+		return created;
+	}
+
+	prune();
+
+	m_paths[key] = texture;
+	m_contents.emplace(hash, StoredTexture{ texture, &decoded->image });
+	m_stats.misses++;
+
+	return texture;
+}
+
+std::shared_ptr<RENDER::Texture> TextureCache::find(uint64_t hash, const DirectX::ScratchImage& image) const
+{
+	// equal hashes may still be other pixels
+	const auto [first, last] = m_contents.equal_range(hash);
+	for (auto it = first; it != last; ++it)
+	{
+		// the pixels are valid as long as the texture is
+		auto texture = it->second.texture.lock();
+		if (texture && IsSameImage(*it->second.image, image))
+		{
+			return texture;
+		}
+	}
+
+	return nullptr;
+}
+
+void TextureCache::prune()
+{
+	for (auto it = m_paths.begin(); it != m_paths.end();)
+	{
+		it = it->second.expired() ? m_paths.erase(it) : std::next(it);
+	}
+
+	for (auto it = m_contents.begin(); it != m_contents.end();)
+	{
+		it = it->second.texture.expired() ? m_contents.erase(it) : std::next(it);
+	}
+}
+
+}  // end namespace SD::ENGINE
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "texture.hpp"
+#include "texture_streamer.hpp"
+
+
+namespace SD::RENDER {
+	class Renderer;
+}
+
+namespace SD::ENGINE {
+
+struct TextureCacheStats
+{
+	size_t pathHits = 0;  // file was already loaded
+	size_t contentHits = 0;  // file was decoded to pixels of an already loaded texture
+	size_t misses = 0;  // texture was created
+};
+
+// Textures shared by canonical path and, once decoded, by content. The cache holds no references itself, a texture
+// lives as long as handles to it do, so asking for a file again is free while it is in use. Decoded textures keep their
+// pixels until then, a content hash match is compared byte by byte before a texture is shared. Entries of released
+// textures are dropped whenever one is added.
+// Streamed textures are shared by path only, their pixels are not known when they are handed out.
+// Safe to use from jobs, decoding and creation happen outside of the lock.
+class TextureCache
+{
+public:
+	TextureCache(RENDER::Renderer* renderer, TextureStreamer* streamer);
+	~TextureCache() = default;
+
+	TextureCache(const TextureCache&) = delete;
+	TextureCache& operator=(const TextureCache&) = delete;
+
+	std::shared_ptr<RENDER::Texture> Get(const std::filesystem::path& path);
+	// Encoded image in memory (embedded in a glTF), shared by a name unique to it. Such images are not cooked.
+	std::shared_ptr<RENDER::Texture> Get(const std::string& name, const uint8_t* data, size_t size);
+	// Texture with no resident mips until the streamer uploads them, a file is shared per usage (and cutoff of cutouts).
+	std::shared_ptr<RENDER::Texture> Stream(const std::filesystem::path& path, TextureUsage usage, float alphaCutoff);
+
+	TextureCacheStats GetStats() const;
+
+private:
+	struct StoredTexture
+	{
+		std::weak_ptr<RENDER::Texture> texture;
+		const DirectX::ScratchImage* image;  // pixels the texture was created from, valid while it is
+	};
+
+	// decoded pixels are shared by content
+	std::shared_ptr<RENDER::Texture> create(const std::string& key, DirectX::ScratchImage image);
+	// under the lock
+	std::shared_ptr<RENDER::Texture> find(uint64_t hash, const DirectX::ScratchImage& image) const;
+	void prune();
+
+private:
+	RENDER::Renderer* m_renderer;
+	TextureStreamer* m_streamer;
+
+	mutable std::mutex m_mutex;
+	std::unordered_map<std::string, std::weak_ptr<RENDER::Texture>> m_paths = {};
+	std::unordered_multimap<uint64_t, StoredTexture> m_contents = {};
+	TextureCacheStats m_stats = {};
+};
+
+}  // end namespace SD::ENGINE
@@ -0,0 +1,197 @@
+#include "texture_streamer.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+
+#include <DirectXTex.h>
+
+#include "exceptions.hpp"
+
+
+namespace SD::ENGINE {
+
+struct TextureStreamer::StreamedTexture
+{
+	std::weak_ptr<RENDER::Texture> texture;
+	DirectX::ScratchImage image;
+	bool hasAlpha = false;
+
+	size_t mip = 0;  // mip being uploaded, smaller ones are resident
+	size_t row = 0;  // next row of the pitch in it
+	bool done = false;
+};
+
+TextureStreamer::TextureStreamer(RENDER::Renderer* renderer, const std::filesystem::path& cacheDir, size_t uploadBudget)
+	: m_renderer(renderer)
+	, m_cacheDir(cacheDir)
+	, m_uploadBudget(uploadBudget)
+{
+	// half of the cores, frames keep the rest
+	m_pDecoder = std::make_unique<JobSystem>(std::max<size_t>(JobSystem::DefaultWorkersCount() / 2, 1));
+}
+
+TextureStreamer::~TextureStreamer()
+{
+	// queued decodes are dropped, the decoder drains its queue on destruction
+	m_stopping = true;
+	m_pDecoder = nullptr;
+}
+
+std::shared_ptr<RENDER::Texture> TextureStreamer::Stream(const std::filesystem::path& path, TextureUsage usage, float alphaCutoff)
+{
+	const auto source = RENDER::Texture::LoadMetadata(path.wstring());
+	if (source.dimension != DirectX::TEX_DIMENSION_TEXTURE2D || source.arraySize != 1 || source.IsCubemap())
+	{
+		return std::make_shared<RENDER::Texture>(m_renderer, path.wstring());
+	}
+
+	const auto metadata = GetCookedTextureMetadata(source, usage);
+	auto texture = std::make_shared<RENDER::Texture>(m_renderer, metadata);
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (m_streaming++ == 0)
+		{
+			m_pTimer = std::make_unique<Timer>();
+			m_uploadedBytes = 0;
+		}
+	}
+
+	// the pool outlives its jobs, unlike the pointer to it, which is cleared first on destruction
+	m_pDecoder->Submit([this, decoder = m_pDecoder.get(), path, usage, alphaCutoff, weakTexture = std::weak_ptr<RENDER::Texture>(texture), metadata]()
+	{
+		decode(*decoder, path, usage, alphaCutoff, weakTexture, metadata);
+	});
+
+	return texture;
+}
+
+void TextureStreamer::Update()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		for (auto& decoded : m_decoded)
+		{
+			if (const auto texture = decoded->texture.lock())
+			{
+				texture->SetHasAlpha(decoded->hasAlpha);
+			}
+			m_uploading.push_back(std::move(decoded));
+		}
+		m_decoded.clear();
+	}
+
+	size_t budget = m_uploadBudget;
+	bool uploaded = false;
+	while (budget > 0)
+	{
+		// smallest pending mip over all textures
+		StreamedTexture* next = nullptr;
+		size_t nextSize = std::numeric_limits<size_t>::max();
+		for (const auto& streamed : m_uploading)
+		{
+			if (streamed->done || streamed->texture.expired())
+			{
+				continue;
+			}
+
+			const size_t size = streamed->image.GetImage(streamed->mip, 0, 0)->slicePitch;
+			if (size < nextSize)
+			{
+				next = streamed.get();
+				nextSize = size;
+			}
+		}
+
+		if (!next)
+		{
+			break;
+		}
+
+		const auto texture = next->texture.lock();
+		const auto image = next->image.GetImage(next->mip, 0, 0);
+
+		// at least a row goes every frame, large mips go in parts
+		const size_t rows = image->slicePitch / image->rowPitch;
+		const size_t rowCount = std::min(rows - next->row, std::max<size_t>(budget / image->rowPitch, uploaded ? 0 : 1));
+		if (rowCount == 0)
+		{
+			break;
+		}
+
+		texture->UploadMip(m_renderer, static_cast<uint32_t>(next->mip), *image, next->row, rowCount);
+
+		next->row += rowCount;
+		if (next->row == rows)
+		{
+			next->done = next->mip == 0;
+			next->mip -= next->done ? 0 : 1;
+			next->row = 0;
+		}
+
+		const size_t bytes = rowCount * image->rowPitch;
+		budget -= std::min(budget, bytes);
+		m_uploadedBytes += bytes;
+		uploaded = true;
+	}
+
+	// done and released textures
+	const auto done = std::remove_if(m_uploading.begin(), m_uploading.end(), [](const auto& streamed)
+	{
+		return streamed->done || streamed->texture.expired();
+	});
+	const auto finished = static_cast<size_t>(std::distance(done, m_uploading.end()));
+	m_uploading.erase(done, m_uploading.end());
+
+	if (finished > 0 && (m_streaming -= finished) == 0)
+	{
+		std::clog << "Textures streamed: " << m_uploadedBytes / (1024 * 1024) << " MB in " << m_pTimer->GetDelta() << " s." << std::endl;
+	}
+}
+
+void TextureStreamer::decode(
+	JobSystem& decoder,
+	const std::filesystem::path& path,
+	TextureUsage usage,
+	float alphaCutoff,
+	const std::weak_ptr<RENDER::Texture>& texture,
+	const DirectX::TexMetadata& metadata)
+{
+	if (m_stopping || texture.expired())
+	{
+		m_streaming--;
+		return;
+	}
+
+	try
+	{
+		auto streamed = std::make_unique<StreamedTexture>();
+		streamed->texture = texture;
+		streamed->image = LoadCookedTexture(path, usage, alphaCutoff, m_cacheDir, decoder);
+
+		const auto& cooked = streamed->image.GetMetadata();
+		if (cooked.mipLevels != metadata.mipLevels || cooked.format != metadata.format)
+		{
+			THROW_SOME_EXCEPTION(L"TEXTURE CHANGED WHILE STREAMING!");
+		}
+
+		streamed->hasAlpha = DirectX::HasAlpha(cooked.format) && !streamed->image.IsAlphaAllOpaque();
+		streamed->mip = cooked.mipLevels - 1;
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_decoded.push_back(std::move(streamed));
+	}
+	catch (const SomeException& e)
+	{
+		std::wclog << L"Texture " << path.wstring() << L" not streamed: " << e.w_what() << std::endl;
+		m_streaming--;
+	}
+	catch (const std::exception& e)
+	{
+		std::clog << "Texture " << path.string() << " not streamed: " << e.what() << std::endl;
+		m_streaming--;
+	}
+}
+
+}  // end namespace SD::ENGINE
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "job_system.hpp"
+
+#include "cooked_texture.hpp"
+#include "texture.hpp"
+#include "timer.hpp"
+
+
+namespace SD::RENDER {
+	class Renderer;
+}
+
+namespace SD::ENGINE {
+
+// bytes uploaded per frame, a single mip row may exceed it
+constexpr size_t DEFAULT_TEXTURE_UPLOAD_BUDGET = 8 * 1024 * 1024;
+
+// Streams textures in, so scenes render before their textures are loaded.
+// A texture is handed out with its whole (cooked) mip chain allocated and nothing resident. Files are loaded from the
+// cooked texture cache, or cooked into it, on streaming threads of their own, so frame jobs never queue behind them. Every frame uploads the smallest pending mips over all
+// textures until the budget is spent, and a texture's view is clamped to the mips it has.
+class TextureStreamer
+{
+public:
+	TextureStreamer(RENDER::Renderer* renderer, const std::filesystem::path& cacheDir, size_t uploadBudget = DEFAULT_TEXTURE_UPLOAD_BUDGET);
+	~TextureStreamer();
+
+	TextureStreamer(const TextureStreamer&) = delete;
+	TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+	// Reads the file header only, the texture gets the layout it is cooked to for the usage. Arrays and volumes are
+	// loaded at once and not cooked. The alpha cutoff is the one of the material for cutouts.
+	std::shared_ptr<RENDER::Texture> Stream(const std::filesystem::path& path, TextureUsage usage, float alphaCutoff);
+
+	// Uploads decoded mips within the frame budget, on the render thread only.
+	void Update();
+
+	// textures not fully resident yet
+	size_t GetStreamingCount() const { return m_streaming; }
+
+private:
+	struct StreamedTexture;
+
+	// compression of cooked textures is spread over the decoder pool
+	void decode(
+		JobSystem& decoder,
+		const std::filesystem::path& path,
+		TextureUsage usage,
+		float alphaCutoff,
+		const std::weak_ptr<RENDER::Texture>& texture,
+		const DirectX::TexMetadata& metadata);
+
+private:
+	RENDER::Renderer* m_renderer;
+	std::filesystem::path m_cacheDir;
+	size_t m_uploadBudget;
+
+	std::mutex m_mutex;
+	std::vector<std::unique_ptr<StreamedTexture>> m_decoded;  // handed over by streaming threads
+	std::vector<std::unique_ptr<StreamedTexture>> m_uploading;  // render thread only
+
+	std::atomic<size_t> m_streaming{ 0 };
+	std::atomic<bool> m_stopping{ false };
+
+	size_t m_uploadedBytes = 0;
+	std::unique_ptr<Timer> m_pTimer = nullptr;  // since the first texture of a streaming batch
+
+	// last, so it is joined before anything its jobs touch goes away
+	std::unique_ptr<JobSystem> m_pDecoder = nullptr;
+};
+
+}  // end namespace SD::ENGINE
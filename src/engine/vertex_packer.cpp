@@ -0,0 +1,296 @@
+#include "vertex_packer.hpp"
+
+#include <DirectXPackedVector.h>
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+
+namespace
+{
+// the half precision step stays under a texel of a 1K texture up to it
+constexpr float HALF_UV_RANGE = 2.0f;
+
+enum class Encoding : uint8_t
+{
+	FLOAT,
+	UNORM16_POSITION,
+	OCTAHEDRAL16,
+	OCTAHEDRAL8,
+	HALF,
+	UNORM8
+};
+
+struct PackedElement
+{
+	Encoding encoding;
+	uint32_t offset;
+	const SD::ENGINE::VertexAttribute* attribute;
+};
+
+DXGI_FORMAT GetFloatFormat(uint32_t components)
+{
+	switch (components)
+	{
+	case 1:
+		return DXGI_FORMAT_R32_FLOAT;
+	case 2:
+		return DXGI_FORMAT_R32G32_FLOAT;
+	case 3:
+		return DXGI_FORMAT_R32G32B32_FLOAT;
+	default:
+		return DXGI_FORMAT_R32G32B32A32_FLOAT;
+	}
+}
+
+bool IsHalfRange(const std::vector<float>& values)
+{
+	return std::all_of(values.begin(), values.end(), [](float value)
+	{
+		return std::abs(value) <= HALF_UV_RANGE;
+	});
+}
+
+DirectX::XMVECTOR LoadAttribute(const float* value, uint32_t components, float w)
+{
+	DirectX::XMFLOAT4 result(0.0f, 0.0f, 0.0f, w);
+	memcpy(&result, value, std::min(components, 4u) * sizeof(float));
+
+	return DirectX::XMLoadFloat4(&result);
+}
+
+// Maps a unit vector to an octahedron unfolded to [-1, 1]^2, the lower half is folded over the diagonals.
+DirectX::XMFLOAT2 EncodeOctahedral(DirectX::FXMVECTOR direction)
+{
+	DirectX::XMFLOAT3 value;
+	DirectX::XMStoreFloat3(&value, direction);
+
+	const float length = std::abs(value.x) + std::abs(value.y) + std::abs(value.z);
+	if (length <= FLT_MIN)
+	{
+		return DirectX::XMFLOAT2(0.0f, 0.0f);
+	}
+
+	const float x = value.x / length;
+	const float y = value.y / length;
+	if (value.z >= 0.0f)
+	{
+		return DirectX::XMFLOAT2(x, y);
+	}
+
+	return DirectX::XMFLOAT2(
+		(1.0f - std::abs(y)) * (x >= 0.0f ? 1.0f : -1.0f),
+		(1.0f - std::abs(x)) * (y >= 0.0f ? 1.0f : -1.0f));
+}
+
+// Same as DecodeOctahedral of octahedral.hlsli.
+DirectX::XMVECTOR DecodeOctahedral(float x, float y)
+{
+	const float z = 1.0f - std::abs(x) - std::abs(y);
+	const float fold = std::max(-z, 0.0f);
+	x += x >= 0.0f ? -fold : fold;
+	y += y >= 0.0f ? -fold : fold;
+
+	return DirectX::XMVector3Normalize(DirectX::XMVectorSet(x, y, z, 0.0f));
+}
+
+// Tangent handedness is the sign of y, so y is moved to [0, 1] and kept off zero.
+float FoldHandedness(float y, float handedness, float minValue)
+{
+	return std::copysign(std::max(y * 0.5f + 0.5f, minValue), handedness);
+}
+
+float UnfoldHandedness(float y)
+{
+	return std::abs(y) * 2.0f - 1.0f;
+}
+
+// Stores the one of the four quantized encodings around the exact one closest in angle.
+// Returns its angular error in degrees.
+template<typename T>
+float StoreDirection(const float* value, uint32_t components, bool tangent, uint8_t* target)
+{
+	constexpr float scale = static_cast<float>(std::numeric_limits<T>::max());
+
+	const auto direction = DirectX::XMVector3Normalize(LoadAttribute(value, components, 0.0f));
+	const float handedness = tangent && components > 3 && value[3] < 0.0f ? -1.0f : 1.0f;
+
+	auto encoded = EncodeOctahedral(direction);
+	if (tangent)
+	{
+		encoded.y = FoldHandedness(encoded.y, handedness, 1.0f / scale);
+	}
+
+	T best[2] = {};
+	float bestDot = -2.0f;
+	for (const float x : { std::floor(encoded.x * scale), std::ceil(encoded.x * scale) })
+	{
+		for (float y : { std::floor(encoded.y * scale), std::ceil(encoded.y * scale) })
+		{
+			if (tangent && y == 0.0f)
+			{
+				y = handedness;
+			}
+
+			const float decodedY = tangent ? UnfoldHandedness(y / scale) : y / scale;
+			const float dot = DirectX::XMVectorGetX(DirectX::XMVector3Dot(direction, DecodeOctahedral(x / scale, decodedY)));
+			if (dot > bestDot)
+			{
+				bestDot = dot;
+				best[0] = static_cast<T>(x);
+				best[1] = static_cast<T>(y);
+			}
+		}
+	}
+
+	memcpy(target, best, sizeof(best));
+
+	// degenerate directions have nothing to compare with
+	if (DirectX::XMVector3Equal(direction, DirectX::XMVectorZero()))
+	{
+		return 0.0f;
+	}
+
+	return DirectX::XMConvertToDegrees(std::acos(std::min(bestDot, 1.0f)));
+}
+}  // end namespace
+
+namespace SD::ENGINE {
+
+PackedVertices PackVertices(const std::vector<VertexAttribute>& attributes, size_t vertexCount, const VertexPackingSettings& settings)
+{
+	PackedVertices packed;
+
+	std::vector<PackedElement> elements;
+	elements.reserve(attributes.size());
+
+	for (const auto& attribute : attributes)
+	{
+		VertexElement element;
+		element.semantic = attribute.semantic;
+		element.semanticIdx = attribute.semanticIdx;
+		element.offset = packed.format.stride;
+
+		auto encoding = Encoding::FLOAT;
+		element.format = GetFloatFormat(attribute.components);
+		auto size = static_cast<uint32_t>(attribute.components * sizeof(float));
+
+		if (attribute.semantic == "POSITION" && settings.quantizePositions)
+		{
+			encoding = Encoding::UNORM16_POSITION;
+			element.format = DXGI_FORMAT_R16G16B16A16_UNORM;
+			size = sizeof(DirectX::PackedVector::XMUSHORTN4);
+		}
+		else if ((attribute.semantic == "NORMAL" || attribute.semantic == "TANGENT") && attribute.components >= 3)
+		{
+			if (settings.directionEncoding == DirectionEncoding::OCTAHEDRAL_8)
+			{
+				encoding = Encoding::OCTAHEDRAL8;
+				element.format = DXGI_FORMAT_R8G8_SNORM;
+				size = 2 * sizeof(int8_t);
+			}
+			else
+			{
+				encoding = Encoding::OCTAHEDRAL16;
+				element.format = DXGI_FORMAT_R16G16_SNORM;
+				size = 2 * sizeof(int16_t);
+			}
+		}
+		else if (attribute.semantic == "TEXCOORD" && attribute.components == 2 && IsHalfRange(attribute.values))
+		{
+			encoding = Encoding::HALF;
+			element.format = DXGI_FORMAT_R16G16_FLOAT;
+			size = sizeof(DirectX::PackedVector::XMHALF2);
+		}
+		else if (attribute.semantic == "COLOR")
+		{
+			encoding = Encoding::UNORM8;
+			element.format = DXGI_FORMAT_R8G8B8A8_UNORM;
+			size = sizeof(DirectX::PackedVector::XMUBYTEN4);
+		}
+
+		elements.push_back({ encoding, element.offset, &attribute });
+		packed.format.elements.push_back(element);
+		packed.format.stride += size;
+	}
+
+	const auto& bounds = settings.positionBounds;
+	const auto boundsMin = DirectX::XMVectorSubtract(DirectX::XMLoadFloat3(&bounds.Center), DirectX::XMLoadFloat3(&bounds.Extents));
+	const auto boundsSize = DirectX::XMVectorMax(
+		DirectX::XMVectorScale(DirectX::XMLoadFloat3(&bounds.Extents), 2.0f), DirectX::XMVectorReplicate(FLT_EPSILON));
+
+	packed.data.resize(static_cast<size_t>(packed.format.stride) * vertexCount);
+
+	for (size_t vertex = 0; vertex < vertexCount; ++vertex)
+	{
+		uint8_t* data = packed.data.data() + vertex * packed.format.stride;
+
+		for (const auto& element : elements)
+		{
+			const auto components = element.attribute->components;
+			const float* value = element.attribute->values.data() + vertex * components;
+			uint8_t* target = data + element.offset;
+
+			switch (element.encoding)
+			{
+			case Encoding::FLOAT:
+			{
+				memcpy(target, value, components * sizeof(float));
+				break;
+			}
+			case Encoding::UNORM16_POSITION:
+			{
+				const auto position = DirectX::XMVectorDivide(
+					DirectX::XMVectorSubtract(LoadAttribute(value, components, 0.0f), boundsMin), boundsSize);
+
+				DirectX::PackedVector::XMUSHORTN4 result;
+				DirectX::PackedVector::XMStoreUShortN4(&result, DirectX::XMVectorSetW(position, 1.0f));
+				memcpy(target, &result, sizeof(result));
+				break;
+			}
+			case Encoding::OCTAHEDRAL16:
+			{
+				const bool tangent = element.attribute->semantic == "TANGENT";
+				const float error = StoreDirection<int16_t>(value, components, tangent, target);
+				packed.maxDirectionError = std::max(packed.maxDirectionError, error);
+				break;
+			}
+			case Encoding::OCTAHEDRAL8:
+			{
+				const bool tangent = element.attribute->semantic == "TANGENT";
+				const float error = StoreDirection<int8_t>(value, components, tangent, target);
+				packed.maxDirectionError = std::max(packed.maxDirectionError, error);
+				break;
+			}
+			case Encoding::HALF:
+			{
+				DirectX::PackedVector::XMHALF2 result;
+				DirectX::PackedVector::XMStoreHalf2(&result, LoadAttribute(value, components, 0.0f));
+				memcpy(target, &result, sizeof(result));
+				break;
+			}
+			case Encoding::UNORM8:
+			{
+				DirectX::PackedVector::XMUBYTEN4 result;
+				DirectX::PackedVector::XMStoreUByteN4(&result, LoadAttribute(value, components, 1.0f));
+				memcpy(target, &result, sizeof(result));
+				break;
+			}
+			}
+		}
+	}
+
+	return packed;
+}
+
+void GetPositionDequantization(const DirectX::BoundingBox& bounds, DirectX::XMFLOAT4& scale, DirectX::XMFLOAT4& offset)
+{
+	scale = DirectX::XMFLOAT4(2.0f * bounds.Extents.x, 2.0f * bounds.Extents.y, 2.0f * bounds.Extents.z, 0.0f);
+	offset = DirectX::XMFLOAT4(
+		bounds.Center.x - bounds.Extents.x, bounds.Center.y - bounds.Extents.y, bounds.Center.z - bounds.Extents.z, 0.0f);
+}
+
+}  // end namespace SD::ENGINE
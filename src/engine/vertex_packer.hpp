@@ -0,0 +1,55 @@
+#pragma once
+
+#include <DirectXCollision.h>
+
+#include <string>
+#include <vector>
+
+#include "geometry_pool.hpp"
+
+
+namespace SD::ENGINE {
+
+// Decoded vertex attribute, tightly packed floats.
+struct VertexAttribute
+{
+	std::string semantic;
+	uint32_t semanticIdx = 0;
+	uint32_t components = 0;
+	std::vector<float> values = {};
+};
+
+// Precision of octahedral normals and tangents, both decode the same way in shaders.
+enum class DirectionEncoding : uint8_t
+{
+	OCTAHEDRAL_16,  // R16G16_SNORM
+	OCTAHEDRAL_8  // R8G8_SNORM
+};
+
+struct VertexPackingSettings
+{
+	bool quantizePositions = false;
+	DirectX::BoundingBox positionBounds = {};  // quantization range of positions
+	DirectionEncoding directionEncoding = DirectionEncoding::OCTAHEDRAL_16;
+};
+
+struct PackedVertices
+{
+	GeometryFormat format = {};
+	std::vector<uint8_t> data = {};
+	float maxDirectionError = 0.0f;  // degrees between normals and tangents and their decoded encoding
+};
+
+// Interleaves attributes into a single stream and quantizes them:
+//   POSITION   - R32G32B32_FLOAT or R16G16B16A16_UNORM relative to the bounds
+//   NORMAL     - octahedral R16G16_SNORM or R8G8_SNORM
+//   TANGENT    - octahedral R16G16_SNORM or R8G8_SNORM, handedness in the sign of y (see octahedral.hlsli)
+//   TEXCOORD_n - R16G16_FLOAT when in half precision range, R32G32_FLOAT otherwise
+//   COLOR_n    - R8G8B8A8_UNORM
+// anything else is kept as floats.
+PackedVertices PackVertices(const std::vector<VertexAttribute>& attributes, size_t vertexCount, const VertexPackingSettings& settings);
+
+// Maps 16 bit positions back to the bounds: position * scale + offset.
+void GetPositionDequantization(const DirectX::BoundingBox& bounds, DirectX::XMFLOAT4& scale, DirectX::XMFLOAT4& offset);
+
+}  // end namespace SD::ENGINE
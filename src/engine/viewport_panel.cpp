@@ -23,14 +23,14 @@ void ViewportPanel::Draw()
 
 	const auto viewportSize = ImGui::GetContentRegionAvail();
 
-	const auto width = static_cast<UINT>(viewportSize.x);
-	const auto height = static_cast<UINT>(viewportSize.y);
+	const auto width = static_cast<uint32_t>(viewportSize.x);
+	const auto height = static_cast<uint32_t>(viewportSize.y);
 	if (frameBuffer->width() != width || frameBuffer->height() != height)
 	{
 		rendererSystem->OnSpaceViewportResize(viewportSize.x, viewportSize.y);
 	}
 
-	ImGui::Image((void*)frameBuffer->getSRV().Get(), viewportSize);
+	ImGui::Image((void*)frameBuffer->getSRV(), viewportSize);
 
 	ImGui::End();
 	ImGui::PopStyleVar();
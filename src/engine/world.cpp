@@ -1,14 +1,31 @@
 #include "world.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
 #include <filesystem>
+#include <numeric>
 #include <iostream>
+#include <iterator>
+#include <limits>
+#include <tuple>
 #include <unordered_map>
+#include <unordered_set>
 
 #include "application.hpp"
+#include "exceptions.hpp"
+#include "gltf_file.hpp"
+#include "index_optimizer.hpp"
+#include "meshlet.hpp"
+#include "meshopt_decoder.hpp"
+#include "tangent_space.hpp"
+#include "timer.hpp"
 #include "utils.hpp"
+#include "vertex_packer.hpp"
 
 #include "scene_browser_panel.hpp"
 #include "node_properties_panel.hpp"
+#include "render_settings_panel.hpp"
 #include "space_settings_panel.hpp"
 
 #define TINYGLTF_IMPLEMENTATION
@@ -19,23 +36,55 @@
 #pragma warning( push, 0 )
 #include "tiny_gltf.h"
 #include <DirectXMath.h>
+#include <DirectXTex.h>
 #pragma warning( pop )
 
 
 namespace
 {
-typedef std::pair<int, int> BufferFormat;
+// component type, element type, normalized
+typedef std::tuple<int, int, bool> BufferFormat;
 
 struct buffer_format_hasher {
 	int64_t operator() (const BufferFormat& p) const {
-		return ((static_cast<int64_t>(p.first)) << 32) | static_cast<int64_t>(p.second);
+		return ((static_cast<int64_t>(std::get<0>(p))) << 32) | (static_cast<int64_t>(std::get<1>(p)) << 1) | static_cast<int64_t>(std::get<2>(p));
 	}
 };
 
-const std::unordered_map<const BufferFormat, DXGI_FORMAT, buffer_format_hasher> BUFFER_FORMATS = {
-	{{TINYGLTF_COMPONENT_TYPE_FLOAT, TINYGLTF_TYPE_VEC2}, DXGI_FORMAT_R32G32_FLOAT},
-	{{TINYGLTF_COMPONENT_TYPE_FLOAT, TINYGLTF_TYPE_VEC3}, DXGI_FORMAT_R32G32B32_FLOAT},
-	{{TINYGLTF_COMPONENT_TYPE_FLOAT, TINYGLTF_TYPE_VEC4}, DXGI_FORMAT_R32G32B32A32_FLOAT},
+// accessor formats read as vertex attributes, KHR_mesh_quantization adds (normalized) 8 and 16 bit integers;
+// all are decoded to floats and packed again by the vertex packer
+const std::unordered_set<BufferFormat, buffer_format_hasher> SUPPORTED_BUFFER_FORMATS = {
+	{TINYGLTF_COMPONENT_TYPE_FLOAT, TINYGLTF_TYPE_VEC2, false},
+	{TINYGLTF_COMPONENT_TYPE_FLOAT, TINYGLTF_TYPE_VEC3, false},
+	{TINYGLTF_COMPONENT_TYPE_FLOAT, TINYGLTF_TYPE_VEC4, false},
+
+	{TINYGLTF_COMPONENT_TYPE_BYTE, TINYGLTF_TYPE_VEC2, true},
+	{TINYGLTF_COMPONENT_TYPE_BYTE, TINYGLTF_TYPE_VEC3, true},
+	{TINYGLTF_COMPONENT_TYPE_BYTE, TINYGLTF_TYPE_VEC4, true},
+	{TINYGLTF_COMPONENT_TYPE_BYTE, TINYGLTF_TYPE_VEC2, false},
+	{TINYGLTF_COMPONENT_TYPE_BYTE, TINYGLTF_TYPE_VEC3, false},
+	{TINYGLTF_COMPONENT_TYPE_BYTE, TINYGLTF_TYPE_VEC4, false},
+
+	{TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE, TINYGLTF_TYPE_VEC2, true},
+	{TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE, TINYGLTF_TYPE_VEC3, true},
+	{TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE, TINYGLTF_TYPE_VEC4, true},
+	{TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE, TINYGLTF_TYPE_VEC2, false},
+	{TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE, TINYGLTF_TYPE_VEC3, false},
+	{TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE, TINYGLTF_TYPE_VEC4, false},
+
+	{TINYGLTF_COMPONENT_TYPE_SHORT, TINYGLTF_TYPE_VEC2, true},
+	{TINYGLTF_COMPONENT_TYPE_SHORT, TINYGLTF_TYPE_VEC3, true},
+	{TINYGLTF_COMPONENT_TYPE_SHORT, TINYGLTF_TYPE_VEC4, true},
+	{TINYGLTF_COMPONENT_TYPE_SHORT, TINYGLTF_TYPE_VEC2, false},
+	{TINYGLTF_COMPONENT_TYPE_SHORT, TINYGLTF_TYPE_VEC3, false},
+	{TINYGLTF_COMPONENT_TYPE_SHORT, TINYGLTF_TYPE_VEC4, false},
+
+	{TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT, TINYGLTF_TYPE_VEC2, true},
+	{TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT, TINYGLTF_TYPE_VEC3, true},
+	{TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT, TINYGLTF_TYPE_VEC4, true},
+	{TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT, TINYGLTF_TYPE_VEC2, false},
+	{TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT, TINYGLTF_TYPE_VEC3, false},
+	{TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT, TINYGLTF_TYPE_VEC4, false},
 };
 
 const std::unordered_map<std::string, SD::ENGINE::LightType> LIGHT_TYPES_MAP = {
@@ -43,6 +92,619 @@ const std::unordered_map<std::string, SD::ENGINE::LightType> LIGHT_TYPES_MAP = {
 	{"spot", SD::ENGINE::LightType::SPOT},
 	{"directional", SD::ENGINE::LightType::DIRECTIONAL},
 };
+
+const std::unordered_map<std::string, SD::ENGINE::DrawBucket> ALPHA_MODES_MAP = {
+	{"OPAQUE", SD::ENGINE::DrawBucket::OPAQUE_GEOMETRY},
+	{"MASK", SD::ENGINE::DrawBucket::ALPHA_TEST},
+	{"BLEND", SD::ENGINE::DrawBucket::BLEND},
+};
+
+// 16 bit static positions relative to the static geometry bounds, sub-millimeter for Sponza sized scenes
+const bool QUANTIZE_STATIC_POSITIONS = true;
+
+// octahedral normals and tangents, 8 bit ones save 4 bytes per vertex for about a degree of error
+const auto DIRECTION_ENCODING = SD::ENGINE::DirectionEncoding::OCTAHEDRAL_16;
+
+// cooked scenes are valid for the packing settings they were cooked with only
+const uint32_t COOKED_SCENE_SETTINGS = static_cast<uint32_t>(DIRECTION_ENCODING) | (QUANTIZE_STATIC_POSITIONS ? 1u << 8 : 0u);
+
+// Sponza cut-outs are exported as OPAQUE, keep discarding (almost) transparent texels for them
+const float DEFAULT_ALPHA_CUTOFF = 0.1f;
+
+// what the pixel shader clips albedo alpha at
+float GetAlphaCutoff(const tinygltf::Material& material)
+{
+	return material.alphaMode == "MASK" ? static_cast<float>(material.alphaCutoff) : DEFAULT_ALPHA_CUTOFF;
+}
+
+SD::RENDER::DepthMode BucketDepthMode(SD::ENGINE::DrawBucket bucket, bool depthPrepass)
+{
+	switch (bucket)
+	{
+	case SD::ENGINE::DrawBucket::OPAQUE_GEOMETRY:
+		return depthPrepass ? SD::RENDER::DepthMode::EQUAL : SD::RENDER::DepthMode::ENABLED;
+	case SD::ENGINE::DrawBucket::BLEND:
+		return SD::RENDER::DepthMode::READ_ONLY;
+	default:
+		return SD::RENDER::DepthMode::ENABLED;
+	}
+}
+
+// Positive floats keep their order when compared as integers, the top 16 bits are a coarse logarithmic depth.
+uint64_t QuantizeDepth(float depth)
+{
+	depth = std::max(depth, 0.0f);
+
+	uint32_t bits;
+	memcpy(&bits, &depth, sizeof(bits));
+
+	return bits >> 16;
+}
+
+// Copies accessor elements into a tightly packed array, whatever the buffer view stride is.
+std::vector<uint8_t> ReadAccessor(const tinygltf::Model& model, const SD::ENGINE::GltfFile& file, const tinygltf::Accessor& accessor)
+{
+	const auto& bufferView = model.bufferViews[accessor.bufferView];
+	const auto buffer = file.GetBuffer(model, bufferView.buffer);
+
+	const size_t elementSize = static_cast<size_t>(
+		tinygltf::GetComponentSizeInBytes(accessor.componentType) * tinygltf::GetNumComponentsInType(accessor.type));
+	const size_t stride = static_cast<size_t>(accessor.ByteStride(bufferView));
+	const uint8_t* data = buffer.data + bufferView.byteOffset + accessor.byteOffset;
+
+	std::vector<uint8_t> result(elementSize * accessor.count);
+	for (size_t idx = 0; idx < accessor.count; ++idx)
+	{
+		memcpy(result.data() + idx * elementSize, data + idx * stride, elementSize);
+	}
+
+	return result;
+}
+
+// Normalized integer components to [0, 1] or [-1, 1] as glTF defines it.
+template<typename T>
+float DecodeComponent(float component, bool normalized)
+{
+	constexpr float scale = 1.0f / static_cast<float>(std::numeric_limits<T>::max());
+
+	return normalized ? std::max(component * scale, -1.0f) : component;
+}
+
+// Converts integer components to floats.
+template<typename T>
+void DecodeComponents(const std::vector<uint8_t>& data, bool normalized, std::vector<float>& values)
+{
+	values.resize(data.size() / sizeof(T));
+	for (size_t idx = 0; idx < values.size(); ++idx)
+	{
+		T component;
+		memcpy(&component, data.data() + idx * sizeof(T), sizeof(T));
+
+		values[idx] = DecodeComponent<T>(static_cast<float>(component), normalized);
+	}
+}
+
+// Accessor min/max are in the accessor component type, decoded the same way as the components.
+float DecodeBound(double bound, int componentType, bool normalized)
+{
+	const auto value = static_cast<float>(bound);
+	switch (componentType)
+	{
+	case TINYGLTF_COMPONENT_TYPE_BYTE:
+		return DecodeComponent<int8_t>(value, normalized);
+	case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE:
+		return DecodeComponent<uint8_t>(value, normalized);
+	case TINYGLTF_COMPONENT_TYPE_SHORT:
+		return DecodeComponent<int16_t>(value, normalized);
+	case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT:
+		return DecodeComponent<uint16_t>(value, normalized);
+	default:
+		return value;
+	}
+}
+
+// Transforms the leading float3 of every element, points get translated, directions are renormalized.
+void TransformValues(std::vector<float>& values, uint32_t components, const DirectX::XMMATRIX& transform, bool point)
+{
+	for (size_t offset = 0; offset + components <= values.size(); offset += components)
+	{
+		auto* value = reinterpret_cast<DirectX::XMFLOAT3*>(values.data() + offset);
+
+		auto vector = DirectX::XMLoadFloat3(value);
+		vector = point
+			? DirectX::XMVector3TransformCoord(vector, transform)
+			: DirectX::XMVector3Normalize(DirectX::XMVector3TransformNormal(vector, transform));
+		DirectX::XMStoreFloat3(value, vector);
+	}
+}
+
+// Reads indices widened to 32 bit, the source size is kept in the format.
+std::vector<uint32_t> ReadIndices(
+	const tinygltf::Model& model, const SD::ENGINE::GltfFile& file, const tinygltf::Accessor& accessor, DXGI_FORMAT& format)
+{
+	const auto data = ReadAccessor(model, file, accessor);
+
+	std::vector<uint32_t> indices(accessor.count);
+	switch (accessor.componentType)
+	{
+	case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE:
+	{
+		std::copy(data.begin(), data.end(), indices.begin());
+		format = DXGI_FORMAT_R16_UINT;
+		break;
+	}
+	case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT:
+	{
+		const auto* source = reinterpret_cast<const uint16_t*>(data.data());
+		std::copy(source, source + accessor.count, indices.begin());
+		format = DXGI_FORMAT_R16_UINT;
+		break;
+	}
+	default:
+	{
+		memcpy(indices.data(), data.data(), data.size());
+		format = DXGI_FORMAT_R32_UINT;
+		break;
+	}
+	}
+
+	return indices;
+}
+
+std::vector<uint8_t> WriteIndices(const std::vector<uint32_t>& indices, DXGI_FORMAT format)
+{
+	if (format == DXGI_FORMAT_R32_UINT)
+	{
+		std::vector<uint8_t> result(indices.size() * sizeof(uint32_t));
+		memcpy(result.data(), indices.data(), result.size());
+
+		return result;
+	}
+
+	std::vector<uint8_t> result(indices.size() * sizeof(uint16_t));
+	auto* target = reinterpret_cast<uint16_t*>(result.data());
+	for (size_t idx = 0; idx < indices.size(); ++idx)
+	{
+		target[idx] = static_cast<uint16_t>(indices[idx]);
+	}
+
+	return result;
+}
+
+const std::unordered_map<std::string, SD::ENGINE::MeshoptMode> MESHOPT_MODES_MAP = {
+	{"ATTRIBUTES", SD::ENGINE::MeshoptMode::ATTRIBUTES},
+	{"TRIANGLES", SD::ENGINE::MeshoptMode::TRIANGLES},
+	{"INDICES", SD::ENGINE::MeshoptMode::INDICES},
+};
+
+const std::unordered_map<std::string, SD::ENGINE::MeshoptFilter> MESHOPT_FILTERS_MAP = {
+	{"NONE", SD::ENGINE::MeshoptFilter::NONE},
+	{"OCTAHEDRAL", SD::ENGINE::MeshoptFilter::OCTAHEDRAL},
+	{"QUATERNION", SD::ENGINE::MeshoptFilter::QUATERNION},
+	{"EXPONENTIAL", SD::ENGINE::MeshoptFilter::EXPONENTIAL},
+};
+
+size_t GetSizeProperty(const tinygltf::Value& object, const std::string& name, size_t fallback = 0)
+{
+	const auto& value = object.Get(name);
+	return value.IsNumber() ? static_cast<size_t>(value.GetNumberAsDouble()) : fallback;
+}
+
+std::string GetStringProperty(const tinygltf::Value& object, const std::string& name, const std::string& fallback)
+{
+	const auto& value = object.Get(name);
+	return value.IsString() ? value.Get<std::string>() : fallback;
+}
+
+// Decodes EXT_meshopt_compression buffer views into buffers of their own, a buffer view per job.
+// Views are redirected to the decoded data, so accessors read it as if it was never compressed.
+// Returns the number of decoded bytes.
+size_t DecodeMeshoptBufferViews(tinygltf::Model& model, const SD::ENGINE::GltfFile& file)
+{
+	static const std::string extensionName = "EXT_meshopt_compression";
+
+	std::vector<size_t> views;
+	for (size_t idx = 0; idx < model.bufferViews.size(); ++idx)
+	{
+		if (model.bufferViews[idx].extensions.count(extensionName) > 0)
+		{
+			views.push_back(idx);
+		}
+	}
+
+	if (views.empty())
+	{
+		return 0;
+	}
+
+	// fallback buffers stay as they are, nothing references them afterwards
+	const size_t firstBuffer = model.buffers.size();
+	model.buffers.resize(firstBuffer + views.size());
+
+	std::atomic<size_t> decodedBytes{ 0 };
+
+	const auto& jobSystem = SD::ENGINE::Application::GetApplication()->GetJobSystem();
+	jobSystem->ParallelFor(views.size(), [&](size_t idx)
+	{
+		auto& bufferView = model.bufferViews[views[idx]];
+		const auto& extension = bufferView.extensions.at(extensionName);
+
+		const size_t bufferIdx = GetSizeProperty(extension, "buffer", model.buffers.size());
+		const size_t byteOffset = GetSizeProperty(extension, "byteOffset");
+		const size_t byteLength = GetSizeProperty(extension, "byteLength");
+		const size_t byteStride = GetSizeProperty(extension, "byteStride");
+		const size_t count = GetSizeProperty(extension, "count");
+
+		const auto mode = MESHOPT_MODES_MAP.find(GetStringProperty(extension, "mode", ""));
+		const auto filter = MESHOPT_FILTERS_MAP.find(GetStringProperty(extension, "filter", "NONE"));
+
+		if (bufferIdx >= firstBuffer || mode == MESHOPT_MODES_MAP.end() || filter == MESHOPT_FILTERS_MAP.end())
+		{
+			throw SD::SomeException(__LINE__, __FILEW__, L"INVALID MESHOPT BUFFER VIEW!");
+		}
+
+		const auto source = file.GetBuffer(model, static_cast<int>(bufferIdx));
+		if (byteOffset + byteLength > source.size)
+		{
+			throw SD::SomeException(__LINE__, __FILEW__, L"MESHOPT BUFFER VIEW IS OUT OF BOUNDS!");
+		}
+
+		auto& decoded = model.buffers[firstBuffer + idx];
+		decoded.data.resize(count * byteStride);
+
+		if (!SD::ENGINE::DecodeMeshoptBuffer(
+			decoded.data.data(), count, byteStride, source.data + byteOffset, byteLength, mode->second, filter->second))
+		{
+			throw SD::SomeException(__LINE__, __FILEW__, L"MALFORMED MESHOPT BUFFER VIEW!");
+		}
+
+		bufferView.buffer = static_cast<int>(firstBuffer + idx);
+		bufferView.byteOffset = 0;
+		bufferView.byteLength = decoded.data.size();
+		bufferView.extensions.erase(extensionName);
+
+		decodedBytes += decoded.data.size();
+	});
+
+	return decodedBytes;
+}
+
+// glTF has no notion of static nodes, nodes opt in to baking with a "static": true extra
+bool IsStaticNode(const tinygltf::Node& node)
+{
+	return node.extras.Has("static") && node.extras.Get("static").IsBool() && node.extras.Get("static").Get<bool>();
+}
+
+// Splits a glTF attribute name into a semantic and its index: TEXCOORD_1 - TEXCOORD, 1.
+void ParseSemantic(const std::string& name, std::string& semantic, uint32_t& semanticIdx)
+{
+	semantic = name;
+	semanticIdx = 0;
+
+	if (const auto pos = name.find_last_of('_'); pos != name.npos)
+	{
+		semantic = name.substr(0, pos);
+		semanticIdx = static_cast<uint32_t>(std::stoi(name.substr(pos + 1)));
+	}
+}
+
+// Decodes primitive attributes to floats.
+std::vector<SD::ENGINE::VertexAttribute> ReadAttributes(
+	const tinygltf::Model& model, const SD::ENGINE::GltfFile& file, const tinygltf::Primitive& primitive, size_t& vertexCount)
+{
+	std::vector<SD::ENGINE::VertexAttribute> attributes;
+	attributes.reserve(primitive.attributes.size());
+
+	for (const auto& [name, idx] : primitive.attributes)
+	{
+		const auto& accessor = model.accessors[idx];
+
+		if (SUPPORTED_BUFFER_FORMATS.count({ accessor.componentType, accessor.type, accessor.normalized }) == 0)
+		{
+			throw SD::SomeException(__LINE__, __FILEW__, L"UNSUPPORTED VERTEX FORMAT!");
+		}
+
+		auto& attribute = attributes.emplace_back();
+		ParseSemantic(name, attribute.semantic, attribute.semanticIdx);
+		attribute.components = static_cast<uint32_t>(tinygltf::GetNumComponentsInType(accessor.type));
+
+		// quantized positions are dequantized by the node transforms, the packer quantizes everything again
+		const auto data = ReadAccessor(model, file, accessor);
+		switch (accessor.componentType)
+		{
+		case TINYGLTF_COMPONENT_TYPE_BYTE:
+			DecodeComponents<int8_t>(data, accessor.normalized, attribute.values);
+			break;
+		case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE:
+			DecodeComponents<uint8_t>(data, accessor.normalized, attribute.values);
+			break;
+		case TINYGLTF_COMPONENT_TYPE_SHORT:
+			DecodeComponents<int16_t>(data, accessor.normalized, attribute.values);
+			break;
+		case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT:
+			DecodeComponents<uint16_t>(data, accessor.normalized, attribute.values);
+			break;
+		default:
+			attribute.values.resize(data.size() / sizeof(float));
+			memcpy(attribute.values.data(), data.data(), data.size());
+			break;
+		}
+
+		vertexCount = accessor.count;
+	}
+
+	return attributes;
+}
+
+struct CompletedPrimitive
+{
+	tinygltf::Primitive* primitive = nullptr;
+	bool smoothNormals = false;
+
+	std::vector<SD::ENGINE::VertexAttribute> attributes = {};
+	std::vector<uint32_t> indices = {};
+	size_t vertexCount = 0;
+};
+
+// Appends a tightly packed accessor with a buffer of its own to the model.
+int AddAccessor(tinygltf::Model& model, const void* data, size_t size, size_t count, int componentType, int type)
+{
+	auto& buffer = model.buffers.emplace_back();
+	buffer.data.resize(size);
+	memcpy(buffer.data.data(), data, size);
+
+	auto& bufferView = model.bufferViews.emplace_back();
+	bufferView.buffer = static_cast<int>(model.buffers.size() - 1);
+	bufferView.byteLength = size;
+
+	auto& accessor = model.accessors.emplace_back();
+	accessor.bufferView = static_cast<int>(model.bufferViews.size() - 1);
+	accessor.componentType = componentType;
+	accessor.type = type;
+	accessor.count = count;
+
+	return static_cast<int>(model.accessors.size() - 1);
+}
+
+// The pbr vertex shader reads NORMAL, TANGENT and TEXCOORD_0, primitives missing any of them get them generated:
+// flat normals as glTF requires (smooth ones when mesh extras ask for smoothNormals), MikkTSpace tangents and zero
+// texture coordinates. Primitives are completed in parallel and written back to the model as float accessors, so
+// everything reading the model afterwards sees complete primitives. Returns the number of completed primitives.
+size_t CompletePrimitiveAttributes(tinygltf::Model& model, const SD::ENGINE::GltfFile& file)
+{
+	std::vector<CompletedPrimitive> completed;
+	for (auto& mesh : model.meshes)
+	{
+		const bool smoothNormals = mesh.extras.Has("smoothNormals") && mesh.extras.Get("smoothNormals").IsBool()
+			&& mesh.extras.Get("smoothNormals").Get<bool>();
+
+		for (auto& primitive : mesh.primitives)
+		{
+			const auto& attributes = primitive.attributes;
+			const bool triangles = primitive.mode == TINYGLTF_MODE_TRIANGLES || primitive.mode == -1;
+			const bool complete = attributes.count("NORMAL") > 0 && attributes.count("TANGENT") > 0 && attributes.count("TEXCOORD_0") > 0;
+
+			if (triangles && !complete && attributes.count("POSITION") > 0)
+			{
+				completed.push_back({ &primitive, smoothNormals });
+			}
+		}
+	}
+
+	const auto& jobSystem = SD::ENGINE::Application::GetApplication()->GetJobSystem();
+	jobSystem->ParallelFor(completed.size(), [&](size_t idx)
+	{
+		auto& result = completed[idx];
+		const auto& primitive = *result.primitive;
+
+		result.attributes = ReadAttributes(model, file, primitive, result.vertexCount);
+
+		if (primitive.indices >= 0)
+		{
+			DXGI_FORMAT format = DXGI_FORMAT_R32_UINT;
+			result.indices = ReadIndices(model, file, model.accessors[primitive.indices], format);
+		}
+		else
+		{
+			result.indices.resize(result.vertexCount);
+			std::iota(result.indices.begin(), result.indices.end(), 0u);
+		}
+
+		if (primitive.attributes.count("NORMAL") == 0)
+		{
+			if (result.smoothNormals)
+			{
+				SD::ENGINE::GenerateSmoothNormals(result.attributes, result.indices, result.vertexCount);
+			}
+			else
+			{
+				SD::ENGINE::GenerateFlatNormals(result.attributes, result.indices, result.vertexCount);
+			}
+		}
+
+		if (primitive.attributes.count("TEXCOORD_0") == 0)
+		{
+			auto& texcoord = result.attributes.emplace_back();
+			texcoord.semantic = "TEXCOORD";
+			texcoord.components = 2;
+			texcoord.values.resize(result.vertexCount * 2, 0.0f);
+		}
+
+		if (primitive.attributes.count("TANGENT") == 0)
+		{
+			SD::ENGINE::GenerateTangents(result.attributes, result.indices, result.vertexCount);
+		}
+	});
+
+	// the model is only read by the jobs, accessors are added afterwards
+	for (auto& result : completed)
+	{
+		auto& primitive = *result.primitive;
+		primitive.attributes.clear();
+
+		for (const auto& attribute : result.attributes)
+		{
+			const int type = attribute.components == 2 ? TINYGLTF_TYPE_VEC2 : attribute.components == 3 ? TINYGLTF_TYPE_VEC3 : TINYGLTF_TYPE_VEC4;
+			const int accessorIdx = AddAccessor(
+				model,
+				attribute.values.data(),
+				attribute.values.size() * sizeof(float),
+				result.vertexCount,
+				TINYGLTF_COMPONENT_TYPE_FLOAT,
+				type);
+
+			std::string name = attribute.semantic;
+			if (name != "POSITION" && name != "NORMAL" && name != "TANGENT")
+			{
+				name += "_" + std::to_string(attribute.semanticIdx);
+			}
+			primitive.attributes[name] = accessorIdx;
+
+			// bounds are taken from positions min and max
+			if (name == "POSITION")
+			{
+				auto& accessor = model.accessors[accessorIdx];
+				accessor.minValues.assign(3, std::numeric_limits<double>::max());
+				accessor.maxValues.assign(3, std::numeric_limits<double>::lowest());
+				for (size_t offset = 0; offset < attribute.values.size(); offset += attribute.components)
+				{
+					for (size_t axis = 0; axis < 3; ++axis)
+					{
+						accessor.minValues[axis] = std::min(accessor.minValues[axis], static_cast<double>(attribute.values[offset + axis]));
+						accessor.maxValues[axis] = std::max(accessor.maxValues[axis], static_cast<double>(attribute.values[offset + axis]));
+					}
+				}
+			}
+		}
+
+		primitive.indices = AddAccessor(
+			model,
+			result.indices.data(),
+			result.indices.size() * sizeof(uint32_t),
+			result.indices.size(),
+			TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT,
+			TINYGLTF_TYPE_SCALAR);
+		primitive.mode = TINYGLTF_MODE_TRIANGLES;
+	}
+
+	return completed.size();
+}
+
+// Packs primitive vertices and indices into the pool, moved into world space when a transform is given.
+// Triangles and vertices are reordered for the post-transform cache, overdraw and vertex fetch on the way.
+// Indices are narrowed to 16 bit, split into chunks with own base vertices when needed, and every chunk is split
+// into meshlets in the same space.
+SD::ENGINE::GeometryRange AddPrimitiveGeometry(
+	const std::string& name,
+	const tinygltf::Model& model,
+	const SD::ENGINE::GltfFile& file,
+	const tinygltf::Primitive& primitive,
+	const DirectX::XMMATRIX* transform,
+	const SD::ENGINE::VertexPackingSettings& settings,
+	SD::ENGINE::GeometryPool& pool,
+	std::vector<SD::ENGINE::IndexRange>& chunks,
+	std::vector<SD::ENGINE::Meshlet>& meshlets)
+{
+	size_t vertexCount = 0;
+	auto attributes = ReadAttributes(model, file, primitive, vertexCount);
+
+	bool mirrored = false;
+	if (transform)
+	{
+		const auto normalTransform = DirectX::XMMatrixTranspose(DirectX::XMMatrixInverse(nullptr, *transform));
+		mirrored = DirectX::XMVectorGetX(DirectX::XMMatrixDeterminant(*transform)) < 0.0f;
+
+		for (auto& attribute : attributes)
+		{
+			if (attribute.semantic == "POSITION")
+			{
+				TransformValues(attribute.values, attribute.components, *transform, true);
+			}
+			else if (attribute.semantic == "NORMAL")
+			{
+				TransformValues(attribute.values, attribute.components, normalTransform, false);
+			}
+			else if (attribute.semantic == "TANGENT")
+			{
+				TransformValues(attribute.values, attribute.components, *transform, false);
+
+				// handedness is flipped together with the winding
+				for (size_t offset = 3; mirrored && offset < attribute.values.size(); offset += attribute.components)
+				{
+					attribute.values[offset] = -attribute.values[offset];
+				}
+			}
+		}
+	}
+
+	DXGI_FORMAT sourceFormat = DXGI_FORMAT_R16_UINT;
+	auto indices = ReadIndices(model, file, model.accessors[primitive.indices], sourceFormat);
+	if (mirrored)
+	{
+		for (size_t idx = 0; idx + 2 < indices.size(); idx += 3)
+		{
+			std::swap(indices[idx + 1], indices[idx + 2]);
+		}
+	}
+
+	// vertex cache, overdraw and vertex fetch optimization
+	const auto before = SD::ENGINE::AnalyzeVertexCache(indices, vertexCount);
+	indices = SD::ENGINE::OptimizeVertexCache(indices, vertexCount);
+
+	const auto position = std::find_if(attributes.begin(), attributes.end(), [](const SD::ENGINE::VertexAttribute& attribute)
+	{
+		return attribute.semantic == "POSITION";
+	});
+	if (position != attributes.end())
+	{
+		indices = SD::ENGINE::OptimizeOverdraw(indices, position->values.data(), position->components, vertexCount);
+	}
+
+	// meshlets are built from source vertices, fetch remap keeps the triangle order
+	const auto sourceIndices = indices;
+
+	size_t remappedCount = 0;
+	const auto remap = SD::ENGINE::OptimizeVertexFetch(indices, vertexCount, remappedCount);
+	const auto after = SD::ENGINE::AnalyzeVertexCache(indices, remappedCount);
+
+	// 16 bit indices relative to chunk base vertices, vertices are ordered by first use so chunks are rare
+	auto indexFormat = DXGI_FORMAT_R16_UINT;
+	chunks = SD::ENGINE::SplitIndices(indices);
+	if (chunks.empty())
+	{
+		indexFormat = DXGI_FORMAT_R32_UINT;
+		chunks.push_back({ 0, static_cast<uint32_t>(indices.size()), 0 });
+	}
+
+	meshlets.clear();
+	if (position != attributes.end())
+	{
+		for (const auto& chunk : chunks)
+		{
+			const auto chunkMeshlets = SD::ENGINE::BuildMeshlets(sourceIndices, chunk, position->values.data(), position->components, vertexCount);
+			meshlets.insert(meshlets.end(), chunkMeshlets.begin(), chunkMeshlets.end());
+		}
+	}
+
+	SD::ENGINE::RebaseIndices(indices, chunks);
+
+	auto packed = SD::ENGINE::PackVertices(attributes, vertexCount, settings);
+
+	std::clog << "Optimized " << name << ": ACMR " << before.acmr << " -> " << after.acmr
+		<< ", ATVR " << before.atvr << " -> " << after.atvr << ", " << meshlets.size() << " meshlets";
+	if (indexFormat != sourceFormat)
+	{
+		std::clog << ", 32 -> 16 bit indices in " << chunks.size() << " chunks";
+	}
+	std::clog << ", max direction error " << packed.maxDirectionError << " deg" << std::endl;
+
+	SD::ENGINE::RemapVertices(packed.data, packed.format.stride, remap, remappedCount);
+	packed.format.indexFormat = indexFormat;
+
+	const auto indexData = WriteIndices(indices, indexFormat);
+
+	return pool.Add(packed.format, packed.data.data(), remappedCount, indexData.data(), indices.size());
+}
 }
 
 namespace SD::ENGINE {
@@ -50,6 +712,7 @@ namespace SD::ENGINE {
 World::World(const Space* space)
 	: m_pTimer(std::make_unique<Timer>())
 	, m_space(space)
+	, m_geometryPool(std::make_unique<GeometryPool>())
 {
 }
 
@@ -61,21 +724,58 @@ void World::Create(const std::string& path, const std::string& environment, cons
 {
 	m_transform = transform;
 
-	const auto& model = load(path);
+	// the glTF is parsed and its geometry processed only when there is no up to date cooked scene next to it
+	m_cookedScenePath = std::filesystem::path(path).replace_extension(COOKED_SCENE_EXTENSION);
+	m_cookedSceneSource = GetCookedSceneSource(path, COOKED_SCENE_SETTINGS);
+
+	tinygltf::Model model;
+	if (std::filesystem::exists(m_cookedScenePath))
+	{
+		try
+		{
+			m_pCookedScene = std::make_unique<CookedScene>(m_cookedScenePath);
+			if (m_pCookedScene->IsValid(m_cookedSceneSource))
+			{
+				model = m_pCookedScene->GetModel();
+				std::clog << "Cooked scene mapped: " << m_pCookedScene->GetSize() / 1024 << " KB in " << m_pTimer->GetDelta() << " s." << std::endl;
+			}
+			else
+			{
+				std::clog << "Cooked scene is stale, cook again!" << std::endl;
+				m_pCookedScene = nullptr;
+			}
+		}
+		catch (const SomeException& e)
+		{
+			std::wclog << L"Cooked scene is damaged, cook again: " << e.w_what() << std::endl;
+			m_pCookedScene = nullptr;
+		}
+	}
 
-	createBuffers(model);
-	createTextures(model, std::filesystem::path(path).remove_filename());
+	if (!m_pCookedScene)
+	{
+		model = load(path);
+		std::clog << "glTF loaded: " << m_pTimer->GetDelta() << " s." << std::endl;
+	}
+
+	createTextures(model, path);
 	createSamplers(model);
 	createMaterials(model);
 	createMeshes(model);
 	createLights(model);
 	createNodes(model);
 	createScenes(model);
+	createGeometry(model);
+
+	// GPU buffers are created, the mappings are not needed anymore
+	m_pCookedScene = nullptr;
+	m_pGltfFile = nullptr;
 
 	m_selectedScene = model.defaultScene;
 
 	m_sceneBrowserPanel = std::make_unique<SceneBrowserPanel>();
 	m_nodePropertiesPanel = std::make_unique<NodePropertiesPanel>();
+	m_renderSettingsPanel = std::make_unique<RenderSettingsPanel>();
 
 	m_environment = std::make_unique<Environment>(environment);
 }
@@ -90,6 +790,8 @@ void World::Simulate(float dt)
 
 void World::Update(float dt)
 {
+	updateMaterials();
+
 	for (auto& scene : m_scenes)
 	{
 		scene->Update(dt);
@@ -102,12 +804,7 @@ void World::Draw()
 
 	m_environment->Draw();
 
-	m_environment->BindRadianceMap();
-	m_environment->BindIrradianceMap();
-	m_environment->BindPrefilterMap();
-	m_environment->BindBRDFLUT();
-
-	m_scenes[m_selectedScene]->Draw();
+	submitDraws(m_scenes[m_selectedScene].get());
 }
 
 void World::DrawImGui()
@@ -116,16 +813,19 @@ void World::DrawImGui()
 
 	auto* selectedNode = m_sceneBrowserPanel->selectedNode();
 	m_nodePropertiesPanel->Draw(selectedNode);
+
+	m_renderSettingsPanel->Draw(this);
 }
 
-tinygltf::Model World::load(const std::string& path) const
+tinygltf::Model World::load(const std::string& path)
 {
 	tinygltf::Model model;
-	tinygltf::TinyGLTF loader;
 	std::string error;
 	std::string warning;
 
-	const bool res = loader.LoadASCIIFromFile(&model, &error, &warning, path);
+	// .bin buffers and the GLB binary chunk stay in the mapping, tinygltf parses the JSON only
+	m_pGltfFile = std::make_unique<GltfFile>();
+	const bool res = m_pGltfFile->Load(std::filesystem::path(path), model, error, warning);
 
 	if (!warning.empty())
 	{
@@ -140,139 +840,653 @@ tinygltf::Model World::load(const std::string& path) const
 	if (!res)
 	{
 		std::clog << "Failed to parse glTF" << std::endl;
+		return model;
+	}
+
+	if (const auto& reason = m_pGltfFile->GetFallbackReason(); !reason.empty())
+	{
+		std::clog << "glTF read by tinygltf: " << reason << std::endl;
+	}
+
+	std::clog << "Buffers mapped: " << m_pGltfFile->GetMappedSize() / (1024 * 1024) << " MB." << std::endl;
+
+	Timer timer;
+	if (const size_t decodedBytes = DecodeMeshoptBufferViews(model, *m_pGltfFile); decodedBytes > 0)
+	{
+		const float decodeTime = timer.GetDelta();
+		const auto& features = GetMeshoptDecoderFeatures();
+		std::clog << "Meshopt buffer views decoded: " << decodedBytes / (1024 * 1024) << " MB in " << decodeTime << " s ("
+			<< static_cast<float>(decodedBytes) / decodeTime / 1e9f << " GB/s"
+			<< (features.avx2 ? ", AVX2" : "") << (features.sse41 ? ", SSE4.1" : "") << ")." << std::endl;
+	}
+
+	if (const size_t completedCount = CompletePrimitiveAttributes(model, *m_pGltfFile); completedCount > 0)
+	{
+		std::clog << "Primitives with generated normals, tangents or texture coordinates: " << completedCount
+			<< " in " << timer.GetDelta() << " s." << std::endl;
 	}
 
 	return model;
 }
 
-void World::createBuffers(const tinygltf::Model& model)
+void World::cook(const tinygltf::Model& model) const
+{
+	CookedGeometry geometry;
+	geometry.batches = m_geometryPool->GetBatches();
+
+	// baked primitives remember their nodes, so those can be unbaked after a cooked load too
+	std::unordered_map<const Primitive*, uint32_t> bakedNodes;
+	for (const auto& node : m_nodes)
+	{
+		for (const auto* primitive : node->m_bakedPrimitives)
+		{
+			bakedNodes[primitive] = node->m_id;
+		}
+	}
+
+	const auto addPrimitives = [&bakedNodes](const Mesh& mesh, std::vector<CookedPrimitive>& primitives)
+	{
+		for (const auto& primitive : mesh.m_primitives)
+		{
+			if (!primitive->m_pGeometryPool)
+			{
+				continue;
+			}
+
+			auto& cooked = primitives.emplace_back();
+			cooked.material = primitive->GetMaterialId();
+			cooked.node = bakedNodes.count(primitive.get()) ? bakedNodes.at(primitive.get()) : 0u;
+			cooked.bounds = primitive->m_bounds;
+			cooked.range = primitive->m_geometryRange;
+			cooked.chunks = primitive->m_indexChunks;
+			cooked.meshlets = primitive->m_meshlets;
+		}
+	};
+
+	for (const auto& mesh : m_meshes)
+	{
+		addPrimitives(*mesh, geometry.meshPrimitives.emplace_back());
+	}
+
+	for (const auto& scene : m_scenes)
+	{
+		auto& primitives = geometry.staticPrimitives.emplace_back();
+		auto& bounds = geometry.staticBounds.emplace_back();
+		if (scene->m_staticNode)
+		{
+			addPrimitives(*scene->m_staticNode->m_mesh, primitives);
+			bounds = scene->m_staticBounds;
+		}
+	}
+
+	auto source = m_cookedSceneSource;
+	source.bufferFiles = m_pGltfFile->GetBufferFiles();
+
+	WriteCookedScene(m_cookedScenePath, source, model, *m_pGltfFile, geometry);
+}
+
+void World::createTextures(const tinygltf::Model& model, const std::string& path)
+{
+	std::clog << "Create textures!" << std::endl;
+
+	const auto& app = Application::GetApplication();
+	const auto& jobSystem = app->GetJobSystem();
+	const auto& textureCache = app->GetTextureCache();
+
+	// materials without a map use these, as do streamed textures until their first mips arrive
+	m_pDefaultAlbedoTexture = textureCache->Get(SD_RES_DIR + std::string("textures\\albedo.dds"));
+	m_pDefaultNormalTexture = textureCache->Get(SD_RES_DIR + std::string("textures\\normal.dds"));
+	m_pDefaultMetallicRoughnessTexture = textureCache->Get(SD_RES_DIR + std::string("textures\\metallicRoughness.dds"));
+
+	// what an image is sampled as decides what it is cooked to, cut-outs keep the coverage of their material cutoff
+	std::vector<TextureUsage> usages(model.images.size(), TextureUsage::COLOR);
+	std::vector<float> alphaCutoffs(model.images.size(), DEFAULT_ALPHA_CUTOFF);
+	const auto setUsage = [&](int textureIndex, TextureUsage usage, float alphaCutoff)
+	{
+		if (textureIndex >= 0 && model.textures[textureIndex].source >= 0)
+		{
+			usages[model.textures[textureIndex].source] = usage;
+			alphaCutoffs[model.textures[textureIndex].source] = alphaCutoff;
+		}
+	};
+	for (const auto& material : model.materials)
+	{
+		setUsage(material.normalTexture.index, TextureUsage::NORMAL, DEFAULT_ALPHA_CUTOFF);
+		setUsage(material.pbrMetallicRoughness.metallicRoughnessTexture.index, TextureUsage::MASK, DEFAULT_ALPHA_CUTOFF);
+
+		// every material but blended ones clips albedo alpha, OPAQUE ones at the default cutoff
+		if (material.alphaMode != "BLEND")
+		{
+			setUsage(material.pbrMetallicRoughness.baseColorTexture.index, TextureUsage::CUTOUT, GetAlphaCutoff(material));
+		}
+	}
+
+	// only headers are read here, the streamer loads cooked mips and uploads them while the scene renders, images
+	// embedded in the file are decoded from the mapping at once
+	const auto dir = std::filesystem::path(path).remove_filename();
+	m_textures.resize(model.images.size());
+	jobSystem->ParallelFor(model.images.size(), [&](size_t idx)
+	{
+		const auto& image = model.images[idx];
+		const auto data = m_pCookedScene ? m_pCookedScene->GetImage(static_cast<uint32_t>(idx)) : m_pGltfFile->GetImage(model, static_cast<int>(idx));
+		if (data.data)
+		{
+			m_textures[idx] = textureCache->Get(path + "#image" + std::to_string(idx), data.data, data.size);
+		}
+		else if (image.bufferView >= 0)
+		{
+			THROW_SOME_EXCEPTION(L"IMAGE BUFFER VIEW IS OUT OF BOUNDS!");
+		}
+		else
+		{
+			m_textures[idx] = textureCache->Stream(dir / std::filesystem::u8path(image.uri), usages[idx], alphaCutoffs[idx]);
+		}
+	});
+
+	std::clog << "Textures created: " << m_pTimer->GetDelta() << " s." << std::endl;
+}
+
+void World::createSamplers(const tinygltf::Model& model)
+{
+	std::clog << "Create samplers!" << std::endl;
+
+	const auto& app = Application::GetApplication();
+	const auto& renderSystem = app->GetRenderSystem();
+
+	// shared by materials without a texture
+	m_pDefaultSampler = renderSystem->GetStateLibrary()->GetSampler(RENDER::Sampler::Describe());
+
+#pragma warning(disable:4189)  // local variable is initialized but not referenced
+	for (const auto& sampler : model.samplers)
+	{
+		m_samplers.emplace_back(renderSystem->GetStateLibrary()->GetSampler(RENDER::Sampler::Describe()));
+	}
+#pragma warning(default:4189)
+
+	std::clog << "Samplers created: " << m_pTimer->GetDelta() << " s." << std::endl;
+}
+
+void World::createMaterials(const tinygltf::Model& model)
 {
-	std::clog << "Create buffers!" << std::endl;
+	std::clog << "Create materials!" << std::endl;
+
+	for (const auto& material : model.materials)
+	{
+		const auto id = static_cast<uint32_t>(m_materials.size());
+		const std::string name = material.name.empty() ? "Material " + std::to_string(id) : material.name;
+		m_materials.emplace_back(std::make_shared<Material>(name, id))->Setup(this, model, material);
+	}
+
+	if (!m_materials.empty())
+	{
+		const auto& app = Application::GetApplication();
+		const auto& renderSystem = app->GetRenderSystem();
+
+		std::vector<MaterialParameters> parameters;
+		std::vector<uint32_t> ids;
+		parameters.reserve(m_materials.size());
+		ids.reserve(m_materials.size());
+		for (const auto& material : m_materials)
+		{
+			parameters.push_back(material->m_parameters);
+			ids.push_back(material->GetId());
+		}
 
+		// default usage, edits write single elements
+		m_pMaterialsBuffer = std::make_unique<RENDER::StructuredBuffer<MaterialParameters>>(renderSystem->GetRenderer(), parameters, false);
+
+		// D3D11 has no root constants, the start instance of a draw offsets this stream to the material id instead
+		m_pMaterialIndexBuffer = std::make_unique<RENDER::VertexBuffer>();
+		m_pMaterialIndexBuffer->create(renderSystem->GetRenderer(), ids.data(), ids.size() * sizeof(uint32_t));
+	}
+
+	const auto textureStats = Application::GetApplication()->GetTextureCache()->GetStats();
+	std::clog << "Texture cache: " << textureStats.misses << " created, " << textureStats.pathHits << " path hits, "
+		<< textureStats.contentHits << " content hits." << std::endl;
+
+	std::clog << "Materials created: " << m_pTimer->GetDelta() << " s." << std::endl;
+}
+
+void World::updateMaterials()
+{
 	const auto& app = Application::GetApplication();
 	const auto& renderSystem = app->GetRenderSystem();
 
-	m_buffers.reserve(model.bufferViews.size());
+	for (const auto& material : m_materials)
+	{
+		// streamed albedo textures tell whether they have alpha once they are decoded
+		if (material->m_bucket == DrawBucket::OPAQUE_GEOMETRY && material->m_pAlbedoTexture->HasAlpha())
+		{
+			material->m_bucket = DrawBucket::ALPHA_TEST;
+		}
+
+		if (!material->m_dirty)
+		{
+			continue;
+		}
+
+		m_pMaterialsBuffer->GetData()[material->GetId()] = material->m_parameters;
+		m_pMaterialsBuffer->UpdateElement(renderSystem->GetRenderer(), material->GetId());
+		material->m_dirty = false;
+	}
+}
+
+void World::createMeshes(const tinygltf::Model& model)
+{
+	std::clog << "Create meshes!" << std::endl;
+
+	// meshes referenced by static nodes only are drawn from the baked copies
+	std::vector<bool> dynamicMeshes(model.meshes.size(), false);
+	for (const auto& node : model.nodes)
+	{
+		if (node.mesh >= 0 && !IsStaticNode(node))
+		{
+			dynamicMeshes[node.mesh] = true;
+		}
+	}
+
+	for (const auto& mesh : model.meshes)
+	{
+		const auto id = static_cast<uint32_t>(m_meshes.size());
+		const std::string name = mesh.name.empty() ? "Mesh " + std::to_string(id) : mesh.name;
+		m_meshes.emplace_back(std::make_shared<Mesh>(name, id))->Setup(this, model, mesh, dynamicMeshes[id]);
+	}
+
+	std::clog << "Meshes created: " << m_pTimer->GetDelta() << " s." << std::endl;
+}
+
+void World::createLights(const tinygltf::Model& model)
+{
+	std::clog << "Create lights!" << std::endl;
+
+	for (const auto& light : model.lights)
+	{
+		const auto id = static_cast<uint32_t>(m_nodes.size());
+		const std::string name = light.name.empty() ? "Light " + std::to_string(id) : light.name;
+		m_lights.emplace_back(std::make_shared<Light>(name))->Setup(light);
+	}
+
+	std::clog << "Lights created: " << m_pTimer->GetDelta() << " s." << std::endl;
+}
+
+void World::createNodes(const tinygltf::Model& model)
+{
+	std::clog << "Create nodes!" << std::endl;
+
+	for (const auto& node : model.nodes)
+	{
+		const auto id = static_cast<uint32_t>(m_nodes.size());
+		const std::string name = node.name.empty() ? "Node " + std::to_string(id) : node.name;
+		m_nodes.emplace_back(std::make_shared<Node>(name, id))->Setup(this, node);
+	}
+
+	std::clog << "Nodes created: " << m_pTimer->GetDelta() << " s." << std::endl;
+}
+
+void World::createScenes(const tinygltf::Model& model)
+{
+	std::clog << "Create scenes!" << std::endl;
+
+	for (const auto& scene : model.scenes)
+	{
+		const auto id = static_cast<uint32_t>(m_scenes.size());
+		const std::string name = scene.name.empty() ? "Scene " + std::to_string(id) : scene.name;
+		m_scenes.emplace_back(std::make_shared<Scene>(name, id))->Setup(this, model, scene);
+	}
+
+	std::clog << "Scenes created: " << m_pTimer->GetDelta() << " s." << std::endl;
+}
+
+void World::createGeometry(const tinygltf::Model& model)
+{
+	std::clog << "Create geometry!" << std::endl;
+
+	const auto& app = Application::GetApplication();
+	const auto& renderSystem = app->GetRenderSystem();
+
+	if (m_pCookedScene)
+	{
+		m_pCookedScene->AddGeometry(*m_geometryPool);
+	}
+
+	for (const auto& scene : m_scenes)
+	{
+		scene->BakeStaticGeometry(this, model, *m_geometryPool);
+	}
+
+	// packed batches are still on the CPU until the pool is created
+	if (!m_pCookedScene && !model.scenes.empty())
+	{
+		try
+		{
+			cook(model);
+			std::clog << "Scene cooked: " << m_pTimer->GetDelta() << " s." << std::endl;
+		}
+		catch (const SomeException& e)
+		{
+			std::wclog << L"Failed to cook scene: " << e.w_what() << std::endl;
+		}
+		catch (const std::exception& e)
+		{
+			std::clog << "Failed to cook scene: " << e.what() << std::endl;
+		}
+	}
+
+	m_pDepthVertexShader = renderSystem->GetStateLibrary()->GetVertexShader(L"depth.vs.cso");
+
+	if (!m_geometryPool->IsEmpty())
+	{
+		// all materials share the pbr vertex shader, it reads the material id per instance from slot 1;
+		// taken from the library, a scene without materials still has geometry
+		const auto pVertexShader = renderSystem->GetStateLibrary()->GetVertexShader(L"pbr.vs.cso");
+		const std::vector<RENDER::InputElement> instanceElements = {
+			{ "MATERIAL", 0u, DXGI_FORMAT_R32_UINT, 1u, 0u, true }
+		};
+		m_geometryPool->Create(
+			renderSystem->GetRenderer(),
+			renderSystem->GetStateLibrary(),
+			pVertexShader->GetBytecode(),
+			m_pDepthVertexShader->GetBytecode(),
+			instanceElements);
+	}
+
+	const auto& stats = m_geometryPool->GetStats();
+	std::clog << "Duplicate primitives: " << stats.duplicates << " (" << stats.savedBytes / 1024 << " KB saved)" << std::endl;
+
+	const auto stateStats = renderSystem->GetStateLibrary()->GetStats();
+	std::clog << "State objects: " << stateStats.created << " created, " << stateStats.requests - stateStats.created << " shared." << std::endl;
+
+	std::clog << "Geometry created: " << m_pTimer->GetDelta() << " s." << std::endl;
+}
+
+void World::collectDraws(const Scene* scene)
+{
+	const auto& camera = Application::GetApplication()->GetCamera();
+
+	for (auto& bucket : m_drawBuckets)
+	{
+		bucket.clear();
+	}
+	scene->CollectDraws(camera->getView(), m_drawBuckets);
+
+	// front to back, so early depth test rejects hidden fragments
+	for (const auto bucket : { DrawBucket::OPAQUE_GEOMETRY, DrawBucket::ALPHA_TEST })
+	{
+		auto& items = m_drawBuckets[static_cast<size_t>(bucket)];
+		std::sort(items.begin(), items.end(), [](const DrawItem& a, const DrawItem& b)
+		{
+			return a.key < b.key;
+		});
+	}
+
+	// back to front, required for correct blending
+	sortBlendBucket();
+
+	m_drawItems.clear();
+	for (const auto bucket : { DrawBucket::OPAQUE_GEOMETRY, DrawBucket::ALPHA_TEST })
+	{
+		const auto& items = m_drawBuckets[static_cast<size_t>(bucket)];
+		m_drawItems.insert(m_drawItems.end(), items.begin(), items.end());
+	}
+
+	const auto& blendItems = m_drawBuckets[static_cast<size_t>(DrawBucket::BLEND)];
+	for (const auto idx : m_blendOrder)
+	{
+		m_drawItems.push_back(blendItems[idx]);
+	}
+
+	for (size_t bucket = 0; bucket < m_drawBuckets.size(); ++bucket)
+	{
+		m_submissionStats.bucketItems[bucket] = m_drawBuckets[bucket].size();
+	}
+}
+
+void World::sortBlendBucket()
+{
+	const auto& items = m_drawBuckets[static_cast<size_t>(DrawBucket::BLEND)];
+
+	// items are collected in hierarchy order, so indices stay valid between frames while the scene is the same
+	if (m_blendOrder.size() != items.size())
+	{
+		m_blendOrder.resize(items.size());
+		std::iota(m_blendOrder.begin(), m_blendOrder.end(), 0u);
+	}
+
+	// the previous frame order is almost sorted, insertion sort is close to linear on it and stable
+	size_t shifts = 0;
+	for (size_t i = 1; i < m_blendOrder.size(); ++i)
+	{
+		const uint32_t idx = m_blendOrder[i];
+		const float depth = items[idx].depth;
+
+		size_t j = i;
+		for (; j > 0 && items[m_blendOrder[j - 1]].depth < depth; --j)
+		{
+			m_blendOrder[j] = m_blendOrder[j - 1];
+			shifts++;
+		}
+		m_blendOrder[j] = idx;
+	}
+
+	m_submissionStats.blendSortShifts = shifts;
+}
+
+void World::cullClusters()
+{
+	const auto& app = Application::GetApplication();
+	const auto& camera = app->GetCamera();
+	const auto& jobSystem = app->GetJobSystem();
+
+	const auto view = camera->getView();
+	const DirectX::BoundingFrustum frustum(camera->getProjection());
+
+	const size_t maxThreads = jobSystem->GetWorkersCount() + 1;
+	const size_t threads = m_submissionSettings.recordingThreads > 0
+		? std::min(static_cast<size_t>(m_submissionSettings.recordingThreads), maxThreads)
+		: maxThreads;
+	const size_t chunks = std::max<size_t>(std::min(threads, m_drawItems.size()), 1);
+	const size_t chunkSize = (m_drawItems.size() + chunks - 1) / chunks;
+
+	std::vector<size_t> chunkClusters(chunks, 0);
+	std::vector<size_t> chunkVisible(chunks, 0);
+
+	// ranges of every item are written by a single job only
+	m_drawRanges.resize(m_drawItems.size());
+
+	jobSystem->ParallelFor(chunks, threads, [&](size_t chunk)
+	{
+		const size_t begin = chunk * chunkSize;
+		const size_t end = std::min(begin + chunkSize, m_drawItems.size());
+		for (size_t idx = begin; idx < end; ++idx)
+		{
+			const auto& item = m_drawItems[idx];
+			const auto& meshlets = item.primitive->GetMeshlets();
+
+			auto& ranges = m_drawRanges[idx];
+			ranges.clear();
+
+			if (!m_submissionSettings.clusterCulling || meshlets.empty())
+			{
+				ranges = item.primitive->GetIndexChunks();
+				continue;
+			}
+
+			// whole primitive first, meshlets of fully visible ones skip the frustum test
+			const auto worldView = item.node->GetDrawTransform() * view;
+
+			DirectX::BoundingBox bounds;
+			item.primitive->GetBounds().Transform(bounds, worldView);
+
+			const auto containment = frustum.Contains(bounds);
+			chunkClusters[chunk] += meshlets.size();
+			if (containment == DirectX::DISJOINT)
+			{
+				continue;
+			}
+
+			chunkVisible[chunk] += CullMeshlets(
+				meshlets, worldView, frustum, containment == DirectX::CONTAINS, !item.primitive->IsDoubleSided(), ranges);
+		}
+	});
 
-	for (const auto& bufferView : model.bufferViews)
+	// drop fully culled items, keeping the order
+	size_t count = 0;
+	size_t rangeCount = 0;
+	for (size_t idx = 0; idx < m_drawItems.size(); ++idx)
 	{
-		if (bufferView.target == TINYGLTF_TARGET_ELEMENT_ARRAY_BUFFER)
+		if (m_drawRanges[idx].empty())
 		{
-			m_buffers.emplace_back(std::make_unique<RENDER::IndexBuffer>());
+			continue;
 		}
-		else
+
+		if (count != idx)
 		{
-			m_buffers.emplace_back(std::make_unique<RENDER::VertexBuffer>());
+			m_drawItems[count] = m_drawItems[idx];
+			std::swap(m_drawRanges[count], m_drawRanges[idx]);
 		}
-
-		const auto buffer = model.buffers[bufferView.buffer];
-		m_buffers.back()->create(renderSystem->GetRenderer(), buffer.data.data() + bufferView.byteOffset, bufferView.byteLength);
+		rangeCount += m_drawRanges[count].size();
+		count++;
 	}
+	m_drawItems.resize(count);
+	m_drawRanges.resize(count);
 
-	std::clog << "Buffers created: " << m_pTimer->GetDelta() << " s." << std::endl;
+	m_submissionStats.clusters = std::accumulate(chunkClusters.begin(), chunkClusters.end(), size_t(0));
+	m_submissionStats.visibleClusters = std::accumulate(chunkVisible.begin(), chunkVisible.end(), size_t(0));
+	m_submissionStats.drawRanges = rangeCount;
 }
 
-void World::createTextures(const tinygltf::Model& model, const std::filesystem::path& dir)
+void World::submitDraws(const Scene* scene)
 {
-	std::clog << "Create textures!" << std::endl;
-
 	const auto& app = Application::GetApplication();
 	const auto& renderSystem = app->GetRenderSystem();
+	const auto& jobSystem = app->GetJobSystem();
 
-	for (const auto& image : model.images)
+	Timer timer;
+
+	// collect and sort draw list
 	{
-		const auto path = dir.string() + image.uri;
-		m_textures.emplace_back(std::make_shared<RENDER::Texture>(renderSystem->GetRenderer(), AToWstring(path)));
-	}
+		collectDraws(scene);
 
-	std::clog << "Textures created: " << m_pTimer->GetDelta() << " s." << std::endl;
-}
+		m_submissionStats.collectTime = timer.GetDelta();
+	}
 
-void World::createSamplers(const tinygltf::Model& model)
-{
-	std::clog << "Create samplers!" << std::endl;
+	// cull meshlets of the draw list in parallel
+	{
+		cullClusters();
 
-	const auto& app = Application::GetApplication();
-	const auto& renderSystem = app->GetRenderSystem();
+		m_submissionStats.cullTime = timer.GetDelta();
+	}
 
-#pragma warning(disable:4189)  // local variable is initialized but not referenced
-	for (const auto& sampler : model.samplers)
+	// record chunks of the draw list in parallel, one command list per chunk,
+	// depth prepass lists of the opaque items go first
 	{
-		m_samplers.emplace_back(std::make_shared<RENDER::Sampler>(renderSystem->GetRenderer()));
-	}
-#pragma warning(default:4189)
+		const size_t maxThreads = jobSystem->GetWorkersCount() + 1;
+		const size_t threads = m_submissionSettings.recordingThreads > 0
+			? std::min(static_cast<size_t>(m_submissionSettings.recordingThreads), maxThreads)
+			: maxThreads;
+		const size_t chunks = std::max<size_t>(std::min(threads, m_drawItems.size()), 1);
+		const size_t chunkSize = (m_drawItems.size() + chunks - 1) / chunks;
+
+		// opaque items lead the draw list
+		const bool depthPrepass = m_submissionSettings.depthPrepass;
+		const size_t prepassItems = !depthPrepass ? 0 : static_cast<size_t>(std::count_if(m_drawItems.begin(), m_drawItems.end(), [](const DrawItem& item)
+		{
+			return item.primitive->GetBucket() == DrawBucket::OPAQUE_GEOMETRY;
+		}));
+		const size_t prepassChunks = std::min(threads, prepassItems);
+		const size_t prepassChunkSize = prepassChunks > 0 ? (prepassItems + prepassChunks - 1) / prepassChunks : 0;
 
-	std::clog << "Samplers created: " << m_pTimer->GetDelta() << " s." << std::endl;
-}
+		m_commandLists.resize(prepassChunks + chunks);
 
-void World::createMaterials(const tinygltf::Model& model)
-{
-	std::clog << "Create materials!" << std::endl;
+		jobSystem->ParallelFor(prepassChunks + chunks, threads, [&](size_t list)
+		{
+			auto& commandList = m_commandLists[list];
+			commandList.Reset();
 
-	for (const auto& material : model.materials)
-	{
-		const auto id = static_cast<uint32_t>(m_materials.size());
-		const std::string name = material.name.empty() ? "Material " + std::to_string(id) : material.name;
-		m_materials.emplace_back(std::make_shared<Material>(name, id))->Setup(this, model, material);
-	}
+			// every list starts from a clean state
+			renderSystem->GetFrameBuffer()->bind(commandList);
+			commandList.SetPrimitiveTopology(RENDER::PrimitiveTopology::TRIANGLE_LIST);
 
-	std::clog << "Materials created: " << m_pTimer->GetDelta() << " s." << std::endl;
-}
+			const Node* boundNode = nullptr;
 
-void World::createMeshes(const tinygltf::Model& model)
-{
-	std::clog << "Create meshes!" << std::endl;
+			if (list < prepassChunks)
+			{
+				// positions only, deferred contexts start without a pixel shader
+				m_pDepthVertexShader->Bind(commandList);
 
-	for (const auto& mesh : model.meshes)
-	{
-		const auto id = static_cast<uint32_t>(m_meshes.size());
-		const std::string name = mesh.name.empty() ? "Mesh " + std::to_string(id) : mesh.name;
-		m_meshes.emplace_back(std::make_shared<Mesh>(name, id))->Setup(this, model, mesh);
-	}
+				const size_t begin = list * prepassChunkSize;
+				const size_t end = std::min(begin + prepassChunkSize, prepassItems);
+				for (size_t idx = begin; idx < end; ++idx)
+				{
+					const auto& item = m_drawItems[idx];
 
-	std::clog << "Meshes created: " << m_pTimer->GetDelta() << " s." << std::endl;
-}
+					if (item.node != boundNode)
+					{
+						item.node->Bind(commandList);
+						boundNode = item.node;
+					}
 
-void World::createLights(const tinygltf::Model& model)
-{
-	std::clog << "Create lights!" << std::endl;
+					item.primitive->DrawDepth(commandList, m_drawRanges[idx]);
+				}
 
-	for (const auto& light : model.lights)
-	{
-		const auto id = static_cast<uint32_t>(m_nodes.size());
-		const std::string name = light.name.empty() ? "Light " + std::to_string(id) : light.name;
-		m_lights.emplace_back(std::make_shared<Light>(name))->Setup(light);
-	}
+				return;
+			}
 
-	std::clog << "Lights created: " << m_pTimer->GetDelta() << " s." << std::endl;
-}
+			m_environment->Bind(commandList);
+			scene->Bind(commandList);
 
-void World::createNodes(const tinygltf::Model& model)
-{
-	std::clog << "Create nodes!" << std::endl;
+			// material parameters are bound once, material switches only rebind textures and states
+			m_pMaterialsBuffer->PSBind(commandList, 8u);
+			m_pMaterialIndexBuffer->Bind(commandList, 1u, sizeof(uint32_t), 0u);
 
-	for (const auto& node : model.nodes)
-	{
-		const auto id = static_cast<uint32_t>(m_nodes.size());
-		const std::string name = node.name.empty() ? "Node " + std::to_string(id) : node.name;
-		m_nodes.emplace_back(std::make_shared<Node>(name, id))->Setup(this, node);
-	}
+			auto depthMode = RENDER::DepthMode::ENABLED;
 
-	std::clog << "Nodes created: " << m_pTimer->GetDelta() << " s." << std::endl;
-}
+			const size_t begin = (list - prepassChunks) * chunkSize;
+			const size_t end = std::min(begin + chunkSize, m_drawItems.size());
+			for (size_t idx = begin; idx < end; ++idx)
+			{
+				const auto& item = m_drawItems[idx];
 
-void World::createScenes(const tinygltf::Model& model)
-{
-	std::clog << "Create scenes!" << std::endl;
+				if (const auto itemDepthMode = BucketDepthMode(item.primitive->GetBucket(), depthPrepass); itemDepthMode != depthMode)
+				{
+					renderSystem->GetFrameBuffer()->bindDepth(commandList, itemDepthMode);
+					depthMode = itemDepthMode;
+				}
 
-	for (const auto& scene : model.scenes)
-	{
-		const auto id = static_cast<uint32_t>(m_scenes.size());
-		const std::string name = scene.name.empty() ? "Scene " + std::to_string(id) : scene.name;
-		m_scenes.emplace_back(std::make_shared<Scene>(name, id))->Setup(this, model, scene);
+				if (item.node != boundNode)
+				{
+					item.node->Bind(commandList);
+					boundNode = item.node;
+				}
+
+				item.primitive->Draw(commandList, m_drawRanges[idx]);
+			}
+		});
+
+		m_submissionStats.prepassItems = prepassItems;
+		m_submissionStats.prepassCommandLists = prepassChunks;
+		m_submissionStats.recordTime = timer.GetDelta();
 	}
 
-	std::clog << "Scenes created: " << m_pTimer->GetDelta() << " s." << std::endl;
+	// playback
+	{
+		if (m_submissionSettings.gpuPlayback)
+		{
+			renderSystem->GetRenderer()->ExecuteCommandLists(m_commandLists, *jobSystem);
+		}
+
+		m_submissionStats.drawItems = m_drawItems.size();
+		m_submissionStats.commandLists = m_commandLists.size();
+		m_submissionStats.prepassCommands = {};
+		m_submissionStats.commands = {};
+		for (size_t idx = 0; idx < m_commandLists.size(); ++idx)
+		{
+			auto& commands = idx < m_submissionStats.prepassCommandLists ? m_submissionStats.prepassCommands : m_submissionStats.commands;
+			commands += m_commandLists[idx].GetStats();
+		}
+
+		m_submissionStats.playbackTime = timer.GetDelta();
+	}
 }
 
 World::Scene::Scene(const std::string& name, const uint32_t id)
@@ -306,6 +1520,131 @@ void World::Scene::Setup(const World* world, const tinygltf::Model& model, const
 	m_pPointLightsConstants = std::make_unique<RENDER::ConstantBuffer<PointLights>>(renderSystem->GetRenderer(), lightsConstants);
 }
 
+void World::Scene::BakeStaticGeometry(const World* world, const tinygltf::Model& model, GeometryPool& pool)
+{
+	// world transforms to bake
+	m_root->Simulate(0.0f);
+
+	// cooked positions are quantized to the bounds they were baked with, not to ones derived from the cooked model
+	bool empty = true;
+	VertexPackingSettings settings;
+	if (world->m_pCookedScene)
+	{
+		empty = !world->m_pCookedScene->GetStaticBounds(m_id, settings.positionBounds);
+	}
+	else
+	{
+		getStaticBounds(m_root.get(), settings.positionBounds, empty);
+	}
+
+	if (empty)
+	{
+		return;
+	}
+	m_staticBounds = settings.positionBounds;
+	settings.quantizePositions = QUANTIZE_STATIC_POSITIONS;
+	settings.directionEncoding = DIRECTION_ENCODING;
+
+	constexpr auto id = std::numeric_limits<uint32_t>::max() - 1;
+	const std::string name = "static";
+	m_staticNode = std::make_shared<Node>(name, id);
+	m_staticNode->Setup(world, tinygltf::Node());
+	m_staticNode->m_static = false;  // already in world space, drawn with identity transform
+	m_staticNode->m_mesh = std::make_shared<Mesh>("Static Geometry", id);
+
+	if (settings.quantizePositions)
+	{
+		GetPositionDequantization(settings.positionBounds, m_staticNode->m_positionScale, m_staticNode->m_positionOffset);
+	}
+
+	if (world->m_pCookedScene)
+	{
+		for (auto& cooked : world->m_pCookedScene->GetStaticPrimitives(m_id))
+		{
+			const auto& primitive = m_staticNode->m_mesh->m_primitives.emplace_back(std::make_unique<Primitive>(
+				world->m_materials[cooked.material], cooked.bounds, &pool, cooked.range, std::move(cooked.chunks), std::move(cooked.meshlets)));
+
+			if (cooked.node < world->m_nodes.size())
+			{
+				const auto& node = world->m_nodes[cooked.node];
+				node->m_bakedInto = m_staticNode;
+				node->m_bakedInverse = DirectX::XMMatrixInverse(nullptr, node->m_worldTransform);
+				node->m_bakedPrimitives.push_back(primitive.get());
+			}
+		}
+		return;
+	}
+
+	bakeNode(model, *world->m_pGltfFile, m_root.get(), settings, pool, *m_staticNode->m_mesh);
+}
+
+void World::Scene::getStaticBounds(const Node* node, DirectX::BoundingBox& bounds, bool& empty) const
+{
+	if (node->m_mesh && node->m_static)
+	{
+		for (const auto& primitive : node->m_mesh->m_primitives)
+		{
+			DirectX::BoundingBox primitiveBounds;
+			primitive->m_bounds.Transform(primitiveBounds, node->m_worldTransform);
+
+			if (empty)
+			{
+				bounds = primitiveBounds;
+				empty = false;
+			}
+			else
+			{
+				DirectX::BoundingBox::CreateMerged(bounds, bounds, primitiveBounds);
+			}
+		}
+	}
+
+	for (const auto& child : node->m_children)
+	{
+		getStaticBounds(child.get(), bounds, empty);
+	}
+}
+
+void World::Scene::bakeNode(
+	const tinygltf::Model& model,
+	const GltfFile& file,
+	Node* node,
+	const VertexPackingSettings& settings,
+	GeometryPool& pool,
+	Mesh& staticMesh) const
+{
+	if (node->m_mesh && node->m_static)
+	{
+		const auto& mesh = model.meshes[node->m_mesh->m_id];
+		const auto& transform = node->m_worldTransform;
+
+		node->m_bakedInto = m_staticNode;
+		node->m_bakedInverse = DirectX::XMMatrixInverse(nullptr, transform);
+
+		for (size_t primitiveIdx = 0; primitiveIdx < mesh.primitives.size(); ++primitiveIdx)
+		{
+			const auto& source = node->m_mesh->m_primitives[primitiveIdx];
+
+			const std::string name = node->m_name + " #" + std::to_string(primitiveIdx);
+			std::vector<IndexRange> chunks;
+			std::vector<Meshlet> meshlets;
+			const auto range = AddPrimitiveGeometry(name, model, file, mesh.primitives[primitiveIdx], &transform, settings, pool, chunks, meshlets);
+
+			DirectX::BoundingBox bounds;
+			source->m_bounds.Transform(bounds, transform);
+
+			const auto& primitive = staticMesh.m_primitives.emplace_back(
+				std::make_unique<Primitive>(source->m_material, bounds, &pool, range, std::move(chunks), std::move(meshlets)));
+			node->m_bakedPrimitives.push_back(primitive.get());
+		}
+	}
+
+	for (const auto& child : node->m_children)
+	{
+		bakeNode(model, file, child.get(), settings, pool, staticMesh);
+	}
+}
+
 void World::Scene::buildHierarchy(
 	const World* world,
 	const tinygltf::Model& model,
@@ -341,24 +1680,39 @@ const std::vector<std::shared_ptr<World::Node>> World::Scene::getChildren(
 void World::Scene::Simulate(float dt)
 {
 	m_root->Simulate(dt);
+
+	if (m_staticNode)
+	{
+		m_staticNode->Simulate(dt);
+	}
 }
 
 void World::Scene::Update(float dt)
 {
 	m_root->Update(dt);
 
+	if (m_staticNode)
+	{
+		m_staticNode->Update(dt);
+	}
+
 	updateLights();
 }
 
-void World::Scene::Draw()
+void World::Scene::CollectDraws(const DirectX::XMMATRIX& view, DrawBuckets& buckets) const
 {
-	const auto& app = Application::GetApplication();
-	const auto& renderSystem = app->GetRenderSystem();
+	m_root->CollectDraws(view, buckets);
 
-	m_pPointLightsBuffer->PSBind(renderSystem->GetRenderer(), 3);
-	m_pPointLightsConstants->PSBind(renderSystem->GetRenderer(), 2);
+	if (m_staticNode)
+	{
+		m_staticNode->CollectDraws(view, buckets);
+	}
+}
 
-	m_root->Draw();
+void World::Scene::Bind(RENDER::CommandList& commandList) const
+{
+	m_pPointLightsBuffer->PSBind(commandList, 3);
+	m_pPointLightsConstants->PSBind(commandList, 2);
 }
 
 void World::Scene::updateLights()
@@ -385,30 +1739,32 @@ World::Environment::Environment(const std::string& name)
 
 	m_environment = std::make_unique<RENDER::Texture>(renderSystem->GetRenderer(), AToWstring(name));
 
-	m_radianceMap = std::make_unique<RENDER::CubeFrameBuffer>(renderSystem->GetRenderer(), 1024.0f);
-	m_irradianceMap = std::make_unique<RENDER::CubeFrameBuffer>(renderSystem->GetRenderer(), 128.0f);
-	m_prefilterMap = std::make_unique<RENDER::CubeFrameBuffer>(renderSystem->GetRenderer(), 256.0f, static_cast<uint8_t>(8));
-	m_brdfLUT = std::make_unique<RENDER::FrameBuffer>(renderSystem->GetRenderer(), 512.0f, 512.0f, DXGI_FORMAT_R16G16_FLOAT);
+	const auto& stateLibrary = renderSystem->GetStateLibrary();
+
+	m_radianceMap = std::make_unique<RENDER::CubeFrameBuffer>(renderSystem->GetRenderer(), stateLibrary, 1024.0f);
+	m_irradianceMap = std::make_unique<RENDER::CubeFrameBuffer>(renderSystem->GetRenderer(), stateLibrary, 128.0f);
+	m_prefilterMap = std::make_unique<RENDER::CubeFrameBuffer>(renderSystem->GetRenderer(), stateLibrary, 256.0f, static_cast<uint8_t>(8));
+	m_brdfLUT = std::make_unique<RENDER::FrameBuffer>(renderSystem->GetRenderer(), stateLibrary, 512.0f, 512.0f, DXGI_FORMAT_R16G16_FLOAT);
 
-	m_pCubemapVertexShader = std::make_unique<SD::RENDER::VertexShader>(renderSystem->GetRenderer(), L"cubemap.vs.cso");
-	m_pEquirectangularToCubemapPixelShader = std::make_unique<SD::RENDER::PixelShader>(renderSystem->GetRenderer(), L"equirectangular_to_cubemap.ps.cso");
-	m_pIrradianceConvolutionPixelShader = std::make_unique<SD::RENDER::PixelShader>(renderSystem->GetRenderer(), L"irradiance_convolution.ps.cso");
+	m_pCubemapVertexShader = stateLibrary->GetVertexShader(L"cubemap.vs.cso");
+	m_pEquirectangularToCubemapPixelShader = stateLibrary->GetPixelShader(L"equirectangular_to_cubemap.ps.cso");
+	m_pIrradianceConvolutionPixelShader = stateLibrary->GetPixelShader(L"irradiance_convolution.ps.cso");
 
-	m_pPrefilterVertexShader = std::make_unique<SD::RENDER::VertexShader>(renderSystem->GetRenderer(), L"prefilter.vs.cso");
-	m_pPrefilterPixelShader = std::make_unique<SD::RENDER::PixelShader>(renderSystem->GetRenderer(), L"prefilter.ps.cso");
+	m_pPrefilterVertexShader = stateLibrary->GetVertexShader(L"prefilter.vs.cso");
+	m_pPrefilterPixelShader = stateLibrary->GetPixelShader(L"prefilter.ps.cso");
 
-	m_pBackgroundVertexShader = std::make_unique<SD::RENDER::VertexShader>(renderSystem->GetRenderer(), L"background.vs.cso");
-	m_pBackgroundPixelShader = std::make_unique<SD::RENDER::PixelShader>(renderSystem->GetRenderer(), L"background.ps.cso");
+	m_pBackgroundVertexShader = stateLibrary->GetVertexShader(L"background.vs.cso");
+	m_pBackgroundPixelShader = stateLibrary->GetPixelShader(L"background.ps.cso");
 
-	m_pConvolveBRDFVertexShader = std::make_unique<SD::RENDER::VertexShader>(renderSystem->GetRenderer(), L"brdf.vs.cso");
-	m_pConvolveBRDFPixelShader = std::make_unique<SD::RENDER::PixelShader>(renderSystem->GetRenderer(), L"brdf.ps.cso");
+	m_pConvolveBRDFVertexShader = stateLibrary->GetVertexShader(L"brdf.vs.cso");
+	m_pConvolveBRDFPixelShader = stateLibrary->GetPixelShader(L"brdf.ps.cso");
 
-	m_environmentSampler = std::make_shared<RENDER::Sampler>(renderSystem->GetRenderer());
-	m_brdfSampler = std::make_shared<RENDER::Sampler>(renderSystem->GetRenderer(), false);
+	m_environmentSampler = stateLibrary->GetSampler(RENDER::Sampler::Describe());
+	m_brdfSampler = stateLibrary->GetSampler(RENDER::Sampler::Describe(false));
 
-	m_pRasterizer = std::make_unique<RENDER::Rasterizer>(renderSystem->GetRenderer(), false);
+	m_pRasterizer = stateLibrary->GetRasterizer(RENDER::Rasterizer::Describe(false));
 
-	m_pBlender = std::make_unique<SD::RENDER::Blender>(renderSystem->GetRenderer(), false);
+	m_pBlender = stateLibrary->GetBlender(RENDER::Blender::Describe(false));
 
 	const std::vector<float> verticesCube =
 	{
@@ -442,17 +1798,14 @@ World::Environment::Environment(const std::string& name)
 		sizeof(decltype(indicesCube)::value_type) * indicesCube.size()
 	);
 
-	std::vector<D3D11_INPUT_ELEMENT_DESC> inputLayoutDescCube;
+	std::vector<RENDER::InputElement> inputLayoutDescCube;
 	inputLayoutDescCube.push_back(
 		{ "position", 0u,
-		DXGI_FORMAT_R32G32B32_FLOAT, 0u,D3D11_APPEND_ALIGNED_ELEMENT,
-			D3D11_INPUT_PER_VERTEX_DATA, 0 }
+		DXGI_FORMAT_R32G32B32_FLOAT, 0u, RENDER::APPEND_ALIGNED }
 	);
 
 	// create input (vertex) layout
-	m_pInputLayoutCube = std::make_unique<SD::RENDER::InputLayout>(
-		renderSystem->GetRenderer(), inputLayoutDescCube, m_pCubemapVertexShader->GetBytecode()
-	);
+	m_pInputLayoutCube = stateLibrary->GetInputLayout(inputLayoutDescCube, m_pCubemapVertexShader->GetBytecode());
 
 	const std::vector<float> verticesQuad =
 	{
@@ -478,22 +1831,18 @@ World::Environment::Environment(const std::string& name)
 		sizeof(decltype(indicesQuad)::value_type) * indicesQuad.size()
 	);
 
-	std::vector<D3D11_INPUT_ELEMENT_DESC> inputLayoutDescQuad;
+	std::vector<RENDER::InputElement> inputLayoutDescQuad;
 	inputLayoutDescQuad.push_back(
 		{ "position", 0u,
-		DXGI_FORMAT_R32G32B32_FLOAT, 0u,D3D11_APPEND_ALIGNED_ELEMENT,
-			D3D11_INPUT_PER_VERTEX_DATA, 0 }
+		DXGI_FORMAT_R32G32B32_FLOAT, 0u, RENDER::APPEND_ALIGNED }
 	);
 	inputLayoutDescQuad.push_back(
 		{ "texcoord", 0u,
-		DXGI_FORMAT_R32G32_FLOAT, 0u,D3D11_APPEND_ALIGNED_ELEMENT,
-			D3D11_INPUT_PER_VERTEX_DATA, 0 }
+		DXGI_FORMAT_R32G32_FLOAT, 0u, RENDER::APPEND_ALIGNED }
 	);
 
 	// create input (vertex) layout
-	m_pInputLayoutQuad = std::make_unique<SD::RENDER::InputLayout>(
-		renderSystem->GetRenderer(), inputLayoutDescQuad, m_pConvolveBRDFVertexShader->GetBytecode()
-	);
+	m_pInputLayoutQuad = stateLibrary->GetInputLayout(inputLayoutDescQuad, m_pConvolveBRDFVertexShader->GetBytecode());
 
 	CB_transform1 transformCB1;
 	m_transformCB1 = std::make_unique<SD::RENDER::ConstantBuffer<CB_transform1>>(renderSystem->GetRenderer(), transformCB1);
@@ -517,8 +1866,6 @@ void World::Environment::Draw()
 	const auto& renderSystem = app->GetRenderSystem();
 	const auto& renderer = renderSystem->GetRenderer();
 
-	D3D_DEBUG_LAYER(renderer);
-
 	// bind shaders
 	m_pBackgroundVertexShader->Bind(renderer);
 	m_pBackgroundPixelShader->Bind(renderer);
@@ -533,7 +1880,7 @@ void World::Environment::Draw()
 	m_transformCB2->Update(renderSystem->GetRenderer());
 
 	// bind textures
-	D3D_THROW_IF_INFO(renderer->GetContext()->PSSetShaderResources(0u, 1u, m_radianceMap->getSRV().GetAddressOf()));
+	renderer->SetShaderResource(RENDER::ShaderStage::PIXEL, 0u, m_radianceMap->getSRV());
 
 	// bind texture samplers
 	m_environmentSampler->Bind(renderer, 0u);
@@ -553,14 +1900,12 @@ void World::Environment::Draw()
 	// bind vertex layout
 	m_pInputLayoutCube->Bind(renderer);
 
-	const auto& context = renderer->GetContext();
-
 	const auto* framebuffer = renderSystem->GetFrameBuffer();
 	framebuffer->bind(renderer, false);
 
-	D3D_THROW_IF_INFO(context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST));
+	renderer->SetPrimitiveTopology(RENDER::PrimitiveTopology::TRIANGLE_LIST);
 
-	D3D_THROW_IF_INFO(context->DrawIndexed(36u, 0u, 0u));
+	renderer->DrawIndexed(36u, 0u, 0);
 
 	framebuffer->bind(renderer, true);
 }
@@ -571,9 +1916,7 @@ void World::Environment::BindRadianceMap() const
 	const auto& renderSystem = app->GetRenderSystem();
 	const auto& renderer = renderSystem->GetRenderer();
 
-	D3D_DEBUG_LAYER(renderer);
-
-	D3D_THROW_IF_INFO(renderer->GetContext()->PSSetShaderResources(4u, 1u, m_radianceMap->getSRV().GetAddressOf()));
+	renderer->SetShaderResource(RENDER::ShaderStage::PIXEL, 4u, m_radianceMap->getSRV());
 
 	m_environmentSampler->Bind(renderer, 3u);
 }
@@ -584,9 +1927,7 @@ void World::Environment::BindIrradianceMap() const
 	const auto& renderSystem = app->GetRenderSystem();
 	const auto& renderer = renderSystem->GetRenderer();
 
-	D3D_DEBUG_LAYER(renderer);
-
-	D3D_THROW_IF_INFO(renderer->GetContext()->PSSetShaderResources(5u, 1u, m_irradianceMap->getSRV().GetAddressOf()));
+	renderer->SetShaderResource(RENDER::ShaderStage::PIXEL, 5u, m_irradianceMap->getSRV());
 }
 
 void World::Environment::BindPrefilterMap() const
@@ -595,9 +1936,7 @@ void World::Environment::BindPrefilterMap() const
 	const auto& renderSystem = app->GetRenderSystem();
 	const auto& renderer = renderSystem->GetRenderer();
 
-	D3D_DEBUG_LAYER(renderer);
-
-	D3D_THROW_IF_INFO(renderer->GetContext()->PSSetShaderResources(6u, 1u, m_prefilterMap->getSRV().GetAddressOf()));
+	renderer->SetShaderResource(RENDER::ShaderStage::PIXEL, 6u, m_prefilterMap->getSRV());
 }
 
 void World::Environment::BindBRDFLUT() const
@@ -606,21 +1945,28 @@ void World::Environment::BindBRDFLUT() const
 	const auto& renderSystem = app->GetRenderSystem();
 	const auto& renderer = renderSystem->GetRenderer();
 
-	D3D_DEBUG_LAYER(renderer);
-
-	D3D_THROW_IF_INFO(renderer->GetContext()->PSSetShaderResources(7u, 1u, m_brdfLUT->getSRV().GetAddressOf()));
+	renderer->SetShaderResource(RENDER::ShaderStage::PIXEL, 7u, m_brdfLUT->getSRV());
 
 	m_brdfSampler->Bind(renderer, 4u);
 }
 
+void World::Environment::Bind(RENDER::CommandList& commandList) const
+{
+	commandList.SetShaderResource(RENDER::ShaderStage::PIXEL, 4u, m_radianceMap->getSRV());
+	commandList.SetShaderResource(RENDER::ShaderStage::PIXEL, 5u, m_irradianceMap->getSRV());
+	commandList.SetShaderResource(RENDER::ShaderStage::PIXEL, 6u, m_prefilterMap->getSRV());
+	commandList.SetShaderResource(RENDER::ShaderStage::PIXEL, 7u, m_brdfLUT->getSRV());
+
+	m_environmentSampler->Bind(commandList, 3u);
+	m_brdfSampler->Bind(commandList, 4u);
+}
+
 void World::Environment::CreateRadianceMap()
 {
 	const auto& app = Application::GetApplication();
 	const auto& renderSystem = app->GetRenderSystem();
 	const auto& renderer = renderSystem->GetRenderer();
 
-	D3D_DEBUG_LAYER(renderer);
-
 	// Begin
 	{
 		m_radianceMap->bind(renderer);  // ???
@@ -628,21 +1974,17 @@ void World::Environment::CreateRadianceMap()
 		const float color[] = { 0.0f, 0.0f, 0.0f, 1.0f };
 		for (uint8_t face = 0; face < 6; ++face)
 		{
-			D3D_THROW_IF_INFO(renderer->GetContext()->ClearRenderTargetView(m_radianceMap->getRTV(face).Get(), color));
+			renderer->ClearRenderTarget(m_radianceMap->getRTV(face), color);
 		}
 	}
 
 	// Draw
 	{
 		// configure viewport
-		D3D11_VIEWPORT vp;
-		vp.Width = static_cast<float>(m_radianceMap->size());
-		vp.Height = static_cast<float>(m_radianceMap->size());
-		vp.MinDepth = 0;
-		vp.MaxDepth = 1;
-		vp.TopLeftX = 0;
-		vp.TopLeftY = 0;
-		D3D_THROW_IF_INFO(renderer->GetContext()->RSSetViewports(1u, &vp));
+		RENDER::Viewport vp;
+		vp.width = static_cast<float>(m_radianceMap->size());
+		vp.height = static_cast<float>(m_radianceMap->size());
+		renderer->SetViewport(vp);
 
 		// bind shaders
 		m_pCubemapVertexShader->Bind(renderer);
@@ -672,9 +2014,7 @@ void World::Environment::CreateRadianceMap()
 		// bind vertex layout
 		m_pInputLayoutCube->Bind(renderer);
 
-		const auto& context = renderer->GetContext();
-
-		D3D_THROW_IF_INFO(context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST));
+		renderer->SetPrimitiveTopology(RENDER::PrimitiveTopology::TRIANGLE_LIST);
 
 
 		const DirectX::XMMATRIX views[] = {
@@ -706,24 +2046,23 @@ void World::Environment::CreateRadianceMap()
 
 		for (uint8_t face = 0; face < 6; ++face)
 		{
-			D3D_THROW_IF_INFO(renderer->GetContext()->OMSetRenderTargets(1u, m_radianceMap->getRTV(face).GetAddressOf(), nullptr));
+			renderer->SetRenderTarget(m_radianceMap->getRTV(face), nullptr);
 
 			const auto& transformCB = m_transformCB1->GetData();
 			transformCB->view = views[face];
 			m_transformCB1->Update(renderSystem->GetRenderer());
 
-			D3D_THROW_IF_INFO(context->DrawIndexed(36u, 0u, 0u));
+			renderer->DrawIndexed(36u, 0u, 0);
 		}
 	}
 
 	// End
 	{
 		// Unbind SRV
-		ID3D11ShaderResourceView* nullSRV = nullptr;
-		D3D_THROW_IF_INFO(renderer->GetContext()->PSSetShaderResources(0u, 1u, &nullSRV));
+		renderer->SetShaderResource(RENDER::ShaderStage::PIXEL, 0u, nullptr);
 
 		// Reset RenderTarget
-		D3D_THROW_IF_INFO(renderer->GetContext()->OMSetRenderTargets(0, nullptr, nullptr));
+		renderer->SetRenderTarget(nullptr, nullptr);
 	}
 }
 
@@ -733,8 +2072,6 @@ void World::Environment::ConvolveIrradianceMap()
 	const auto& renderSystem = app->GetRenderSystem();
 	const auto& renderer = renderSystem->GetRenderer();
 
-	D3D_DEBUG_LAYER(renderer);
-
 	// Begin
 	{
 		m_irradianceMap->bind(renderer);  // ???
@@ -742,21 +2079,17 @@ void World::Environment::ConvolveIrradianceMap()
 		const float color[] = { 0.0f, 0.0f, 0.0f, 1.0f };
 		for (uint8_t face = 0; face < 6; ++face)
 		{
-			D3D_THROW_IF_INFO(renderer->GetContext()->ClearRenderTargetView(m_irradianceMap->getRTV(face).Get(), color));
+			renderer->ClearRenderTarget(m_irradianceMap->getRTV(face), color);
 		}
 	}
 
 	// Draw
 	{
 		// configure viewport
-		D3D11_VIEWPORT vp;
-		vp.Width = static_cast<float>(m_irradianceMap->size());
-		vp.Height = static_cast<float>(m_irradianceMap->size());
-		vp.MinDepth = 0;
-		vp.MaxDepth = 1;
-		vp.TopLeftX = 0;
-		vp.TopLeftY = 0;
-		D3D_THROW_IF_INFO(renderer->GetContext()->RSSetViewports(1u, &vp));
+		RENDER::Viewport vp;
+		vp.width = static_cast<float>(m_irradianceMap->size());
+		vp.height = static_cast<float>(m_irradianceMap->size());
+		renderer->SetViewport(vp);
 
 		// bind shaders
 		m_pCubemapVertexShader->Bind(renderer);
@@ -766,7 +2099,7 @@ void World::Environment::ConvolveIrradianceMap()
 		m_transformCB1->VSBind(renderer, 0u);
 
 		// bind textures
-		D3D_THROW_IF_INFO(renderer->GetContext()->PSSetShaderResources(0u, 1u, m_radianceMap->getSRV().GetAddressOf()));
+		renderer->SetShaderResource(RENDER::ShaderStage::PIXEL, 0u, m_radianceMap->getSRV());
 
 		// bind texture samplers
 		m_environmentSampler->Bind(renderer, 0u);
@@ -786,9 +2119,7 @@ void World::Environment::ConvolveIrradianceMap()
 		// bind vertex layout
 		m_pInputLayoutCube->Bind(renderer);
 
-		const auto& context = renderer->GetContext();
-
-		D3D_THROW_IF_INFO(context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST));
+		renderer->SetPrimitiveTopology(RENDER::PrimitiveTopology::TRIANGLE_LIST);
 
 
 		const DirectX::XMMATRIX views[] = {
@@ -820,24 +2151,23 @@ void World::Environment::ConvolveIrradianceMap()
 
 		for (uint8_t face = 0; face < 6; ++face)
 		{
-			D3D_THROW_IF_INFO(renderer->GetContext()->OMSetRenderTargets(1u, m_irradianceMap->getRTV(face).GetAddressOf(), nullptr));
+			renderer->SetRenderTarget(m_irradianceMap->getRTV(face), nullptr);
 
 			const auto& transformCB = m_transformCB1->GetData();
 			transformCB->view = views[face];
 			m_transformCB1->Update(renderSystem->GetRenderer());
 
-			D3D_THROW_IF_INFO(context->DrawIndexed(36u, 0u, 0u));
+			renderer->DrawIndexed(36u, 0u, 0);
 		}
 	}
 
 	// End
 	{
 		// Unbind SRV
-		ID3D11ShaderResourceView* nullSRV = nullptr;
-		D3D_THROW_IF_INFO(renderer->GetContext()->PSSetShaderResources(0u, 1u, &nullSRV));
+		renderer->SetShaderResource(RENDER::ShaderStage::PIXEL, 0u, nullptr);
 
 		// Reset RenderTarget
-		D3D_THROW_IF_INFO(renderer->GetContext()->OMSetRenderTargets(0, nullptr, nullptr));
+		renderer->SetRenderTarget(nullptr, nullptr);
 	}
 }
 
@@ -847,8 +2177,6 @@ void World::Environment::CreatePrefilterMap()
 	const auto& renderSystem = app->GetRenderSystem();
 	const auto& renderer = renderSystem->GetRenderer();
 
-	D3D_DEBUG_LAYER(renderer);
-
 	// Begin
 	{
 		m_prefilterMap->bind(renderer);  // ???
@@ -858,7 +2186,7 @@ void World::Environment::CreatePrefilterMap()
 		{
 			for (uint8_t mip = 0; mip < 8; ++mip)
 			{
-				D3D_THROW_IF_INFO(renderer->GetContext()->ClearRenderTargetView(m_prefilterMap->getRTV(face).Get(), color));
+				renderer->ClearRenderTarget(m_prefilterMap->getRTV(face), color);
 			}
 		}
 	}
@@ -874,7 +2202,7 @@ void World::Environment::CreatePrefilterMap()
 		m_constantsCB->PSBind(renderer, 0u);
 
 		// bind textures
-		D3D_THROW_IF_INFO(renderer->GetContext()->PSSetShaderResources(0u, 1u, m_radianceMap->getSRV().GetAddressOf()));
+		renderer->SetShaderResource(RENDER::ShaderStage::PIXEL, 0u, m_radianceMap->getSRV());
 
 		// bind texture samplers
 		m_environmentSampler->Bind(renderer, 0u);
@@ -894,9 +2222,7 @@ void World::Environment::CreatePrefilterMap()
 		// bind vertex layout
 		m_pInputLayoutCube->Bind(renderer);
 
-		const auto& context = renderer->GetContext();
-
-		D3D_THROW_IF_INFO(context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST));
+		renderer->SetPrimitiveTopology(RENDER::PrimitiveTopology::TRIANGLE_LIST);
 
 
 		const DirectX::XMMATRIX views[] = {
@@ -930,14 +2256,10 @@ void World::Environment::CreatePrefilterMap()
 		for (uint8_t mip = 0; mip < mips; ++mip)
 		{
 			// configure viewport
-			D3D11_VIEWPORT vp;
-			vp.Width = static_cast<float>(m_prefilterMap->size() >> mip);
-			vp.Height = static_cast<float>(m_prefilterMap->size() >> mip);
-			vp.MinDepth = 0;
-			vp.MaxDepth = 1;
-			vp.TopLeftX = 0;
-			vp.TopLeftY = 0;
-			D3D_THROW_IF_INFO(renderer->GetContext()->RSSetViewports(1u, &vp));
+			RENDER::Viewport vp;
+			vp.width = static_cast<float>(m_prefilterMap->size() >> mip);
+			vp.height = static_cast<float>(m_prefilterMap->size() >> mip);
+			renderer->SetViewport(vp);
 
 			const auto& constantsCB = m_constantsCB->GetData();
 			constantsCB->roughness = (float)mip / (float)(mips - 1);
@@ -949,9 +2271,9 @@ void World::Environment::CreatePrefilterMap()
 				transformCB->view = views[face];
 				m_transformCB1->Update(renderSystem->GetRenderer());
 
-				D3D_THROW_IF_INFO(renderer->GetContext()->OMSetRenderTargets(1u, m_prefilterMap->getRTV(face, mip).GetAddressOf(), nullptr));
+				renderer->SetRenderTarget(m_prefilterMap->getRTV(face, mip), nullptr);
 
-				D3D_THROW_IF_INFO(context->DrawIndexed(36u, 0u, 0u));
+				renderer->DrawIndexed(36u, 0u, 0);
 			}
 		}
 	}
@@ -959,11 +2281,10 @@ void World::Environment::CreatePrefilterMap()
 	// End
 	{
 		// Unbind SRV
-		ID3D11ShaderResourceView* nullSRV = nullptr;
-		D3D_THROW_IF_INFO(renderer->GetContext()->PSSetShaderResources(0u, 1u, &nullSRV));
+		renderer->SetShaderResource(RENDER::ShaderStage::PIXEL, 0u, nullptr);
 
 		// Reset RenderTarget
-		D3D_THROW_IF_INFO(renderer->GetContext()->OMSetRenderTargets(0, nullptr, nullptr));
+		renderer->SetRenderTarget(nullptr, nullptr);
 	}
 }
 
@@ -973,27 +2294,21 @@ void World::Environment::ConvolveBRDF()
 	const auto& renderSystem = app->GetRenderSystem();
 	const auto& renderer = renderSystem->GetRenderer();
 
-	D3D_DEBUG_LAYER(renderer);
-
 	// Begin
 	{
 		m_brdfLUT->bind(renderer);  // ???
 
 		const float color[] = { 0.0f, 0.0f, 0.0f, 1.0f };
-		D3D_THROW_IF_INFO(renderer->GetContext()->ClearRenderTargetView(m_brdfLUT->getRTV().Get(), color));
+		renderer->ClearRenderTarget(m_brdfLUT->getRTV(), color);
 	}
 
 	// Draw
 	{
 		// configure viewport
-		D3D11_VIEWPORT vp;
-		vp.Width = static_cast<float>(m_brdfLUT->width());
-		vp.Height = static_cast<float>(m_brdfLUT->height());
-		vp.MinDepth = 0;
-		vp.MaxDepth = 1;
-		vp.TopLeftX = 0;
-		vp.TopLeftY = 0;
-		D3D_THROW_IF_INFO(renderer->GetContext()->RSSetViewports(1u, &vp));
+		RENDER::Viewport vp;
+		vp.width = static_cast<float>(m_brdfLUT->width());
+		vp.height = static_cast<float>(m_brdfLUT->height());
+		renderer->SetViewport(vp);
 
 		// bind shaders
 		m_pConvolveBRDFVertexShader->Bind(renderer);
@@ -1014,20 +2329,18 @@ void World::Environment::ConvolveBRDF()
 		// bind vertex layout
 		m_pInputLayoutQuad->Bind(renderer);
 
-		const auto& context = renderer->GetContext();
-
-		D3D_THROW_IF_INFO(context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP));
+		renderer->SetPrimitiveTopology(RENDER::PrimitiveTopology::TRIANGLE_STRIP);
 
 
-		D3D_THROW_IF_INFO(renderer->GetContext()->OMSetRenderTargets(1u, m_brdfLUT->getRTV().GetAddressOf(), nullptr));
+		renderer->SetRenderTarget(m_brdfLUT->getRTV(), nullptr);
 
-		D3D_THROW_IF_INFO(context->DrawIndexed(4, 0u, 0u));
+		renderer->DrawIndexed(4u, 0u, 0);
 	}
 
 	// End
 	{
 		// Reset RenderTarget
-		D3D_THROW_IF_INFO(renderer->GetContext()->OMSetRenderTargets(0, nullptr, nullptr));
+		renderer->SetRenderTarget(nullptr, nullptr);
 	}
 }
 
@@ -1048,6 +2361,8 @@ void World::Node::Setup(const World* world, const tinygltf::Node& node)
 		m_mesh = world->m_meshes[node.mesh];
 	}
 
+	m_static = IsStaticNode(node);
+
 	if (node.light >= 0)
 	{
 		m_light = world->m_lights[node.light];
@@ -1103,6 +2418,8 @@ void World::Node::Simulate(float dt)
 		m_worldTransform = m_localTransform;
 	}
 
+	m_drawTransform = m_bakedInverse * m_worldTransform;
+
 	for (const auto& child : m_children)
 	{
 		child->Simulate(dt);
@@ -1115,15 +2432,17 @@ void World::Node::Update(float dt)
 	const auto& camera = app->GetCamera();
 	const auto& renderSystem = app->GetRenderSystem();
 
-	if (m_mesh)
+	if (m_mesh && !m_static)
 	{
 		// update transform constant buffer
 		{
 			const auto& transformCB = m_pTransformCB->GetData();
-			transformCB->model = m_worldTransform;
+			transformCB->model = m_drawTransform;
 			transformCB->view = camera->getView();
 			transformCB->projection = camera->getProjection();
 			transformCB->viewPosition = camera->getPosition();
+			transformCB->positionScale = m_positionScale;
+			transformCB->positionOffset = m_positionOffset;
 			m_pTransformCB->Update(renderSystem->GetRenderer());
 		}
 	}
@@ -1134,21 +2453,54 @@ void World::Node::Update(float dt)
 	}
 }
 
-void World::Node::Draw()
+void World::Node::Unbake()
 {
-	const auto& app = Application::GetApplication();
-	const auto& renderSystem = app->GetRenderSystem();
+	if (m_static && m_mesh)
+	{
+		auto mesh = std::make_shared<Mesh>(m_mesh->m_name, m_mesh->m_id);
+
+		// baked positions are quantized to the bounds of the static geometry
+		if (const auto staticNode = m_bakedInto.lock())
+		{
+			auto& primitives = staticNode->m_mesh->m_primitives;
+			const auto baked = std::stable_partition(primitives.begin(), primitives.end(), [this](const std::unique_ptr<Primitive>& primitive)
+			{
+				return std::find(m_bakedPrimitives.begin(), m_bakedPrimitives.end(), primitive.get()) == m_bakedPrimitives.end();
+			});
+			std::move(baked, primitives.end(), std::back_inserter(mesh->m_primitives));
+			primitives.erase(baked, primitives.end());
+
+			m_positionScale = staticNode->m_positionScale;
+			m_positionOffset = staticNode->m_positionOffset;
+		}
 
-	if (m_mesh)
+		m_mesh = mesh;
+		m_bakedPrimitives.clear();
+	}
+	m_static = false;
+
+	// descendants are baked with this transform
+	for (const auto& child : m_children)
 	{
-		m_pTransformCB->VSBind(renderSystem->GetRenderer(), 0u);
+		child->Unbake();
+	}
+}
+
+void World::Node::Bind(RENDER::CommandList& commandList) const
+{
+	m_pTransformCB->VSBind(commandList, 0u);
+}
 
-		m_mesh->Draw();
+void World::Node::CollectDraws(const DirectX::XMMATRIX& view, DrawBuckets& buckets) const
+{
+	if (m_mesh && !m_static)
+	{
+		m_mesh->CollectDraws(this, view, buckets);
 	}
 
 	for (const auto& child : m_children)
 	{
-		child->Draw();
+		child->CollectDraws(view, buckets);
 	}
 }
 
@@ -1186,17 +2538,27 @@ void World::Material::Setup(const World* world, const tinygltf::Model& model, co
 	const auto& app = Application::GetApplication();
 	const auto& renderSystem = app->GetRenderSystem();
 
-	m_pVertexShader = std::make_unique<SD::RENDER::VertexShader>(renderSystem->GetRenderer(), L"pbr.vs.cso");
-	m_pPixelShader = std::make_unique<SD::RENDER::PixelShader>(renderSystem->GetRenderer(), L"pbr.ps.cso");
+	const auto& stateLibrary = renderSystem->GetStateLibrary();
+
+	// the same few objects for every material, only read and created by the first one
+	m_pVertexShader = stateLibrary->GetVertexShader(L"pbr.vs.cso");
+	m_pPixelShader = stateLibrary->GetPixelShader(L"pbr.ps.cso");
+
+	m_doubleSided = material.doubleSided;
+	m_pRasterizer = stateLibrary->GetRasterizer(RENDER::Rasterizer::Describe(!m_doubleSided));
 
-	m_pRasterizer = std::make_unique<RENDER::Rasterizer>(renderSystem->GetRenderer(), !material.doubleSided);
+	m_bucket = ALPHA_MODES_MAP.at(material.alphaMode);
 
-	// MASK blending is not supported yet
-	const bool blendEnabled = material.alphaMode != "OPAQUE";
-	m_pBlender = std::make_unique<SD::RENDER::Blender>(renderSystem->GetRenderer(), blendEnabled);
+	// MASK is alpha tested in the pixel shader, only BLEND needs blending
+	const bool blendEnabled = m_bucket == DrawBucket::BLEND;
+	m_pBlender = stateLibrary->GetBlender(RENDER::Blender::Describe(blendEnabled));
 
 	// create textures
 	{
+		m_pAlbedoFallback = world->m_pDefaultAlbedoTexture;
+		m_pNormalFallback = world->m_pDefaultNormalTexture;
+		m_pMetallicRoughnessFallback = world->m_pDefaultMetallicRoughnessTexture;
+
 		// albedo
 		{
 			const auto textureIndex = material.pbrMetallicRoughness.baseColorTexture.index;
@@ -1208,9 +2570,8 @@ void World::Material::Setup(const World* world, const tinygltf::Model& model, co
 			}
 			else
 			{
-				static const std::string albedo = SD_RES_DIR + std::string("textures\\albedo.dds");
-				m_pAlbedoTexture = std::make_shared<SD::RENDER::Texture>(renderSystem->GetRenderer(), AToWstring(albedo));
-				m_pAlbedoSampler = std::make_shared<SD::RENDER::Sampler>(renderSystem->GetRenderer());
+				m_pAlbedoTexture = world->m_pDefaultAlbedoTexture;
+				m_pAlbedoSampler = world->m_pDefaultSampler;
 			}
 		}
 		// normal
@@ -1224,9 +2585,8 @@ void World::Material::Setup(const World* world, const tinygltf::Model& model, co
 			}
 			else
 			{
-				static const std::string normal = SD_RES_DIR + std::string("textures\\normal.dds");
-				m_pNormalTexture = std::make_shared<SD::RENDER::Texture>(renderSystem->GetRenderer(), AToWstring(normal));
-				m_pNormalSampler = std::make_shared<SD::RENDER::Sampler>(renderSystem->GetRenderer());
+				m_pNormalTexture = world->m_pDefaultNormalTexture;
+				m_pNormalSampler = world->m_pDefaultSampler;
 			}
 		}
 		// metallicRoughness
@@ -1240,53 +2600,52 @@ void World::Material::Setup(const World* world, const tinygltf::Model& model, co
 			}
 			else
 			{
-				static const std::string metallicRoughness = SD_RES_DIR + std::string("textures\\metallicRoughness.dds");
-				m_pMetallicRoughnessTexture = std::make_shared<SD::RENDER::Texture>(renderSystem->GetRenderer(), AToWstring(metallicRoughness));
-				m_pMetallicRoughnessSampler = std::make_shared<SD::RENDER::Sampler>(renderSystem->GetRenderer());
+				m_pMetallicRoughnessTexture = world->m_pDefaultMetallicRoughnessTexture;
+				m_pMetallicRoughnessSampler = world->m_pDefaultSampler;
 			}
 		}
 	}
 
-	CB_material materialCB;
-	materialCB.normalMapScale = static_cast<float>(material.normalTexture.scale);
-	materialCB.metallicFactor = static_cast<float>(material.pbrMetallicRoughness.metallicFactor);
-	materialCB.roughnessFactor = static_cast<float>(material.pbrMetallicRoughness.roughnessFactor);
-	materialCB.baseColorFactor = DirectX::XMFLOAT4(
+	// cut-outs exported as OPAQUE are alpha tested, so the depth prepass covers fully opaque materials only
+	if (m_bucket == DrawBucket::OPAQUE_GEOMETRY && (m_pAlbedoTexture->HasAlpha() || material.pbrMetallicRoughness.baseColorFactor[3] < 1.0))
+	{
+		m_bucket = DrawBucket::ALPHA_TEST;
+	}
+
+	// uploaded by the world into the material table
+	m_parameters.normalMapScale = static_cast<float>(material.normalTexture.scale);
+	m_parameters.metallicFactor = static_cast<float>(material.pbrMetallicRoughness.metallicFactor);
+	m_parameters.roughnessFactor = static_cast<float>(material.pbrMetallicRoughness.roughnessFactor);
+	m_parameters.alphaCutoff = GetAlphaCutoff(material);
+	m_parameters.baseColorFactor = DirectX::XMFLOAT4(
 		static_cast<float>(material.pbrMetallicRoughness.baseColorFactor[0]),
 		static_cast<float>(material.pbrMetallicRoughness.baseColorFactor[1]),
 		static_cast<float>(material.pbrMetallicRoughness.baseColorFactor[2]),
 		static_cast<float>(material.pbrMetallicRoughness.baseColorFactor[3])
 	);
-	m_pMaterialCB = std::make_unique<SD::RENDER::ConstantBuffer<CB_material>>(renderSystem->GetRenderer(), materialCB);
 }
 
-void World::Material::Bind()
+void World::Material::Bind(RENDER::CommandList& commandList) const
 {
-	const auto& app = Application::GetApplication();
-	const auto& renderSystem = app->GetRenderSystem();
-
 	// bind shaders
-	m_pVertexShader->Bind(renderSystem->GetRenderer());
-	m_pPixelShader->Bind(renderSystem->GetRenderer());
-
-	// bind constant buffer
-	m_pMaterialCB->PSBind(renderSystem->GetRenderer(), 0u);
+	m_pVertexShader->Bind(commandList);
+	m_pPixelShader->Bind(commandList);
 
-	// bind textures
-	m_pAlbedoTexture->Bind(renderSystem->GetRenderer(), 0u);
-	m_pNormalTexture->Bind(renderSystem->GetRenderer(), 1u);
-	m_pMetallicRoughnessTexture->Bind(renderSystem->GetRenderer(), 2u);
+	// bind textures, streamed ones without resident mips are replaced by the fallbacks
+	(m_pAlbedoTexture->IsResident() ? m_pAlbedoTexture : m_pAlbedoFallback)->Bind(commandList, 0u);
+	(m_pNormalTexture->IsResident() ? m_pNormalTexture : m_pNormalFallback)->Bind(commandList, 1u);
+	(m_pMetallicRoughnessTexture->IsResident() ? m_pMetallicRoughnessTexture : m_pMetallicRoughnessFallback)->Bind(commandList, 2u);
 
 	// bind texture samplers
-	m_pAlbedoSampler->Bind(renderSystem->GetRenderer(), 0u);
-	m_pNormalSampler->Bind(renderSystem->GetRenderer(), 1u);
-	m_pMetallicRoughnessSampler->Bind(renderSystem->GetRenderer(), 2u);
+	m_pAlbedoSampler->Bind(commandList, 0u);
+	m_pNormalSampler->Bind(commandList, 1u);
+	m_pMetallicRoughnessSampler->Bind(commandList, 2u);
 
 	// bind rasterizer state
-	m_pRasterizer->Bind(renderSystem->GetRenderer());
+	m_pRasterizer->Bind(commandList);
 
 	// bind Blend State
-	m_pBlender->Bind(renderSystem->GetRenderer());
+	m_pBlender->Bind(commandList);
 }
 
 World::Mesh::Mesh(const std::string& name, const uint32_t id)
@@ -1295,124 +2654,132 @@ World::Mesh::Mesh(const std::string& name, const uint32_t id)
 {
 }
 
-void World::Mesh::Setup(const World* world, const tinygltf::Model& model, const tinygltf::Mesh& mesh)
+void World::Mesh::Setup(const World* world, const tinygltf::Model& model, const tinygltf::Mesh& mesh, bool createGeometry)
 {
 	m_primitives.reserve(mesh.primitives.size());
 
-	for (const auto& primitive : mesh.primitives)
+	if (createGeometry && world->m_pCookedScene)
 	{
-		m_primitives.emplace_back(std::make_unique<Primitive>(world, model, primitive));
+		for (auto& cooked : world->m_pCookedScene->GetMeshPrimitives(m_id))
+		{
+			m_primitives.emplace_back(std::make_unique<Primitive>(
+				world->m_materials[cooked.material], cooked.bounds, world->m_geometryPool.get(), cooked.range, std::move(cooked.chunks), std::move(cooked.meshlets)));
+		}
+		return;
 	}
-}
 
-void World::Mesh::Draw()
-{
-	for (auto& primitive : m_primitives)
+	for (const auto& primitive : mesh.primitives)
 	{
-		primitive->Draw();
+		const std::string name = m_name + " #" + std::to_string(m_primitives.size());
+		m_primitives.emplace_back(std::make_unique<Primitive>(world, model, primitive, name, createGeometry));
 	}
 }
 
-World::Primitive::Attribute::Attribute(const std::string& name)
-	: m_name(name)
-	, m_semanticIdx(0)
+void World::Mesh::CollectDraws(const Node* node, const DirectX::XMMATRIX& view, DrawBuckets& buckets) const
 {
-	if (const auto pos = m_name.find_last_of('_'); pos != m_name.npos )
+	const auto worldView = node->GetDrawTransform() * view;
+
+	for (const auto& primitive : m_primitives)
 	{
-		auto view = std::string_view(m_name);
-		view.remove_prefix(pos + 1);
-		m_semanticIdx = std::stoi(view.data());
+		const auto center = DirectX::XMLoadFloat3(&primitive->GetBounds().Center);
+		const float depth = DirectX::XMVectorGetZ(DirectX::XMVector3TransformCoord(center, worldView));
 
-		view = std::string_view(m_name);
-		view.remove_suffix(name.size() - pos);
-		m_name = view;
+		// depth first, then state (material) coherence
+		const uint64_t key = (QuantizeDepth(depth) << 48) | (static_cast<uint64_t>(primitive->GetMaterialId() & 0xFFFF) << 32) | node->m_id;
+
+		buckets[static_cast<size_t>(primitive->GetBucket())].push_back({ key, depth, node, primitive.get() });
 	}
 }
 
-World::Primitive::Primitive(const World* world, const tinygltf::Model& model, const tinygltf::Primitive& primitive)
+World::Primitive::Primitive(const World* world, const tinygltf::Model& model, const tinygltf::Primitive& primitive, const std::string& name, bool createGeometry)
 {
-	const auto& app = Application::GetApplication();
-	const auto& renderSystem = app->GetRenderSystem();
-
 	m_material = world->m_materials[primitive.material];
 
-	// setup indices
+	// setup bounds, glTF requires min/max for positions
 	{
-		const auto accessor = model.accessors[primitive.indices];
-
-		m_pIndexBuffer = std::static_pointer_cast<const RENDER::IndexBuffer>(world->m_buffers[accessor.bufferView]);
+		const auto& accessor = model.accessors[primitive.attributes.at("POSITION")];
+		if (accessor.minValues.size() == 3 && accessor.maxValues.size() == 3)
+		{
+			const auto decode = [&accessor](double bound)
+			{
+				return DecodeBound(bound, accessor.componentType, accessor.normalized);
+			};
 
-		m_indicesOffset = accessor.byteOffset;
-		m_indicesCount = accessor.count;
+			const DirectX::XMFLOAT3 min(decode(accessor.minValues[0]), decode(accessor.minValues[1]), decode(accessor.minValues[2]));
+			const DirectX::XMFLOAT3 max(decode(accessor.maxValues[0]), decode(accessor.maxValues[1]), decode(accessor.maxValues[2]));
+			DirectX::BoundingBox::CreateFromPoints(m_bounds, DirectX::XMLoadFloat3(&min), DirectX::XMLoadFloat3(&max));
+		}
 	}
 
-	// setup input layout and vertex buffers
+	// pack vertices and indices into the shared pool, in mesh space
+	if (createGeometry)
 	{
-		std::vector<D3D11_INPUT_ELEMENT_DESC> inputLayoutDesc;
+		VertexPackingSettings settings;
+		settings.directionEncoding = DIRECTION_ENCODING;
 
-		m_attributes.reserve(primitive.attributes.size());
+		m_pGeometryPool = world->m_geometryPool.get();
+		m_geometryRange = AddPrimitiveGeometry(name, model, *world->m_pGltfFile, primitive, nullptr, settings, *world->m_geometryPool, m_indexChunks, m_meshlets);
+	}
+}
 
-		m_vertexBuffers.reserve(primitive.attributes.size());
-		m_vertexStrides.reserve(primitive.attributes.size());
-		m_vertexOffsets.reserve(primitive.attributes.size());
+World::Primitive::Primitive(
+	const std::shared_ptr<Material>& material,
+	const DirectX::BoundingBox& bounds,
+	const GeometryPool* pool,
+	const GeometryRange& range,
+	std::vector<IndexRange>&& indexChunks,
+	std::vector<Meshlet>&& meshlets)
+	: m_material(material)
+	, m_bounds(bounds)
+	, m_pGeometryPool(pool)
+	, m_geometryRange(range)
+	, m_indexChunks(std::move(indexChunks))
+	, m_meshlets(std::move(meshlets))
+{
+}
 
-		UINT inputSlot = 0;
+uint32_t World::Primitive::GetMaterialId() const
+{
+	return m_material->m_id;
+}
 
-		// create vertex buffers
-		for (const auto& [name, idx] : primitive.attributes)
-		{
-			const auto& accessor = model.accessors[idx];
-			const auto& bufferView = model.bufferViews[accessor.bufferView];
+DrawBucket World::Primitive::GetBucket() const
+{
+	return m_material->GetBucket();
+}
 
-			const auto& attribute = m_attributes.emplace_back(name);
-			const DXGI_FORMAT format = BUFFER_FORMATS.at({ accessor.componentType, accessor.type });
+bool World::Primitive::IsDoubleSided() const
+{
+	return m_material->IsDoubleSided();
+}
 
-			inputLayoutDesc.push_back(
-				{ attribute.m_name.c_str(), static_cast<UINT>(attribute.m_semanticIdx),
-				format, inputSlot++,D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 }
-			);
+void World::Primitive::Draw(RENDER::CommandList& commandList, const std::vector<IndexRange>& ranges) const
+{
+	m_material->Bind(commandList);
 
-			m_vertexBuffers.push_back(std::static_pointer_cast<const RENDER::VertexBuffer>(world->m_buffers[accessor.bufferView]));
-			m_vertexStrides.push_back(accessor.ByteStride(bufferView));
-			m_vertexOffsets.push_back(accessor.byteOffset);
-		}
+	// buffers and layout are shared, so they are filtered out between draws of the same batch
+	m_pGeometryPool->Bind(commandList, m_geometryRange.batch);
 
-		// create input (vertex) layout
-		m_pInputLayout = std::make_unique<SD::RENDER::InputLayout>(renderSystem->GetRenderer(), inputLayoutDesc, m_material->m_pVertexShader->GetBytecode());
-	}
+	drawRanges(commandList, ranges, m_material->GetId());
 }
 
-void World::Primitive::Draw()
+void World::Primitive::DrawDepth(RENDER::CommandList& commandList, const std::vector<IndexRange>& ranges) const
 {
-	const auto& app = Application::GetApplication();
-	const auto& renderSystem = app->GetRenderSystem();
-	const auto& context = renderSystem->GetRenderer()->GetContext();
+	// same culling as the main pass, otherwise back faces may win the EQUAL test
+	m_material->m_pRasterizer->Bind(commandList);
 
-	D3D_DEBUG_LAYER(renderSystem->GetRenderer());
+	m_pGeometryPool->BindPositions(commandList, m_geometryRange.batch);
 
-	m_material->Bind();
+	drawRanges(commandList, ranges, 0u);
+}
 
-	// Bind vertex buffer
-	UINT slot = 0;
-	for (const auto& vertexBuffer : m_vertexBuffers)
+void World::Primitive::drawRanges(RENDER::CommandList& commandList, const std::vector<IndexRange>& ranges, uint32_t startInstance) const
+{
+	for (const auto& range : ranges)
 	{
-		vertexBuffer->Bind(renderSystem->GetRenderer(), slot, static_cast<UINT>(m_vertexStrides[slot]), static_cast<UINT>(m_vertexOffsets[slot]));
-		slot++;
+		commandList.DrawIndexed(
+			range.indexCount, m_geometryRange.startIndex + range.startIndex, m_geometryRange.baseVertex + range.baseVertex, startInstance);
 	}
-
-	// Bind index buffer
-	m_pIndexBuffer->Bind(renderSystem->GetRenderer(), 0u, 0u, static_cast<UINT>(m_indicesOffset));
-
-	// bind vertex layout
-	m_pInputLayout->Bind(renderSystem->GetRenderer());
-
-	// Draw
-	D3D_THROW_IF_INFO(context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST));
-	D3D_THROW_IF_INFO(context->DrawIndexed(static_cast<UINT>(m_indicesCount), 0u, 0u));
-
-	// Unbind SRV
-	ID3D11ShaderResourceView* nullSRV = nullptr;
-	D3D_THROW_IF_INFO(context->PSSetShaderResources(2u, 1u, &nullSRV));
 }
 
 World::Light::Light(const std::string& name)
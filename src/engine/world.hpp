@@ -1,15 +1,23 @@
 #pragma once
 
 #include <DirectXMath.h>
+#include <DirectXCollision.h>
 
+#include <array>
 #include <memory>
 #include <filesystem>
 #include <string>
 
 #include "space.hpp"
+#include "cooked_scene.hpp"
+#include "geometry_pool.hpp"
+#include "gltf_file.hpp"
+#include "meshlet.hpp"
+#include "vertex_packer.hpp"
 
 #include "blender.hpp"
 #include "buffer.hpp"
+#include "command_list.hpp"
 #include "constant_buffer.hpp"
 #include "frame_buffer.hpp"
 #include "structured_buffer.hpp"
@@ -18,6 +26,7 @@
 #include "pixel_shader.hpp"
 #include "rasterizer.hpp"
 #include "sampler.hpp"
+#include "state_library.hpp"
 #include "texture.hpp"
 #include "vertex_buffer.hpp"
 #include "vertex_shader.hpp"
@@ -43,11 +52,21 @@ enum class LightType : uint8_t
     DIRECTIONAL
 };
 
+enum class DrawBucket : uint8_t
+{
+    OPAQUE_GEOMETRY,  // plain OPAQUE collides with wingdi.h
+    ALPHA_TEST,
+    BLEND,
+
+    COUNT
+};
+
 class World
 {
 private:
     friend class SceneBrowserPanel;
     friend class NodePropertiesPanel;
+    friend class RenderSettingsPanel;
 
     class Environment;
     class Node;
@@ -74,6 +93,54 @@ private:
 
     static constexpr size_t MAX_LIGHTS = 512;
 
+    // element of the material table, same layout as in the pbr pixel shader
+    struct MaterialParameters
+    {
+        DirectX::XMFLOAT4 baseColorFactor;
+        float normalMapScale;
+        float metallicFactor;
+        float roughnessFactor;
+        float alphaCutoff;
+    };
+
+    struct DrawItem
+    {
+        uint64_t key;
+        float depth;  // view space depth of the primitive bounds center
+        const Node* node;
+        const Primitive* primitive;
+    };
+
+    using DrawBuckets = std::array<std::vector<DrawItem>, static_cast<size_t>(DrawBucket::COUNT)>;
+
+    struct SubmissionSettings
+    {
+        int recordingThreads = 0;  // 0 - all job system workers and the main thread
+        bool gpuPlayback = true;  // false - only count recorded commands
+        bool clusterCulling = true;  // frustum and backface culling of meshlets
+        bool depthPrepass = true;  // opaque depth first, the main pass shades visible fragments only
+    };
+
+    struct SubmissionStats
+    {
+        size_t drawItems = 0;
+        std::array<size_t, static_cast<size_t>(DrawBucket::COUNT)> bucketItems = {};
+        size_t blendSortShifts = 0;
+        size_t clusters = 0;  // meshlets of culled draw items
+        size_t visibleClusters = 0;
+        size_t drawRanges = 0;
+        size_t prepassItems = 0;
+        size_t prepassCommandLists = 0;
+        size_t commandLists = 0;
+        RENDER::CommandListStats prepassCommands = {};
+        RENDER::CommandListStats commands = {};
+
+        float collectTime = 0.0f;
+        float cullTime = 0.0f;
+        float recordTime = 0.0f;
+        float playbackTime = 0.0f;
+    };
+
 public:
     World(const Space* space);
     ~World();
@@ -86,16 +153,23 @@ public:
     void DrawImGui();
 
 private:
-    tinygltf::Model load(const std::string& path) const;
+    tinygltf::Model load(const std::string& path);
+    void cook(const tinygltf::Model& model) const;
 
-    void createBuffers(const tinygltf::Model& model);
-    void createTextures(const tinygltf::Model& model, const std::filesystem::path& dir);
+    void createTextures(const tinygltf::Model& model, const std::string& path);
     void createSamplers(const tinygltf::Model& model);
     void createMaterials(const tinygltf::Model& model);
+    void updateMaterials();
     void createMeshes(const tinygltf::Model& model);
     void createLights(const tinygltf::Model& model);
     void createNodes(const tinygltf::Model& model);
     void createScenes(const tinygltf::Model& model);
+    void createGeometry(const tinygltf::Model& model);
+
+    void collectDraws(const Scene* scene);
+    void sortBlendBucket();
+    void cullClusters();
+    void submitDraws(const Scene* scene);
 
 private:
     std::unique_ptr<Timer> m_pTimer;
@@ -104,7 +178,10 @@ private:
 
     std::vector<std::shared_ptr<RENDER::Texture>> m_textures = {};
     std::vector<std::shared_ptr<RENDER::Sampler>> m_samplers = {};
-    std::vector<std::shared_ptr<RENDER::Buffer>> m_buffers = {};
+    std::shared_ptr<RENDER::Texture> m_pDefaultAlbedoTexture = nullptr;
+    std::shared_ptr<RENDER::Texture> m_pDefaultNormalTexture = nullptr;
+    std::shared_ptr<RENDER::Texture> m_pDefaultMetallicRoughnessTexture = nullptr;
+    std::shared_ptr<RENDER::Sampler> m_pDefaultSampler = nullptr;
     std::vector<std::shared_ptr<Material>> m_materials = {};
     std::vector<std::shared_ptr<Mesh>> m_meshes = {};
     std::vector<std::shared_ptr<Node>> m_nodes = {};
@@ -117,13 +194,39 @@ private:
 
     std::unique_ptr<SceneBrowserPanel> m_sceneBrowserPanel = nullptr;
     std::unique_ptr<NodePropertiesPanel> m_nodePropertiesPanel = nullptr;
+    std::unique_ptr<RenderSettingsPanel> m_renderSettingsPanel = nullptr;
 
     std::unique_ptr<World::Environment> m_environment = nullptr;
+
+    // parameters of all materials, draws pick their element through the start instance
+    std::unique_ptr<RENDER::StructuredBuffer<MaterialParameters>> m_pMaterialsBuffer = nullptr;
+    std::unique_ptr<RENDER::VertexBuffer> m_pMaterialIndexBuffer = nullptr;  // per instance material ids
+
+    std::unique_ptr<GeometryPool> m_geometryPool = nullptr;
+
+    // set while a scene is created from its cooked file, geometry is uploaded straight from the mapping
+    std::unique_ptr<CookedScene> m_pCookedScene = nullptr;
+    std::filesystem::path m_cookedScenePath = {};
+    CookedSceneSource m_cookedSceneSource = {};
+
+    // buffers of the loaded glTF, set until the geometry is created
+    std::unique_ptr<GltfFile> m_pGltfFile = nullptr;
+    std::shared_ptr<RENDER::VertexShader> m_pDepthVertexShader = nullptr;  // position stream only, no pixel shader
+
+    DrawBuckets m_drawBuckets = {};
+    std::vector<DrawItem> m_drawItems = {};
+    std::vector<std::vector<IndexRange>> m_drawRanges = {};  // visible index ranges of every draw item
+    std::vector<uint32_t> m_blendOrder = {};  // previous frame back to front order of the blend bucket
+    std::vector<RENDER::CommandList> m_commandLists = {};
+
+    SubmissionSettings m_submissionSettings = {};
+    SubmissionStats m_submissionStats = {};
 };
 
 class World::Scene
 {
 private:
+    friend class World;
     friend class SceneBrowserPanel;
 
 public:
@@ -132,9 +235,14 @@ public:
 
     void Setup(const World* world, const tinygltf::Model& model, const tinygltf::Scene& scene);
 
+    // Pre-transforms meshes of static nodes into the pool, they are drawn by a single identity node afterwards.
+    void BakeStaticGeometry(const World* world, const tinygltf::Model& model, GeometryPool& pool);
+
     void Simulate(float dt);
     void Update(float dt);
-    void Draw();
+
+    void CollectDraws(const DirectX::XMMATRIX& view, DrawBuckets& buckets) const;
+    void Bind(RENDER::CommandList& commandList) const;
 
 private:
     void buildHierarchy(
@@ -146,6 +254,15 @@ private:
         const World* world,
         const std::vector<int>& children) const;
 
+    void getStaticBounds(const Node* node, DirectX::BoundingBox& bounds, bool& empty) const;
+    void bakeNode(
+        const tinygltf::Model& model,
+        const GltfFile& file,
+        Node* node,
+        const VertexPackingSettings& settings,
+        GeometryPool& pool,
+        Mesh& staticMesh) const;
+
     void updateLights();
 
 private:
@@ -153,6 +270,8 @@ private:
     const std::uint32_t m_id;
 
     std::shared_ptr<Node> m_root = nullptr;
+    std::shared_ptr<Node> m_staticNode = nullptr;  // owns baked static geometry, not a part of the hierarchy
+    DirectX::BoundingBox m_staticBounds = {};  // static positions are quantized to them
 
     std::unique_ptr<RENDER::StructuredBuffer<PointLight>> m_pPointLightsBuffer;
     std::unique_ptr<RENDER::ConstantBuffer<PointLights>> m_pPointLightsConstants;
@@ -188,6 +307,8 @@ public:
     void BindPrefilterMap() const;
     void BindBRDFLUT() const;
 
+    void Bind(RENDER::CommandList& commandList) const;
+
     void CreateRadianceMap();
     void ConvolveIrradianceMap();
     void CreatePrefilterMap();
@@ -207,18 +328,18 @@ private:
     std::shared_ptr<RENDER::Rasterizer> m_pRasterizer = nullptr;
     std::shared_ptr<RENDER::Blender> m_pBlender = nullptr;
 
-    std::unique_ptr<RENDER::VertexShader> m_pCubemapVertexShader = nullptr;
-    std::unique_ptr<RENDER::PixelShader> m_pEquirectangularToCubemapPixelShader = nullptr;
-    std::unique_ptr<RENDER::PixelShader> m_pIrradianceConvolutionPixelShader = nullptr;
+    std::shared_ptr<RENDER::VertexShader> m_pCubemapVertexShader = nullptr;
+    std::shared_ptr<RENDER::PixelShader> m_pEquirectangularToCubemapPixelShader = nullptr;
+    std::shared_ptr<RENDER::PixelShader> m_pIrradianceConvolutionPixelShader = nullptr;
 
-    std::unique_ptr<RENDER::VertexShader> m_pPrefilterVertexShader = nullptr;
-    std::unique_ptr<RENDER::PixelShader> m_pPrefilterPixelShader = nullptr;
+    std::shared_ptr<RENDER::VertexShader> m_pPrefilterVertexShader = nullptr;
+    std::shared_ptr<RENDER::PixelShader> m_pPrefilterPixelShader = nullptr;
 
-    std::unique_ptr<RENDER::VertexShader> m_pBackgroundVertexShader = nullptr;
-    std::unique_ptr<RENDER::PixelShader> m_pBackgroundPixelShader = nullptr;
+    std::shared_ptr<RENDER::VertexShader> m_pBackgroundVertexShader = nullptr;
+    std::shared_ptr<RENDER::PixelShader> m_pBackgroundPixelShader = nullptr;
 
-    std::unique_ptr<RENDER::VertexShader> m_pConvolveBRDFVertexShader = nullptr;
-    std::unique_ptr<RENDER::PixelShader> m_pConvolveBRDFPixelShader = nullptr;
+    std::shared_ptr<RENDER::VertexShader> m_pConvolveBRDFVertexShader = nullptr;
+    std::shared_ptr<RENDER::PixelShader> m_pConvolveBRDFPixelShader = nullptr;
 
     std::unique_ptr<RENDER::ConstantBuffer<CB_transform1>> m_transformCB1 = nullptr;
     std::unique_ptr<RENDER::ConstantBuffer<CB_transform2>> m_transformCB2 = nullptr;
@@ -226,17 +347,18 @@ private:
 
     std::unique_ptr<RENDER::VertexBuffer> m_pVertexBufferCube = nullptr;
     std::unique_ptr<RENDER::IndexBuffer> m_pIndexBufferCube = nullptr;
-    std::unique_ptr<RENDER::InputLayout> m_pInputLayoutCube = nullptr;
+    std::shared_ptr<RENDER::InputLayout> m_pInputLayoutCube = nullptr;
 
     std::unique_ptr<RENDER::VertexBuffer> m_pVertexBufferQuad = nullptr;
     std::unique_ptr<RENDER::IndexBuffer> m_pIndexBufferQuad = nullptr;
-    std::unique_ptr<RENDER::InputLayout> m_pInputLayoutQuad = nullptr;
+    std::shared_ptr<RENDER::InputLayout> m_pInputLayoutQuad = nullptr;
 };
 
 class World::Node
 {
 private:
     friend class Scene;
+    friend class Mesh;
     friend class SceneBrowserPanel;
     friend class NodePropertiesPanel;
 
@@ -246,6 +368,9 @@ private:
         DirectX::XMMATRIX view;
         DirectX::XMMATRIX projection;
         alignas(16) DirectX::XMFLOAT3 viewPosition;
+        float pad;
+        DirectX::XMFLOAT4 positionScale;  // 16 bit positions dequantization
+        DirectX::XMFLOAT4 positionOffset;
     };
 
 public:
@@ -256,21 +381,41 @@ public:
 
     void Simulate(float dt);
     void Update(float dt);
-    void Draw();
 
+    void Bind(RENDER::CommandList& commandList) const;
+
+    const DirectX::XMMATRIX& GetWorldTransform() const { return m_worldTransform; }
+    // of the primitives the node draws, baked ones are in world space of the bake
+    const DirectX::XMMATRIX& GetDrawTransform() const { return m_drawTransform; }
+
+    // Takes the node and its static descendants out of the static geometry, so their transforms can be edited. The
+    // baked primitives are moved over and drawn by the nodes, relative to the transforms they were baked with.
+    void Unbake();
+
+    void CollectDraws(const DirectX::XMMATRIX& view, DrawBuckets& buckets) const;
     void CollectLights(std::vector<PointLight>& lights);
 
 private:
     const std::string m_name;
     const std::uint32_t m_id;
 
+    bool m_static = false;  // mesh is baked into the static geometry at load, the transform is frozen until unbaked
+
     DirectX::XMMATRIX m_localTransform = DirectX::XMMatrixIdentity();
     DirectX::XMMATRIX m_worldTransform = DirectX::XMMatrixIdentity();
+    DirectX::XMMATRIX m_drawTransform = DirectX::XMMatrixIdentity();
+    DirectX::XMMATRIX m_bakedInverse = DirectX::XMMatrixIdentity();  // of the world transform baked with
+
+    std::weak_ptr<Node> m_bakedInto;  // static node drawing the baked primitives
+    std::vector<const Primitive*> m_bakedPrimitives = {};
 
     DirectX::XMVECTOR m_originalScale = {};
     DirectX::XMVECTOR m_originalRotation = {};
     DirectX::XMVECTOR m_originalTranslation = {};
 
+    DirectX::XMFLOAT4 m_positionScale = { 1.0f, 1.0f, 1.0f, 0.0f };
+    DirectX::XMFLOAT4 m_positionOffset = { 0.0f, 0.0f, 0.0f, 0.0f };
+
     std::shared_ptr<Mesh> m_mesh = nullptr;
     std::shared_ptr<Light> m_light = nullptr;
 
@@ -283,37 +428,42 @@ private:
 class World::Material
 {
 private:
+    friend class World;
     friend class Primitive;
     friend class NodePropertiesPanel;
 
-    struct CB_material
-    {
-        // TODO: alignment
-        DirectX::XMFLOAT4 baseColorFactor;
-        float normalMapScale;
-        float metallicFactor;
-        alignas(8) float roughnessFactor;
-    };
-
 public:
     Material(const std::string& name, const uint32_t id);
     ~Material() = default;
 
     void Setup(const World* world, const tinygltf::Model& model, const tinygltf::Material& material);
 
-    void Bind();
+    void Bind(RENDER::CommandList& commandList) const;
+
+    uint32_t GetId() const { return m_id; }
+    DrawBucket GetBucket() const { return m_bucket; }
+    bool IsDoubleSided() const { return m_doubleSided; }
+    const RENDER::VertexShader* GetVertexShader() const { return m_pVertexShader.get(); }
 
 private:
     const std::string m_name;
     const std::uint32_t m_id;
 
-    std::unique_ptr<RENDER::PixelShader> m_pPixelShader = nullptr;
-    std::unique_ptr<RENDER::VertexShader> m_pVertexShader = nullptr;
+    DrawBucket m_bucket = DrawBucket::OPAQUE_GEOMETRY;
+    bool m_doubleSided = false;
+
+    std::shared_ptr<RENDER::PixelShader> m_pPixelShader = nullptr;
+    std::shared_ptr<RENDER::VertexShader> m_pVertexShader = nullptr;
 
     std::shared_ptr<const RENDER::Texture> m_pAlbedoTexture = nullptr;
     std::shared_ptr<const RENDER::Texture> m_pNormalTexture = nullptr;
     std::shared_ptr<const RENDER::Texture> m_pMetallicRoughnessTexture = nullptr;
 
+    // bound while streamed textures have no resident mips
+    std::shared_ptr<const RENDER::Texture> m_pAlbedoFallback = nullptr;
+    std::shared_ptr<const RENDER::Texture> m_pNormalFallback = nullptr;
+    std::shared_ptr<const RENDER::Texture> m_pMetallicRoughnessFallback = nullptr;
+
     std::shared_ptr<RENDER::Sampler> m_pAlbedoSampler = nullptr;
     std::shared_ptr<RENDER::Sampler> m_pNormalSampler = nullptr;
     std::shared_ptr<RENDER::Sampler> m_pMetallicRoughnessSampler = nullptr;
@@ -321,21 +471,24 @@ private:
     std::shared_ptr<RENDER::Rasterizer> m_pRasterizer = nullptr;
     std::shared_ptr<RENDER::Blender> m_pBlender = nullptr;
 
-    std::unique_ptr<RENDER::ConstantBuffer<CB_material>> m_pMaterialCB = nullptr;
+    MaterialParameters m_parameters = {};
+    bool m_dirty = false;  // parameters changed since the last upload to the material table
 };
 
 class World::Mesh
 {
 private:
+    friend class World;
+    friend class Scene;
     friend class NodePropertiesPanel;
 
 public:
     Mesh(const std::string& name, const uint32_t id);
     ~Mesh() = default;
 
-    void Setup(const World* world, const tinygltf::Model& model, const tinygltf::Mesh& mesh);
+    void Setup(const World* world, const tinygltf::Model& model, const tinygltf::Mesh& mesh, bool createGeometry);
 
-    void Draw();
+    void CollectDraws(const Node* node, const DirectX::XMMATRIX& view, DrawBuckets& buckets) const;
 
 private:
     const std::string m_name;
@@ -347,35 +500,48 @@ private:
 class World::Primitive
 {
 private:
+    friend class World;
+    friend class Scene;
     friend class NodePropertiesPanel;
 
-    struct Attribute
-    {
-        Attribute(const std::string& name);
-
-        std::string m_name;
-        std::size_t m_semanticIdx;
-    };
-
 public:
-    Primitive(const World* world, const tinygltf::Model& model, const tinygltf::Primitive& primitive);
+    Primitive(const World* world, const tinygltf::Model& model, const tinygltf::Primitive& primitive, const std::string& name, bool createGeometry);
+    Primitive(
+        const std::shared_ptr<Material>& material,
+        const DirectX::BoundingBox& bounds,
+        const GeometryPool* pool,
+        const GeometryRange& range,
+        std::vector<IndexRange>&& indexChunks,
+        std::vector<Meshlet>&& meshlets);
     ~Primitive() = default;
 
-    void Draw();
+    uint32_t GetMaterialId() const;
+    DrawBucket GetBucket() const;
+    bool IsDoubleSided() const;
+    const DirectX::BoundingBox& GetBounds() const { return m_bounds; }
+    const std::vector<IndexRange>& GetIndexChunks() const { return m_indexChunks; }
+    const std::vector<Meshlet>& GetMeshlets() const { return m_meshlets; }
+
+    // Draws index ranges relative to the primitive ones.
+    void Draw(RENDER::CommandList& commandList, const std::vector<IndexRange>& ranges) const;
+    // Draws positions only, the depth vertex shader is expected to be bound.
+    void DrawDepth(RENDER::CommandList& commandList, const std::vector<IndexRange>& ranges) const;
+
+private:
+    // start instance offsets the per instance material ids, so it is the material id of the main pass
+    void drawRanges(RENDER::CommandList& commandList, const std::vector<IndexRange>& ranges, uint32_t startInstance) const;
 
 private:
     std::shared_ptr<Material> m_material = nullptr;
 
-    std::shared_ptr<const RENDER::IndexBuffer> m_pIndexBuffer = nullptr;
-    size_t m_indicesCount = 0;
-    size_t m_indicesOffset = 0;
+    DirectX::BoundingBox m_bounds = {};
 
-    std::vector<Attribute> m_attributes = {};
-    std::vector<std::shared_ptr<const RENDER::VertexBuffer>> m_vertexBuffers = {};
-    std::vector<size_t> m_vertexStrides = {};
-    std::vector<size_t> m_vertexOffsets = {};
+    // null for primitives drawn only from baked static copies
+    const GeometryPool* m_pGeometryPool = nullptr;
+    GeometryRange m_geometryRange = {};
+    std::vector<IndexRange> m_indexChunks = {};  // 16 bit indices of more than 65536 vertices are split
 
-    std::unique_ptr<RENDER::InputLayout> m_pInputLayout = nullptr;
+    std::vector<Meshlet> m_meshlets = {};  // in the space of the geometry
 };
 
 class World::Light
@@ -1,33 +1,109 @@
+#ifdef _WIN32
 #include <windows.h>
+#endif
 
 #include <exception>
+#include <iostream>
+#include <string>
 
 #include <application.hpp>
+#include <compression_benchmark.hpp>
 #include <exceptions.hpp>
+#include <gltf_benchmark.hpp>
 
 
 using namespace SD;
 
 
-int main(int, char**)
+ENGINE::ApplicationSettings ParseArguments(int argc, char** argv)
+{
+    ENGINE::ApplicationSettings settings;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string argument = argv[i];
+        if (argument == "--headless")
+        {
+            settings.headless = true;
+        }
+        else if (argument == "--frames" && i + 1 < argc)
+        {
+            settings.frames = static_cast<uint32_t>(std::stoul(argv[++i]));
+        }
+        else if (argument == "--gltf-benchmark")
+        {
+            const bool hasPath = i + 1 < argc && argv[i + 1][0] != '-';
+            settings.gltfBenchmark = hasPath ? argv[++i] : SD_RES_DIR + std::string("scenes\\Sponza\\main\\main.gltf");
+        }
+        else if (argument == "--bc-benchmark")
+        {
+            const bool hasPath = i + 1 < argc && argv[i + 1][0] != '-';
+            settings.compressionBenchmark = true;
+            settings.compressionBenchmarkImage = hasPath ? argv[++i] : "";
+        }
+    }
+
+    return settings;
+}
+
+// Message boxes with a window, the error stream in headless runs and where there are no message boxes.
+void ReportError([[maybe_unused]] bool headless, const wchar_t* message, [[maybe_unused]] const wchar_t* caption)
+{
+#ifdef _WIN32
+    if (!headless)
+    {
+        MessageBoxW(nullptr, message, caption, MB_ICONERROR | MB_DEFAULT_DESKTOP_ONLY);
+        return;
+    }
+#endif
+
+    std::wcerr << message << std::endl;
+}
+
+void ReportError([[maybe_unused]] bool headless, const char* message, [[maybe_unused]] const char* caption)
+{
+#ifdef _WIN32
+    if (!headless)
+    {
+        MessageBoxA(nullptr, message, caption, MB_ICONERROR | MB_DEFAULT_DESKTOP_ONLY);
+        return;
+    }
+#endif
+
+    std::cerr << message << std::endl;
+}
+
+int main(int argc, char** argv)
 {
     //return ENGINE::Application().Run();
 
+    const auto settings = ParseArguments(argc, argv);
+
     try
     {
-        return ENGINE::Application().Run();
+        if (!settings.gltfBenchmark.empty())
+        {
+            return ENGINE::RunGltfBenchmark(settings.gltfBenchmark);
+        }
+
+        if (settings.compressionBenchmark)
+        {
+            return ENGINE::RunCompressionBenchmark(settings.compressionBenchmarkImage);
+        }
+
+        return ENGINE::Application(settings).Run();
     }
     catch (const SomeException& e)
     {
-        MessageBoxW(nullptr, e.w_what(), L"Some Exception", MB_ICONERROR | MB_DEFAULT_DESKTOP_ONLY);
+        ReportError(settings.headless, e.w_what(), L"Some Exception");
     }
     catch (const std::exception& e)
     {
-        MessageBoxA(nullptr, e.what(), "Standard Exception", MB_ICONERROR | MB_DEFAULT_DESKTOP_ONLY);
+        ReportError(settings.headless, e.what(), "Standard Exception");
     }
     catch (...)
     {
-        MessageBoxA(nullptr, "No details available", "Unknown Exception", MB_ICONERROR | MB_DEFAULT_DESKTOP_ONLY);
+        ReportError(settings.headless, "No details available", "Unknown Exception");
     }
 
     return -1;
@@ -1,23 +1,25 @@
 #pragma once
 
-#include <d3d11.h>
-#include <wrl/client.h>
+#include "renderer.hpp"
 
 
 namespace SD::RENDER {
 
-	class Renderer;
+	class CommandList;
 
 class Blender
 {
 public:
 	Blender(Renderer* renderer, bool enabled);
+	Blender(Renderer* renderer, const BlendDesc& desc);
+
+	static BlendDesc Describe(bool enabled);
 
 	void Bind(Renderer* renderer);
+	void Bind(CommandList& commandList) const;
 
 private:
-	bool m_enabled = false;
-	Microsoft::WRL::ComPtr<ID3D11BlendState> m_pBlender;
+	BlendStateHandle m_pBlender;
 };
 
 }  // end namespace SD::RENDER
@@ -1,12 +1,11 @@
 #pragma once
 
-#include <d3d11.h>
-#include <wrl/client.h>
+#include "renderer.hpp"
 
 
 namespace SD::RENDER {
 
-	class Renderer;
+	class CommandList;
 
 class Buffer
 {
@@ -16,13 +15,14 @@ public:
 
 	void create(Renderer* renderer, const void* data, const size_t byteLength);
 
-	virtual void Bind(Renderer* renderer, UINT slot, UINT stride, UINT offset) const = 0;
+	virtual void Bind(Renderer* renderer, uint32_t slot, uint32_t stride, uint32_t offset) const = 0;
+	virtual void Bind(CommandList& commandList, uint32_t slot, uint32_t stride, uint32_t offset) const = 0;
 
 protected:
-	virtual D3D11_BUFFER_DESC getDescriptor(const size_t byteLength) const = 0;
+	virtual BufferDesc getDescriptor(const size_t byteLength) const = 0;
 
 protected:
-	Microsoft::WRL::ComPtr<ID3D11Buffer> m_pBuffer;
+	BufferHandle m_pBuffer;
 };
 
 }  // end namespace SD::RENDER
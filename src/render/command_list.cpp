@@ -0,0 +1,240 @@
+#include "command_list.hpp"
+
+
+namespace SD::RENDER {
+
+CommandListStats& CommandListStats::operator+=(const CommandListStats& other)
+{
+	commands += other.commands;
+	stateChanges += other.stateChanges;
+	skippedChanges += other.skippedChanges;
+	draws += other.draws;
+	primitives += other.primitives;
+	constantBytes += other.constantBytes;
+
+	return *this;
+}
+
+void CommandList::Reset()
+{
+	m_commands.clear();
+	m_payload.clear();
+
+	m_stats = {};
+	m_cache = {};
+}
+
+void CommandList::SetRenderTarget(NativeRenderTargetView* renderTarget, NativeDepthStencilView* depthStencil)
+{
+	auto& command = push(CommandType::SET_RENDER_TARGET, renderTarget);
+	command.args[0] = static_cast<uint32_t>(m_payload.size());
+
+	const auto* data = reinterpret_cast<const uint8_t*>(&depthStencil);
+	m_payload.insert(m_payload.end(), data, data + sizeof(depthStencil));
+
+	m_cache.renderTarget = renderTarget;
+}
+
+void CommandList::SetViewport(const Viewport& viewport)
+{
+	auto& command = push(CommandType::SET_VIEWPORT);
+	command.args[0] = static_cast<uint32_t>(m_payload.size());
+
+	const auto* data = reinterpret_cast<const uint8_t*>(&viewport);
+	m_payload.insert(m_payload.end(), data, data + sizeof(viewport));
+}
+
+void CommandList::SetDepthStencilState(NativeDepthStencilState* state)
+{
+	if (filter(m_cache.depthStencilState, state))
+	{
+		push(CommandType::SET_DEPTH_STENCIL_STATE, state);
+	}
+}
+
+void CommandList::SetBlendState(NativeBlendState* state)
+{
+	if (filter(m_cache.blendState, state))
+	{
+		push(CommandType::SET_BLEND_STATE, state);
+	}
+}
+
+void CommandList::SetRasterizerState(NativeRasterizerState* state)
+{
+	if (filter(m_cache.rasterizerState, state))
+	{
+		push(CommandType::SET_RASTERIZER_STATE, state);
+	}
+}
+
+void CommandList::SetPrimitiveTopology(PrimitiveTopology topology)
+{
+	if (m_cache.topology == topology)
+	{
+		m_stats.skippedChanges++;
+		return;
+	}
+
+	m_cache.topology = topology;
+	push(CommandType::SET_PRIMITIVE_TOPOLOGY).args[0] = static_cast<uint32_t>(topology);
+}
+
+void CommandList::SetInputLayout(NativeInputLayout* layout)
+{
+	if (filter(m_cache.inputLayout, layout))
+	{
+		push(CommandType::SET_INPUT_LAYOUT, layout);
+	}
+}
+
+void CommandList::SetVertexShader(NativeVertexShader* shader)
+{
+	if (filter(m_cache.vertexShader, shader))
+	{
+		push(CommandType::SET_VERTEX_SHADER, shader);
+	}
+}
+
+void CommandList::SetPixelShader(NativePixelShader* shader)
+{
+	if (filter(m_cache.pixelShader, shader))
+	{
+		push(CommandType::SET_PIXEL_SHADER, shader);
+	}
+}
+
+void CommandList::SetVertexBuffer(uint32_t slot, NativeBuffer* buffer, uint32_t stride, uint32_t offset)
+{
+	if (m_cache.vertexBuffers[slot] == buffer && m_cache.vertexStrides[slot] == stride && m_cache.vertexOffsets[slot] == offset)
+	{
+		m_stats.skippedChanges++;
+		return;
+	}
+
+	m_cache.vertexBuffers[slot] = buffer;
+	m_cache.vertexStrides[slot] = stride;
+	m_cache.vertexOffsets[slot] = offset;
+
+	auto& command = push(CommandType::SET_VERTEX_BUFFER, buffer);
+	command.slot = slot;
+	command.args[0] = stride;
+	command.args[1] = offset;
+}
+
+void CommandList::SetIndexBuffer(NativeBuffer* buffer, DXGI_FORMAT format, uint32_t offset)
+{
+	if (m_cache.indexBuffer == buffer && m_cache.indexFormat == format && m_cache.indexOffset == offset)
+	{
+		m_stats.skippedChanges++;
+		return;
+	}
+
+	m_cache.indexBuffer = buffer;
+	m_cache.indexFormat = format;
+	m_cache.indexOffset = offset;
+
+	auto& command = push(CommandType::SET_INDEX_BUFFER, buffer);
+	command.args[0] = static_cast<uint32_t>(format);
+	command.args[1] = offset;
+}
+
+void CommandList::SetConstantBuffer(ShaderStage stage, uint32_t slot, NativeBuffer* buffer)
+{
+	if (filter(m_cache.constantBuffers[static_cast<size_t>(stage)][slot], buffer))
+	{
+		auto& command = push(CommandType::SET_CONSTANT_BUFFER, buffer);
+		command.stage = stage;
+		command.slot = slot;
+	}
+}
+
+void CommandList::SetShaderResource(ShaderStage stage, uint32_t slot, NativeShaderResourceView* view)
+{
+	if (filter(m_cache.shaderResources[static_cast<size_t>(stage)][slot], view))
+	{
+		auto& command = push(CommandType::SET_SHADER_RESOURCE, view);
+		command.stage = stage;
+		command.slot = slot;
+	}
+}
+
+void CommandList::SetSampler(ShaderStage stage, uint32_t slot, NativeSamplerState* sampler)
+{
+	if (filter(m_cache.samplers[static_cast<size_t>(stage)][slot], sampler))
+	{
+		auto& command = push(CommandType::SET_SAMPLER, sampler);
+		command.stage = stage;
+		command.slot = slot;
+	}
+}
+
+void CommandList::UpdateConstants(NativeBuffer* buffer, const void* data, size_t size)
+{
+	auto& command = push(CommandType::UPDATE_CONSTANTS, buffer);
+	command.args[0] = static_cast<uint32_t>(m_payload.size());
+	command.args[1] = static_cast<uint32_t>(size);
+
+	const auto* bytes = static_cast<const uint8_t*>(data);
+	m_payload.insert(m_payload.end(), bytes, bytes + size);
+
+	m_stats.constantBytes += size;
+}
+
+void CommandList::Draw(uint32_t vertexCount, uint32_t startVertex)
+{
+	auto& command = push(CommandType::DRAW);
+	command.args[0] = vertexCount;
+	command.args[1] = startVertex;
+
+	m_stats.draws++;
+	m_stats.primitives += vertexCount / 3;
+}
+
+void CommandList::DrawIndexed(uint32_t indexCount, uint32_t startIndex, int32_t baseVertex, uint32_t startInstance)
+{
+	auto& command = push(CommandType::DRAW_INDEXED);
+	command.args[0] = indexCount;
+	command.args[1] = startIndex;
+	command.args[2] = startInstance;
+	command.baseVertex = baseVertex;
+
+	m_stats.draws++;
+	m_stats.primitives += indexCount / 3;
+}
+
+Command& CommandList::push(CommandType type, void* object)
+{
+	m_stats.commands++;
+	if (type != CommandType::DRAW && type != CommandType::DRAW_INDEXED)
+	{
+		m_stats.stateChanges++;
+	}
+
+	auto& command = m_commands.emplace_back();
+	command.type = type;
+	command.stage = ShaderStage::PIXEL;
+	command.slot = 0u;
+	command.object = object;
+	command.args[0] = 0u;
+	command.args[1] = 0u;
+	command.args[2] = 0u;
+	command.baseVertex = 0;
+
+	return command;
+}
+
+bool CommandList::filter(void*& cached, void* object)
+{
+	if (cached == object)
+	{
+		m_stats.skippedChanges++;
+		return false;
+	}
+
+	cached = object;
+
+	return true;
+}
+
+}  // end namespace SD::RENDER
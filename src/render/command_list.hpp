@@ -0,0 +1,143 @@
+#pragma once
+
+#include "renderer.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+namespace SD::RENDER {
+
+enum class CommandType : uint8_t
+{
+	SET_RENDER_TARGET,
+	SET_VIEWPORT,
+	SET_DEPTH_STENCIL_STATE,
+	SET_BLEND_STATE,
+	SET_RASTERIZER_STATE,
+	SET_PRIMITIVE_TOPOLOGY,
+	SET_INPUT_LAYOUT,
+	SET_VERTEX_SHADER,
+	SET_PIXEL_SHADER,
+	SET_VERTEX_BUFFER,
+	SET_INDEX_BUFFER,
+	SET_CONSTANT_BUFFER,
+	SET_SHADER_RESOURCE,
+	SET_SAMPLER,
+	UPDATE_CONSTANTS,
+	DRAW,
+	DRAW_INDEXED,
+
+	COUNT
+};
+
+struct Command
+{
+	CommandType type;
+	ShaderStage stage;
+	uint32_t slot;
+
+	// recorded native object (shader, state, buffer, view...), not owned
+	void* object;
+
+	// command specific arguments (strides, offsets, counts, formats, payload location)
+	uint32_t args[3];
+	int32_t baseVertex;
+};
+
+struct CommandListStats
+{
+	size_t commands = 0;
+	size_t stateChanges = 0;
+	size_t skippedChanges = 0;
+	size_t draws = 0;
+	size_t primitives = 0;
+	size_t constantBytes = 0;
+
+	CommandListStats& operator+=(const CommandListStats& other);
+};
+
+// Engine-level list of draw commands recorded on any thread and played back by a renderer backend.
+// Commands keep raw (non-owning) pointers, recorded objects must outlive the playback.
+// Redundant state changes are filtered at record time.
+class CommandList
+{
+public:
+	static constexpr size_t MAX_SLOTS = 16;
+
+	CommandList() = default;
+	~CommandList() = default;
+
+	CommandList(CommandList&&) = default;
+	CommandList& operator=(CommandList&&) = default;
+
+	CommandList(const CommandList&) = delete;
+	CommandList& operator=(const CommandList&) = delete;
+
+	void Reset();
+
+	void SetRenderTarget(NativeRenderTargetView* renderTarget, NativeDepthStencilView* depthStencil);
+	void SetViewport(const Viewport& viewport);
+	void SetDepthStencilState(NativeDepthStencilState* state);
+	void SetBlendState(NativeBlendState* state);
+	void SetRasterizerState(NativeRasterizerState* state);
+	void SetPrimitiveTopology(PrimitiveTopology topology);
+	void SetInputLayout(NativeInputLayout* layout);
+	void SetVertexShader(NativeVertexShader* shader);
+	void SetPixelShader(NativePixelShader* shader);
+	void SetVertexBuffer(uint32_t slot, NativeBuffer* buffer, uint32_t stride, uint32_t offset);
+	void SetIndexBuffer(NativeBuffer* buffer, DXGI_FORMAT format, uint32_t offset);
+	void SetConstantBuffer(ShaderStage stage, uint32_t slot, NativeBuffer* buffer);
+	void SetShaderResource(ShaderStage stage, uint32_t slot, NativeShaderResourceView* view);
+	void SetSampler(ShaderStage stage, uint32_t slot, NativeSamplerState* sampler);
+
+	// Copies data into the list, playback writes it into the (dynamic) buffer, discarding its contents.
+	void UpdateConstants(NativeBuffer* buffer, const void* data, size_t size);
+
+	void Draw(uint32_t vertexCount, uint32_t startVertex);
+	// A non zero start instance is played back as a single instance draw, offsetting per-instance streams.
+	void DrawIndexed(uint32_t indexCount, uint32_t startIndex, int32_t baseVertex, uint32_t startInstance = 0u);
+
+	const std::vector<Command>& GetCommands() const { return m_commands; }
+	const uint8_t* GetPayload(const Command& command) const { return m_payload.data() + command.args[0]; }
+	const CommandListStats& GetStats() const { return m_stats; }
+
+	bool IsEmpty() const { return m_commands.empty(); }
+
+private:
+	Command& push(CommandType type, void* object = nullptr);
+	bool filter(void*& cached, void* object);
+
+private:
+	std::vector<Command> m_commands = {};
+	std::vector<uint8_t> m_payload = {};
+
+	CommandListStats m_stats = {};
+
+	// currently recorded state
+	struct Cache
+	{
+		void* renderTarget;
+		void* depthStencilState;
+		void* blendState;
+		void* rasterizerState;
+		void* inputLayout;
+		void* vertexShader;
+		void* pixelShader;
+		void* indexBuffer;
+		uint32_t indexOffset;
+		DXGI_FORMAT indexFormat;
+		PrimitiveTopology topology;
+		std::array<void*, MAX_SLOTS> vertexBuffers;
+		std::array<uint32_t, MAX_SLOTS> vertexStrides;
+		std::array<uint32_t, MAX_SLOTS> vertexOffsets;
+		std::array<void*, MAX_SLOTS> constantBuffers[2];
+		std::array<void*, MAX_SLOTS> shaderResources[2];
+		std::array<void*, MAX_SLOTS> samplers[2];
+	};
+	Cache m_cache = {};
+};
+
+}  // end namespace SD::RENDER
@@ -1,11 +1,9 @@
 #pragma once
 
-#include <d3d11.h>
-#include <wrl/client.h>
-
 #include "renderer.hpp"
-#include "debug_layer.hpp"
-#include <exceptions.hpp>
+#include "command_list.hpp"
+
+#include <cstring>
 
 
 namespace SD::RENDER {
@@ -17,43 +15,44 @@ public:
 	ConstantBuffer(Renderer* renderer, C& data)
 		: m_data(std::move(data))
 	{
-		D3D_DEBUG_LAYER(renderer);
-
-		D3D11_BUFFER_DESC constantBufferDesc;
-		constantBufferDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
-		constantBufferDesc.Usage = D3D11_USAGE_DYNAMIC;
-		constantBufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
-		constantBufferDesc.MiscFlags = 0u;
-		constantBufferDesc.ByteWidth = sizeof(m_data);
-		constantBufferDesc.StructureByteStride = 0u;
+		BufferDesc constantBufferDesc;
+		constantBufferDesc.type = BufferType::CONSTANT;
+		constantBufferDesc.size = sizeof(m_data);
+		constantBufferDesc.dynamic = true;
 
-		D3D11_SUBRESOURCE_DATA constantBufferData = {};
-		constantBufferData.pSysMem = &m_data;
-		D3D_THROW_INFO_EXCEPTION(renderer->GetDevice()->CreateBuffer(&constantBufferDesc, &constantBufferData, &m_pConstantBuffer));
+		m_pConstantBuffer = renderer->CreateBuffer(constantBufferDesc, &m_data);
 	}
 
 	void Update(Renderer* renderer)
 	{
-		D3D_DEBUG_LAYER(renderer);
+		void* mappedData = renderer->Map(m_pConstantBuffer.get());
+		memcpy(mappedData, &m_data, sizeof(m_data));
+		renderer->Unmap(m_pConstantBuffer.get());
+	}
 
-		D3D11_MAPPED_SUBRESOURCE mappedData;
-		D3D_THROW_IF_INFO(renderer->GetContext()->Map(m_pConstantBuffer.Get(), 0u, D3D11_MAP_WRITE_DISCARD, 0u, &mappedData));
-		memcpy(mappedData.pData, &m_data, sizeof(m_data));
-		D3D_THROW_IF_INFO(renderer->GetContext()->Unmap(m_pConstantBuffer.Get(), 0u));
+	void Update(CommandList& commandList) const
+	{
+		commandList.UpdateConstants(m_pConstantBuffer.get(), &m_data, sizeof(m_data));
 	}
 
-	void VSBind(Renderer* renderer, UINT slot) const
+	void VSBind(Renderer* renderer, uint32_t slot) const
 	{
-		D3D_DEBUG_LAYER(renderer);
+		renderer->SetConstantBuffer(ShaderStage::VERTEX, slot, m_pConstantBuffer.get());
+	}
 
-		D3D_THROW_IF_INFO(renderer->GetContext()->VSSetConstantBuffers(slot, 1u, m_pConstantBuffer.GetAddressOf()));
+	void PSBind(Renderer* renderer, uint32_t slot) const
+	{
+		renderer->SetConstantBuffer(ShaderStage::PIXEL, slot, m_pConstantBuffer.get());
 	}
 
-	void PSBind(Renderer* renderer, UINT slot) const
+	void VSBind(CommandList& commandList, uint32_t slot) const
 	{
-		D3D_DEBUG_LAYER(renderer);
+		commandList.SetConstantBuffer(ShaderStage::VERTEX, slot, m_pConstantBuffer.get());
+	}
 
-		D3D_THROW_IF_INFO(renderer->GetContext()->PSSetConstantBuffers(slot, 1u, m_pConstantBuffer.GetAddressOf()));
+	void PSBind(CommandList& commandList, uint32_t slot) const
+	{
+		commandList.SetConstantBuffer(ShaderStage::PIXEL, slot, m_pConstantBuffer.get());
 	}
 
 	C* GetData()
@@ -63,7 +62,7 @@ public:
 
 private:
 	C m_data;
-	Microsoft::WRL::ComPtr<ID3D11Buffer> m_pConstantBuffer;
+	BufferHandle m_pConstantBuffer;
 };
 
 }  // end namespace SD::RENDER
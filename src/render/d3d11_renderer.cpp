@@ -0,0 +1,851 @@
+#include "d3d11_renderer.hpp"
+
+#include "exceptions.hpp"
+#include "job_system.hpp"
+
+#include "debug_layer.hpp"
+#include "command_list.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+
+
+namespace
+{
+static_assert(SD::RENDER::APPEND_ALIGNED == D3D11_APPEND_ALIGNED_ELEMENT, "Append aligned offsets differ");
+
+const std::unordered_map<SD::RENDER::BufferType, UINT> BUFFER_BIND_FLAGS = {
+    {SD::RENDER::BufferType::VERTEX, D3D11_BIND_VERTEX_BUFFER},
+    {SD::RENDER::BufferType::INDEX, D3D11_BIND_INDEX_BUFFER},
+    {SD::RENDER::BufferType::CONSTANT, D3D11_BIND_CONSTANT_BUFFER},
+    {SD::RENDER::BufferType::STRUCTURED, D3D11_BIND_SHADER_RESOURCE},
+};
+
+const std::unordered_map<SD::RENDER::DepthFunc, D3D11_COMPARISON_FUNC> DEPTH_FUNCS = {
+    {SD::RENDER::DepthFunc::LESS, D3D11_COMPARISON_LESS},
+    {SD::RENDER::DepthFunc::LESS_EQUAL, D3D11_COMPARISON_LESS_EQUAL},
+    {SD::RENDER::DepthFunc::EQUAL, D3D11_COMPARISON_EQUAL},
+    {SD::RENDER::DepthFunc::ALWAYS, D3D11_COMPARISON_ALWAYS},
+};
+
+const std::unordered_map<SD::RENDER::CullMode, D3D11_CULL_MODE> CULL_MODES = {
+    {SD::RENDER::CullMode::NONE, D3D11_CULL_NONE},
+    {SD::RENDER::CullMode::BACK, D3D11_CULL_BACK},
+    {SD::RENDER::CullMode::FRONT, D3D11_CULL_FRONT},
+};
+
+const std::unordered_map<SD::RENDER::AddressMode, D3D11_TEXTURE_ADDRESS_MODE> ADDRESS_MODES = {
+    {SD::RENDER::AddressMode::WRAP, D3D11_TEXTURE_ADDRESS_WRAP},
+    {SD::RENDER::AddressMode::CLAMP, D3D11_TEXTURE_ADDRESS_CLAMP},
+};
+
+const std::unordered_map<SD::RENDER::PrimitiveTopology, D3D11_PRIMITIVE_TOPOLOGY> PRIMITIVE_TOPOLOGIES = {
+    {SD::RENDER::PrimitiveTopology::UNDEFINED, D3D11_PRIMITIVE_TOPOLOGY_UNDEFINED},
+    {SD::RENDER::PrimitiveTopology::TRIANGLE_LIST, D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST},
+    {SD::RENDER::PrimitiveTopology::TRIANGLE_STRIP, D3D11_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP},
+};
+
+// Native handles are the D3D11 objects, a handle owns the reference the object was created with.
+template<typename Native, typename T>
+std::shared_ptr<Native> MakeHandle(T* object)
+{
+    return std::shared_ptr<Native>(reinterpret_cast<Native*>(object), [](Native* native)
+    {
+        if (native)
+        {
+            reinterpret_cast<T*>(native)->Release();
+        }
+    });
+}
+
+template<typename T, typename Native>
+T* ToD3D(Native* native)
+{
+    return reinterpret_cast<T*>(native);
+}
+
+D3D11_VIEWPORT ToD3DViewport(const SD::RENDER::Viewport& viewport)
+{
+    D3D11_VIEWPORT vp;
+    vp.TopLeftX = viewport.x;
+    vp.TopLeftY = viewport.y;
+    vp.Width = viewport.width;
+    vp.Height = viewport.height;
+    vp.MinDepth = viewport.minDepth;
+    vp.MaxDepth = viewport.maxDepth;
+
+    return vp;
+}
+
+// Replays engine commands into a D3D11 context, deferred or immediate.
+void Playback(const SD::RENDER::CommandList& commandList, ID3D11DeviceContext* context)
+{
+    using SD::RENDER::CommandType;
+    using SD::RENDER::ShaderStage;
+
+    for (const auto& command : commandList.GetCommands())
+    {
+        switch (command.type)
+        {
+            case CommandType::SET_RENDER_TARGET:
+            {
+                ID3D11DepthStencilView* depthStencil = nullptr;
+                memcpy(&depthStencil, commandList.GetPayload(command), sizeof(depthStencil));
+
+                auto* renderTarget = static_cast<ID3D11RenderTargetView*>(command.object);
+                context->OMSetRenderTargets(1u, &renderTarget, depthStencil);
+                break;
+            }
+            case CommandType::SET_VIEWPORT:
+            {
+                SD::RENDER::Viewport viewport;
+                memcpy(&viewport, commandList.GetPayload(command), sizeof(viewport));
+
+                const D3D11_VIEWPORT vp = ToD3DViewport(viewport);
+                context->RSSetViewports(1u, &vp);
+                break;
+            }
+            case CommandType::SET_DEPTH_STENCIL_STATE:
+            {
+                context->OMSetDepthStencilState(static_cast<ID3D11DepthStencilState*>(command.object), 1u);
+                break;
+            }
+            case CommandType::SET_BLEND_STATE:
+            {
+                context->OMSetBlendState(static_cast<ID3D11BlendState*>(command.object), nullptr, 0xFFFFFFFFu);
+                break;
+            }
+            case CommandType::SET_RASTERIZER_STATE:
+            {
+                context->RSSetState(static_cast<ID3D11RasterizerState*>(command.object));
+                break;
+            }
+            case CommandType::SET_PRIMITIVE_TOPOLOGY:
+            {
+                context->IASetPrimitiveTopology(PRIMITIVE_TOPOLOGIES.at(static_cast<SD::RENDER::PrimitiveTopology>(command.args[0])));
+                break;
+            }
+            case CommandType::SET_INPUT_LAYOUT:
+            {
+                context->IASetInputLayout(static_cast<ID3D11InputLayout*>(command.object));
+                break;
+            }
+            case CommandType::SET_VERTEX_SHADER:
+            {
+                context->VSSetShader(static_cast<ID3D11VertexShader*>(command.object), nullptr, 0u);
+                break;
+            }
+            case CommandType::SET_PIXEL_SHADER:
+            {
+                context->PSSetShader(static_cast<ID3D11PixelShader*>(command.object), nullptr, 0u);
+                break;
+            }
+            case CommandType::SET_VERTEX_BUFFER:
+            {
+                auto* buffer = static_cast<ID3D11Buffer*>(command.object);
+                context->IASetVertexBuffers(command.slot, 1u, &buffer, &command.args[0], &command.args[1]);
+                break;
+            }
+            case CommandType::SET_INDEX_BUFFER:
+            {
+                context->IASetIndexBuffer(static_cast<ID3D11Buffer*>(command.object), static_cast<DXGI_FORMAT>(command.args[0]), command.args[1]);
+                break;
+            }
+            case CommandType::SET_CONSTANT_BUFFER:
+            {
+                auto* buffer = static_cast<ID3D11Buffer*>(command.object);
+                if (command.stage == ShaderStage::VERTEX)
+                {
+                    context->VSSetConstantBuffers(command.slot, 1u, &buffer);
+                }
+                else
+                {
+                    context->PSSetConstantBuffers(command.slot, 1u, &buffer);
+                }
+                break;
+            }
+            case CommandType::SET_SHADER_RESOURCE:
+            {
+                auto* view = static_cast<ID3D11ShaderResourceView*>(command.object);
+                if (command.stage == ShaderStage::VERTEX)
+                {
+                    context->VSSetShaderResources(command.slot, 1u, &view);
+                }
+                else
+                {
+                    context->PSSetShaderResources(command.slot, 1u, &view);
+                }
+                break;
+            }
+            case CommandType::SET_SAMPLER:
+            {
+                auto* sampler = static_cast<ID3D11SamplerState*>(command.object);
+                if (command.stage == ShaderStage::VERTEX)
+                {
+                    context->VSSetSamplers(command.slot, 1u, &sampler);
+                }
+                else
+                {
+                    context->PSSetSamplers(command.slot, 1u, &sampler);
+                }
+                break;
+            }
+            case CommandType::UPDATE_CONSTANTS:
+            {
+                auto* buffer = static_cast<ID3D11Buffer*>(command.object);
+
+                D3D11_MAPPED_SUBRESOURCE mappedData;
+                if (SUCCEEDED(context->Map(buffer, 0u, D3D11_MAP_WRITE_DISCARD, 0u, &mappedData)))
+                {
+                    memcpy(mappedData.pData, commandList.GetPayload(command), command.args[1]);
+                    context->Unmap(buffer, 0u);
+                }
+                break;
+            }
+            case CommandType::DRAW:
+            {
+                context->Draw(command.args[0], command.args[1]);
+                break;
+            }
+            case CommandType::DRAW_INDEXED:
+            {
+                if (command.args[2] == 0u)
+                {
+                    context->DrawIndexed(command.args[0], command.args[1], command.baseVertex);
+                }
+                else
+                {
+                    context->DrawIndexedInstanced(command.args[0], 1u, command.args[1], command.baseVertex, command.args[2]);
+                }
+                break;
+            }
+            default:
+                break;
+        }
+    }
+}
+}  // end namespace
+
+namespace SD::RENDER {
+
+D3D11Renderer::D3D11Renderer(const float width, const float height, const HWND handle)
+    : m_debugLayer(std::make_unique<DebugLayer>())
+{
+    D3D_DEBUG_LAYER(this);
+
+    DXGI_SWAP_CHAIN_DESC sd = {};
+    sd.BufferDesc.Width = static_cast<UINT>(width);
+    sd.BufferDesc.Height = static_cast<UINT>(height);
+    sd.BufferDesc.Format = DXGI_FORMAT_B8G8R8A8_UNORM;
+    sd.BufferDesc.RefreshRate.Numerator = 0;
+    sd.BufferDesc.RefreshRate.Denominator = 0;
+    sd.BufferDesc.Scaling = DXGI_MODE_SCALING_UNSPECIFIED;
+    sd.BufferDesc.ScanlineOrdering = DXGI_MODE_SCANLINE_ORDER_UNSPECIFIED;
+    sd.SampleDesc.Count = 1;
+    sd.SampleDesc.Quality = 0;
+    sd.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
+    sd.BufferCount = 1;
+    sd.OutputWindow = handle;
+    sd.Windowed = TRUE;
+    sd.SwapEffect = DXGI_SWAP_EFFECT_DISCARD;
+    sd.Flags = 0;
+
+    UINT deviceFlags = 0u;
+    if (m_debugLayer->isInitialised())
+    {
+        deviceFlags |= D3D11_CREATE_DEVICE_DEBUG;
+    }
+
+    // create device and front/back buffers, and swap chain and rendering context
+    D3D_THROW_INFO_EXCEPTION(D3D11CreateDeviceAndSwapChain(
+        nullptr,
+        D3D_DRIVER_TYPE_HARDWARE,
+        nullptr,
+        deviceFlags,
+        nullptr,
+        0,
+        D3D11_SDK_VERSION,
+        &sd,
+        m_pSwapChain.GetAddressOf(),
+        m_pD3dDevice.GetAddressOf(),
+        nullptr,
+        m_pD3dContext.GetAddressOf()
+    ));
+
+    createBackBufferView();
+}
+
+D3D11Renderer::~D3D11Renderer() = default;
+
+NativeRenderTargetView* D3D11Renderer::GetRenderTargetView() const
+{
+    return reinterpret_cast<NativeRenderTargetView*>(m_pRenderTargetView.Get());
+}
+
+void D3D11Renderer::Present()
+{
+    D3D_DEBUG_LAYER(this);
+
+    debugLayer->Set();
+
+    HRESULT hr;
+    // First argument for VSync
+    if (FAILED(hr = m_pSwapChain->Present(0u, 0u)))
+    {
+        if (hr == DXGI_ERROR_DEVICE_REMOVED)
+        {
+            throw D3D_EXCEPTION(m_pD3dDevice->GetDeviceRemovedReason());
+        }
+        else
+        {
+            throw D3D_EXCEPTION(hr);
+        }
+    }
+}
+
+void D3D11Renderer::Resize()
+{
+    D3D_DEBUG_LAYER(this);
+
+    D3D_THROW_IF_INFO(m_pD3dContext->OMSetRenderTargets(0, nullptr, nullptr));
+
+    m_pRenderTargetView.Reset();
+
+    // Preserve the existing buffer count and format.
+    // Automatically choose the width and height to match the client rect for HWNDs.
+    D3D_THROW_INFO_EXCEPTION(m_pSwapChain->ResizeBuffers(0, 0, 0, DXGI_FORMAT_UNKNOWN, 0));
+
+    createBackBufferView();
+}
+
+void D3D11Renderer::createBackBufferView()
+{
+    D3D_DEBUG_LAYER(this);
+
+    // gain access to texture subresource in swap chain (back buffer)
+    Microsoft::WRL::ComPtr<ID3D11Resource> pBackBuffer;
+    D3D_THROW_INFO_EXCEPTION(m_pSwapChain->GetBuffer(0, __uuidof(ID3D11Resource), &pBackBuffer));
+    D3D_THROW_INFO_EXCEPTION(m_pD3dDevice->CreateRenderTargetView(pBackBuffer.Get(), nullptr, m_pRenderTargetView.ReleaseAndGetAddressOf()));
+}
+
+BufferHandle D3D11Renderer::CreateBuffer(const BufferDesc& desc, const void* data) const
+{
+    D3D_DEBUG_LAYER(this);
+
+    D3D11_BUFFER_DESC bufferDesc = {};
+    bufferDesc.BindFlags = BUFFER_BIND_FLAGS.at(desc.type);
+    bufferDesc.Usage = desc.dynamic ? D3D11_USAGE_DYNAMIC : D3D11_USAGE_DEFAULT;
+    bufferDesc.CPUAccessFlags = desc.dynamic ? D3D11_CPU_ACCESS_WRITE : 0u;
+    bufferDesc.MiscFlags = desc.type == BufferType::STRUCTURED ? D3D11_RESOURCE_MISC_BUFFER_STRUCTURED : 0u;
+    bufferDesc.ByteWidth = static_cast<UINT>(desc.size);
+    bufferDesc.StructureByteStride = desc.stride;
+
+    D3D11_SUBRESOURCE_DATA bufferData = {};
+    bufferData.pSysMem = data;
+
+    ID3D11Buffer* pBuffer = nullptr;
+    D3D_THROW_INFO_EXCEPTION(m_pD3dDevice->CreateBuffer(&bufferDesc, data ? &bufferData : nullptr, &pBuffer));
+
+    return MakeHandle<NativeBuffer>(pBuffer);
+}
+
+TextureHandle D3D11Renderer::CreateTexture(const TextureDesc& desc, const SubresourceData* data) const
+{
+    D3D_DEBUG_LAYER(this);
+
+    D3D11_TEXTURE2D_DESC textureDesc = {};
+    textureDesc.Width = desc.width;
+    textureDesc.Height = desc.height;
+    textureDesc.MipLevels = desc.mipLevels;
+    textureDesc.ArraySize = desc.arraySize;
+    textureDesc.Format = desc.format;
+    textureDesc.SampleDesc.Count = 1;
+    textureDesc.SampleDesc.Quality = 0;
+    textureDesc.Usage = desc.immutable ? D3D11_USAGE_IMMUTABLE : D3D11_USAGE_DEFAULT;
+    textureDesc.BindFlags = (desc.shaderResource ? D3D11_BIND_SHADER_RESOURCE : 0u)
+        | (desc.renderTarget ? D3D11_BIND_RENDER_TARGET : 0u)
+        | (desc.depthStencil ? D3D11_BIND_DEPTH_STENCIL : 0u);
+    textureDesc.CPUAccessFlags = 0;
+    textureDesc.MiscFlags = desc.cube ? D3D11_RESOURCE_MISC_TEXTURECUBE : 0u;
+
+    std::vector<D3D11_SUBRESOURCE_DATA> initialData;
+    if (data)
+    {
+        initialData.resize(desc.mipLevels);
+        for (uint32_t mip = 0; mip < desc.mipLevels; ++mip)
+        {
+            initialData[mip].pSysMem = data[mip].data;
+            initialData[mip].SysMemPitch = static_cast<UINT>(data[mip].rowPitch);
+        }
+    }
+
+    ID3D11Texture2D* pTexture = nullptr;
+    D3D_THROW_INFO_EXCEPTION(m_pD3dDevice->CreateTexture2D(&textureDesc, data ? initialData.data() : nullptr, &pTexture));
+
+    return MakeHandle<NativeTexture>(pTexture);
+}
+
+ShaderResourceViewHandle D3D11Renderer::CreateShaderResourceView(NativeTexture* texture, const ViewDesc& desc) const
+{
+    D3D_DEBUG_LAYER(this);
+
+    auto* pTexture = ToD3D<ID3D11Texture2D>(texture);
+    D3D11_TEXTURE2D_DESC textureDesc;
+    pTexture->GetDesc(&textureDesc);
+
+    const UINT mipLevels = desc.mipLevels == 0 ? static_cast<UINT>(-1) : desc.mipLevels;
+
+    D3D11_SHADER_RESOURCE_VIEW_DESC viewDesc = {};
+    viewDesc.Format = desc.format;
+    if (desc.cube)
+    {
+        viewDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURECUBE;
+        viewDesc.TextureCube.MostDetailedMip = desc.firstMip;
+        viewDesc.TextureCube.MipLevels = mipLevels;
+    }
+    else if (textureDesc.ArraySize > 1)
+    {
+        viewDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2DARRAY;
+        viewDesc.Texture2DArray.MostDetailedMip = desc.firstMip;
+        viewDesc.Texture2DArray.MipLevels = mipLevels;
+        viewDesc.Texture2DArray.FirstArraySlice = desc.firstSlice;
+        viewDesc.Texture2DArray.ArraySize = desc.sliceCount;
+    }
+    else
+    {
+        viewDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+        viewDesc.Texture2D.MostDetailedMip = desc.firstMip;
+        viewDesc.Texture2D.MipLevels = mipLevels;
+    }
+
+    ID3D11ShaderResourceView* pView = nullptr;
+    D3D_THROW_INFO_EXCEPTION(m_pD3dDevice->CreateShaderResourceView(pTexture, &viewDesc, &pView));
+
+    return MakeHandle<NativeShaderResourceView>(pView);
+}
+
+ShaderResourceViewHandle D3D11Renderer::CreateBufferView(NativeBuffer* buffer, uint32_t elementCount) const
+{
+    D3D_DEBUG_LAYER(this);
+
+    D3D11_SHADER_RESOURCE_VIEW_DESC viewDesc = {};
+    viewDesc.Format = DXGI_FORMAT_UNKNOWN;
+    viewDesc.ViewDimension = D3D11_SRV_DIMENSION_BUFFER;
+    viewDesc.Buffer.FirstElement = 0;
+    viewDesc.Buffer.NumElements = elementCount;
+
+    ID3D11ShaderResourceView* pView = nullptr;
+    D3D_THROW_INFO_EXCEPTION(m_pD3dDevice->CreateShaderResourceView(ToD3D<ID3D11Buffer>(buffer), &viewDesc, &pView));
+
+    return MakeHandle<NativeShaderResourceView>(pView);
+}
+
+RenderTargetViewHandle D3D11Renderer::CreateRenderTargetView(NativeTexture* texture, const ViewDesc& desc) const
+{
+    D3D_DEBUG_LAYER(this);
+
+    auto* pTexture = ToD3D<ID3D11Texture2D>(texture);
+    D3D11_TEXTURE2D_DESC textureDesc;
+    pTexture->GetDesc(&textureDesc);
+
+    D3D11_RENDER_TARGET_VIEW_DESC viewDesc = {};
+    viewDesc.Format = desc.format;
+    if (textureDesc.ArraySize > 1)
+    {
+        viewDesc.ViewDimension = D3D11_RTV_DIMENSION_TEXTURE2DARRAY;
+        viewDesc.Texture2DArray.MipSlice = desc.firstMip;
+        viewDesc.Texture2DArray.FirstArraySlice = desc.firstSlice;
+        viewDesc.Texture2DArray.ArraySize = desc.sliceCount;
+    }
+    else
+    {
+        viewDesc.ViewDimension = D3D11_RTV_DIMENSION_TEXTURE2D;
+        viewDesc.Texture2D.MipSlice = desc.firstMip;
+    }
+
+    ID3D11RenderTargetView* pView = nullptr;
+    D3D_THROW_INFO_EXCEPTION(m_pD3dDevice->CreateRenderTargetView(pTexture, &viewDesc, &pView));
+
+    return MakeHandle<NativeRenderTargetView>(pView);
+}
+
+DepthStencilViewHandle D3D11Renderer::CreateDepthStencilView(NativeTexture* texture, const ViewDesc& desc) const
+{
+    D3D_DEBUG_LAYER(this);
+
+    auto* pTexture = ToD3D<ID3D11Texture2D>(texture);
+    D3D11_TEXTURE2D_DESC textureDesc;
+    pTexture->GetDesc(&textureDesc);
+
+    D3D11_DEPTH_STENCIL_VIEW_DESC viewDesc = {};
+    viewDesc.Format = desc.format;
+    if (textureDesc.ArraySize > 1)
+    {
+        viewDesc.ViewDimension = D3D11_DSV_DIMENSION_TEXTURE2DARRAY;
+        viewDesc.Texture2DArray.MipSlice = desc.firstMip;
+        viewDesc.Texture2DArray.FirstArraySlice = desc.firstSlice;
+        viewDesc.Texture2DArray.ArraySize = desc.sliceCount;
+    }
+    else
+    {
+        viewDesc.ViewDimension = D3D11_DSV_DIMENSION_TEXTURE2D;
+        viewDesc.Texture2D.MipSlice = desc.firstMip;
+    }
+
+    ID3D11DepthStencilView* pView = nullptr;
+    D3D_THROW_INFO_EXCEPTION(m_pD3dDevice->CreateDepthStencilView(pTexture, &viewDesc, &pView));
+
+    return MakeHandle<NativeDepthStencilView>(pView);
+}
+
+DepthStencilStateHandle D3D11Renderer::CreateDepthStencilState(const DepthStencilDesc& desc) const
+{
+    D3D_DEBUG_LAYER(this);
+
+    D3D11_DEPTH_STENCIL_DESC depthStencilDesc = {};
+    depthStencilDesc.DepthEnable = desc.depthTest ? TRUE : FALSE;
+    depthStencilDesc.DepthWriteMask = desc.depthWrite ? D3D11_DEPTH_WRITE_MASK_ALL : D3D11_DEPTH_WRITE_MASK_ZERO;
+    depthStencilDesc.DepthFunc = DEPTH_FUNCS.at(desc.depthFunc);
+
+    ID3D11DepthStencilState* pState = nullptr;
+    D3D_THROW_INFO_EXCEPTION(m_pD3dDevice->CreateDepthStencilState(&depthStencilDesc, &pState));
+
+    return MakeHandle<NativeDepthStencilState>(pState);
+}
+
+BlendStateHandle D3D11Renderer::CreateBlendState(const BlendDesc& desc) const
+{
+    D3D_DEBUG_LAYER(this);
+
+    D3D11_BLEND_DESC blendDesc = {};
+    auto& blendDescRT = blendDesc.RenderTarget[0];
+    if (desc.alphaBlend)
+    {
+        blendDescRT.BlendEnable = TRUE;
+        blendDescRT.SrcBlend = D3D11_BLEND_SRC_ALPHA;
+        blendDescRT.DestBlend = D3D11_BLEND_INV_SRC_ALPHA;
+        blendDescRT.BlendOp = D3D11_BLEND_OP_ADD;
+        blendDescRT.SrcBlendAlpha = D3D11_BLEND_SRC_ALPHA;
+        blendDescRT.DestBlendAlpha = D3D11_BLEND_DEST_ALPHA;
+        blendDescRT.BlendOpAlpha = D3D11_BLEND_OP_ADD;
+    }
+    else
+    {
+        blendDescRT.BlendEnable = FALSE;
+    }
+    blendDescRT.RenderTargetWriteMask = D3D11_COLOR_WRITE_ENABLE_ALL;
+
+    ID3D11BlendState* pState = nullptr;
+    D3D_THROW_INFO_EXCEPTION(m_pD3dDevice->CreateBlendState(&blendDesc, &pState));
+
+    return MakeHandle<NativeBlendState>(pState);
+}
+
+RasterizerStateHandle D3D11Renderer::CreateRasterizerState(const RasterizerDesc& desc) const
+{
+    D3D_DEBUG_LAYER(this);
+
+    D3D11_RASTERIZER_DESC rasterizerDesc = CD3D11_RASTERIZER_DESC(CD3D11_DEFAULT{});
+    rasterizerDesc.CullMode = CULL_MODES.at(desc.cull);
+
+    ID3D11RasterizerState* pState = nullptr;
+    D3D_THROW_INFO_EXCEPTION(m_pD3dDevice->CreateRasterizerState(&rasterizerDesc, &pState));
+
+    return MakeHandle<NativeRasterizerState>(pState);
+}
+
+SamplerStateHandle D3D11Renderer::CreateSamplerState(const SamplerDesc& desc) const
+{
+    D3D_DEBUG_LAYER(this);
+
+    const auto address = ADDRESS_MODES.at(desc.address);
+
+    D3D11_SAMPLER_DESC samplerDesc = {};
+    samplerDesc.Filter = D3D11_FILTER_ANISOTROPIC;
+    samplerDesc.AddressU = address;
+    samplerDesc.AddressV = address;
+    samplerDesc.AddressW = address;
+    samplerDesc.MaxAnisotropy = std::min<UINT>(desc.maxAnisotropy, D3D11_REQ_MAXANISOTROPY);
+    samplerDesc.MipLODBias = 0.0f;
+    samplerDesc.MinLOD = 0.0f;
+    samplerDesc.MaxLOD = D3D11_FLOAT32_MAX;
+
+    ID3D11SamplerState* pState = nullptr;
+    D3D_THROW_INFO_EXCEPTION(m_pD3dDevice->CreateSamplerState(&samplerDesc, &pState));
+
+    return MakeHandle<NativeSamplerState>(pState);
+}
+
+InputLayoutHandle D3D11Renderer::CreateInputLayout(const std::vector<InputElement>& elements, const std::vector<uint8_t>& vsBytecode) const
+{
+    D3D_DEBUG_LAYER(this);
+
+    std::vector<D3D11_INPUT_ELEMENT_DESC> elementDescs;
+    elementDescs.reserve(elements.size());
+    for (const auto& element : elements)
+    {
+        auto& elementDesc = elementDescs.emplace_back();
+        elementDesc.SemanticName = element.semantic.c_str();
+        elementDesc.SemanticIndex = element.semanticIndex;
+        elementDesc.Format = element.format;
+        elementDesc.InputSlot = element.slot;
+        elementDesc.AlignedByteOffset = element.offset;
+        elementDesc.InputSlotClass = element.perInstance ? D3D11_INPUT_PER_INSTANCE_DATA : D3D11_INPUT_PER_VERTEX_DATA;
+        elementDesc.InstanceDataStepRate = element.perInstance ? 1u : 0u;
+    }
+
+    ID3D11InputLayout* pLayout = nullptr;
+    D3D_THROW_INFO_EXCEPTION(m_pD3dDevice->CreateInputLayout(
+        elementDescs.data(), static_cast<UINT>(elementDescs.size()),
+        vsBytecode.data(), vsBytecode.size(),
+        &pLayout
+    ));
+
+    return MakeHandle<NativeInputLayout>(pLayout);
+}
+
+VertexShaderHandle D3D11Renderer::CreateVertexShader(const std::vector<uint8_t>& bytecode) const
+{
+    D3D_DEBUG_LAYER(this);
+
+    ID3D11VertexShader* pShader = nullptr;
+    D3D_THROW_INFO_EXCEPTION(m_pD3dDevice->CreateVertexShader(bytecode.data(), bytecode.size(), nullptr, &pShader));
+
+    return MakeHandle<NativeVertexShader>(pShader);
+}
+
+PixelShaderHandle D3D11Renderer::CreatePixelShader(const std::vector<uint8_t>& bytecode) const
+{
+    D3D_DEBUG_LAYER(this);
+
+    ID3D11PixelShader* pShader = nullptr;
+    D3D_THROW_INFO_EXCEPTION(m_pD3dDevice->CreatePixelShader(bytecode.data(), bytecode.size(), nullptr, &pShader));
+
+    return MakeHandle<NativePixelShader>(pShader);
+}
+
+void D3D11Renderer::SetRenderTarget(NativeRenderTargetView* renderTarget, NativeDepthStencilView* depthStencil) const
+{
+    D3D_DEBUG_LAYER(this);
+
+    auto* pRenderTarget = ToD3D<ID3D11RenderTargetView>(renderTarget);
+    D3D_THROW_IF_INFO(m_pD3dContext->OMSetRenderTargets(1u, &pRenderTarget, ToD3D<ID3D11DepthStencilView>(depthStencil)));
+}
+
+void D3D11Renderer::SetViewport(const Viewport& viewport) const
+{
+    D3D_DEBUG_LAYER(this);
+
+    const D3D11_VIEWPORT vp = ToD3DViewport(viewport);
+    D3D_THROW_IF_INFO(m_pD3dContext->RSSetViewports(1u, &vp));
+}
+
+void D3D11Renderer::SetDepthStencilState(NativeDepthStencilState* state) const
+{
+    D3D_DEBUG_LAYER(this);
+
+    D3D_THROW_IF_INFO(m_pD3dContext->OMSetDepthStencilState(ToD3D<ID3D11DepthStencilState>(state), 1u));
+}
+
+void D3D11Renderer::SetBlendState(NativeBlendState* state) const
+{
+    D3D_DEBUG_LAYER(this);
+
+    D3D_THROW_IF_INFO(m_pD3dContext->OMSetBlendState(ToD3D<ID3D11BlendState>(state), nullptr, 0xFFFFFFFFu));
+}
+
+void D3D11Renderer::SetRasterizerState(NativeRasterizerState* state) const
+{
+    D3D_DEBUG_LAYER(this);
+
+    D3D_THROW_IF_INFO(m_pD3dContext->RSSetState(ToD3D<ID3D11RasterizerState>(state)));
+}
+
+void D3D11Renderer::ClearRenderTarget(NativeRenderTargetView* view, const float color[4]) const
+{
+    D3D_DEBUG_LAYER(this);
+
+    D3D_THROW_IF_INFO(m_pD3dContext->ClearRenderTargetView(ToD3D<ID3D11RenderTargetView>(view), color));
+}
+
+void D3D11Renderer::ClearDepth(NativeDepthStencilView* view, float depth) const
+{
+    D3D_DEBUG_LAYER(this);
+
+    D3D_THROW_IF_INFO(m_pD3dContext->ClearDepthStencilView(ToD3D<ID3D11DepthStencilView>(view), D3D11_CLEAR_DEPTH, depth, 0u));
+}
+
+void D3D11Renderer::SetPrimitiveTopology(PrimitiveTopology topology) const
+{
+    D3D_DEBUG_LAYER(this);
+
+    D3D_THROW_IF_INFO(m_pD3dContext->IASetPrimitiveTopology(PRIMITIVE_TOPOLOGIES.at(topology)));
+}
+
+void D3D11Renderer::SetInputLayout(NativeInputLayout* layout) const
+{
+    D3D_DEBUG_LAYER(this);
+
+    D3D_THROW_IF_INFO(m_pD3dContext->IASetInputLayout(ToD3D<ID3D11InputLayout>(layout)));
+}
+
+void D3D11Renderer::SetVertexBuffer(uint32_t slot, NativeBuffer* buffer, uint32_t stride, uint32_t offset) const
+{
+    D3D_DEBUG_LAYER(this);
+
+    auto* pBuffer = ToD3D<ID3D11Buffer>(buffer);
+    D3D_THROW_IF_INFO(m_pD3dContext->IASetVertexBuffers(slot, 1u, &pBuffer, &stride, &offset));
+}
+
+void D3D11Renderer::SetIndexBuffer(NativeBuffer* buffer, DXGI_FORMAT format, uint32_t offset) const
+{
+    D3D_DEBUG_LAYER(this);
+
+    D3D_THROW_IF_INFO(m_pD3dContext->IASetIndexBuffer(ToD3D<ID3D11Buffer>(buffer), format, offset));
+}
+
+void D3D11Renderer::SetVertexShader(NativeVertexShader* shader) const
+{
+    D3D_DEBUG_LAYER(this);
+
+    D3D_THROW_IF_INFO(m_pD3dContext->VSSetShader(ToD3D<ID3D11VertexShader>(shader), nullptr, 0u));
+}
+
+void D3D11Renderer::SetPixelShader(NativePixelShader* shader) const
+{
+    D3D_DEBUG_LAYER(this);
+
+    D3D_THROW_IF_INFO(m_pD3dContext->PSSetShader(ToD3D<ID3D11PixelShader>(shader), nullptr, 0u));
+}
+
+void D3D11Renderer::SetConstantBuffer(ShaderStage stage, uint32_t slot, NativeBuffer* buffer) const
+{
+    D3D_DEBUG_LAYER(this);
+
+    auto* pBuffer = ToD3D<ID3D11Buffer>(buffer);
+    if (stage == ShaderStage::VERTEX)
+    {
+        D3D_THROW_IF_INFO(m_pD3dContext->VSSetConstantBuffers(slot, 1u, &pBuffer));
+    }
+    else
+    {
+        D3D_THROW_IF_INFO(m_pD3dContext->PSSetConstantBuffers(slot, 1u, &pBuffer));
+    }
+}
+
+void D3D11Renderer::SetShaderResource(ShaderStage stage, uint32_t slot, NativeShaderResourceView* view) const
+{
+    D3D_DEBUG_LAYER(this);
+
+    auto* pView = ToD3D<ID3D11ShaderResourceView>(view);
+    if (stage == ShaderStage::VERTEX)
+    {
+        D3D_THROW_IF_INFO(m_pD3dContext->VSSetShaderResources(slot, 1u, &pView));
+    }
+    else
+    {
+        D3D_THROW_IF_INFO(m_pD3dContext->PSSetShaderResources(slot, 1u, &pView));
+    }
+}
+
+void D3D11Renderer::SetSampler(ShaderStage stage, uint32_t slot, NativeSamplerState* sampler) const
+{
+    D3D_DEBUG_LAYER(this);
+
+    auto* pSampler = ToD3D<ID3D11SamplerState>(sampler);
+    if (stage == ShaderStage::VERTEX)
+    {
+        D3D_THROW_IF_INFO(m_pD3dContext->VSSetSamplers(slot, 1u, &pSampler));
+    }
+    else
+    {
+        D3D_THROW_IF_INFO(m_pD3dContext->PSSetSamplers(slot, 1u, &pSampler));
+    }
+}
+
+void* D3D11Renderer::Map(NativeBuffer* buffer) const
+{
+    D3D_DEBUG_LAYER(this);
+
+    D3D11_MAPPED_SUBRESOURCE mappedData;
+    D3D_THROW_INFO_EXCEPTION(m_pD3dContext->Map(ToD3D<ID3D11Buffer>(buffer), 0u, D3D11_MAP_WRITE_DISCARD, 0u, &mappedData));
+
+    return mappedData.pData;
+}
+
+void D3D11Renderer::Unmap(NativeBuffer* buffer) const
+{
+    D3D_DEBUG_LAYER(this);
+
+    D3D_THROW_IF_INFO(m_pD3dContext->Unmap(ToD3D<ID3D11Buffer>(buffer), 0u));
+}
+
+void D3D11Renderer::UpdateBuffer(NativeBuffer* buffer, size_t offset, const void* data, size_t size) const
+{
+    D3D_DEBUG_LAYER(this);
+
+    D3D11_BOX box = {};
+    box.left = static_cast<UINT>(offset);
+    box.right = static_cast<UINT>(offset + size);
+    box.bottom = 1u;
+    box.back = 1u;
+    D3D_THROW_IF_INFO(m_pD3dContext->UpdateSubresource(ToD3D<ID3D11Buffer>(buffer), 0u, &box, data, 0u, 0u));
+}
+
+void D3D11Renderer::UpdateTexture(NativeTexture* texture, uint32_t mip, uint32_t top, uint32_t bottom, const void* data, size_t rowPitch) const
+{
+    D3D_DEBUG_LAYER(this);
+
+    auto* pTexture = ToD3D<ID3D11Texture2D>(texture);
+    D3D11_TEXTURE2D_DESC textureDesc;
+    pTexture->GetDesc(&textureDesc);
+
+    D3D11_BOX box = {};
+    box.left = 0;
+    box.right = std::max(textureDesc.Width >> mip, 1u);
+    box.top = top;
+    box.bottom = bottom;
+    box.front = 0;
+    box.back = 1;
+
+    const UINT subresource = D3D11CalcSubresource(mip, 0u, textureDesc.MipLevels);
+    D3D_THROW_IF_INFO(m_pD3dContext->UpdateSubresource(pTexture, subresource, &box, data, static_cast<UINT>(rowPitch), 0u));
+}
+
+void D3D11Renderer::DrawIndexed(uint32_t indexCount, uint32_t startIndex, int32_t baseVertex) const
+{
+    D3D_DEBUG_LAYER(this);
+
+    D3D_THROW_IF_INFO(m_pD3dContext->DrawIndexed(indexCount, startIndex, baseVertex));
+}
+
+void D3D11Renderer::ExecuteCommandLists(const std::vector<CommandList>& commandLists, JobSystem& jobSystem)
+{
+    D3D_DEBUG_LAYER(this);
+
+    while (m_deferredContexts.size() < commandLists.size())
+    {
+        auto& context = m_deferredContexts.emplace_back();
+        D3D_THROW_INFO_EXCEPTION(m_pD3dDevice->CreateDeferredContext(0u, context.GetAddressOf()));
+    }
+    m_nativeCommandLists.resize(commandLists.size());
+
+    // translate engine lists into native ones, each deferred context is owned by a single job
+    jobSystem.ParallelFor(commandLists.size(), [&](size_t idx)
+    {
+        const auto& context = m_deferredContexts[idx];
+
+        Playback(commandLists[idx], context.Get());
+        D3D_THROW_NOINFO_EXCEPTION(context->FinishCommandList(FALSE, m_nativeCommandLists[idx].ReleaseAndGetAddressOf()));
+    });
+
+    // execute in recorded order
+    for (auto& nativeCommandList : m_nativeCommandLists)
+    {
+        D3D_THROW_IF_INFO(m_pD3dContext->ExecuteCommandList(nativeCommandList.Get(), TRUE));
+        nativeCommandList.Reset();
+    }
+}
+
+}  // end namespace SD::RENDER
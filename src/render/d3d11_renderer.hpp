@@ -0,0 +1,91 @@
+#pragma once
+
+#include "renderer.hpp"
+
+#include <windows.h>
+
+#include <wrl.h>
+#include <d3d11.h>
+
+
+namespace SD::RENDER {
+
+class DebugLayer;
+
+// Hardware device with a swap chain on a window.
+// Native handles are the D3D11 objects themselves, so they may be passed to D3D11 integrations (ImGui) as they are.
+class D3D11Renderer : public Renderer
+{
+public:
+    D3D11Renderer(const float width, const float height, const HWND handle);
+    ~D3D11Renderer() override;
+
+    DebugLayer* GetDebugLayer() const { return m_debugLayer.get(); }
+
+    // Native objects for third party integrations (ImGui).
+    ID3D11Device* GetDevice() const { return m_pD3dDevice.Get(); }
+    ID3D11DeviceContext* GetContext() const { return m_pD3dContext.Get(); }
+
+    NativeRenderTargetView* GetRenderTargetView() const override;
+
+    bool IsHeadless() const override { return false; }
+
+    void Present() override;
+    void Resize() override;
+
+    BufferHandle CreateBuffer(const BufferDesc& desc, const void* data) const override;
+    TextureHandle CreateTexture(const TextureDesc& desc, const SubresourceData* data) const override;
+    ShaderResourceViewHandle CreateShaderResourceView(NativeTexture* texture, const ViewDesc& desc) const override;
+    ShaderResourceViewHandle CreateBufferView(NativeBuffer* buffer, uint32_t elementCount) const override;
+    RenderTargetViewHandle CreateRenderTargetView(NativeTexture* texture, const ViewDesc& desc) const override;
+    DepthStencilViewHandle CreateDepthStencilView(NativeTexture* texture, const ViewDesc& desc) const override;
+    DepthStencilStateHandle CreateDepthStencilState(const DepthStencilDesc& desc) const override;
+    BlendStateHandle CreateBlendState(const BlendDesc& desc) const override;
+    RasterizerStateHandle CreateRasterizerState(const RasterizerDesc& desc) const override;
+    SamplerStateHandle CreateSamplerState(const SamplerDesc& desc) const override;
+    InputLayoutHandle CreateInputLayout(const std::vector<InputElement>& elements, const std::vector<uint8_t>& vsBytecode) const override;
+    VertexShaderHandle CreateVertexShader(const std::vector<uint8_t>& bytecode) const override;
+    PixelShaderHandle CreatePixelShader(const std::vector<uint8_t>& bytecode) const override;
+
+    void SetRenderTarget(NativeRenderTargetView* renderTarget, NativeDepthStencilView* depthStencil) const override;
+    void SetViewport(const Viewport& viewport) const override;
+    void SetDepthStencilState(NativeDepthStencilState* state) const override;
+    void SetBlendState(NativeBlendState* state) const override;
+    void SetRasterizerState(NativeRasterizerState* state) const override;
+    void ClearRenderTarget(NativeRenderTargetView* view, const float color[4]) const override;
+    void ClearDepth(NativeDepthStencilView* view, float depth) const override;
+    void SetPrimitiveTopology(PrimitiveTopology topology) const override;
+    void SetInputLayout(NativeInputLayout* layout) const override;
+    void SetVertexBuffer(uint32_t slot, NativeBuffer* buffer, uint32_t stride, uint32_t offset) const override;
+    void SetIndexBuffer(NativeBuffer* buffer, DXGI_FORMAT format, uint32_t offset) const override;
+    void SetVertexShader(NativeVertexShader* shader) const override;
+    void SetPixelShader(NativePixelShader* shader) const override;
+    void SetConstantBuffer(ShaderStage stage, uint32_t slot, NativeBuffer* buffer) const override;
+    void SetShaderResource(ShaderStage stage, uint32_t slot, NativeShaderResourceView* view) const override;
+    void SetSampler(ShaderStage stage, uint32_t slot, NativeSamplerState* sampler) const override;
+    void* Map(NativeBuffer* buffer) const override;
+    void Unmap(NativeBuffer* buffer) const override;
+    void UpdateBuffer(NativeBuffer* buffer, size_t offset, const void* data, size_t size) const override;
+    void UpdateTexture(NativeTexture* texture, uint32_t mip, uint32_t top, uint32_t bottom, const void* data, size_t rowPitch) const override;
+    void DrawIndexed(uint32_t indexCount, uint32_t startIndex, int32_t baseVertex) const override;
+
+    // Plays command lists back into deferred contexts on the job system
+    // and executes the produced native command lists in order on the immediate context.
+    void ExecuteCommandLists(const std::vector<CommandList>& commandLists, JobSystem& jobSystem) override;
+
+private:
+    void createBackBufferView();
+
+private:
+    std::unique_ptr<DebugLayer> m_debugLayer;
+
+    Microsoft::WRL::ComPtr<ID3D11Device> m_pD3dDevice;
+    Microsoft::WRL::ComPtr<IDXGISwapChain> m_pSwapChain;
+    Microsoft::WRL::ComPtr<ID3D11DeviceContext> m_pD3dContext;
+    Microsoft::WRL::ComPtr<ID3D11RenderTargetView> m_pRenderTargetView;
+
+    std::vector<Microsoft::WRL::ComPtr<ID3D11DeviceContext>> m_deferredContexts;
+    std::vector<Microsoft::WRL::ComPtr<ID3D11CommandList>> m_nativeCommandLists;
+};
+
+}  // end namespace SD::RENDER
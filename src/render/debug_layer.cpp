@@ -46,6 +46,16 @@ bool DebugLayer::isInitialised() const
 	return m_pDxgiInfoQueue != nullptr;
 }
 
+std::unique_lock<std::mutex> DebugLayer::Lock()
+{
+	if (!isInitialised())
+	{
+		return {};
+	}
+
+	return std::unique_lock<std::mutex>(m_mutex);
+}
+
 void DebugLayer::Set() noexcept
 {
 	if (!isInitialised())
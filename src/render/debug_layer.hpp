@@ -1,6 +1,7 @@
 #pragma once
 
 #include <wrl.h>
+#include <mutex>
 #include <vector>
 #include <string>
 #include <dxgidebug.h>
@@ -19,10 +20,15 @@ public:
 
 	bool isInitialised() const;
 
+	// Held from Set until GetMessages, so messages of a call made on another thread are not reported for this one.
+	// Not locked without an info queue.
+	std::unique_lock<std::mutex> Lock();
+
 	void Set() noexcept;
 	std::vector<std::string> GetMessages() const;
 
 private:
+	std::mutex m_mutex;  // resources may be created from several threads
 	unsigned long long m_start = 0u;
 	Microsoft::WRL::ComPtr<IDXGIInfoQueue> m_pDxgiInfoQueue = nullptr;
 };
@@ -1,53 +1,65 @@
 #pragma once
 
-#include <cstdint>
-#include <d3d11.h>
-#include <wrl/client.h>
+#include "renderer.hpp"
 
+#include <cstdint>
 #include <vector>
 
 
 namespace SD::RENDER {
 
-class Renderer;
+class CommandList;
+class StateLibrary;
+
+enum class DepthMode : uint8_t
+{
+	DISABLED,
+	ENABLED,
+	READ_ONLY,  // test without writes, for blended geometry
+	EQUAL  // only fragments laid down by the depth prepass, without writes
+};
 
 class FrameBuffer
 {
 public:
-	FrameBuffer(Renderer* renderer, const float width, const float height, DXGI_FORMAT format = DXGI_FORMAT_B8G8R8A8_UNORM);
+	FrameBuffer(Renderer* renderer, StateLibrary* stateLibrary, const float width, const float height, DXGI_FORMAT format = DXGI_FORMAT_B8G8R8A8_UNORM);
 	~FrameBuffer() = default;
 
 	void bind(Renderer* renderer, bool depth = true) const;
+	void bind(CommandList& commandList, DepthMode depthMode = DepthMode::ENABLED) const;
+	void bindDepth(CommandList& commandList, DepthMode depthMode) const;
 
-	Microsoft::WRL::ComPtr<ID3D11RenderTargetView> getRTV() const { return m_pRenderTargetView; }
-	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> getSRV() const { return m_pShaderResourceView; }
-	Microsoft::WRL::ComPtr<ID3D11DepthStencilView> getDSV() const { return m_pDepthStencilView; }
+	NativeRenderTargetView* getRTV() const { return m_pRenderTargetView.get(); }
+	NativeShaderResourceView* getSRV() const { return m_pShaderResourceView.get(); }
+	NativeDepthStencilView* getDSV() const { return m_pDepthStencilView.get(); }
 
-	void resize(Renderer* renderer, const UINT width, const UINT height);
+	void resize(Renderer* renderer, const uint32_t width, const uint32_t height);
 
-	UINT width() const { return m_width; }
-	UINT height() const { return m_height; }
+	uint32_t width() const { return m_width; }
+	uint32_t height() const { return m_height; }
 
 private:
 	void createTextures(const Renderer* renderer);
 	void createViews(const Renderer* renderer);
-	void createStates(const Renderer* renderer);
+	void createStates(StateLibrary* stateLibrary);
 
 private:
-	UINT m_width;
-	UINT m_height;
+	uint32_t m_width;
+	uint32_t m_height;
 
 	DXGI_FORMAT m_format;
 
-	Microsoft::WRL::ComPtr<ID3D11Texture2D> m_pRenderTarget;
-	Microsoft::WRL::ComPtr<ID3D11Texture2D> m_pDepthStencil;
+	TextureHandle m_pRenderTarget;
+	TextureHandle m_pDepthStencil;
 
-	Microsoft::WRL::ComPtr<ID3D11RenderTargetView> m_pRenderTargetView;
-	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> m_pShaderResourceView;
-	Microsoft::WRL::ComPtr<ID3D11DepthStencilView> m_pDepthStencilView;
+	RenderTargetViewHandle m_pRenderTargetView;
+	ShaderResourceViewHandle m_pShaderResourceView;
+	DepthStencilViewHandle m_pDepthStencilView;
 
-	Microsoft::WRL::ComPtr<ID3D11DepthStencilState> m_pDepthStencilStateEnabled;
-	Microsoft::WRL::ComPtr<ID3D11DepthStencilState> m_pDepthStencilStateDisabled;
+	DepthStencilStateHandle m_pDepthStencilStateEnabled;
+	DepthStencilStateHandle m_pDepthStencilStateDisabled;
+	DepthStencilStateHandle m_pDepthStencilStateReadOnly;
+	DepthStencilStateHandle m_pDepthStencilStateEqual;
 };
 
 
@@ -56,36 +68,36 @@ class CubeFrameBuffer
 private:
 	static constexpr uint8_t FACE_COUNT = 6;
 public:
-	CubeFrameBuffer(Renderer* renderer, const float size, const uint8_t mips = 1u);
+	CubeFrameBuffer(Renderer* renderer, StateLibrary* stateLibrary, const float size, const uint8_t mips = 1u);
 	~CubeFrameBuffer() = default;
 
 	void bind(Renderer* renderer) const;
 
-	Microsoft::WRL::ComPtr<ID3D11RenderTargetView> getRTV(uint8_t face, uint8_t mip = 0u) const { return m_pRenderTargetView[face][mip]; }
-	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> getSRV() const { return m_pShaderResourceView; }
-	Microsoft::WRL::ComPtr<ID3D11DepthStencilView> getDSV(uint8_t face, uint8_t mip = 0u) const { return m_pDepthStencilView[face][mip]; }
+	NativeRenderTargetView* getRTV(uint8_t face, uint8_t mip = 0u) const { return m_pRenderTargetView[face][mip].get(); }
+	NativeShaderResourceView* getSRV() const { return m_pShaderResourceView.get(); }
+	NativeDepthStencilView* getDSV(uint8_t face, uint8_t mip = 0u) const { return m_pDepthStencilView[face][mip].get(); }
 
-	void resize(Renderer* renderer, const UINT size);
+	void resize(Renderer* renderer, const uint32_t size);
 
-	UINT size() const { return m_size; }
+	uint32_t size() const { return m_size; }
 
 private:
 	void createTextures(const Renderer* renderer);
 	void createViews(const Renderer* renderer);
-	void createStates(const Renderer* renderer);
+	void createStates(StateLibrary* stateLibrary);
 
 private:
-	UINT m_size;
-	UINT m_mips;
+	uint32_t m_size;
+	uint32_t m_mips;
 
-	Microsoft::WRL::ComPtr<ID3D11Texture2D> m_pRenderTarget;
-	Microsoft::WRL::ComPtr<ID3D11Texture2D> m_pDepthStencil;
+	TextureHandle m_pRenderTarget;
+	TextureHandle m_pDepthStencil;
 
-	std::vector<Microsoft::WRL::ComPtr<ID3D11RenderTargetView>> m_pRenderTargetView[6];
-	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> m_pShaderResourceView;
-	std::vector<Microsoft::WRL::ComPtr<ID3D11DepthStencilView>> m_pDepthStencilView[6];
+	std::vector<RenderTargetViewHandle> m_pRenderTargetView[6];
+	ShaderResourceViewHandle m_pShaderResourceView;
+	std::vector<DepthStencilViewHandle> m_pDepthStencilView[6];
 
-	Microsoft::WRL::ComPtr<ID3D11DepthStencilState> m_pDepthStencilState;
+	DepthStencilStateHandle m_pDepthStencilState;
 };
 
 }  // end namespace SD::RENDER
@@ -1,27 +1,30 @@
 #include "index_buffer.hpp"
 
-#include "renderer.hpp"
-#include "debug_layer.hpp"
-#include <exceptions.hpp>
+#include "command_list.hpp"
 
 
 namespace SD::RENDER {
 
-void IndexBuffer::Bind(Renderer* renderer, UINT, UINT, UINT offset) const
+IndexBuffer::IndexBuffer(DXGI_FORMAT format)
+	: m_format(format)
 {
-	D3D_DEBUG_LAYER(renderer);
+}
 
-	D3D_THROW_IF_INFO(renderer->GetContext()->IASetIndexBuffer(m_pBuffer.Get(), DXGI_FORMAT_R16_UINT, offset));
+void IndexBuffer::Bind(Renderer* renderer, uint32_t, uint32_t, uint32_t offset) const
+{
+	renderer->SetIndexBuffer(m_pBuffer.get(), m_format, offset);
+}
+
+void IndexBuffer::Bind(CommandList& commandList, uint32_t, uint32_t, uint32_t offset) const
+{
+	commandList.SetIndexBuffer(m_pBuffer.get(), m_format, offset);
 }
 
-D3D11_BUFFER_DESC IndexBuffer::getDescriptor(const size_t byteLength) const
+BufferDesc IndexBuffer::getDescriptor(const size_t byteLength) const
 {
-	D3D11_BUFFER_DESC bufferDesc = {};
-	bufferDesc.BindFlags = D3D11_BIND_INDEX_BUFFER;
-	bufferDesc.Usage = D3D11_USAGE_DEFAULT;
-	bufferDesc.CPUAccessFlags = 0u;
-	bufferDesc.MiscFlags = 0u;
-	bufferDesc.ByteWidth = static_cast<UINT>(byteLength);
+	BufferDesc bufferDesc;
+	bufferDesc.type = BufferType::INDEX;
+	bufferDesc.size = byteLength;
 
 	return bufferDesc;
 }
@@ -8,13 +8,19 @@ namespace SD::RENDER {
 class IndexBuffer : public Buffer
 {
 public:
-	IndexBuffer() = default;
+	IndexBuffer(DXGI_FORMAT format = DXGI_FORMAT_R16_UINT);
 	~IndexBuffer() override = default;
 
-	void Bind(Renderer* renderer, UINT slot, UINT stride, UINT offset) const override;
+	DXGI_FORMAT GetFormat() const { return m_format; }
+
+	void Bind(Renderer* renderer, uint32_t slot, uint32_t stride, uint32_t offset) const override;
+	void Bind(CommandList& commandList, uint32_t slot, uint32_t stride, uint32_t offset) const override;
 
 protected:
-	D3D11_BUFFER_DESC getDescriptor(const size_t byteLength) const override;
+	BufferDesc getDescriptor(const size_t byteLength) const override;
+
+private:
+	DXGI_FORMAT m_format;
 };
 
 }  // end namespace SD::RENDER
@@ -1,28 +1,23 @@
 #include "input_layout.hpp"
 
-#include "renderer.hpp"
-#include "debug_layer.hpp"
-#include <exceptions.hpp>
+#include "command_list.hpp"
 
 
 namespace SD::RENDER {
 
-InputLayout::InputLayout(Renderer* renderer, const std::vector<D3D11_INPUT_ELEMENT_DESC>& layout, ID3DBlob* pVSBytecode)
+InputLayout::InputLayout(Renderer* renderer, const std::vector<InputElement>& layout, const std::vector<uint8_t>& vsBytecode)
 {
-	D3D_DEBUG_LAYER(renderer);
-
-	D3D_THROW_INFO_EXCEPTION(renderer->GetDevice()->CreateInputLayout(
-		layout.data(), static_cast<UINT>(layout.size()),
-		pVSBytecode->GetBufferPointer(), pVSBytecode->GetBufferSize(),
-		m_pInputLayout.GetAddressOf()
-	));
+	m_pInputLayout = renderer->CreateInputLayout(layout, vsBytecode);
 }
 
 void InputLayout::Bind(Renderer* renderer)
 {
-	D3D_DEBUG_LAYER(renderer);
+	renderer->SetInputLayout(m_pInputLayout.get());
+}
 
-	D3D_THROW_IF_INFO(renderer->GetContext()->IASetInputLayout(m_pInputLayout.Get()));
+void InputLayout::Bind(CommandList& commandList) const
+{
+	commandList.SetInputLayout(m_pInputLayout.get());
 }
 
 }  // end namespace SD::RENDER
@@ -1,24 +1,22 @@
 #pragma once
 
-#include <d3d11.h>
-#include <wrl/client.h>
-
-#include <vector>
+#include "renderer.hpp"
 
 
 namespace SD::RENDER {
 
-	class Renderer;
+	class CommandList;
 
 class InputLayout
 {
 public:
-	InputLayout(Renderer* renderer, const std::vector<D3D11_INPUT_ELEMENT_DESC>& layout, ID3DBlob* pVSBytecode);
+	InputLayout(Renderer* renderer, const std::vector<InputElement>& layout, const std::vector<uint8_t>& vsBytecode);
 
 	void Bind(Renderer* renderer);
+	void Bind(CommandList& commandList) const;
 
 private:
-	Microsoft::WRL::ComPtr<ID3D11InputLayout> m_pInputLayout;
+	InputLayoutHandle m_pInputLayout;
 };
 
 }  // end namespace SD::RENDER
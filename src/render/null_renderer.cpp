@@ -0,0 +1,391 @@
+#include "null_renderer.hpp"
+
+#include "job_system.hpp"
+
+#include "command_list.hpp"
+
+#include <algorithm>
+
+
+namespace
+{
+// Memory of a dynamic buffer, the native object behind its handle.
+struct NullBuffer
+{
+    std::vector<uint8_t> memory;
+};
+
+// Bytes per 4x4 block of block compressed formats, 0 for the rest.
+size_t GetBlockBytes(DXGI_FORMAT format)
+{
+    switch (format)
+    {
+    case DXGI_FORMAT_BC1_TYPELESS:
+    case DXGI_FORMAT_BC1_UNORM:
+    case DXGI_FORMAT_BC1_UNORM_SRGB:
+    case DXGI_FORMAT_BC4_TYPELESS:
+    case DXGI_FORMAT_BC4_UNORM:
+    case DXGI_FORMAT_BC4_SNORM:
+        return 8;
+    case DXGI_FORMAT_BC2_TYPELESS:
+    case DXGI_FORMAT_BC2_UNORM:
+    case DXGI_FORMAT_BC2_UNORM_SRGB:
+    case DXGI_FORMAT_BC3_TYPELESS:
+    case DXGI_FORMAT_BC3_UNORM:
+    case DXGI_FORMAT_BC3_UNORM_SRGB:
+    case DXGI_FORMAT_BC5_TYPELESS:
+    case DXGI_FORMAT_BC5_UNORM:
+    case DXGI_FORMAT_BC5_SNORM:
+    case DXGI_FORMAT_BC6H_TYPELESS:
+    case DXGI_FORMAT_BC6H_UF16:
+    case DXGI_FORMAT_BC6H_SF16:
+    case DXGI_FORMAT_BC7_TYPELESS:
+    case DXGI_FORMAT_BC7_UNORM:
+    case DXGI_FORMAT_BC7_UNORM_SRGB:
+        return 16;
+    default:
+        return 0;
+    }
+}
+
+// Formats the engine creates, the rest is counted as 32 bits per texel.
+size_t GetBitsPerTexel(DXGI_FORMAT format)
+{
+    switch (format)
+    {
+    case DXGI_FORMAT_R32G32B32A32_FLOAT:
+        return 128;
+    case DXGI_FORMAT_R32G32B32_FLOAT:
+        return 96;
+    case DXGI_FORMAT_R16G16B16A16_FLOAT:
+    case DXGI_FORMAT_R16G16B16A16_UNORM:
+    case DXGI_FORMAT_R32G32_FLOAT:
+        return 64;
+    case DXGI_FORMAT_R8G8_UNORM:
+    case DXGI_FORMAT_R16_FLOAT:
+    case DXGI_FORMAT_R16_UNORM:
+    case DXGI_FORMAT_D16_UNORM:
+        return 16;
+    case DXGI_FORMAT_R8_UNORM:
+    case DXGI_FORMAT_A8_UNORM:
+        return 8;
+    default:
+        return 32;
+    }
+}
+
+size_t GetMipBytes(DXGI_FORMAT format, size_t width, size_t height)
+{
+    const size_t blockBytes = GetBlockBytes(format);
+    if (blockBytes > 0)
+    {
+        return ((width + 3) / 4) * ((height + 3) / 4) * blockBytes;
+    }
+
+    return width * height * GetBitsPerTexel(format) / 8;
+}
+}  // end namespace
+
+namespace SD::RENDER {
+
+NullRenderer::NullRenderer() = default;
+
+NullRenderer::~NullRenderer() = default;
+
+RendererStats NullRenderer::GetStats() const
+{
+    RendererStats stats;
+    stats.calls = m_calls;
+    stats.draws = m_draws;
+    stats.primitives = m_primitives;
+    stats.buffers = m_buffers;
+    stats.textures = m_textures;
+    stats.views = m_views;
+    stats.shaders = m_shaders;
+    stats.states = m_states;
+    stats.bufferBytes = m_bufferBytes;
+    stats.textureBytes = m_textureBytes;
+    stats.uploadBytes = m_uploadBytes;
+
+    return stats;
+}
+
+void NullRenderer::Present()
+{
+    countCall();
+}
+
+void NullRenderer::Resize()
+{
+    countCall();
+}
+
+BufferHandle NullRenderer::CreateBuffer(const BufferDesc& desc, const void* data) const
+{
+    countCall();
+
+    m_buffers++;
+    m_bufferBytes += desc.size;
+    if (data)
+    {
+        m_uploadBytes += desc.size;
+    }
+
+    if (!desc.dynamic)
+    {
+        return nullptr;
+    }
+
+    // each buffer maps its own memory, so buffers may be written from several threads
+    auto* buffer = new NullBuffer();
+    buffer->memory.resize(desc.size);
+
+    return BufferHandle(reinterpret_cast<NativeBuffer*>(buffer), [](NativeBuffer* native)
+    {
+        delete reinterpret_cast<NullBuffer*>(native);
+    });
+}
+
+TextureHandle NullRenderer::CreateTexture(const TextureDesc& desc, const SubresourceData* data) const
+{
+    countCall();
+
+    // size of all subresources, block compressed formats included
+    size_t bytes = 0;
+    for (uint32_t mip = 0; mip < std::max(desc.mipLevels, 1u); ++mip)
+    {
+        const size_t width = std::max(desc.width >> mip, 1u);
+        const size_t height = std::max(desc.height >> mip, 1u);
+
+        bytes += GetMipBytes(desc.format, width, height) * desc.arraySize;
+    }
+
+    m_textures++;
+    m_textureBytes += bytes;
+    if (data)
+    {
+        m_uploadBytes += bytes;
+    }
+
+    return nullptr;
+}
+
+ShaderResourceViewHandle NullRenderer::CreateShaderResourceView(NativeTexture*, const ViewDesc&) const
+{
+    countCall();
+    m_views++;
+
+    return nullptr;
+}
+
+ShaderResourceViewHandle NullRenderer::CreateBufferView(NativeBuffer*, uint32_t) const
+{
+    countCall();
+    m_views++;
+
+    return nullptr;
+}
+
+RenderTargetViewHandle NullRenderer::CreateRenderTargetView(NativeTexture*, const ViewDesc&) const
+{
+    countCall();
+    m_views++;
+
+    return nullptr;
+}
+
+DepthStencilViewHandle NullRenderer::CreateDepthStencilView(NativeTexture*, const ViewDesc&) const
+{
+    countCall();
+    m_views++;
+
+    return nullptr;
+}
+
+DepthStencilStateHandle NullRenderer::CreateDepthStencilState(const DepthStencilDesc&) const
+{
+    countCall();
+    m_states++;
+
+    return nullptr;
+}
+
+BlendStateHandle NullRenderer::CreateBlendState(const BlendDesc&) const
+{
+    countCall();
+    m_states++;
+
+    return nullptr;
+}
+
+RasterizerStateHandle NullRenderer::CreateRasterizerState(const RasterizerDesc&) const
+{
+    countCall();
+    m_states++;
+
+    return nullptr;
+}
+
+SamplerStateHandle NullRenderer::CreateSamplerState(const SamplerDesc&) const
+{
+    countCall();
+    m_states++;
+
+    return nullptr;
+}
+
+InputLayoutHandle NullRenderer::CreateInputLayout(const std::vector<InputElement>&, const std::vector<uint8_t>&) const
+{
+    countCall();
+    m_states++;
+
+    return nullptr;
+}
+
+VertexShaderHandle NullRenderer::CreateVertexShader(const std::vector<uint8_t>&) const
+{
+    countCall();
+    m_shaders++;
+
+    return nullptr;
+}
+
+PixelShaderHandle NullRenderer::CreatePixelShader(const std::vector<uint8_t>&) const
+{
+    countCall();
+    m_shaders++;
+
+    return nullptr;
+}
+
+void NullRenderer::SetRenderTarget(NativeRenderTargetView*, NativeDepthStencilView*) const
+{
+    countCall();
+}
+
+void NullRenderer::SetViewport(const Viewport&) const
+{
+    countCall();
+}
+
+void NullRenderer::SetDepthStencilState(NativeDepthStencilState*) const
+{
+    countCall();
+}
+
+void NullRenderer::SetBlendState(NativeBlendState*) const
+{
+    countCall();
+}
+
+void NullRenderer::SetRasterizerState(NativeRasterizerState*) const
+{
+    countCall();
+}
+
+void NullRenderer::ClearRenderTarget(NativeRenderTargetView*, const float[4]) const
+{
+    countCall();
+}
+
+void NullRenderer::ClearDepth(NativeDepthStencilView*, float) const
+{
+    countCall();
+}
+
+void NullRenderer::SetPrimitiveTopology(PrimitiveTopology) const
+{
+    countCall();
+}
+
+void NullRenderer::SetInputLayout(NativeInputLayout*) const
+{
+    countCall();
+}
+
+void NullRenderer::SetVertexBuffer(uint32_t, NativeBuffer*, uint32_t, uint32_t) const
+{
+    countCall();
+}
+
+void NullRenderer::SetIndexBuffer(NativeBuffer*, DXGI_FORMAT, uint32_t) const
+{
+    countCall();
+}
+
+void NullRenderer::SetVertexShader(NativeVertexShader*) const
+{
+    countCall();
+}
+
+void NullRenderer::SetPixelShader(NativePixelShader*) const
+{
+    countCall();
+}
+
+void NullRenderer::SetConstantBuffer(ShaderStage, uint32_t, NativeBuffer*) const
+{
+    countCall();
+}
+
+void NullRenderer::SetShaderResource(ShaderStage, uint32_t, NativeShaderResourceView*) const
+{
+    countCall();
+}
+
+void NullRenderer::SetSampler(ShaderStage, uint32_t, NativeSamplerState*) const
+{
+    countCall();
+}
+
+void* NullRenderer::Map(NativeBuffer* buffer) const
+{
+    countCall();
+
+    if (!buffer)
+    {
+        return nullptr;
+    }
+
+    return reinterpret_cast<NullBuffer*>(buffer)->memory.data();
+}
+
+void NullRenderer::Unmap(NativeBuffer*) const
+{
+    countCall();
+}
+
+void NullRenderer::UpdateBuffer(NativeBuffer*, size_t, const void*, size_t size) const
+{
+    countCall();
+
+    m_uploadBytes += size;
+}
+
+void NullRenderer::UpdateTexture(NativeTexture*, uint32_t, uint32_t, uint32_t, const void*, size_t) const
+{
+    countCall();
+}
+
+void NullRenderer::DrawIndexed(uint32_t indexCount, uint32_t, int32_t) const
+{
+    countCall();
+
+    m_draws++;
+    m_primitives += indexCount / 3;
+}
+
+void NullRenderer::ExecuteCommandLists(const std::vector<CommandList>& commandLists, JobSystem&)
+{
+    for (const auto& commandList : commandLists)
+    {
+        const auto& stats = commandList.GetStats();
+
+        m_calls += stats.commands;
+        m_draws += stats.draws;
+        m_primitives += stats.primitives;
+        m_uploadBytes += stats.constantBytes;
+    }
+}
+
+}  // end namespace SD::RENDER
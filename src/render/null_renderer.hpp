@@ -0,0 +1,84 @@
+#pragma once
+
+#include "renderer.hpp"
+
+#include <atomic>
+
+
+namespace SD::RENDER {
+
+// Backend without a device for headless runs.
+// Accepts every call and does no GPU work, only counts calls and bytes that would have been sent to the device.
+// Dynamic buffers own system memory for Map, every other object is a null handle.
+class NullRenderer : public Renderer
+{
+public:
+    NullRenderer();
+    ~NullRenderer() override;
+
+    NativeRenderTargetView* GetRenderTargetView() const override { return nullptr; }
+
+    bool IsHeadless() const override { return true; }
+    RendererStats GetStats() const override;
+
+    void Present() override;
+    void Resize() override;
+
+    BufferHandle CreateBuffer(const BufferDesc& desc, const void* data) const override;
+    TextureHandle CreateTexture(const TextureDesc& desc, const SubresourceData* data) const override;
+    ShaderResourceViewHandle CreateShaderResourceView(NativeTexture* texture, const ViewDesc& desc) const override;
+    ShaderResourceViewHandle CreateBufferView(NativeBuffer* buffer, uint32_t elementCount) const override;
+    RenderTargetViewHandle CreateRenderTargetView(NativeTexture* texture, const ViewDesc& desc) const override;
+    DepthStencilViewHandle CreateDepthStencilView(NativeTexture* texture, const ViewDesc& desc) const override;
+    DepthStencilStateHandle CreateDepthStencilState(const DepthStencilDesc& desc) const override;
+    BlendStateHandle CreateBlendState(const BlendDesc& desc) const override;
+    RasterizerStateHandle CreateRasterizerState(const RasterizerDesc& desc) const override;
+    SamplerStateHandle CreateSamplerState(const SamplerDesc& desc) const override;
+    InputLayoutHandle CreateInputLayout(const std::vector<InputElement>& elements, const std::vector<uint8_t>& vsBytecode) const override;
+    VertexShaderHandle CreateVertexShader(const std::vector<uint8_t>& bytecode) const override;
+    PixelShaderHandle CreatePixelShader(const std::vector<uint8_t>& bytecode) const override;
+
+    void SetRenderTarget(NativeRenderTargetView* renderTarget, NativeDepthStencilView* depthStencil) const override;
+    void SetViewport(const Viewport& viewport) const override;
+    void SetDepthStencilState(NativeDepthStencilState* state) const override;
+    void SetBlendState(NativeBlendState* state) const override;
+    void SetRasterizerState(NativeRasterizerState* state) const override;
+    void ClearRenderTarget(NativeRenderTargetView* view, const float color[4]) const override;
+    void ClearDepth(NativeDepthStencilView* view, float depth) const override;
+    void SetPrimitiveTopology(PrimitiveTopology topology) const override;
+    void SetInputLayout(NativeInputLayout* layout) const override;
+    void SetVertexBuffer(uint32_t slot, NativeBuffer* buffer, uint32_t stride, uint32_t offset) const override;
+    void SetIndexBuffer(NativeBuffer* buffer, DXGI_FORMAT format, uint32_t offset) const override;
+    void SetVertexShader(NativeVertexShader* shader) const override;
+    void SetPixelShader(NativePixelShader* shader) const override;
+    void SetConstantBuffer(ShaderStage stage, uint32_t slot, NativeBuffer* buffer) const override;
+    void SetShaderResource(ShaderStage stage, uint32_t slot, NativeShaderResourceView* view) const override;
+    void SetSampler(ShaderStage stage, uint32_t slot, NativeSamplerState* sampler) const override;
+    void* Map(NativeBuffer* buffer) const override;
+    void Unmap(NativeBuffer* buffer) const override;
+    void UpdateBuffer(NativeBuffer* buffer, size_t offset, const void* data, size_t size) const override;
+    void UpdateTexture(NativeTexture* texture, uint32_t mip, uint32_t top, uint32_t bottom, const void* data, size_t rowPitch) const override;
+    void DrawIndexed(uint32_t indexCount, uint32_t startIndex, int32_t baseVertex) const override;
+
+    // Command lists are only counted, nothing is played back.
+    void ExecuteCommandLists(const std::vector<CommandList>& commandLists, JobSystem& jobSystem) override;
+
+private:
+    void countCall() const { m_calls++; }
+
+private:
+    // creation may happen on worker threads
+    mutable std::atomic<size_t> m_calls{ 0 };
+    mutable std::atomic<size_t> m_draws{ 0 };
+    mutable std::atomic<size_t> m_primitives{ 0 };
+    mutable std::atomic<size_t> m_buffers{ 0 };
+    mutable std::atomic<size_t> m_textures{ 0 };
+    mutable std::atomic<size_t> m_views{ 0 };
+    mutable std::atomic<size_t> m_shaders{ 0 };
+    mutable std::atomic<size_t> m_states{ 0 };
+    mutable std::atomic<size_t> m_bufferBytes{ 0 };
+    mutable std::atomic<size_t> m_textureBytes{ 0 };
+    mutable std::atomic<size_t> m_uploadBytes{ 0 };
+};
+
+}  // end namespace SD::RENDER
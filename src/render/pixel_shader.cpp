@@ -1,34 +1,48 @@
 #include "pixel_shader.hpp"
 
-#include <d3dcompiler.h>
-
-#include "renderer.hpp"
-#include "debug_layer.hpp"
+#include "command_list.hpp"
 #include <exceptions.hpp>
 
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+
+namespace
+{
+std::vector<uint8_t> ReadBytecode(const std::wstring& path)
+{
+	std::ifstream file(std::filesystem::path(path), std::ios::binary);
+	if (!file)
+	{
+		throw SD::SomeException(__LINE__, __FILEW__, L"Failed to read shader " + path);
+	}
+
+	return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+}  // end namespace
 
 namespace SD::RENDER {
 
 PixelShader::PixelShader(Renderer* renderer, const std::wstring& name)
+	: m_bytecode(ReadBytecode(PS_PATH + name))
 {
-	D3D_DEBUG_LAYER(renderer);
-
-	D3D_THROW_INFO_EXCEPTION(D3DReadFileToBlob((PS_PATH + name).c_str(), m_pBytecodeBlob.GetAddressOf()));
-	D3D_THROW_INFO_EXCEPTION(renderer->GetDevice()->CreatePixelShader(
-		m_pBytecodeBlob->GetBufferPointer(), m_pBytecodeBlob->GetBufferSize(), nullptr, m_pPixelShader.GetAddressOf())
-	);
+	m_pPixelShader = renderer->CreatePixelShader(m_bytecode);
 }
 
 void PixelShader::Bind(Renderer* renderer)
 {
-	D3D_DEBUG_LAYER(renderer);
+	renderer->SetPixelShader(m_pPixelShader.get());
+}
 
-	D3D_THROW_IF_INFO(renderer->GetContext()->PSSetShader(m_pPixelShader.Get(), nullptr, 0u));
+void PixelShader::Bind(CommandList& commandList) const
+{
+	commandList.SetPixelShader(m_pPixelShader.get());
 }
 
-ID3DBlob* PixelShader::GetBytecode() const
+const std::vector<uint8_t>& PixelShader::GetBytecode() const
 {
-	return m_pBytecodeBlob.Get();
+	return m_bytecode;
 }
 
 }  // end namespace SD::RENDER
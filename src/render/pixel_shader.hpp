@@ -1,7 +1,6 @@
 #pragma once
 
-#include <d3d11.h>
-#include <wrl.h>
+#include "renderer.hpp"
 
 #include <string>
 
@@ -10,7 +9,7 @@ namespace SD::RENDER {
 
 const std::wstring PS_PATH = L"src\\shaders\\";
 
-class Renderer;
+class CommandList;
 
 class PixelShader
 {
@@ -18,11 +17,12 @@ public:
 	PixelShader(Renderer* renderer, const std::wstring& name);
 
 	void Bind(Renderer* renderer);
-	ID3DBlob* GetBytecode() const;
+	void Bind(CommandList& commandList) const;
+	const std::vector<uint8_t>& GetBytecode() const;
 
 private:
-	Microsoft::WRL::ComPtr<ID3DBlob> m_pBytecodeBlob;
-	Microsoft::WRL::ComPtr<ID3D11PixelShader> m_pPixelShader;
+	std::vector<uint8_t> m_bytecode;
+	PixelShaderHandle m_pPixelShader;
 };
 
 }  // end namespace SD::RENDER
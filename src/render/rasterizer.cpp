@@ -1,28 +1,36 @@
 #include "rasterizer.hpp"
 
-#include "renderer.hpp"
-#include "debug_layer.hpp"
-#include "exceptions.hpp"
+#include "command_list.hpp"
 
 
 namespace SD::RENDER {
 
 Rasterizer::Rasterizer(Renderer* renderer, bool cull)
-    : m_cull(cull)
+    : Rasterizer(renderer, Describe(cull))
 {
-    D3D_DEBUG_LAYER(renderer);
+}
 
-    D3D11_RASTERIZER_DESC rasterizerDesc = CD3D11_RASTERIZER_DESC(CD3D11_DEFAULT{});
-    rasterizerDesc.CullMode = m_cull ? D3D11_CULL_BACK : D3D11_CULL_NONE;
+Rasterizer::Rasterizer(Renderer* renderer, const RasterizerDesc& desc)
+{
+    m_pRasterizer = renderer->CreateRasterizerState(desc);
+}
 
-    D3D_THROW_INFO_EXCEPTION(renderer->GetDevice()->CreateRasterizerState(&rasterizerDesc, m_pRasterizer.GetAddressOf()));
+RasterizerDesc Rasterizer::Describe(bool cull)
+{
+    RasterizerDesc rasterizerDesc;
+    rasterizerDesc.cull = cull ? CullMode::BACK : CullMode::NONE;
+
+    return rasterizerDesc;
 }
 
 void Rasterizer::Bind(Renderer* renderer)
 {
-    D3D_DEBUG_LAYER(renderer);
+    renderer->SetRasterizerState(m_pRasterizer.get());
+}
 
-    D3D_THROW_IF_INFO(renderer->GetContext()->RSSetState(m_pRasterizer.Get()));
+void Rasterizer::Bind(CommandList& commandList) const
+{
+    commandList.SetRasterizerState(m_pRasterizer.get());
 }
 
 }  // end namespace SD::RENDER
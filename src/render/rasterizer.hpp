@@ -1,23 +1,25 @@
 #pragma once
 
-#include <d3d11.h>
-#include <wrl/client.h>
+#include "renderer.hpp"
 
 
 namespace SD::RENDER {
 
-	class Renderer;
+	class CommandList;
 
 class Rasterizer
 {
 public:
 	Rasterizer(Renderer* renderer, bool cull);
+	Rasterizer(Renderer* renderer, const RasterizerDesc& desc);
+
+	static RasterizerDesc Describe(bool cull);
 
 	void Bind(Renderer* renderer);
+	void Bind(CommandList& commandList) const;
 
 private:
-	bool m_cull = true;
-	Microsoft::WRL::ComPtr<ID3D11RasterizerState> m_pRasterizer;
+	RasterizerStateHandle m_pRasterizer;
 };
 
 }  // end namespace SD::RENDER
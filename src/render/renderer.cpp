@@ -1,61 +0,0 @@
-#include "renderer.hpp"
-
-#include "exceptions.hpp"
-
-#include "debug_layer.hpp"
-
-
-namespace SD::RENDER {
-
-Renderer::Renderer(const float width, const float height, const HWND handle)
-    : m_debugLayer(std::make_unique<DebugLayer>())
-{
-    D3D_DEBUG_LAYER(this);
-
-    DXGI_SWAP_CHAIN_DESC sd = {};
-    sd.BufferDesc.Width = static_cast<UINT>(width);
-    sd.BufferDesc.Height = static_cast<UINT>(height);
-    sd.BufferDesc.Format = DXGI_FORMAT_B8G8R8A8_UNORM;
-    sd.BufferDesc.RefreshRate.Numerator = 0;
-    sd.BufferDesc.RefreshRate.Denominator = 0;
-    sd.BufferDesc.Scaling = DXGI_MODE_SCALING_UNSPECIFIED;
-    sd.BufferDesc.ScanlineOrdering = DXGI_MODE_SCANLINE_ORDER_UNSPECIFIED;
-    sd.SampleDesc.Count = 1;
-    sd.SampleDesc.Quality = 0;
-    sd.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
-    sd.BufferCount = 1;
-    sd.OutputWindow = handle;
-    sd.Windowed = TRUE;
-    sd.SwapEffect = DXGI_SWAP_EFFECT_DISCARD;
-    sd.Flags = 0;
-
-    UINT deviceFlags = 0u;
-    if (m_debugLayer->isInitialised())
-    {
-        deviceFlags |= D3D11_CREATE_DEVICE_DEBUG;
-    }
-
-    // create device and front/back buffers, and swap chain and rendering context
-    D3D_THROW_INFO_EXCEPTION(D3D11CreateDeviceAndSwapChain(
-        nullptr,
-        D3D_DRIVER_TYPE_HARDWARE,
-        nullptr,
-        deviceFlags,
-        nullptr,
-        0,
-        D3D11_SDK_VERSION,
-        &sd,
-        m_pSwapChain.GetAddressOf(),
-        m_pD3dDevice.GetAddressOf(),
-        nullptr,
-        m_pD3dContext.GetAddressOf()
-    ));
-
-    // gain access to texture subresource in swap chain (back buffer)
-    Microsoft::WRL::ComPtr<ID3D11Resource> pBackBuffer;
-    D3D_THROW_INFO_EXCEPTION(m_pSwapChain->GetBuffer(0, __uuidof(ID3D11Resource), &pBackBuffer));
-    D3D_THROW_INFO_EXCEPTION(m_pD3dDevice->CreateRenderTargetView(pBackBuffer.Get(), nullptr, m_pRenderTargetView.GetAddressOf()));
-}
-
-Renderer::~Renderer() = default;
-}  // end namespace SD::RENDER
@@ -1,22 +1,225 @@
 #pragma once
 
-#include <windows.h>
-
-#include <wrl.h>
-#include <d3d11.h>
+#include <dxgiformat.h>
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <string>
+#include <vector>
+
 
+namespace SD {
+class JobSystem;
+}
 
 namespace SD::RENDER {
 
-class DebugLayer;
+class CommandList;
+
+// Backend objects, opaque to the engine. Only the backend that created an object knows what it is.
+struct NativeBuffer;
+struct NativeTexture;
+struct NativeShaderResourceView;
+struct NativeRenderTargetView;
+struct NativeDepthStencilView;
+struct NativeDepthStencilState;
+struct NativeBlendState;
+struct NativeRasterizerState;
+struct NativeSamplerState;
+struct NativeInputLayout;
+struct NativeVertexShader;
+struct NativePixelShader;
+
+// Handles own their object, the last copy releases it.
+using BufferHandle = std::shared_ptr<NativeBuffer>;
+using TextureHandle = std::shared_ptr<NativeTexture>;
+using ShaderResourceViewHandle = std::shared_ptr<NativeShaderResourceView>;
+using RenderTargetViewHandle = std::shared_ptr<NativeRenderTargetView>;
+using DepthStencilViewHandle = std::shared_ptr<NativeDepthStencilView>;
+using DepthStencilStateHandle = std::shared_ptr<NativeDepthStencilState>;
+using BlendStateHandle = std::shared_ptr<NativeBlendState>;
+using RasterizerStateHandle = std::shared_ptr<NativeRasterizerState>;
+using SamplerStateHandle = std::shared_ptr<NativeSamplerState>;
+using InputLayoutHandle = std::shared_ptr<NativeInputLayout>;
+using VertexShaderHandle = std::shared_ptr<NativeVertexShader>;
+using PixelShaderHandle = std::shared_ptr<NativePixelShader>;
+
+enum class ShaderStage : uint8_t
+{
+    VERTEX,
+    PIXEL
+};
+
+enum class BufferType : uint8_t
+{
+    VERTEX,
+    INDEX,
+    CONSTANT,
+    STRUCTURED
+};
+
+struct BufferDesc
+{
+    BufferType type = BufferType::VERTEX;
+    size_t size = 0;
+    uint32_t stride = 0;  // element size of structured buffers
+    bool dynamic = false;  // rewritten as a whole with Map, otherwise written with UpdateBuffer
+};
+
+struct TextureDesc
+{
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t mipLevels = 1;  // 0 for the whole chain
+    uint32_t arraySize = 1;
+    DXGI_FORMAT format = DXGI_FORMAT_UNKNOWN;
+
+    bool shaderResource = true;
+    bool renderTarget = false;
+    bool depthStencil = false;
+    bool cube = false;  // six slices sampled as a cube
+    bool immutable = false;  // created with every mip of the first slice and never written
+};
+
+// Initial data of a mip.
+struct SubresourceData
+{
+    const void* data = nullptr;
+    size_t rowPitch = 0;
+};
+
+// Mips and array slices seen by a texture view. Shader resource views of cubes see all six faces.
+struct ViewDesc
+{
+    DXGI_FORMAT format = DXGI_FORMAT_UNKNOWN;
+    uint32_t firstMip = 0;
+    uint32_t mipLevels = 1;  // shader resource views only, 0 for all mips from the first one
+    uint32_t firstSlice = 0;
+    uint32_t sliceCount = 1;
+    bool cube = false;
+};
+
+enum class DepthFunc : uint8_t
+{
+    LESS,
+    LESS_EQUAL,
+    EQUAL,
+    ALWAYS
+};
+
+struct DepthStencilDesc
+{
+    bool depthTest = false;
+    bool depthWrite = false;
+    DepthFunc depthFunc = DepthFunc::LESS;
+
+    bool operator==(const DepthStencilDesc& other) const
+    {
+        return depthTest == other.depthTest && depthWrite == other.depthWrite && depthFunc == other.depthFunc;
+    }
+};
+
+// Colour writes are always enabled, blending is source alpha over the target.
+struct BlendDesc
+{
+    bool alphaBlend = false;
+
+    bool operator==(const BlendDesc& other) const { return alphaBlend == other.alphaBlend; }
+};
 
+enum class CullMode : uint8_t
+{
+    NONE,
+    BACK,
+    FRONT
+};
+
+struct RasterizerDesc
+{
+    CullMode cull = CullMode::BACK;
+
+    bool operator==(const RasterizerDesc& other) const { return cull == other.cull; }
+};
+
+enum class AddressMode : uint8_t
+{
+    WRAP,
+    CLAMP
+};
+
+// Anisotropic filtering over the whole mip chain.
+struct SamplerDesc
+{
+    AddressMode address = AddressMode::WRAP;
+    uint32_t maxAnisotropy = 16;
+
+    bool operator==(const SamplerDesc& other) const { return address == other.address && maxAnisotropy == other.maxAnisotropy; }
+};
+
+constexpr uint32_t APPEND_ALIGNED = ~0u;
+
+struct InputElement
+{
+    std::string semantic;
+    uint32_t semanticIndex = 0;
+    DXGI_FORMAT format = DXGI_FORMAT_UNKNOWN;
+    uint32_t slot = 0;
+    uint32_t offset = APPEND_ALIGNED;  // right after the previous element of the slot
+    bool perInstance = false;  // stepped once per instance
+
+    bool operator==(const InputElement& other) const
+    {
+        return semantic == other.semantic
+            && semanticIndex == other.semanticIndex
+            && format == other.format
+            && slot == other.slot
+            && offset == other.offset
+            && perInstance == other.perInstance;
+    }
+};
+
+struct Viewport
+{
+    float x = 0.0f;
+    float y = 0.0f;
+    float width = 0.0f;
+    float height = 0.0f;
+    float minDepth = 0.0f;
+    float maxDepth = 1.0f;
+};
+
+enum class PrimitiveTopology : uint8_t
+{
+    UNDEFINED,
+    TRIANGLE_LIST,
+    TRIANGLE_STRIP
+};
+
+struct RendererStats
+{
+    size_t calls = 0;
+    size_t draws = 0;
+    size_t primitives = 0;
+
+    size_t buffers = 0;
+    size_t textures = 0;
+    size_t views = 0;
+    size_t shaders = 0;
+    size_t states = 0;
+
+    size_t bufferBytes = 0;
+    size_t textureBytes = 0;
+    size_t uploadBytes = 0;
+};
+
+// Device and context operations used by the engine, described in engine terms.
+// A backend translates descriptions into its own objects and throws when a call fails.
 class Renderer
 {
 public:
-    Renderer(const float width, const float height, const HWND handle);
-    ~Renderer();
+    Renderer() = default;
+    virtual ~Renderer() = default;
 
     Renderer(Renderer&&) = default;
     Renderer& operator= (Renderer&&) = default;
@@ -24,20 +227,59 @@ public:
     Renderer(Renderer const&) = delete;
     Renderer& operator= (Renderer const&) = delete;
 
-    ID3D11Device* GetDevice() const { return m_pD3dDevice.Get(); }
-    IDXGISwapChain* GetSwapChain() const { return m_pSwapChain.Get(); }
-    ID3D11DeviceContext* GetContext() const { return m_pD3dContext.Get(); }
-    Microsoft::WRL::ComPtr<ID3D11RenderTargetView>& GetRenderTargetView() { return m_pRenderTargetView; }  // TODO: fix crash on resize
+    // back buffer of the swap chain, null when the backend has none
+    virtual NativeRenderTargetView* GetRenderTargetView() const = 0;
+
+    virtual bool IsHeadless() const = 0;
+    virtual RendererStats GetStats() const { return {}; }
+
+    // swap chain
+    virtual void Present() = 0;
+    virtual void Resize() = 0;
 
-    DebugLayer* GetDebugLayer() const { return m_debugLayer.get(); }
+    // device, objects may be created from any thread
+    virtual BufferHandle CreateBuffer(const BufferDesc& desc, const void* data) const = 0;
+    virtual TextureHandle CreateTexture(const TextureDesc& desc, const SubresourceData* data) const = 0;
+    virtual ShaderResourceViewHandle CreateShaderResourceView(NativeTexture* texture, const ViewDesc& desc) const = 0;
+    virtual ShaderResourceViewHandle CreateBufferView(NativeBuffer* buffer, uint32_t elementCount) const = 0;
+    virtual RenderTargetViewHandle CreateRenderTargetView(NativeTexture* texture, const ViewDesc& desc) const = 0;
+    virtual DepthStencilViewHandle CreateDepthStencilView(NativeTexture* texture, const ViewDesc& desc) const = 0;
+    virtual DepthStencilStateHandle CreateDepthStencilState(const DepthStencilDesc& desc) const = 0;
+    virtual BlendStateHandle CreateBlendState(const BlendDesc& desc) const = 0;
+    virtual RasterizerStateHandle CreateRasterizerState(const RasterizerDesc& desc) const = 0;
+    virtual SamplerStateHandle CreateSamplerState(const SamplerDesc& desc) const = 0;
+    virtual InputLayoutHandle CreateInputLayout(const std::vector<InputElement>& elements, const std::vector<uint8_t>& vsBytecode) const = 0;
+    virtual VertexShaderHandle CreateVertexShader(const std::vector<uint8_t>& bytecode) const = 0;
+    virtual PixelShaderHandle CreatePixelShader(const std::vector<uint8_t>& bytecode) const = 0;
 
-private:
-    Microsoft::WRL::ComPtr<ID3D11Device> m_pD3dDevice;
-    Microsoft::WRL::ComPtr<IDXGISwapChain> m_pSwapChain;
-    Microsoft::WRL::ComPtr<ID3D11DeviceContext> m_pD3dContext;
-    Microsoft::WRL::ComPtr<ID3D11RenderTargetView> m_pRenderTargetView;
+    // immediate context, render thread only; objects are not owned, null unbinds
+    virtual void SetRenderTarget(NativeRenderTargetView* renderTarget, NativeDepthStencilView* depthStencil) const = 0;
+    virtual void SetViewport(const Viewport& viewport) const = 0;
+    virtual void SetDepthStencilState(NativeDepthStencilState* state) const = 0;
+    virtual void SetBlendState(NativeBlendState* state) const = 0;
+    virtual void SetRasterizerState(NativeRasterizerState* state) const = 0;
+    virtual void ClearRenderTarget(NativeRenderTargetView* view, const float color[4]) const = 0;
+    virtual void ClearDepth(NativeDepthStencilView* view, float depth) const = 0;
+    virtual void SetPrimitiveTopology(PrimitiveTopology topology) const = 0;
+    virtual void SetInputLayout(NativeInputLayout* layout) const = 0;
+    virtual void SetVertexBuffer(uint32_t slot, NativeBuffer* buffer, uint32_t stride, uint32_t offset) const = 0;
+    virtual void SetIndexBuffer(NativeBuffer* buffer, DXGI_FORMAT format, uint32_t offset) const = 0;
+    virtual void SetVertexShader(NativeVertexShader* shader) const = 0;
+    virtual void SetPixelShader(NativePixelShader* shader) const = 0;
+    virtual void SetConstantBuffer(ShaderStage stage, uint32_t slot, NativeBuffer* buffer) const = 0;
+    virtual void SetShaderResource(ShaderStage stage, uint32_t slot, NativeShaderResourceView* view) const = 0;
+    virtual void SetSampler(ShaderStage stage, uint32_t slot, NativeSamplerState* sampler) const = 0;
+    // Maps a whole dynamic buffer for writing, the previous contents are discarded.
+    virtual void* Map(NativeBuffer* buffer) const = 0;
+    virtual void Unmap(NativeBuffer* buffer) const = 0;
+    // Writes bytes of a default buffer.
+    virtual void UpdateBuffer(NativeBuffer* buffer, size_t offset, const void* data, size_t size) const = 0;
+    // Writes rows [top, bottom) of a mip of a default texture, in texels.
+    virtual void UpdateTexture(NativeTexture* texture, uint32_t mip, uint32_t top, uint32_t bottom, const void* data, size_t rowPitch) const = 0;
+    virtual void DrawIndexed(uint32_t indexCount, uint32_t startIndex, int32_t baseVertex) const = 0;
 
-    std::unique_ptr<DebugLayer> m_debugLayer;
+    // Executes engine command lists in order, recording may be spread over the job system.
+    virtual void ExecuteCommandLists(const std::vector<CommandList>& commandLists, JobSystem& jobSystem) = 0;
 };
 
 }  // end namespace SD::RENDER
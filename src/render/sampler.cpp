@@ -1,33 +1,37 @@
 #include "sampler.hpp"
 
-#include "renderer.hpp"
-#include "debug_layer.hpp"
-#include <exceptions.hpp>
+#include "command_list.hpp"
 
 
 namespace SD::RENDER {
 
 Sampler::Sampler(Renderer* renderer, bool wrap)
+    : Sampler(renderer, Describe(wrap))
 {
-    D3D_DEBUG_LAYER(renderer);
-
-    D3D11_SAMPLER_DESC samplerDesc = {};
-    samplerDesc.Filter = D3D11_FILTER_ANISOTROPIC;
-    samplerDesc.AddressU = wrap ? D3D11_TEXTURE_ADDRESS_WRAP : D3D11_TEXTURE_ADDRESS_CLAMP;
-    samplerDesc.AddressV = wrap ? D3D11_TEXTURE_ADDRESS_WRAP : D3D11_TEXTURE_ADDRESS_CLAMP;
-    samplerDesc.AddressW = wrap ? D3D11_TEXTURE_ADDRESS_WRAP : D3D11_TEXTURE_ADDRESS_CLAMP;
-    samplerDesc.MaxAnisotropy = D3D11_REQ_MAXANISOTROPY;
-    samplerDesc.MipLODBias = 0.0f;
-    samplerDesc.MinLOD = 0.0f;
-    samplerDesc.MaxLOD = D3D11_FLOAT32_MAX;
-    D3D_THROW_INFO_EXCEPTION(renderer->GetDevice()->CreateSamplerState(&samplerDesc, m_pSampler.GetAddressOf()));
 }
 
-void Sampler::Bind(Renderer* renderer, UINT slot)
+Sampler::Sampler(Renderer* renderer, const SamplerDesc& desc)
 {
-    D3D_DEBUG_LAYER(renderer);
+    m_pSampler = renderer->CreateSamplerState(desc);
+}
+
+SamplerDesc Sampler::Describe(bool wrap)
+{
+    SamplerDesc samplerDesc;
+    samplerDesc.address = wrap ? AddressMode::WRAP : AddressMode::CLAMP;
+    samplerDesc.maxAnisotropy = 16;
+
+    return samplerDesc;
+}
 
-    D3D_THROW_IF_INFO(renderer->GetContext()->PSSetSamplers(slot, 1, m_pSampler.GetAddressOf()));
+void Sampler::Bind(Renderer* renderer, uint32_t slot)
+{
+    renderer->SetSampler(ShaderStage::PIXEL, slot, m_pSampler.get());
+}
+
+void Sampler::Bind(CommandList& commandList, uint32_t slot) const
+{
+    commandList.SetSampler(ShaderStage::PIXEL, slot, m_pSampler.get());
 }
 
 }  // end namespace SD::RENDER
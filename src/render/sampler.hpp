@@ -1,22 +1,25 @@
 #pragma once
 
-#include <d3d11.h>
-#include <wrl/client.h>
+#include "renderer.hpp"
 
 
 namespace SD::RENDER {
 
-	class Renderer;
+	class CommandList;
 
 class Sampler
 {
 public:
 	Sampler(Renderer* renderer, bool wrap = true);
+	Sampler(Renderer* renderer, const SamplerDesc& desc);
 
-	void Bind(Renderer* renderer, UINT slot);
+	static SamplerDesc Describe(bool wrap = true);
+
+	void Bind(Renderer* renderer, uint32_t slot);
+	void Bind(CommandList& commandList, uint32_t slot) const;
 
 private:
-	Microsoft::WRL::ComPtr<ID3D11SamplerState> m_pSampler;
+	SamplerStateHandle m_pSampler;
 };
 
 }  // end namespace SD::RENDER
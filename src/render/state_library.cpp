@@ -0,0 +1,152 @@
+#include "state_library.hpp"
+
+#include <hash.hpp>
+
+#include "vertex_shader.hpp"
+#include "pixel_shader.hpp"
+#include "input_layout.hpp"
+#include "rasterizer.hpp"
+#include "blender.hpp"
+#include "sampler.hpp"
+
+
+namespace
+{
+uint64_t HashName(const std::wstring& name)
+{
+    return SD::Hash64(name.data(), name.size() * sizeof(wchar_t));
+}
+
+uint64_t HashRasterizerDesc(const SD::RENDER::RasterizerDesc& desc)
+{
+    return SD::HashCombine(0, static_cast<uint64_t>(desc.cull));
+}
+
+uint64_t HashBlendDesc(const SD::RENDER::BlendDesc& desc)
+{
+    return SD::HashCombine(0, desc.alphaBlend);
+}
+
+uint64_t HashSamplerDesc(const SD::RENDER::SamplerDesc& desc)
+{
+    return SD::HashCombine(static_cast<uint64_t>(desc.address), desc.maxAnisotropy);
+}
+
+uint64_t HashDepthStencilDesc(const SD::RENDER::DepthStencilDesc& desc)
+{
+    uint64_t hash = SD::HashCombine(desc.depthTest, desc.depthWrite);
+    return SD::HashCombine(hash, static_cast<uint64_t>(desc.depthFunc));
+}
+
+// Field by field, semantics by their characters rather than by the string they point to.
+uint64_t HashInputLayout(const std::vector<SD::RENDER::InputElement>& layout, const std::vector<uint8_t>& vsBytecode)
+{
+    uint64_t hash = SD::Hash64(vsBytecode.data(), vsBytecode.size());
+    for (const auto& element : layout)
+    {
+        hash = SD::HashCombine(hash, SD::Hash64(element.semantic.data(), element.semantic.size()));
+        hash = SD::HashCombine(hash, element.semanticIndex);
+        hash = SD::HashCombine(hash, element.format);
+        hash = SD::HashCombine(hash, element.slot);
+        hash = SD::HashCombine(hash, element.offset);
+        hash = SD::HashCombine(hash, element.perInstance);
+    }
+
+    return hash;
+}
+}  // end namespace
+
+namespace SD::RENDER {
+
+StateLibrary::StateLibrary(Renderer* renderer)
+    : m_renderer(renderer)
+{
+}
+
+template<typename Desc, typename T, typename F>
+T StateLibrary::get(Objects<Desc, T>& objects, uint64_t hash, const Desc& desc, F&& create)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_stats.requests++;
+
+    const auto [first, last] = objects.equal_range(hash);
+    for (auto it = first; it != last; ++it)
+    {
+        if (it->second.desc == desc)
+        {
+            return it->second.object;
+        }
+    }
+
+    auto object = create();
+    objects.emplace(hash, Entry<Desc, T>{ desc, object });
+    m_stats.created++;
+
+    return object;
+}
+
+std::shared_ptr<VertexShader> StateLibrary::GetVertexShader(const std::wstring& name)
+{
+    return get(m_vertexShaders, HashName(name), name, [this, &name]()
+    {
+        return std::make_shared<VertexShader>(m_renderer, name);
+    });
+}
+
+std::shared_ptr<PixelShader> StateLibrary::GetPixelShader(const std::wstring& name)
+{
+    return get(m_pixelShaders, HashName(name), name, [this, &name]()
+    {
+        return std::make_shared<PixelShader>(m_renderer, name);
+    });
+}
+
+std::shared_ptr<InputLayout> StateLibrary::GetInputLayout(const std::vector<InputElement>& layout, const std::vector<uint8_t>& vsBytecode)
+{
+    return get(m_inputLayouts, HashInputLayout(layout, vsBytecode), InputLayoutDesc{ layout, vsBytecode }, [this, &layout, &vsBytecode]()
+    {
+        return std::make_shared<InputLayout>(m_renderer, layout, vsBytecode);
+    });
+}
+
+std::shared_ptr<Rasterizer> StateLibrary::GetRasterizer(const RasterizerDesc& desc)
+{
+    return get(m_rasterizers, HashRasterizerDesc(desc), desc, [this, &desc]()
+    {
+        return std::make_shared<Rasterizer>(m_renderer, desc);
+    });
+}
+
+std::shared_ptr<Blender> StateLibrary::GetBlender(const BlendDesc& desc)
+{
+    return get(m_blenders, HashBlendDesc(desc), desc, [this, &desc]()
+    {
+        return std::make_shared<Blender>(m_renderer, desc);
+    });
+}
+
+std::shared_ptr<Sampler> StateLibrary::GetSampler(const SamplerDesc& desc)
+{
+    return get(m_samplers, HashSamplerDesc(desc), desc, [this, &desc]()
+    {
+        return std::make_shared<Sampler>(m_renderer, desc);
+    });
+}
+
+DepthStencilStateHandle StateLibrary::GetDepthStencilState(const DepthStencilDesc& desc)
+{
+    return get(m_depthStencilStates, HashDepthStencilDesc(desc), desc, [this, &desc]()
+    {
+        return m_renderer->CreateDepthStencilState(desc);
+    });
+}
+
+StateLibraryStats StateLibrary::GetStats() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_stats;
+}
+
+}  // end namespace SD::RENDER
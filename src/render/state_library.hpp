@@ -0,0 +1,92 @@
+#pragma once
+
+#include "renderer.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+namespace SD::RENDER {
+
+class VertexShader;
+class PixelShader;
+class InputLayout;
+class Rasterizer;
+class Blender;
+class Sampler;
+
+struct StateLibraryStats
+{
+	size_t requests = 0;  // objects asked for
+	size_t created = 0;  // objects created, the rest of the requests were shared
+};
+
+// Shaders, input layouts and pipeline states shared by what they are created from: shaders by file name, states by
+// their description, input layouts by their elements and the vertex shader bytecode. Objects are looked up by a hash of
+// it and kept with a copy of it, which a hash match is compared with. There are a handful of distinct objects in a
+// scene, the library keeps them all until it is destroyed.
+// Safe to use from jobs, objects are created under the lock so each is created once.
+class StateLibrary
+{
+public:
+	StateLibrary(Renderer* renderer);
+	~StateLibrary() = default;
+
+	StateLibrary(const StateLibrary&) = delete;
+	StateLibrary& operator=(const StateLibrary&) = delete;
+
+	std::shared_ptr<VertexShader> GetVertexShader(const std::wstring& name);
+	std::shared_ptr<PixelShader> GetPixelShader(const std::wstring& name);
+	std::shared_ptr<InputLayout> GetInputLayout(const std::vector<InputElement>& layout, const std::vector<uint8_t>& vsBytecode);
+
+	std::shared_ptr<Rasterizer> GetRasterizer(const RasterizerDesc& desc);
+	std::shared_ptr<Blender> GetBlender(const BlendDesc& desc);
+	std::shared_ptr<Sampler> GetSampler(const SamplerDesc& desc);
+	DepthStencilStateHandle GetDepthStencilState(const DepthStencilDesc& desc);
+
+	StateLibraryStats GetStats() const;
+
+private:
+	template<typename Desc, typename T>
+	struct Entry
+	{
+		Desc desc;
+		T object;
+	};
+
+	// equal hashes of other descriptions are kept side by side
+	template<typename Desc, typename T>
+	using Objects = std::unordered_multimap<uint64_t, Entry<Desc, T>>;
+
+	struct InputLayoutDesc
+	{
+		std::vector<InputElement> layout;
+		std::vector<uint8_t> vsBytecode;
+
+		bool operator==(const InputLayoutDesc& other) const { return layout == other.layout && vsBytecode == other.vsBytecode; }
+	};
+
+	template<typename Desc, typename T, typename F>
+	T get(Objects<Desc, T>& objects, uint64_t hash, const Desc& desc, F&& create);
+
+private:
+	Renderer* m_renderer;
+
+	mutable std::mutex m_mutex;
+	Objects<std::wstring, std::shared_ptr<VertexShader>> m_vertexShaders = {};
+	Objects<std::wstring, std::shared_ptr<PixelShader>> m_pixelShaders = {};
+	Objects<InputLayoutDesc, std::shared_ptr<InputLayout>> m_inputLayouts = {};
+	Objects<RasterizerDesc, std::shared_ptr<Rasterizer>> m_rasterizers = {};
+	Objects<BlendDesc, std::shared_ptr<Blender>> m_blenders = {};
+	Objects<SamplerDesc, std::shared_ptr<Sampler>> m_samplers = {};
+	Objects<DepthStencilDesc, DepthStencilStateHandle> m_depthStencilStates = {};
+	StateLibraryStats m_stats = {};
+};
+
+}  // end namespace SD::RENDER
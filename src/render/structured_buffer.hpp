@@ -1,11 +1,9 @@
 #pragma once
 
-#include <d3d11.h>
-#include <wrl/client.h>
-
 #include "renderer.hpp"
-#include "debug_layer.hpp"
-#include <exceptions.hpp>
+#include "command_list.hpp"
+
+#include <cstring>
 
 
 namespace SD::RENDER {
@@ -14,60 +12,58 @@ template<class C>
 class StructuredBuffer
 {
 public:
-	StructuredBuffer(Renderer* renderer, std::vector<C>& data)
+	// Dynamic buffers are rewritten as a whole, default ones are meant for sparse element updates.
+	StructuredBuffer(Renderer* renderer, std::vector<C>& data, bool dynamic = true)
 		: m_data(std::move(data))
+		, m_dynamic(dynamic)
 	{
-		D3D_DEBUG_LAYER(renderer);
-
-		D3D11_BUFFER_DESC structuredBufferDesc;
-		structuredBufferDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
-		structuredBufferDesc.Usage = D3D11_USAGE_DYNAMIC;
-		structuredBufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
-		structuredBufferDesc.MiscFlags = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED;
-		structuredBufferDesc.ByteWidth = static_cast<UINT>(sizeof(C) * m_data.capacity());
-		structuredBufferDesc.StructureByteStride = sizeof(C);
+		BufferDesc structuredBufferDesc;
+		structuredBufferDesc.type = BufferType::STRUCTURED;
+		structuredBufferDesc.size = sizeof(C) * m_data.capacity();
+		structuredBufferDesc.stride = sizeof(C);
+		structuredBufferDesc.dynamic = m_dynamic;
+
+		m_pStructuredBuffer = renderer->CreateBuffer(structuredBufferDesc, m_data.empty() ? nullptr : m_data.data());
+		m_pBufferSRV = renderer->CreateBufferView(m_pStructuredBuffer.get(), static_cast<uint32_t>(m_data.capacity()));
+	}
 
-		if (!m_data.empty())
-		{
-			D3D11_SUBRESOURCE_DATA structuredBufferData = {};
-			structuredBufferData.pSysMem = static_cast<void*>(m_data.data());
-			D3D_THROW_INFO_EXCEPTION(renderer->GetDevice()->CreateBuffer(&structuredBufferDesc, &structuredBufferData, &m_pStructuredBuffer));
-		}
-		else
+	void Update(Renderer* renderer)
+	{
+		if (!m_dynamic)
 		{
-			D3D_THROW_INFO_EXCEPTION(renderer->GetDevice()->CreateBuffer(&structuredBufferDesc, nullptr, &m_pStructuredBuffer));
+			renderer->UpdateBuffer(m_pStructuredBuffer.get(), 0u, m_data.data(), sizeof(C) * m_data.capacity());
+			return;
 		}
 
-		D3D11_SHADER_RESOURCE_VIEW_DESC bufferSRVDesc = {};
-		bufferSRVDesc.Format = DXGI_FORMAT_UNKNOWN;
-		bufferSRVDesc.ViewDimension = D3D11_SRV_DIMENSION_BUFFER;
-		bufferSRVDesc.Buffer.FirstElement = 0;
-		bufferSRVDesc.Buffer.NumElements = static_cast<UINT>(m_data.capacity());
-		D3D_THROW_INFO_EXCEPTION(renderer->GetDevice()->CreateShaderResourceView(m_pStructuredBuffer.Get(), &bufferSRVDesc, m_pBufferSRV.GetAddressOf()));
+		void* mappedData = renderer->Map(m_pStructuredBuffer.get());
+		memcpy(mappedData, m_data.data(), sizeof(C) * m_data.capacity());
+		renderer->Unmap(m_pStructuredBuffer.get());
 	}
 
-	void Update(Renderer* renderer)
+	// Writes a single element of a default buffer in place, the rest of the buffer is untouched.
+	void UpdateElement(Renderer* renderer, size_t idx)
 	{
-		D3D_DEBUG_LAYER(renderer);
-
-		D3D11_MAPPED_SUBRESOURCE mappedData;
-		D3D_THROW_IF_INFO(renderer->GetContext()->Map(m_pStructuredBuffer.Get(), 0u, D3D11_MAP_WRITE_DISCARD, 0u, &mappedData));
-		memcpy(mappedData.pData, m_data.data(), sizeof(C) * m_data.capacity());
-		D3D_THROW_IF_INFO(renderer->GetContext()->Unmap(m_pStructuredBuffer.Get(), 0u));
+		renderer->UpdateBuffer(m_pStructuredBuffer.get(), sizeof(C) * idx, &m_data[idx], sizeof(C));
 	}
 
-	void VSBind(Renderer* renderer, UINT slot) const
+	void VSBind(Renderer* renderer, uint32_t slot) const
 	{
-		D3D_DEBUG_LAYER(renderer);
+		renderer->SetShaderResource(ShaderStage::VERTEX, slot, m_pBufferSRV.get());
+	}
 
-		D3D_THROW_IF_INFO(renderer->GetContext()->VSSetShaderResources(slot, 1u, m_pBufferSRV.GetAddressOf()));
+	void PSBind(Renderer* renderer, uint32_t slot) const
+	{
+		renderer->SetShaderResource(ShaderStage::PIXEL, slot, m_pBufferSRV.get());
 	}
 
-	void PSBind(Renderer* renderer, UINT slot) const
+	void VSBind(CommandList& commandList, uint32_t slot) const
 	{
-		D3D_DEBUG_LAYER(renderer);
+		commandList.SetShaderResource(ShaderStage::VERTEX, slot, m_pBufferSRV.get());
+	}
 
-		D3D_THROW_IF_INFO(renderer->GetContext()->PSSetShaderResources(slot, 1u, m_pBufferSRV.GetAddressOf()));
+	void PSBind(CommandList& commandList, uint32_t slot) const
+	{
+		commandList.SetShaderResource(ShaderStage::PIXEL, slot, m_pBufferSRV.get());
 	}
 
 	std::vector<C>& GetData()
@@ -77,8 +73,9 @@ public:
 
 private:
 	std::vector<C> m_data;
-	Microsoft::WRL::ComPtr<ID3D11Buffer> m_pStructuredBuffer;
-	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> m_pBufferSRV;
+	bool m_dynamic = true;
+	BufferHandle m_pStructuredBuffer;
+	ShaderResourceViewHandle m_pBufferSRV;
 };
 
 }  // end namespace SD::RENDER
@@ -1,59 +1,92 @@
 #include "texture.hpp"
 
-#include "renderer.hpp"
-#include "debug_layer.hpp"
+#include "command_list.hpp"
 #include "exceptions.hpp"
 
 #include <DirectXTex.h>
 
+#include <algorithm>
+#include <cstring>
+
 
 namespace SD::RENDER {
 
 Texture::Texture(Renderer* renderer, const std::wstring& path)
+    : Texture(renderer, Load(path))
 {
-    D3D_DEBUG_LAYER(renderer);
-
-    DirectX::ScratchImage scratch = Load(path);
-
-    D3D11_TEXTURE2D_DESC textureDesc = {};
-    textureDesc.Width = static_cast<UINT>(scratch.GetMetadata().width);
-    textureDesc.Height = static_cast<UINT>(scratch.GetMetadata().height);
-    textureDesc.MipLevels = static_cast<UINT>(scratch.GetMetadata().mipLevels);
-    textureDesc.ArraySize = static_cast<UINT>(scratch.GetMetadata().arraySize);
-    textureDesc.Format = scratch.GetMetadata().format;
-    textureDesc.SampleDesc.Count = 1;
-    textureDesc.SampleDesc.Quality = 0;
-    textureDesc.Usage = D3D11_USAGE_IMMUTABLE;
-    textureDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
-    textureDesc.CPUAccessFlags = 0;
-    textureDesc.MiscFlags = 0;
-
-    std::vector<D3D11_SUBRESOURCE_DATA> initialData;
-    initialData.reserve(textureDesc.MipLevels);
-    for (auto mip = 0; mip < initialData.capacity(); mip++)
+}
+
+Texture::Texture(Renderer* renderer, const DirectX::ScratchImage& scratch)
+{
+    m_hasAlpha = DirectX::HasAlpha(scratch.GetMetadata().format) && !scratch.IsAlphaAllOpaque();
+
+    TextureDesc textureDesc;
+    textureDesc.width = static_cast<uint32_t>(scratch.GetMetadata().width);
+    textureDesc.height = static_cast<uint32_t>(scratch.GetMetadata().height);
+    textureDesc.mipLevels = static_cast<uint32_t>(scratch.GetMetadata().mipLevels);
+    textureDesc.arraySize = static_cast<uint32_t>(scratch.GetMetadata().arraySize);
+    textureDesc.format = scratch.GetMetadata().format;
+    textureDesc.immutable = true;
+
+    std::vector<SubresourceData> initialData;
+    initialData.reserve(textureDesc.mipLevels);
+    for (size_t mip = 0; mip < initialData.capacity(); mip++)
     {
         const auto& i = scratch.GetImage(mip, 0, 0);
         auto& data = initialData.emplace_back();
-        data.pSysMem = i->pixels;
-        data.SysMemPitch = static_cast<UINT>(i->rowPitch);
+        data.data = i->pixels;
+        data.rowPitch = i->rowPitch;
     }
 
-    Microsoft::WRL::ComPtr<ID3D11Texture2D> pDiffuseTexture;
-    D3D_THROW_INFO_EXCEPTION(renderer->GetDevice()->CreateTexture2D(&textureDesc, initialData.data(), pDiffuseTexture.GetAddressOf()));
+    m_pTexture = renderer->CreateTexture(textureDesc, initialData.data());
+
+    m_format = textureDesc.format;
+    m_mipLevels = textureDesc.mipLevels;
+    m_mostDetailedMip = 0;
+    createView(renderer);
+}
+
+Texture::Texture(Renderer* renderer, const DirectX::TexMetadata& metadata)
+{
+    TextureDesc textureDesc;
+    textureDesc.width = static_cast<uint32_t>(metadata.width);
+    textureDesc.height = static_cast<uint32_t>(metadata.height);
+    textureDesc.mipLevels = static_cast<uint32_t>(metadata.mipLevels);
+    textureDesc.arraySize = static_cast<uint32_t>(metadata.arraySize);
+    textureDesc.format = metadata.format;
+    textureDesc.immutable = false;  // mips are updated as they arrive
+
+    m_pTexture = renderer->CreateTexture(textureDesc, nullptr);
+
+    m_format = textureDesc.format;
+    m_mipLevels = textureDesc.mipLevels;
+    m_mostDetailedMip = m_mipLevels;
+}
+
+void Texture::Bind(Renderer* renderer, uint32_t slot) const
+{
+    renderer->SetShaderResource(ShaderStage::PIXEL, slot, m_pTextureView.get());
+}
 
-    D3D11_SHADER_RESOURCE_VIEW_DESC textureSRVDesc = {};
-    textureSRVDesc.Format = textureDesc.Format;
-    textureSRVDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
-    textureSRVDesc.Texture2D.MostDetailedMip = 0;
-    textureSRVDesc.Texture2D.MipLevels = static_cast<UINT>(-1);
-    D3D_THROW_INFO_EXCEPTION(renderer->GetDevice()->CreateShaderResourceView(pDiffuseTexture.Get(), &textureSRVDesc, m_pTextureView.GetAddressOf()));
+void Texture::Bind(CommandList& commandList, uint32_t slot) const
+{
+    commandList.SetShaderResource(ShaderStage::PIXEL, slot, m_pTextureView.get());
 }
 
-void Texture::Bind(Renderer* renderer, UINT slot) const
+void Texture::UploadMip(Renderer* renderer, uint32_t mip, const DirectX::Image& image, size_t firstRow, size_t rowCount)
 {
-    D3D_DEBUG_LAYER(renderer);
+    const size_t rows = image.slicePitch / image.rowPitch;
+    const size_t rowHeight = DirectX::IsCompressed(m_format) ? 4 : 1;
 
-    D3D_THROW_IF_INFO(renderer->GetContext()->PSSetShaderResources(slot, 1u, m_pTextureView.GetAddressOf()));
+    const auto top = static_cast<uint32_t>(firstRow * rowHeight);
+    const auto bottom = static_cast<uint32_t>(std::min(image.height, (firstRow + rowCount) * rowHeight));
+    renderer->UpdateTexture(m_pTexture.get(), mip, top, bottom, image.pixels + firstRow * image.rowPitch, image.rowPitch);
+
+    if (firstRow + rowCount >= rows && mip < m_mostDetailedMip)
+    {
+        m_mostDetailedMip = mip;
+        createView(renderer);
+    }
 }
 
 DirectX::ScratchImage Texture::Load(const std::wstring& path)
@@ -72,33 +105,52 @@ DirectX::ScratchImage Texture::Load(const std::wstring& path)
         WIN_THROW_IF_FAILED(DirectX::LoadFromWICFile(path.c_str(), DirectX::WIC_FLAGS_NONE, nullptr, image));
     }
 
-    /*
-    DirectX::ScratchImage convert;
-    if (image.GetImage(0, 0, 0)->format != DXGI_FORMAT::DXGI_FORMAT_B8G8R8A8_UNORM)
+    return image;
+}
+
+DirectX::ScratchImage Texture::Load(const uint8_t* data, size_t size)
+{
+    // there is no extension to go by, DDS files start with their magic
+    DirectX::ScratchImage image;
+    if (size >= 4 && memcmp(data, "DDS ", 4) == 0)
     {
-        WIN_THROW_IF_FAILED(DirectX::Convert(
-            *image.GetImage(0, 0, 0),
-            DXGI_FORMAT::DXGI_FORMAT_B8G8R8A8_UNORM,
-            DirectX::TEX_FILTER_DEFAULT,
-            0.0,
-            convert
-        ));
-
-        image = std::move(convert);
+        WIN_THROW_IF_FAILED(DirectX::LoadFromDDSMemory(data, size, DirectX::DDS_FLAGS_NONE, nullptr, image));
     }
-
-    // Generate mips
+    else
     {
-        WIN_THROW_IF_FAILED(DirectX::GenerateMipMaps(
-            image.GetImages(), image.GetImageCount(), image.GetMetadata(),
-            DirectX::TEX_FILTER_DEFAULT, 0, convert
-        ));
-
-        image = std::move(convert);
+        WIN_THROW_IF_FAILED(DirectX::LoadFromWICMemory(data, size, DirectX::WIC_FLAGS_NONE, nullptr, image));
     }
-    */
 
     return image;
 }
 
+DirectX::TexMetadata Texture::LoadMetadata(const std::wstring& path)
+{
+    DirectX::TexMetadata metadata = {};
+    if (path.compare(path.size() - 4, 4, L".dds") == 0)
+    {
+        WIN_THROW_IF_FAILED(DirectX::GetMetadataFromDDSFile(path.c_str(), DirectX::DDS_FLAGS_NONE, metadata));
+    }
+    else if (path.compare(path.size() - 4, 4, L".hdr") == 0)
+    {
+        WIN_THROW_IF_FAILED(DirectX::GetMetadataFromHDRFile(path.c_str(), metadata));
+    }
+    else
+    {
+        WIN_THROW_IF_FAILED(DirectX::GetMetadataFromWICFile(path.c_str(), DirectX::WIC_FLAGS_NONE, metadata));
+    }
+
+    return metadata;
+}
+
+void Texture::createView(Renderer* renderer)
+{
+    // views are immutable, a clamp change needs a new one
+    ViewDesc textureSRVDesc;
+    textureSRVDesc.format = m_format;
+    textureSRVDesc.firstMip = m_mostDetailedMip;
+    textureSRVDesc.mipLevels = m_mipLevels - m_mostDetailedMip;
+    m_pTextureView = renderer->CreateShaderResourceView(m_pTexture.get(), textureSRVDesc);
+}
+
 }  // end namespace SD::RENDER
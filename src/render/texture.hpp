@@ -1,30 +1,66 @@
 #pragma once
 
-#include <d3d11.h>
-#include <wrl/client.h>
+#include "renderer.hpp"
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
 
 
 namespace DirectX {
 	class ScratchImage;
+	struct TexMetadata;
+	struct Image;
 }
 
 namespace SD::RENDER {
 
-	class Renderer;
+	class CommandList;
 
 class Texture
 {
 public:
 	Texture(Renderer* renderer, const std::wstring& path);
-	void Bind(Renderer* renderer, UINT slot) const;
+	// Device creation is free-threaded, so textures may be created from any thread.
+	Texture(Renderer* renderer, const DirectX::ScratchImage& scratch);
+	// Streamed texture, the whole mip chain is allocated but no mip is resident until it is uploaded.
+	Texture(Renderer* renderer, const DirectX::TexMetadata& metadata);
+	void Bind(Renderer* renderer, uint32_t slot) const;
+	void Bind(CommandList& commandList, uint32_t slot) const;
+
+	// Uploads rows of a mip of a streamed texture through the immediate context, so on the render thread only. Rows are
+	// rows of the pitch (of blocks for block compressed formats). Mips are uploaded smallest first, the view is clamped
+	// to the ones uploaded whole.
+	void UploadMip(Renderer* renderer, uint32_t mip, const DirectX::Image& image, size_t firstRow, size_t rowCount);
+
+	bool HasAlpha() const { return m_hasAlpha; }
+	// streamed textures know it once they are decoded
+	void SetHasAlpha(bool hasAlpha) { m_hasAlpha = hasAlpha; }
+
+	uint32_t GetMipLevels() const { return m_mipLevels; }
+	uint32_t GetMostDetailedMip() const { return m_mostDetailedMip; }
+	// at least one mip can be sampled
+	bool IsResident() const { return m_mostDetailedMip < m_mipLevels; }
+
+	// Decodes a DDS, HDR or WIC file, no device is involved, so files may be decoded on any thread.
+	static DirectX::ScratchImage Load(const std::wstring& path);
+	// Decodes a DDS or WIC image held in memory, such as one embedded in a glTF.
+	static DirectX::ScratchImage Load(const uint8_t* data, size_t size);
+	// Reads the file header only.
+	static DirectX::TexMetadata LoadMetadata(const std::wstring& path);
 
 private:
-	DirectX::ScratchImage Load(const std::wstring& path);
+	void createView(Renderer* renderer);
 
 private:
-	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> m_pTextureView;
+	TextureHandle m_pTexture;
+	ShaderResourceViewHandle m_pTextureView;
+
+	DXGI_FORMAT m_format = DXGI_FORMAT_UNKNOWN;
+	uint32_t m_mipLevels = 0;
+	uint32_t m_mostDetailedMip = 0;  // equals the mip count while nothing is resident
+
+	bool m_hasAlpha = false;  // any texel is not fully opaque
 };
 
 }  // end namespace SD::RENDER
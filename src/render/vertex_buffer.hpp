@@ -11,10 +11,11 @@ public:
 	VertexBuffer() = default;
 	~VertexBuffer() override = default;
 
-	void Bind(Renderer* renderer, UINT slot, UINT stride, UINT offset) const override;
+	void Bind(Renderer* renderer, uint32_t slot, uint32_t stride, uint32_t offset) const override;
+	void Bind(CommandList& commandList, uint32_t slot, uint32_t stride, uint32_t offset) const override;
 
 protected:
-	D3D11_BUFFER_DESC getDescriptor(const size_t byteLength) const override;
+	BufferDesc getDescriptor(const size_t byteLength) const override;
 };
 
 }  // end namespace SD::RENDER
@@ -1,34 +1,48 @@
 #include "vertex_shader.hpp"
 
-#include <d3dcompiler.h>
-
-#include "renderer.hpp"
-#include "debug_layer.hpp"
+#include "command_list.hpp"
 #include <exceptions.hpp>
 
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+
+namespace
+{
+std::vector<uint8_t> ReadBytecode(const std::wstring& path)
+{
+	std::ifstream file(std::filesystem::path(path), std::ios::binary);
+	if (!file)
+	{
+		throw SD::SomeException(__LINE__, __FILEW__, L"Failed to read shader " + path);
+	}
+
+	return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+}  // end namespace
 
 namespace SD::RENDER {
 
 VertexShader::VertexShader(Renderer* renderer, const std::wstring& name)
+	: m_bytecode(ReadBytecode(VS_PATH + name))
 {
-	D3D_DEBUG_LAYER(renderer);
-
-	D3D_THROW_INFO_EXCEPTION(D3DReadFileToBlob((VS_PATH + name).c_str(), m_pBytecodeBlob.GetAddressOf()));
-	D3D_THROW_INFO_EXCEPTION(renderer->GetDevice()->CreateVertexShader(
-		m_pBytecodeBlob->GetBufferPointer(), m_pBytecodeBlob->GetBufferSize(), nullptr, m_pVertexShader.GetAddressOf())
-	);
+	m_pVertexShader = renderer->CreateVertexShader(m_bytecode);
 }
 
 void VertexShader::Bind(Renderer* renderer)
 {
-	D3D_DEBUG_LAYER(renderer);
+	renderer->SetVertexShader(m_pVertexShader.get());
+}
 
-	D3D_THROW_IF_INFO(renderer->GetContext()->VSSetShader(m_pVertexShader.Get(), nullptr, 0u));
+void VertexShader::Bind(CommandList& commandList) const
+{
+	commandList.SetVertexShader(m_pVertexShader.get());
 }
 
-ID3DBlob* VertexShader::GetBytecode() const
+const std::vector<uint8_t>& VertexShader::GetBytecode() const
 {
-	return m_pBytecodeBlob.Get();
+	return m_bytecode;
 }
 
 }  // end namespace SD::RENDER
@@ -1,7 +1,9 @@
+#include "octahedral.hlsli"
+
 struct VS_INPUT
 {
     float3 pos : POSITION;
-    float3 normal : NORMAL;
+    float2 normal : NORMAL;  // octahedral snorm
     float2 uv : TEXCOORD;
 };
 
@@ -39,7 +41,7 @@ VS_OUTPUT main(VS_INPUT input)
     output.fragPos = posWS;
     output.fragPosLightSpace = fragPosLightSpace;
     output.viewPos = viewPos;
-    output.normal = input.normal;
+    output.normal = DecodeOctahedral(input.normal);
     output.uv = input.uv;
     
     return output;
@@ -0,0 +1,27 @@
+struct VS_INPUT
+{
+    float3 position : POSITION;  // float or 16 bit unorm in the dequantization range
+};
+
+
+cbuffer transform : register(b0)
+{
+    row_major matrix model;
+    row_major matrix view;
+    row_major matrix projection;
+    float3 viewPos;
+    float4 positionScale;
+    float4 positionOffset;
+};
+
+
+// Must match pbr.vs position math exactly, the main pass tests depth for EQUAL.
+float4 main(VS_INPUT input) : SV_POSITION
+{
+    precise float3 position = input.position * positionScale.xyz + positionOffset.xyz;
+
+    precise float4 posWS = mul(float4(position, 1.0f), model);
+    precise float4 pos = mul(posWS, mul(view, projection));
+
+    return pos;
+}
@@ -0,0 +1,25 @@
+#ifndef OCTAHEDRAL_HLSLI
+#define OCTAHEDRAL_HLSLI
+
+// Octahedral normals and tangents, R16G16_SNORM or R8G8_SNORM (see vertex_packer.hpp).
+
+// Unit vector from an octahedron unfolded to [-1, 1]^2, the lower half is folded over the diagonals.
+float3 DecodeOctahedral(float2 encoded)
+{
+    float3 direction = float3(encoded, 1.0f - abs(encoded.x) - abs(encoded.y));
+    const float fold = saturate(-direction.z);
+    direction.xy += direction.xy >= 0.0f ? -fold : fold;
+
+    return normalize(direction);
+}
+
+// Tangent with handedness in w, the handedness is the sign of y and y itself is remapped to [0, 1].
+float4 DecodeOctahedralTangent(float2 encoded)
+{
+    const float handedness = encoded.y < 0.0f ? -1.0f : 1.0f;
+    const float3 tangent = DecodeOctahedral(float2(encoded.x, abs(encoded.y) * 2.0f - 1.0f));
+
+    return float4(tangent, handedness);
+}
+
+#endif  // OCTAHEDRAL_HLSLI
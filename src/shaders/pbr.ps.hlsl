@@ -8,14 +8,16 @@ struct PS_INPUIT
     float3 normal : NORMAL;
     float3 tangent : TANGENT;
     float2 uv : TEXCOORD;
+    nointerpolation uint materialIndex : MATERIAL;
 };
 
-cbuffer material : register(b0)
+struct Material
 {
     float4 baseColorFactor;
     float normalMapScale;
     float metallicFactor;
     float roughnessFactor;
+    float alphaCutoff;
 };
 
 cbuffer pointLights : register(b2)  // TODO: slot
@@ -48,9 +50,10 @@ SamplerState environmentSampler : SAMPLER : register(s3);
 SamplerState brdfSampler : SAMPLER : register(s4);
 
 StructuredBuffer<PointLight> pointLights : register(t3); // TODO: slot
+StructuredBuffer<Material> materials : register(t8);  // all materials of the world
 
 
-float3 getNormalFromMap(PS_INPUIT input);
+float3 getNormalFromMap(PS_INPUIT input, float normalMapScale);
 float3 fresnelSchlick(float cosTheta, float3 F0);
 float3 fresnelSchlickRoughness(float cosTheta, float3 F0, float roughness);
 float DistributionGGX(float3 N, float3 H, float roughness);
@@ -60,15 +63,18 @@ float GeometrySmith(float3 N, float3 V, float3 L, float roughness);
 
 float4 main(PS_INPUIT input) : SV_TARGET
 {
-    float4 albedo = pow(albedoMap.Sample(albedoSampler, input.uv), 2.2f);
-    albedo *= baseColorFactor;
+    const Material material = materials[input.materialIndex];
 
-    clip(albedo.a < 0.1 ? -1 : 1);  // TODO
-    //clip(albedo.a < 0.9 ? -1 : 1);
+    // alpha is linear, cutout mips are cooked to keep its coverage of the cutoff
+    float4 albedo = albedoMap.Sample(albedoSampler, input.uv);
+    albedo.rgb = pow(albedo.rgb, 2.2f);
+    albedo *= material.baseColorFactor;
 
-    const float3 normal = getNormalFromMap(input);
+    clip(albedo.a - material.alphaCutoff);
+
+    const float3 normal = getNormalFromMap(input, material.normalMapScale);
     float3 metallicRoughness = metallicRoughnessMap.Sample(metallicRoughnessSampler, input.uv);
-    metallicRoughness *= float3(1.0f, roughnessFactor, metallicFactor);
+    metallicRoughness *= float3(1.0f, material.roughnessFactor, material.metallicFactor);
 
     const float3 worldPos = input.fragPos;
 
@@ -148,9 +154,12 @@ float4 main(PS_INPUIT input) : SV_TARGET
     return float4(color, albedo.a);
 }
 
-float3 getNormalFromMap(PS_INPUIT input)
+float3 getNormalFromMap(PS_INPUIT input, float normalMapScale)
 {
-    float3 normal = normalMap.Sample(normalSampler, input.uv).xyz * 2.0 - 1.0;
+    // normal maps are cooked to two channels (BC5), z is rebuilt
+    float3 normal;
+    normal.xy = normalMap.Sample(normalSampler, input.uv).xy * 2.0 - 1.0;
+    normal.z = sqrt(saturate(1.0 - dot(normal.xy, normal.xy)));
     normal *= float3(normalMapScale, normalMapScale, 1.0);
 
     float3 N = normalize(input.normal);
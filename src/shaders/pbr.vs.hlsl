@@ -1,9 +1,12 @@
+#include "octahedral.hlsli"
+
 struct VS_INPUT
 {
-    float3 position : POSITION;
-    float3 normal : NORMAL;
-    float4 tangent : TANGENT;
-    float2 uv : TEXCOORD0;
+    float3 position : POSITION;  // float or 16 bit unorm in the dequantization range
+    float2 normal : NORMAL;  // octahedral snorm
+    float2 tangent : TANGENT;  // octahedral snorm, handedness in the sign of y
+    float2 uv : TEXCOORD0;  // half or float
+    uint materialIndex : MATERIAL;  // per instance, offset by the start instance of the draw
 };
 
 struct VS_OUTPUT
@@ -14,6 +17,7 @@ struct VS_OUTPUT
     float3 normal : NORMAL;
     float3 tangent : TANGENT;
     float2 uv : TEXCOORD;
+    nointerpolation uint materialIndex : MATERIAL;
 };
 
 
@@ -23,23 +27,31 @@ cbuffer transform : register(b0)
     row_major matrix view;
     row_major matrix projection;
     float3 viewPos;
+    float4 positionScale;
+    float4 positionOffset;
 };
 
 
 VS_OUTPUT main(VS_INPUT input)
 {
+    // precise keeps depth bit exact with depth.vs for the EQUAL test after the prepass
+    precise float3 position = input.position * positionScale.xyz + positionOffset.xyz;
+    const float3 normal = DecodeOctahedral(input.normal);
+    const float4 tangent = DecodeOctahedralTangent(input.tangent);
+
     VS_OUTPUT output;
-    float4 posWS = mul(float4(input.position, 1.0f), model);
-    float4 normalWS = mul(float4(input.normal, 0.0f), model);
-    float4 tangentWS = mul(float4(input.tangent.xyz * input.tangent.w, 0.0f), model);
-    //float4 tangentWS = mul(float4(input.tangent.xyz * 1.0, 0.0f), model);
+    precise float4 posWS = mul(float4(position, 1.0f), model);
+    float4 normalWS = mul(float4(normal, 0.0f), model);
+    float4 tangentWS = mul(float4(tangent.xyz * tangent.w, 0.0f), model);
 
-    output.pos = mul(posWS, mul(view, projection));
+    precise float4 pos = mul(posWS, mul(view, projection));
+    output.pos = pos;
     output.fragPos = posWS.xyz;
     output.viewPos = viewPos;
     output.normal = normalize(normalWS.xyz);
     output.tangent = normalize(tangentWS.xyz);
     output.uv = input.uv;
+    output.materialIndex = input.materialIndex;
     
     return output;
 }
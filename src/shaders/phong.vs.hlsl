@@ -1,7 +1,9 @@
+#include "octahedral.hlsli"
+
 struct VS_INPUT
 {
     float3 pos : POSITION;
-    float3 normal : NORMAL;
+    float2 normal : NORMAL;  // octahedral snorm
     float2 uv : TEXCOORD;
 };
 
@@ -28,7 +30,7 @@ VS_OUTPUT main(VS_INPUT input)
     output.pos = mul(float4(input.pos, 1.0f), mul(model, mul(view, projection)));
     output.fragPos = mul(float4(input.pos, 1.0f), model).xyz;
     output.viewPos = viewPos;
-    output.normal = input.normal;
+    output.normal = DecodeOctahedral(input.normal);
     output.uv = input.uv;
     
     return output;